@@ -1,6 +1,7 @@
 #include <iostream>
 #include "helpers.hpp"
 #include "transformers.hpp"
+#include "rigid.hpp"
 
 using namespace AdasTools;
 
@@ -30,11 +31,7 @@ int main()
 
     // Compose M = Mv * Ms (vehicle * sensor-local) so we can transform points
     double M[16];
-    for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) {
-        double s = 0.0;
-        for (int k = 0; k < 4; ++k) s += Mv[r*4 + k] * Ms[k*4 + c];
-        M[r*4 + c] = s;
-    }
+    rigidCompose(Mv, Ms, M);
 
     // call local->global (vehicle, sensor-local)
     Pose lidarGlobal = localToGlobalFromMatrix(vehiclePose, lidarPose);
@@ -50,11 +47,8 @@ int main()
     // Local point in lidar frame (as Pose: position + zero orientation)
     Pose p_local = {1.0, 0.5, 0.2, 0.0, 0.0, 0.0};
     // Apply M to point
-    double X = p_local.x, Y = p_local.y, Z = p_local.z;
-    double gx = M[0]*X + M[1]*Y + M[2]*Z + M[3];
-    double gy = M[4]*X + M[5]*Y + M[6]*Z + M[7];
-    double gz = M[8]*X + M[9]*Y + M[10]*Z + M[11];
-    std::cout << "Lidar point global: (" << gx << ", " << gy << ", " << gz << ")\n";
+    Point3 g = rigidTransformPoint(M, Point3{ p_local.x, p_local.y, p_local.z });
+    std::cout << "Lidar point global: (" << g.x << ", " << g.y << ", " << g.z << ")\n";
 
     // --- Camera sensor init and projection sequence ---
     // camera sensor is mounted on vehicle at some pose (angles given in degrees)
@@ -77,36 +71,15 @@ int main()
 
     // Compute camera global matrix: M_camera_global = Mv * Mc
     double Mcam_global[16];
-    for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) {
-        double s = 0.0;
-        for (int k = 0; k < 4; ++k) s += Mv[r*4 + k] * Mc[k*4 + c];
-        Mcam_global[r*4 + c] = s;
-    }
-
-    // Compute inverse of Mcam_global (rigid transform): inv = [R^T, -R^T t; 0 1]
-    double r00 = Mcam_global[0], r01 = Mcam_global[1], r02 = Mcam_global[2];
-    double r10 = Mcam_global[4], r11 = Mcam_global[5], r12 = Mcam_global[6];
-    double r20 = Mcam_global[8], r21 = Mcam_global[9], r22 = Mcam_global[10];
-    double tx  = Mcam_global[3], ty = Mcam_global[7], tz = Mcam_global[11];
-    double Rtr[9] = { r00, r10, r20, r01, r11, r21, r02, r12, r22 };
-    double t_inv_x = -(Rtr[0]*tx + Rtr[1]*ty + Rtr[2]*tz);
-    double t_inv_y = -(Rtr[3]*tx + Rtr[4]*ty + Rtr[5]*tz);
-    double t_inv_z = -(Rtr[6]*tx + Rtr[7]*ty + Rtr[8]*tz);
+    rigidCompose(Mv, Mc, Mcam_global);
+
+    // Inverse of Mcam_global (rigid transform): inv = [R^T, -R^T t; 0 1]
     double Minv_cam[16];
-    Minv_cam[0]=Rtr[0]; Minv_cam[1]=Rtr[1]; Minv_cam[2]=Rtr[2]; Minv_cam[3]=t_inv_x;
-    Minv_cam[4]=Rtr[3]; Minv_cam[5]=Rtr[4]; Minv_cam[6]=Rtr[5]; Minv_cam[7]=t_inv_y;
-    Minv_cam[8]=Rtr[6]; Minv_cam[9]=Rtr[7]; Minv_cam[10]=Rtr[8]; Minv_cam[11]=t_inv_z;
-    Minv_cam[12]=0.0; Minv_cam[13]=0.0; Minv_cam[14]=0.0; Minv_cam[15]=1.0;
+    rigidInverse(Mcam_global, Minv_cam);
 
     // extrinsic mapping from lidar_local -> camera = Minv_cam * M_lidar_global (M)
     double extrinsic_lidar_to_camera[16];
-    for (int r = 0; r < 4; ++r) {
-        for (int c = 0; c < 4; ++c) {
-            double s = 0.0;
-            for (int k = 0; k < 4; ++k) s += Minv_cam[r*4 + k] * M[k*4 + c];
-            extrinsic_lidar_to_camera[r*4 + c] = s;
-        }
-    }
+    rigidCompose(Minv_cam, M, extrinsic_lidar_to_camera);
 
     // Project the lidar local point into the camera image
     Pose pix = projectPointCamera(p_local, extrinsic_lidar_to_camera, K);
@@ -17,6 +17,7 @@
 
 #include "helpers.hpp"
 #include "transformers.hpp"
+#include "trace.hpp"
 
 using namespace AdasTools;
 
@@ -84,6 +85,7 @@ static bool draw_marker_and_save(const char *inpath, const char *outpath,
     int v = static_cast<int>(std::round(pix.y));
 
     // Draw a simple 5x5 red square center at (u,v)
+    ADAS_TRACE_SCOPE(TRACE_STAGE_RASTERIZE, "drawMarkerAndWrite");
     const int radius = 2;
     for (int dy = -radius; dy <= radius; ++dy) {
         for (int dx = -radius; dx <= radius; ++dx) {
@@ -109,7 +111,7 @@ static bool draw_marker_and_save(const char *inpath, const char *outpath,
 int main(int argc, char **argv)
 {
     if (argc < 3) {
-        std::cout << "Usage: visualize_projection <input_image> <output_image>\n";
+        std::cout << "Usage: visualize_projection <input_image> <output_image> [trace.json]\n";
         std::cout << "This example uses a hard-coded lidar pose and camera intrinsics/extrinsics for demo.\n";
         return 0;
     }
@@ -134,9 +136,16 @@ int main(int argc, char **argv)
                    0.0, 800.0, 240.0,
                    0.0, 0.0, 1.0};
 
+    // Optional Chrome trace of the stages (needs ADAS_TOOLS_INSTRUMENTATION=ON)
+    const char *tracepath = argc > 3 ? argv[3] : nullptr;
+    if (tracepath) traceSetEnabled(true);
+
     bool ok = draw_marker_and_save(inpath, outpath, p_local, extrinsic, K);
     if (!ok) return 2;
 
     std::cout << "Wrote " << outpath << " with projected marker.\n";
+    if (tracepath && traceWriteChromeJson(tracepath)) {
+        std::cout << "Wrote " << tracepath << " (" << traceEventCount() << " trace events).\n";
+    }
     return 0;
 }
@@ -0,0 +1,135 @@
+/* *******************************************************************************
+ * File: include/accumulation.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Rolling world-frame accumulation of lidar sweeps. Each sweep
+ *              is transformed into the world frame once on insertion and
+ *              binned into a voxel hash (open addressing, fixed capacity,
+ *              a small ring of points per voxel). Points expire by age and
+ *              voxels by distance from the vehicle; the current window is
+ *              extracted in the present vehicle frame in one gather-and-
+ *              transform pass, so no history is re-transformed per frame.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+#include "trajectory.hpp"
+
+namespace AdasTools {
+
+class FrameArena;
+class TaskPool;
+
+/** Largest AccumulationConfig::pointsPerVoxel. */
+constexpr unsigned kAccumulationMaxPointsPerVoxel = 64;
+
+/** @brief Tuning for AccumulationMap. */
+struct AccumulationConfig {
+    double voxelSize;        /**< voxel edge (m) */
+    unsigned pointsPerVoxel; /**< points kept per voxel (the oldest is replaced when full) */
+    size_t maxVoxels;        /**< capacity; points landing in new voxels beyond it are dropped */
+    double maxAge;           /**< points older than this (s) before the newest sweep are evicted */
+    double maxDistance;      /**< voxels further than this (m) from the vehicle are evicted */
+};
+
+/** @brief 0.1 m voxels, 4 points each, 256k voxels (~35 MB), 1 s history, 80 m radius. */
+inline AccumulationConfig defaultAccumulationConfig()
+{
+    AccumulationConfig c;
+    c.voxelSize = 0.1;
+    c.pointsPerVoxel = 4;
+    c.maxVoxels = 1u << 18;
+    c.maxAge = 1.0;
+    c.maxDistance = 80.0;
+    return c;
+}
+
+/**
+ * @brief Voxel-hashed store of recent sweeps in world coordinates.
+ *
+ * Voxel indices are kept in 21 bits per axis, so the map covers
+ * +-2^20 voxels around the world origin (+-104 km at 0.1 m); points outside
+ * are dropped.
+ */
+class AccumulationMap {
+public:
+    AccumulationMap();
+    ~AccumulationMap();
+    AccumulationMap(const AccumulationMap &) = delete;
+    AccumulationMap &operator=(const AccumulationMap &) = delete;
+
+    /** @brief Allocate storage for a config (clears the map). @return false on invalid config or allocation failure */
+    bool init(const AccumulationConfig &config);
+
+    /** @brief Remove everything (storage is kept). */
+    void clear();
+
+    /**
+     * @brief Evict expired points/voxels, then add one sweep.
+     * @param points Sweep in the vehicle frame
+     * @param n Number of points
+     * @param vehicleToWorld Vehicle pose at the sweep time
+     * @param stamp Sweep time (s), non-decreasing between calls
+     * @return Points stored (the rest were beyond maxDistance, outside the map or found no free voxel)
+     */
+    size_t insert(const Point3 *points, size_t n, const RigidTransform &vehicleToWorld, double stamp);
+    size_t insert(const Point3 *points, size_t n, const Pose &vehicleToWorld, double stamp);
+
+    /**
+     * @brief Drop points with stamp < now - maxAge and voxels further than
+     *        maxDistance from `position` (world frame). Called by insert().
+     */
+    void evict(double now, const Point3 &position);
+
+    /**
+     * @brief Write the accumulated points in the current vehicle frame.
+     * @param vehicleToWorld Current vehicle pose
+     * @param out Output, room for `capacity` points (size() is enough)
+     * @param capacity Size of `out` (and of `stamps`)
+     * @param stamps Optional output: sweep time of each point
+     * @param scratch Arena for per-block offsets (nullptr = threadScratchArena(), heap if none)
+     * @param pool Task pool for the voxel blocks (nullptr = defaultTaskPool())
+     * @return Points written (min(size(), capacity)), grouped by voxel
+     */
+    size_t extract(const RigidTransform &vehicleToWorld, Point3 *out, size_t capacity, double *stamps = nullptr,
+                   FrameArena *scratch = nullptr, TaskPool *pool = nullptr) const;
+    size_t extract(const Pose &vehicleToWorld, Point3 *out, size_t capacity, double *stamps = nullptr,
+                   FrameArena *scratch = nullptr, TaskPool *pool = nullptr) const;
+
+    /** @brief Points currently stored. */
+    size_t size() const { return points_; }
+
+    /** @brief Occupied voxels. */
+    size_t voxelCount() const { return voxels_; }
+
+    /** @brief Points insert() did not store since init(). */
+    unsigned long long dropped() const { return dropped_; }
+
+    /** @brief Scratch bytes extract() needs. */
+    size_t extractScratchBytes() const;
+
+private:
+    bool findOrAdd(unsigned long long key, size_t &voxel);
+    void removeVoxel(size_t voxel);
+    void compactVoxel(size_t voxel, double cutoff);
+    size_t bucketOf(unsigned long long key) const;
+
+    AccumulationConfig config_;
+    double invVoxel_;
+    void *memory_;
+    unsigned long long *keys_; /**< packed voxel index per voxel */
+    unsigned char *counts_;    /**< points per voxel */
+    unsigned char *next_;      /**< ring write position once full (== oldest point) */
+    Point3 *slots_;            /**< pointsPerVoxel world points per voxel */
+    double *stamps_;           /**< stamp per slot */
+    unsigned int *buckets_;    /**< hash: voxel + 1, 0 = empty */
+    size_t bucketMask_;
+    unsigned bucketShift_;
+    size_t voxels_;
+    size_t points_;
+    unsigned long long dropped_;
+};
+
+} // namespace AdasTools
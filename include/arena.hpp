@@ -0,0 +1,190 @@
+/* *******************************************************************************
+ * File: include/arena.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Per-frame monotonic (arena) allocator for scratch buffers used by
+ *              batch routines (projected coordinates, masks, index lists).
+ *              Allocation is a pointer bump, reset is O(1) and the backing
+ *              block is either caller-provided or reserved once (optionally on
+ *              huge pages). No STL; a std::pmr adapter is available when
+ *              ADAS_TOOLS_WITH_PMR is defined.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+
+namespace AdasTools {
+
+/**
+ * @brief Backing options for FrameArena::reserve().
+ */
+enum ArenaBacking {
+    ARENA_BACKING_DEFAULT = 0,   /**< plain anonymous pages / aligned malloc */
+    ARENA_BACKING_HUGE_PAGES = 1 /**< try MAP_HUGETLB, then transparent huge pages, then default */
+};
+
+/**
+ * @brief Monotonic bump allocator with O(1) reset.
+ *
+ * Typical use: one arena per worker thread, reserve() once at start-up, draw
+ * scratch from it during a frame, reset() at frame end. Individual
+ * allocations are never freed. When the arena is exhausted allocate()
+ * returns nullptr (and failedAllocations() increments) instead of falling back
+ * to the heap, so latency stays bounded.
+ */
+class FrameArena {
+public:
+    /** @brief Empty arena; call reserve() or attach() before allocating. */
+    FrameArena();
+
+    /**
+     * @brief Arena over caller-owned storage (e.g. a static buffer).
+     * @param buffer Storage, must outlive the arena
+     * @param bytes Size of `buffer` in bytes
+     */
+    FrameArena(void *buffer, size_t bytes);
+
+    ~FrameArena();
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /**
+     * @brief Reserve an owned backing block (releases any previous one).
+     * @param bytes Requested capacity (rounded up to the page/huge-page size)
+     * @param backing ARENA_BACKING_DEFAULT or ARENA_BACKING_HUGE_PAGES
+     * @return true on success
+     */
+    bool reserve(size_t bytes, ArenaBacking backing = ARENA_BACKING_DEFAULT);
+
+    /** @brief Use caller-owned storage (releases any owned block). */
+    void attach(void *buffer, size_t bytes);
+
+    /** @brief Release an owned block; the arena becomes empty. */
+    void release();
+
+    /**
+     * @brief Allocate `bytes` aligned to `align` (power of two).
+     * @return pointer or nullptr if the arena is exhausted (or the request
+     *         cannot be represented in size_t)
+     */
+    void *allocate(size_t bytes, size_t align = alignof(double))
+    {
+        // Work in offsets within the block: offset_ <= capacity_, so neither
+        // the padding nor the size check can wrap around.
+        size_t misalign = ((size_t)base_ + offset_) & (align - 1);
+        size_t pad = misalign ? align - misalign : 0;
+        size_t room = capacity_ - offset_;
+        if (pad > room || bytes > room - pad) {
+            ++failed_;
+            return nullptr;
+        }
+        unsigned char *p = base_ + offset_ + pad;
+        offset_ += pad + bytes;
+        if (offset_ > highWater_) highWater_ = offset_;
+        return p;
+    }
+
+    /**
+     * @brief Typed array allocation (uninitialised; T should be a POD).
+     * @param count Number of elements
+     * @param align Alignment (defaults to alignof(T); use 32/64 for SIMD)
+     * @return pointer or nullptr if the arena is exhausted or count * sizeof(T) overflows
+     */
+    template <typename T>
+    T *allocArray(size_t count, size_t align = alignof(T))
+    {
+        if (count > (size_t)-1 / sizeof(T)) {
+            ++failed_;
+            return nullptr;
+        }
+        return static_cast<T *>(allocate(count * sizeof(T), align < alignof(T) ? alignof(T) : align));
+    }
+
+    /** @brief Drop every allocation in O(1). */
+    void reset() { offset_ = 0; }
+
+    /** @brief Current fill level; pass to rewind() to free everything after it. */
+    size_t mark() const { return offset_; }
+
+    /** @brief Roll back to a previous mark() (nested scratch scopes). */
+    void rewind(size_t marker) { if (marker <= offset_) offset_ = marker; }
+
+    size_t used() const { return offset_; }
+    size_t capacity() const { return capacity_; }
+    /** @brief Largest fill level seen since construction; use it to size reserve(). */
+    size_t highWater() const { return highWater_; }
+    /** @brief Number of allocate() calls that did not fit. */
+    size_t failedAllocations() const { return failed_; }
+    /** @brief true if the owned block is backed by huge pages. */
+    bool hugePages() const { return huge_; }
+
+private:
+    unsigned char *base_;
+    size_t capacity_;
+    size_t offset_;
+    size_t highWater_;
+    size_t failed_;
+    size_t mappedBytes_; /**< owned block size (0 when caller-owned) */
+    bool mapped_;        /**< owned block came from mmap (else aligned malloc) */
+    bool huge_;
+};
+
+/**
+ * @brief RAII scratch scope: rewinds the arena to its entry mark on exit.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(FrameArena &arena) : arena_(arena), marker_(arena.mark()) {}
+    ~ArenaScope() { arena_.rewind(marker_); }
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+    FrameArena &arena_;
+    size_t marker_;
+};
+
+/**
+ * @brief Install the calling thread's default scratch arena.
+ *
+ * Batch routines that take an optional `FrameArena *scratch` argument use
+ * this arena when they are passed nullptr. The arena is not owned.
+ * @param arena Arena to use, or nullptr to clear
+ */
+void setThreadScratchArena(FrameArena *arena);
+
+/** @brief The calling thread's default scratch arena (may be nullptr). */
+FrameArena *threadScratchArena();
+
+} // namespace AdasTools
+
+#if defined(ADAS_TOOLS_WITH_PMR)
+#include <memory_resource>
+#include <new>
+
+namespace AdasTools {
+
+/**
+ * @brief std::pmr adapter so STL-based callers can draw from a FrameArena.
+ *        Deallocation is a no-op; memory returns on FrameArena::reset().
+ */
+class ArenaMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaMemoryResource(FrameArena &arena) : arena_(arena) {}
+
+private:
+    void *do_allocate(size_t bytes, size_t align) override
+    {
+        void *p = arena_.allocate(bytes, align);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    FrameArena &arena_;
+};
+
+} // namespace AdasTools
+#endif
@@ -0,0 +1,89 @@
+/* *******************************************************************************
+ * File: include/boxes.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Batch operations on 3D oriented bounding boxes (center Pose +
+ *              size): frame changes applied to the box pose as a whole,
+ *              corner generation, and projection to 2D image rectangles with
+ *              near-plane clipping. Uses the extrinsic/intrinsic conventions
+ *              of projectPointCamera() in transformers.hpp.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+/**
+ * @brief Oriented 3D box: center pose (R = Rz*Ry*Rx) and full edge lengths
+ *        along the box's own x (length), y (width) and z (height) axes.
+ */
+struct OrientedBox {
+    Pose center; /**< box center and orientation */
+    Point3 size; /**< full extents in meters (not half sizes) */
+};
+
+/** @brief Visibility of a projected box. */
+enum BoxVisibility {
+    BOX_BEHIND = 0,        /**< every corner at or behind the near plane */
+    BOX_OUTSIDE_IMAGE = 1, /**< in front of the camera but the rectangle misses the image */
+    BOX_CLIPPED = 2,       /**< crosses the near plane; rectangle from the clipped box */
+    BOX_IN_FRONT = 3       /**< fully in front of the near plane */
+};
+
+/**
+ * @brief Image-space bounding rectangle of a projected box, clamped to the
+ *        image ([0, width] x [0, height]). Only meaningful when visibility is
+ *        BOX_CLIPPED or BOX_IN_FRONT.
+ */
+struct ImageRect {
+    double uMin, vMin; /**< top-left pixel */
+    double uMax, vMax; /**< bottom-right pixel */
+    double minDepth;   /**< smallest camera depth of the (clipped) box */
+    BoxVisibility visibility;
+};
+
+/**
+ * @brief The 8 corners of a box. Corner i has sign (bit0 ? + : -) along x,
+ *        bit1 along y and bit2 along z of the box frame.
+ */
+void boxCorners(const OrientedBox &box, Point3 corners[8]);
+
+/**
+ * @brief Move boxes into another frame: out[i].center = frame * in[i].center.
+ *        The pose is composed once per box instead of transforming 8 corners.
+ * @param in Boxes in the local frame
+ * @param out Boxes in the parent frame (may equal `in`)
+ * @param n Number of boxes
+ * @param frame Local frame expressed in the parent frame
+ */
+void boxesLocalToGlobal(const OrientedBox *in, OrientedBox *out, size_t n, const Frame3D &frame);
+
+/**
+ * @brief As boxesLocalToGlobal() with a row-major 4x4 rigid transform.
+ */
+void boxesTransform(const OrientedBox *in, OrientedBox *out, size_t n, const double transform[16]);
+
+/**
+ * @brief Project boxes into one camera and compute their 2D rectangles.
+ *
+ * Each box is brought into the camera frame as a pose (center + 3 scaled
+ * axes); corners in front of `nearPlane` are projected directly and every
+ * edge crossing the plane contributes its intersection point, so boxes that
+ * straddle the camera get a correct (clipped) rectangle.
+ * @param boxes Boxes in the frame the extrinsic maps from
+ * @param n Number of boxes
+ * @param extrinsic 4x4 row-major, point frame -> camera frame (z forward)
+ * @param intrinsic 3x3 row-major K
+ * @param width Image width in pixels
+ * @param height Image height in pixels
+ * @param nearPlane Camera depth (m) of the clipping plane, > 0
+ * @param out n rectangles
+ * @return Number of boxes with a non-empty rectangle inside the image
+ */
+size_t projectBoxesToImage(const OrientedBox *boxes, size_t n, const double extrinsic[16], const double intrinsic[9],
+                           int width, int height, double nearPlane, ImageRect *out);
+
+} // namespace AdasTools
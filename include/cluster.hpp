@@ -0,0 +1,95 @@
+/* *******************************************************************************
+ * File: include/cluster.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Euclidean clustering of obstacle points. Points are binned into
+ *              a sorted voxel grid whose cells are small enough that each cell
+ *              is connected by itself; neighbouring cells are linked with a
+ *              union-find when any pair of their points is within the
+ *              tolerance. Tiles of the grid are linked in parallel and the
+ *              tile seams merged afterwards. Every cluster gets an
+ *              OrientedBox (yaw only) in the usual Pose conventions.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "boxes.hpp"
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+class FrameArena;
+class TaskPool;
+
+/** @brief Label of points that belong to no reported cluster. */
+const unsigned int kClusterNoise = 0xFFFFFFFFu;
+
+/** @brief Tuning for clusterPoints(). */
+struct ClusterConfig {
+    double tolerance;   /**< points closer than this (m) are in the same cluster */
+    unsigned minPoints; /**< smaller clusters are reported as noise */
+    unsigned maxPoints; /**< larger clusters are reported as noise */
+    double tileSize;    /**< tile width (m) along x for the parallel linking pass */
+    bool fitYaw;        /**< boxes aligned to the principal xy axis (else yaw = 0) */
+};
+
+/** @brief 0.5 m tolerance, 3 .. 2^32-1 points, 8 m tiles, yaw-fitted boxes. */
+inline ClusterConfig defaultClusterConfig()
+{
+    ClusterConfig c;
+    c.tolerance = 0.5;
+    c.minPoints = 3;
+    c.maxPoints = 0xFFFFFFFFu;
+    c.tileSize = 8.0;
+    c.fitYaw = true;
+    return c;
+}
+
+/** @brief One cluster: bounding box, centroid and its range in the member list. */
+struct PointCluster {
+    OrientedBox box;          /**< center pose (roll = pitch = 0) and full extents */
+    Point3 centroid;          /**< mean of the member points */
+    unsigned int firstMember; /**< offset into the members output */
+    unsigned int memberCount; /**< number of points */
+};
+
+/** @brief Scratch bytes clusterPoints() needs for n points. */
+size_t clusterScratchBytes(size_t n);
+
+/**
+ * @brief Cluster a point cloud.
+ *
+ * Cluster ids are ordered by the voxel key of their lowest cell (x-major), so
+ * the output does not depend on the thread count.
+ * @param points Points (any Cartesian frame; boxes are fitted around z)
+ * @param n Number of points
+ * @param config Tuning (see defaultClusterConfig())
+ * @param labels Output per point: cluster id or kClusterNoise (may be nullptr)
+ * @param clusters Output clusters
+ * @param maxClusters Capacity of `clusters`; further clusters become noise
+ * @param members Output, room for n: point indices grouped by cluster (may be nullptr)
+ * @param scratch Arena for the grid (nullptr = threadScratchArena(), heap if none)
+ * @param pool Task pool for tiles and box fitting (nullptr = defaultTaskPool())
+ * @param ok Optional status: false if the scratch could not be allocated
+ *           (arena exhausted) or the input is out of range (tolerance <= 0,
+ *           more than 2^32-2 points, grid too large); true otherwise, also
+ *           when no clusters were found
+ * @return Number of clusters written (0 on failure)
+ */
+size_t clusterPoints(const Point3 *points, size_t n, const ClusterConfig &config,
+                     unsigned int *labels, PointCluster *clusters, size_t maxClusters,
+                     unsigned int *members = nullptr, FrameArena *scratch = nullptr, TaskPool *pool = nullptr,
+                     bool *ok = nullptr);
+
+/**
+ * @brief Cluster the subset points[indices[0..count)], e.g. the obstacle list
+ *        of segmentGround(). labels are per subset entry; members hold
+ *        indices into `points`. `ok` reports failure as for clusterPoints().
+ */
+size_t clusterPointSubset(const Point3 *points, const unsigned int *indices, size_t count, const ClusterConfig &config,
+                          unsigned int *labels, PointCluster *clusters, size_t maxClusters,
+                          unsigned int *members = nullptr, FrameArena *scratch = nullptr, TaskPool *pool = nullptr,
+                          bool *ok = nullptr);
+
+} // namespace AdasTools
@@ -0,0 +1,83 @@
+/* *******************************************************************************
+ * File: include/compact.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Compact point storage for history buffers and accumulation:
+ *              6-byte points as int16 with a per-cloud offset/scale, or as
+ *              IEEE half floats (F16C). Decoding runs 4 points per step with
+ *              AVX2 (run-time dispatch as in rigid.cpp, scalar fallback), and
+ *              the batch transform and multi-camera projection read compact
+ *              clouds directly: chunks are decoded into L1-sized blocks and
+ *              the dequantization is folded into the transform matrix.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+/** @brief Quantized point: p = offset + scale * (x, y, z). */
+struct PointI16 {
+    short x, y, z;
+};
+
+/** @brief Point as IEEE 754 binary16 bit patterns: p = offset + scale * half(x, y, z). */
+struct PointF16 {
+    unsigned short x, y, z;
+};
+
+/**
+ * @brief Per-cloud dequantization, shared by both compact formats.
+ *
+ * For int16 the scale is the step (e.g. 0.01 m covers +-327 m around the
+ * offset). For half floats the scale is normally 1: values are metres
+ * relative to the offset (resolution ~1 cm up to 16 m, ~3 cm up to 64 m).
+ */
+struct PointQuantization {
+    Point3 offset; /**< value decoded from 0 */
+    Point3 scale;  /**< step per unit, per axis */
+};
+
+/** @brief Fixed step `resolution` (m) around `origin`: covers +-32767 steps. */
+PointQuantization quantizationForResolution(const Point3 &origin, double resolution);
+
+/** @brief Finest int16 steps covering the box [lo, hi] (per axis). */
+PointQuantization quantizationForBounds(const Point3 &lo, const Point3 &hi);
+
+/**
+ * @brief Round points to int16 steps (saturating at +-32767).
+ * @return Number of points that had to be clamped
+ */
+size_t encodePointsI16(const Point3 *in, size_t n, const PointQuantization &q, PointI16 *out);
+
+/** @brief Expand int16 points to doubles. */
+void decodePointsI16(const PointI16 *in, size_t n, const PointQuantization &q, Point3 *out);
+
+/** @brief Convert points to half floats relative to q (round to nearest even; overflow gives inf). */
+void encodePointsF16(const Point3 *in, size_t n, const PointQuantization &q, PointF16 *out);
+
+/** @brief Expand half-float points to doubles. */
+void decodePointsF16(const PointF16 *in, size_t n, const PointQuantization &q, Point3 *out);
+
+/** @brief IEEE binary16 bits to float (exact, handles subnormals, inf and NaN). */
+float halfToFloat(unsigned short h);
+
+/** @brief float to IEEE binary16 bits, round to nearest even. */
+unsigned short floatToHalf(float f);
+
+/**
+ * @brief out = m * decode(in): rigidTransformPoints() reading int16 points.
+ * @param m Transform (row-major 4x4) applied to the decoded points
+ * @param in Compact points
+ * @param n Number of points
+ * @param q Quantization of `in`
+ * @param out Output points
+ */
+void rigidTransformPointsI16(const double m[16], const PointI16 *in, size_t n, const PointQuantization &q, Point3 *out);
+
+/** @brief out = m * decode(in) for half-float points. */
+void rigidTransformPointsF16(const double m[16], const PointF16 *in, size_t n, const PointQuantization &q, Point3 *out);
+
+} // namespace AdasTools
@@ -0,0 +1,97 @@
+/* *******************************************************************************
+ * File: include/depth.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Depth-image unprojection (the inverse of projectPointCamera):
+ *              dense depth maps from stereo or learned depth become Point3
+ *              clouds in the camera's target frame (pseudo-lidar). A ray
+ *              table holding the target-frame direction of every sampled
+ *              pixel is built once per calibration, so each pixel costs one
+ *              multiply-add per axis. Rows are processed in parallel; invalid
+ *              depths are dropped and the cloud is written compacted.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+struct CameraModel;
+class FrameArena;
+class TaskPool;
+
+/** @brief Meaning of the values in a depth image. */
+enum DepthEncoding {
+    DEPTH_Z = 0,    /**< camera-frame z (stereo, most learned depth) */
+    DEPTH_RANGE = 1 /**< distance along the pixel ray */
+};
+
+/**
+ * @brief Unprojects depth images of one camera into a fixed target frame.
+ *
+ * The camera is given in the conventions of projectPointCamera(): the
+ * extrinsic maps target-frame points into the camera frame, so unprojecting
+ * a pixel and projecting the result gives back (u, v, depth).
+ */
+class DepthUnprojector {
+public:
+    DepthUnprojector();
+    ~DepthUnprojector();
+    DepthUnprojector(const DepthUnprojector &) = delete;
+    DepthUnprojector &operator=(const DepthUnprojector &) = delete;
+
+    /**
+     * @brief Build the ray table (call when the calibration changes).
+     * @param camera Intrinsic, extrinsic (target -> camera), image size and minDepth
+     * @param stride Use every stride-th pixel in u and v (1 = all pixels)
+     * @param encoding Depth values are camera z or ray distance
+     * @return false on invalid arguments or allocation failure (the table is then empty)
+     */
+    bool build(const CameraModel &camera, unsigned stride = 1, DepthEncoding encoding = DEPTH_Z);
+
+    /** @brief Sampled pixels: the most points unproject() can write. */
+    size_t maxPoints() const { return (size_t)sampledCols_ * sampledRows_; }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    unsigned stride() const { return stride_; }
+
+    /**
+     * @brief Unproject a float depth image (metres).
+     *
+     * Pixels with depth <= camera.minDepth, > maxDepth or NaN are skipped.
+     * Points are written in row-major pixel order.
+     * @param depth Depth image of the size given to build()
+     * @param rowStride Elements between depth rows (>= width)
+     * @param out Output, room for maxPoints() points
+     * @param pixels Optional output, room for maxPoints(): pixel index v * width + u of each point
+     * @param maxDepth Far limit (m)
+     * @param scratch Arena for per-block counts (nullptr = threadScratchArena(), heap if none)
+     * @param pool Task pool for the rows (nullptr = defaultTaskPool())
+     * @return Number of points written
+     */
+    size_t unproject(const float *depth, size_t rowStride, Point3 *out, unsigned int *pixels = nullptr,
+                     double maxDepth = 1e30, FrameArena *scratch = nullptr, TaskPool *pool = nullptr) const;
+
+    /** @brief unproject() for integer depth (e.g. millimetres): metres = value * scale; 0 is invalid. */
+    size_t unproject(const unsigned short *depth, size_t rowStride, double scale, Point3 *out,
+                     unsigned int *pixels = nullptr, double maxDepth = 1e30, FrameArena *scratch = nullptr,
+                     TaskPool *pool = nullptr) const;
+
+private:
+    float *rays_;      /**< SoA x | y | z target-frame ray per sampled pixel */
+    double origin_[3]; /**< camera center in the target frame */
+    double minDepth_;
+    int width_;
+    int height_;
+    unsigned stride_;
+    unsigned sampledCols_;
+    unsigned sampledRows_;
+};
+
+/** @brief Scratch bytes DepthUnprojector::unproject() needs for an image height and stride. */
+size_t depthUnprojectScratchBytes(int height, unsigned stride);
+
+} // namespace AdasTools
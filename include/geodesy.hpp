@@ -0,0 +1,96 @@
+/* *******************************************************************************
+ * File: include/geodesy.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: WGS84 geodetic (latitude/longitude/ellipsoidal height),
+ *              ECEF and local East-North-Up conversion for bringing GNSS
+ *              positions and map features into the Cartesian frames used by
+ *              Pose and Frame3D. An EnuFrame caches the rotation and origin
+ *              of the tangent frame at a reference point, so ECEF <-> ENU is
+ *              one rigid transform per point (rigidTransformPoints) and only
+ *              the ellipsoid step costs trigonometry. ECEF -> geodetic uses
+ *              Heikkinen's closed form (no iteration).
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+class TaskPool;
+
+/** WGS84 semi-major axis (m). */
+constexpr double kWgs84A = 6378137.0;
+/** WGS84 flattening. */
+constexpr double kWgs84F = 1.0 / 298.257223563;
+
+/** @brief Geodetic position on WGS84. Angles in radians like the rest of the library. */
+struct GeodeticPoint {
+    double latitude;  /**< radians, north positive */
+    double longitude; /**< radians, east positive */
+    double altitude;  /**< height above the ellipsoid (m) */
+};
+
+/** @brief GeodeticPoint from degrees (the usual GNSS output). */
+inline GeodeticPoint geodeticFromDegrees(double latitudeDeg, double longitudeDeg, double altitude)
+{
+    const double k = 3.14159265358979323846 / 180.0;
+    return GeodeticPoint{ latitudeDeg * k, longitudeDeg * k, altitude };
+}
+
+/**
+ * @brief Compass heading (clockwise from north, radians) to the ENU yaw used
+ *        by Pose/Frame3D (counter-clockwise about up, from east).
+ */
+inline double headingToEnuYaw(double heading) { return 1.5707963267948966 - heading; }
+
+/** @brief Geodetic -> Earth-centred Earth-fixed (m). */
+Point3 geodeticToEcef(const GeodeticPoint &g);
+
+/** @brief ECEF -> geodetic (not defined at the Earth's centre). */
+GeodeticPoint ecefToGeodetic(const Point3 &ecef);
+
+/**
+ * @brief Local East-North-Up frame at a reference point. The matrices are
+ *        row-major 4x4 rigid transforms for rigidTransformPoints() and the
+ *        other matrix APIs.
+ */
+struct EnuFrame {
+    GeodeticPoint origin;
+    Point3 originEcef;
+    double ecefToEnu[16]; /**< p_enu = R (p_ecef - originEcef) */
+    double enuToEcef[16]; /**< inverse */
+};
+
+/** @brief Build (once per reference point) the ENU frame at `origin`. */
+EnuFrame makeEnuFrame(const GeodeticPoint &origin);
+
+/** @brief Single-point conversions through a cached frame. */
+Point3 geodeticToEnu(const EnuFrame &frame, const GeodeticPoint &g);
+GeodeticPoint enuToGeodetic(const EnuFrame &frame, const Point3 &enu);
+
+/**
+ * @brief Batch conversions in parallel blocks (pool nullptr = defaultTaskPool()).
+ *        Results are identical for any thread count; out may not alias in.
+ */
+void geodeticToEcefBatch(const GeodeticPoint *in, Point3 *out, size_t n, TaskPool *pool = nullptr);
+void ecefToGeodeticBatch(const Point3 *in, GeodeticPoint *out, size_t n, TaskPool *pool = nullptr);
+void geodeticToEnuBatch(const EnuFrame &frame, const GeodeticPoint *in, Point3 *out, size_t n,
+                        TaskPool *pool = nullptr);
+void enuToGeodeticBatch(const EnuFrame &frame, const Point3 *in, GeodeticPoint *out, size_t n,
+                        TaskPool *pool = nullptr);
+
+/**
+ * @brief Pose in the reference ENU frame of a body from its GNSS position and
+ *        attitude (roll/pitch/yaw relative to the local ENU axes at that
+ *        position, see headingToEnuYaw()). The result works with
+ *        localToGlobal()/poseToMatrix() like any world pose.
+ */
+Pose geodeticPoseToEnu(const EnuFrame &frame, const GeodeticPoint &position, double roll, double pitch, double yaw);
+
+/** @brief The ENU frame as a Frame3D in ECEF: localToGlobal(enuPoint, f) is the ECEF point. */
+Frame3D enuFrameInEcef(const EnuFrame &frame);
+
+} // namespace AdasTools
@@ -0,0 +1,85 @@
+/* *******************************************************************************
+ * File: include/ground.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: RANSAC ground-plane segmentation for vehicle-frame point
+ *              clouds. Hypotheses are scored in parallel (TaskPool) on a
+ *              structure-of-arrays float subsample with a vectorizable
+ *              point-to-plane distance kernel; the best plane is refined by
+ *              least squares and every point is classified in one pass into
+ *              ground / non-ground index lists.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+class FrameArena;
+class TaskPool;
+
+/** @brief Plane n . p + d = 0 with unit normal n pointing up (nz > 0). */
+struct GroundPlane {
+    double nx, ny, nz;
+    double d;
+};
+
+/** @brief Tuning for segmentGround(). */
+struct GroundSegmentationConfig {
+    double distanceThreshold; /**< max |distance| (m) of a ground point to the plane */
+    double maxSlope;          /**< max plane tilt from horizontal (rad) */
+    double maxSeedHeight;     /**< only points with z below this seed hypotheses (vehicle frame) */
+    unsigned iterations;      /**< RANSAC hypotheses */
+    unsigned sampleSize;      /**< points used to score hypotheses (evenly strided subsample) */
+    unsigned seed;            /**< RNG seed; results do not depend on the thread count */
+    bool refine;              /**< least-squares refit on the inliers of the best hypothesis */
+};
+
+/** @brief 0.15 m threshold, 15 deg slope, 128 hypotheses on 4096 points, refine on. */
+inline GroundSegmentationConfig defaultGroundSegmentationConfig()
+{
+    GroundSegmentationConfig c;
+    c.distanceThreshold = 0.15;
+    c.maxSlope = 0.2617993877991494;
+    c.maxSeedHeight = 1e30;
+    c.iterations = 128;
+    c.sampleSize = 4096;
+    c.seed = 1u;
+    c.refine = true;
+    return c;
+}
+
+/** @brief Output of segmentGround(). */
+struct GroundSegmentationResult {
+    GroundPlane plane;    /**< fitted plane */
+    Pose frame;           /**< plane frame: origin = projection of (0,0,0), z = normal, yaw = 0 */
+    size_t groundCount;   /**< entries written to groundIndices */
+    size_t obstacleCount; /**< entries written to obstacleIndices */
+    size_t sampleInliers; /**< inliers of the winning hypothesis on the subsample */
+};
+
+/** @brief Scratch bytes segmentGround() needs for a config. */
+size_t groundSegmentationScratchBytes(const GroundSegmentationConfig &config);
+
+/**
+ * @brief Fit the ground plane and split the cloud into ground / obstacle points.
+ * @param points Vehicle-frame points (z up)
+ * @param n Number of points
+ * @param config Tuning (see defaultGroundSegmentationConfig())
+ * @param groundIndices Output, room for n indices (ascending)
+ * @param obstacleIndices Output, room for n indices (ascending); may be nullptr
+ * @param result Plane, frame and counts
+ * @param scratch Arena for the subsample (nullptr = threadScratchArena(), heap if none)
+ * @param pool Task pool for hypothesis scoring (nullptr = defaultTaskPool())
+ * @return false if no hypothesis produced a valid plane (or scratch was exhausted)
+ */
+bool segmentGround(const Point3 *points, size_t n, const GroundSegmentationConfig &config,
+                   unsigned int *groundIndices, unsigned int *obstacleIndices, GroundSegmentationResult &result,
+                   FrameArena *scratch = nullptr, TaskPool *pool = nullptr);
+
+/** @brief Pose of a plane frame (origin = projection of the origin, z = normal, yaw = 0). */
+Pose groundPlaneFrame(const GroundPlane &plane);
+
+} // namespace AdasTools
@@ -10,6 +10,18 @@
 
 #pragma once
 
+/**
+ * ADAS_CORE_INLINE marks the transform/quaternion core definitions. With
+ * ADAS_TOOLS_HEADER_ONLY they are `inline` and compiled into each caller (so
+ * per-element calls can be inlined and vectorized without LTO); otherwise
+ * they are emitted once by src/transformers.cpp and src/quaternion.cpp.
+ */
+#if defined(ADAS_TOOLS_HEADER_ONLY)
+#define ADAS_CORE_INLINE inline
+#else
+#define ADAS_CORE_INLINE
+#endif
+
 namespace AdasTools {
 
 /**
@@ -0,0 +1,167 @@
+/* *******************************************************************************
+ * File: include/histogram.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: HDR-style latency histograms (log-linear buckets with a fixed
+ *              relative precision) and per-stage latency metrics. Stage
+ *              latencies are recorded per thread without locks by the same
+ *              TraceScope/ADAS_TRACE_SCOPE markers used for tracing, merged on
+ *              read and exported as p50/p99/p99.9/max in text or JSON. In
+ *              instrumented builds every transform/project/interpolate entry
+ *              point of the library carries such a marker.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "trace.hpp"
+
+namespace AdasTools {
+
+/** Upper bound for significantBits in HistogramConfig. */
+constexpr unsigned kHistogramMaxSignificantBits = 7;
+
+/** Bucket storage needed for the finest configuration over 64-bit values. */
+constexpr size_t kHistogramMaxBuckets =
+    (1u << kHistogramMaxSignificantBits) + (64 - kHistogramMaxSignificantBits) * (1u << (kHistogramMaxSignificantBits - 1));
+
+/**
+ * @brief Bucket layout of a LatencyHistogram.
+ *
+ * Values below 2^significantBits get one bucket each; above that every
+ * power-of-two range is split into 2^(significantBits-1) buckets, so the
+ * relative bucket width (and hence percentile error) is at most
+ * 2^(1-significantBits): 7 bits -> 1.6 %, 5 bits -> 6.3 %.
+ */
+struct HistogramConfig {
+    unsigned significantBits;        /**< precision, 2..kHistogramMaxSignificantBits */
+    unsigned long long highestValue; /**< larger values are clamped (max() stays exact) */
+};
+
+/** @brief 7 significant bits, values up to ~17 s in nanoseconds. */
+inline HistogramConfig defaultHistogramConfig()
+{
+    HistogramConfig c;
+    c.significantBits = 7;
+    c.highestValue = 1ull << 34;
+    return c;
+}
+
+/**
+ * @brief Fixed-storage log-linear histogram (single-threaded value type).
+ */
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(const HistogramConfig &config = defaultHistogramConfig());
+
+    /** @brief Add one sample. */
+    void record(unsigned long long value)
+    {
+        if (value > highest_) value = highest_;
+        ++counts_[bucketIndex(value)];
+        ++total_;
+        sum_ += value;
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+
+    /**
+     * @brief Add `n` samples to a bucket (used when merging raw counters).
+     *        Only counts change; set sum/min/max afterwards with setSummary().
+     */
+    void addBucket(size_t index, unsigned long long n);
+
+    /** @brief Overwrite the exact sum/min/max tracked alongside raw buckets. */
+    void setSummary(unsigned long long sum, unsigned long long minValue, unsigned long long maxValue);
+
+    /** @brief Add another histogram with the same config. @return false on config mismatch */
+    bool merge(const LatencyHistogram &other);
+
+    /** @brief Drop all samples. */
+    void clear();
+
+    /**
+     * @brief Value at or below which `percent` of samples fall (bucket upper
+     *        bound, clamped to max()). @param percent in [0, 100]
+     */
+    unsigned long long percentile(double percent) const;
+
+    unsigned long long count() const { return total_; }
+    unsigned long long min() const { return total_ ? min_ : 0; }
+    unsigned long long max() const { return max_; }
+    double mean() const { return total_ ? (double)sum_ / (double)total_ : 0.0; }
+
+    /** @brief Bucket holding `value` (value must be <= highestValue). */
+    size_t bucketIndex(unsigned long long value) const
+    {
+        if (value < linearLimit_) return (size_t)value;
+        unsigned msb = 63u - (unsigned)__builtin_clzll(value);
+        unsigned shift = msb - bits_ + 1u;
+        unsigned long long mantissa = value >> shift;
+        return (size_t)(linearLimit_ + (shift - 1u) * halfLimit_ + (mantissa - halfLimit_));
+    }
+
+    /** @brief Largest value mapped to bucket `index`. */
+    unsigned long long bucketUpperBound(size_t index) const;
+
+    size_t bucketCount() const { return buckets_; }
+    unsigned long long bucketValue(size_t index) const { return counts_[index]; }
+    const HistogramConfig &config() const { return config_; }
+
+private:
+    HistogramConfig config_;
+    unsigned bits_;
+    unsigned long long linearLimit_; /**< 2^bits */
+    unsigned long long halfLimit_;   /**< 2^(bits-1) */
+    unsigned long long highest_;
+    size_t buckets_;
+    unsigned long long total_;
+    unsigned long long sum_;
+    unsigned long long min_;
+    unsigned long long max_;
+    unsigned long long counts_[kHistogramMaxBuckets];
+};
+
+/** @brief Output format of latencyFormatReport(). */
+enum LatencyReportFormat {
+    LATENCY_REPORT_TEXT = 0, /**< one `adas_latency_ns{stage=..,quantile=..} v` line per value */
+    LATENCY_REPORT_JSON = 1  /**< {"transform":{"count":..,"p50":..,...},...} */
+};
+
+/**
+ * @brief Set the bucket layout for stage metrics. Clears recorded samples;
+ *        call while no thread is recording.
+ */
+void latencyConfigure(const HistogramConfig &config);
+
+/** @brief Start/stop per-stage latency recording (process wide, default off). */
+void latencySetEnabled(bool enabled);
+
+/** @brief true while stage latencies are recorded. */
+bool latencyEnabled();
+
+/** @brief Record one stage duration (ns) into the calling thread's histogram. */
+void latencyRecord(TraceStage stage, unsigned long long nanoseconds);
+
+/**
+ * @brief Merge every thread's histogram for `stage` into `out`
+ *        (out is cleared and reconfigured first).
+ */
+void latencySnapshot(TraceStage stage, LatencyHistogram &out);
+
+/** @brief Zero all stage histograms (call while no thread is recording). */
+void latencyReset();
+
+/**
+ * @brief Format count/p50/p99/p99.9/max/mean for every stage with samples.
+ * @param buffer Output buffer (always NUL-terminated when capacity > 0)
+ * @param capacity Size of `buffer` in bytes
+ * @param format Text or JSON
+ * @return Characters needed (excluding NUL); output is truncated if >= capacity
+ */
+size_t latencyFormatReport(char *buffer, size_t capacity, LatencyReportFormat format);
+
+/** @brief Write latencyFormatReport() output to a file. @return true on success */
+bool latencyWriteReport(const char *path, LatencyReportFormat format);
+
+} // namespace AdasTools
@@ -0,0 +1,112 @@
+/* *******************************************************************************
+ * File: include/icp.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Point-to-plane ICP for refining the relative pose of two
+ *              clouds (e.g. lidar-to-lidar extrinsics). The target is indexed
+ *              once by a PointKdTree with PCA normals; every iteration finds
+ *              correspondences in parallel (TaskPool), accumulates the 6x6
+ *              normal equations per fixed block of source points (AVX2/FMA
+ *              where available) and applies the solved twist as an exact
+ *              rotation (quaternion) + translation. Iterations stop once the
+ *              update falls below the configured epsilons.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+#include "kdtree.hpp"
+#include "trajectory.hpp"
+
+namespace AdasTools {
+
+class FrameArena;
+class TaskPool;
+
+/**
+ * @brief Unit normals of a cloud from the k nearest neighbours of every point
+ *        (smallest principal axis of the neighbourhood covariance).
+ *
+ * Points with fewer than 3 neighbours within `radius`, or a neighbourhood
+ * that is not planar (line or blob), get a zero normal; registerPointToPlane()
+ * skips them.
+ * @param tree Tree built over `points`
+ * @param points The same n points
+ * @param n Number of points
+ * @param k Neighbours per point (3..64)
+ * @param radius Neighbour search radius (m)
+ * @param normals Output, n unit normals (or zero)
+ * @param pool Task pool (nullptr = defaultTaskPool())
+ */
+void estimatePointNormals(const PointKdTree &tree, const Point3 *points, size_t n, unsigned k, double radius,
+                          Point3 *normals, TaskPool *pool = nullptr);
+
+/** @brief Tuning for registerPointToPlane(). */
+struct IcpConfig {
+    unsigned maxIterations;           /**< hard cap on iterations */
+    double maxCorrespondenceDistance; /**< pairs farther apart (m) are ignored */
+    double rotationEpsilon;           /**< stop when the update rotates less than this (rad) */
+    double translationEpsilon;        /**< ... and moves less than this (m) */
+    unsigned minCorrespondences;      /**< fail below this many pairs */
+};
+
+/** @brief 30 iterations, 1 m gate, stop below 1e-5 rad / 1e-4 m, 20 pairs minimum. */
+inline IcpConfig defaultIcpConfig()
+{
+    IcpConfig c;
+    c.maxIterations = 30;
+    c.maxCorrespondenceDistance = 1.0;
+    c.rotationEpsilon = 1e-5;
+    c.translationEpsilon = 1e-4;
+    c.minCorrespondences = 20;
+    return c;
+}
+
+/** @brief Output of registerPointToPlane(). */
+struct IcpResult {
+    RigidTransform transform; /**< refined source-to-target transform */
+    Pose pose;                /**< the same as x,y,z,roll,pitch,yaw (R = Rz*Ry*Rx) */
+    unsigned iterations;      /**< iterations run */
+    size_t correspondences;   /**< pairs used in the last iteration */
+    double rms;               /**< RMS point-to-plane residual of the last iteration (m) */
+    bool converged;           /**< stopped on the epsilons (not on maxIterations) */
+};
+
+/** @brief Scratch bytes registerPointToPlane() needs for n source points. */
+size_t icpScratchBytes(size_t n);
+
+/**
+ * @brief Refine T such that T * source lies on the target surface.
+ *
+ * Minimizes sum (n_j . (T p_i - q_j))^2 over nearest-neighbour pairs. The
+ * per-block sums are reduced in block order, so the result does not depend
+ * on the thread count.
+ *
+ * Cost is per iteration, so the starting guess matters: 30k -> 30k points
+ * take about 13 ms warm-started from the previous answer (1 iteration) but
+ * about 60 ms cold from identity (5 iterations) on one core. Only the warm
+ * path fits a 20 ms per-frame budget there; run cold solves off the frame
+ * loop (or on more cores, the correspondence search scales with the pool).
+ * @param target Tree over the target points
+ * @param targetPoints Target points (the array the tree was built from)
+ * @param targetNormals Normals from estimatePointNormals()
+ * @param source Source points
+ * @param n Number of source points
+ * @param initial Initial guess (e.g. the current extrinsic)
+ * @param config Tuning (see defaultIcpConfig())
+ * @param result Refined transform, pose and statistics (set even on failure)
+ * @param scratch Arena for per-point match hints (nullptr = threadScratchArena(), heap if none)
+ * @param pool Task pool for the correspondence search (nullptr = defaultTaskPool())
+ * @return false if there were too few correspondences or the system was singular
+ */
+bool registerPointToPlane(const PointKdTree &target, const Point3 *targetPoints, const Point3 *targetNormals,
+                          const Point3 *source, size_t n, const RigidTransform &initial, const IcpConfig &config,
+                          IcpResult &result, FrameArena *scratch = nullptr, TaskPool *pool = nullptr);
+
+/** @brief registerPointToPlane() with the initial guess given as a Pose. */
+bool registerPointToPlane(const PointKdTree &target, const Point3 *targetPoints, const Point3 *targetNormals,
+                          const Point3 *source, size_t n, const Pose &initial, const IcpConfig &config,
+                          IcpResult &result, FrameArena *scratch = nullptr, TaskPool *pool = nullptr);
+
+} // namespace AdasTools
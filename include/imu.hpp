@@ -0,0 +1,123 @@
+/* *******************************************************************************
+ * File: include/imu.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Strapdown IMU integration between pose updates. Gyro and
+ *              accelerometer samples are integrated into orientation
+ *              (quaternion), velocity and position, and can be preintegrated
+ *              between keyframes into one relative motion that is applied to
+ *              any start state. Each sample interval is integrated in closed
+ *              form for constant body rate and specific force: the rotation
+ *              by the exponential map, velocity and position through the
+ *              integrated rotation (no midpoint or Euler approximation), so
+ *              the result does not depend on the IMU rate for such motion.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+#include "quaternion.hpp"
+#include "trajectory.hpp"
+
+namespace AdasTools {
+
+/** @brief Standard gravity (m/s^2). */
+constexpr double kStandardGravity = 9.80665;
+
+/**
+ * @brief One IMU sample in the IMU (body) frame. The measurements are taken
+ *        as constant over the interval ending at `stamp` (the usual output of
+ *        IMUs that average internally).
+ */
+struct ImuSample {
+    double stamp; /**< end of the interval (s) */
+    Point3 gyro;  /**< body rate (rad/s) */
+    Point3 accel; /**< specific force (m/s^2): at rest the accelerometer reads -gravity */
+};
+
+/** @brief Constant sensor biases, subtracted from the measurements. */
+struct ImuBias {
+    Point3 gyro;  /**< rad/s */
+    Point3 accel; /**< m/s^2 */
+};
+
+/** @brief Body state in the world (navigation) frame. */
+struct NavState {
+    double stamp;
+    RigidTransform pose; /**< body -> world */
+    Point3 velocity;     /**< world frame (m/s) */
+};
+
+/**
+ * @brief Motion between two keyframes expressed in the body frame of the
+ *        first one: independent of its pose, velocity and gravity.
+ */
+struct ImuPreintegration {
+    double startStamp;   /**< keyframe i */
+    double stamp;        /**< last integrated sample */
+    Quaternion rotation; /**< dR = R_i^T R_j */
+    Point3 velocity;     /**< dv = R_i^T (v_j - v_i - g dt) */
+    Point3 position;     /**< dp = R_i^T (p_j - p_i - v_i dt - g dt^2 / 2) */
+};
+
+/** @brief Empty preintegration starting at a keyframe time. */
+ImuPreintegration startPreintegration(double stamp);
+
+/**
+ * @brief Add samples to a preintegration (may be called repeatedly).
+ *        Samples not later than pre.stamp are skipped.
+ * @return Samples integrated
+ */
+size_t preintegrateImu(ImuPreintegration &pre, const ImuSample *samples, size_t n, const ImuBias &bias);
+
+/**
+ * @brief State at pre.stamp from the state at pre.startStamp.
+ * @param gravity World-frame gravity (e.g. {0, 0, -kStandardGravity})
+ */
+NavState predictNavState(const NavState &start, const ImuPreintegration &pre, const Point3 &gravity);
+
+/**
+ * @brief Propagates one IMU's navigation state sample by sample. Run one
+ *        per IMU; compose the state with the IMU mounting (composeTransform)
+ *        to get the vehicle pose.
+ */
+class ImuPropagator {
+public:
+    ImuPropagator();
+
+    /** @brief Start from a known state (e.g. each 10-20 Hz pose update). */
+    void reset(const NavState &state) { state_ = state; }
+
+    /** @brief World-frame gravity (default {0, 0, -kStandardGravity}). */
+    void setGravity(const Point3 &gravity) { gravity_ = gravity; }
+
+    void setBias(const ImuBias &bias) { bias_ = bias; }
+
+    const NavState &state() const { return state_; }
+
+    /**
+     * @brief Integrate a batch of samples in time order. Samples not later
+     *        than the current state are skipped.
+     * @param outputs Optional: state after each integrated sample
+     * @return Samples integrated (entries written to outputs)
+     */
+    size_t propagate(const ImuSample *samples, size_t n, NavState *outputs = nullptr);
+
+    /**
+     * @brief propagate() that appends the pose after each sample to a
+     *        Trajectory, for the relative/interpolation transform APIs.
+     * @return Samples integrated (stops early if the trajectory cannot grow;
+     *         the state then stays at the last recorded sample)
+     */
+    size_t propagate(const ImuSample *samples, size_t n, Trajectory &trajectory);
+
+private:
+    size_t integrate(const ImuSample *samples, size_t n, NavState *outputs, Trajectory *trajectory);
+
+    NavState state_;
+    Point3 gravity_;
+    ImuBias bias_;
+};
+
+} // namespace AdasTools
@@ -0,0 +1,146 @@
+/* *******************************************************************************
+ * File: include/instrumentation.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Compile-time-toggleable hot-path instrumentation. Each public
+ *              entry point records call count, points processed and elapsed
+ *              ticks (TSC on x86, steady clock elsewhere) into per-thread
+ *              counters without locks; a snapshot sums all threads on read.
+ *              Enable with -DADAS_TOOLS_ENABLE_INSTRUMENTATION (CMake option
+ *              ADAS_TOOLS_INSTRUMENTATION). When disabled ADAS_PROFILE_SCOPE
+ *              expands to nothing.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+
+namespace AdasTools {
+
+/**
+ * @brief Instrumented entry points. Append new probes before PROBE_COUNT and
+ *        add their name in profileProbeName().
+ */
+enum ProfileProbe {
+    PROBE_LOCAL_TO_GLOBAL = 0,
+    PROBE_GLOBAL_TO_LOCAL,
+    PROBE_LOCAL_TO_GLOBAL_FROM_MATRIX,
+    PROBE_GLOBAL_TO_LOCAL_FROM_MATRIX,
+    PROBE_PROJECT_POINT_CAMERA,
+    PROBE_SLERP,
+    PROBE_PROJECT_MULTI_CAMERA,
+    PROBE_PROJECT_BOXES,
+    PROBE_FILTER_POINTS,
+    PROBE_GROUND_SEGMENTATION,
+    PROBE_CLUSTER_POINTS,
+    PROBE_ICP_REGISTRATION,
+    PROBE_REPROJECTION_ERROR,
+    PROBE_RANGE_ENCODE,
+    PROBE_RANGE_DECODE,
+    PROBE_BEV_WARP,
+    PROBE_DEPTH_UNPROJECT,
+    PROBE_ACCUMULATE_INSERT,
+    PROBE_ACCUMULATE_EXTRACT,
+    PROBE_RAY_CAST,
+    PROBE_VISIBILITY,
+    PROBE_CARVE_FREE_SPACE,
+    PROBE_IMU_PROPAGATE,
+    PROBE_IMU_PREINTEGRATE,
+    PROBE_GEODETIC_TO_CARTESIAN,
+    PROBE_CARTESIAN_TO_GEODETIC,
+    PROBE_RIGID_COMPOSE,
+    PROBE_RIGID_INVERSE,
+    PROBE_RIGID_TRANSFORM_POINTS,
+    PROBE_TRAJECTORY_RELATIVE,
+    PROBE_TRAJECTORY_INTERPOLATE,
+    PROBE_POSE_LOG_READ,
+    PROBE_POSE_LOG_WRITE,
+    PROBE_COMPACT_ENCODE,
+    PROBE_COMPACT_DECODE,
+    PROBE_COMPACT_TRANSFORM,
+    PROBE_POSES_TO_MATRICES,
+    PROBE_POSES_TO_TRANSFORMS,
+    PROBE_BOXES_TRANSFORM,
+    PROBE_BOXES_LOCAL_TO_GLOBAL,
+    PROBE_COUNT
+};
+
+/**
+ * @brief Aggregated counters for one probe.
+ */
+struct ProbeStats {
+    unsigned long long calls;  /**< number of calls */
+    unsigned long long points; /**< points (or elements) processed */
+    unsigned long long ticks;  /**< elapsed ticks summed over calls */
+};
+
+/**
+ * @brief Sum of all threads' counters at the time of the snapshot.
+ */
+struct ProfileSnapshot {
+    ProbeStats probes[PROBE_COUNT];
+    double ticksPerSecond; /**< tick rate used to convert `ticks` to time */
+};
+
+/** @brief true if the library was built with instrumentation enabled. */
+bool profileEnabled();
+
+/** @brief Read the current tick counter (TSC on x86, steady-clock ns otherwise). */
+unsigned long long profileTicks();
+
+/**
+ * @brief Record one call into the calling thread's counters (lock-free).
+ * @param probe Entry point
+ * @param points Points processed by the call
+ * @param ticks Elapsed ticks
+ */
+void profileRecord(ProfileProbe probe, unsigned long long points, unsigned long long ticks);
+
+/**
+ * @brief Sum every thread's counters into `out`. Counters of exited threads
+ *        are retained. Safe to call concurrently with recording.
+ */
+void profileSnapshot(ProfileSnapshot &out);
+
+/** @brief Zero all counters (intended for quiescent moments, e.g. between runs). */
+void profileReset();
+
+/** @brief Human readable name of a probe, e.g. "localToGlobal". */
+const char *profileProbeName(ProfileProbe probe);
+
+/**
+ * @brief RAII helper that times its own lifetime into a probe.
+ */
+class ProfileScope {
+public:
+    ProfileScope(ProfileProbe probe, unsigned long long points)
+        : probe_(probe), points_(points), start_(profileTicks()) {}
+    ~ProfileScope() { profileRecord(probe_, points_, profileTicks() - start_); }
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+    /** @brief Replace the point count (for calls that only know it on return). */
+    void setPoints(unsigned long long points) { points_ = points; }
+
+private:
+    ProfileProbe probe_;
+    unsigned long long points_;
+    unsigned long long start_;
+};
+
+} // namespace AdasTools
+
+#define ADAS_PROFILE_CONCAT_INNER(a, b) a##b
+#define ADAS_PROFILE_CONCAT(a, b) ADAS_PROFILE_CONCAT_INNER(a, b)
+
+#if defined(ADAS_TOOLS_ENABLE_INSTRUMENTATION)
+/** Time the enclosing scope into `probe`, counting `points` processed. */
+#define ADAS_PROFILE_SCOPE(probe, points) \
+    ::AdasTools::ProfileScope ADAS_PROFILE_CONCAT(adasProfileScope_, __LINE__)((probe), (unsigned long long)(points))
+/** Named variant, for calls whose point count is set on return with ADAS_PROFILE_SET_POINTS. */
+#define ADAS_PROFILE_SCOPE_NAMED(name, probe) ::AdasTools::ProfileScope name((probe), 0ull)
+#define ADAS_PROFILE_SET_POINTS(name, points) (name).setPoints((unsigned long long)(points))
+#else
+#define ADAS_PROFILE_SCOPE(probe, points) ((void)0)
+#define ADAS_PROFILE_SCOPE_NAMED(name, probe) ((void)0)
+#define ADAS_PROFILE_SET_POINTS(name, points) ((void)0)
+#endif
@@ -0,0 +1,132 @@
+/* *******************************************************************************
+ * File: include/ipm.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Inverse perspective mapping: top-down (bird's-eye view)
+ *              images of the ground plane from one or more calibrated
+ *              cameras. The ray/plane geometry is solved once per grid cell
+ *              when the rig or the grid changes and stored as a remap table
+ *              (source pixel, fixed-point bilinear weights, up to two
+ *              cameras with feathered blending). Warping a frame set is then
+ *              table lookups and integer arithmetic, SIMD for 3/4-channel
+ *              images, in parallel over blocks of rows.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "ground.hpp"
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+struct BevSample;
+struct CameraModel;
+class TaskPool;
+
+/** Cameras a BevRemap can stitch (camera index is stored in one byte). */
+constexpr size_t kBevMaxCameras = 16;
+
+/**
+ * @brief Top-down grid on the ground plane, in the vehicle frame (x forward,
+ *        y left, z up). Row 0 is the front edge and column 0 the left edge,
+ *        so the image shows the scene as seen from above with x pointing up.
+ */
+struct BevGridSpec {
+    double xMax;       /**< x (m) of the front edge of row 0 */
+    double yMax;       /**< y (m) of the left edge of column 0 */
+    double resolution; /**< cell size (m) */
+    unsigned rows;     /**< cells along -x */
+    unsigned cols;     /**< cells along -y */
+    GroundPlane plane; /**< ground; each cell is the vertical projection of its center onto it */
+};
+
+/** @brief rows x cols grid of `resolution` cells centered on the vehicle, ground at z = groundZ. */
+inline BevGridSpec centeredBevGrid(unsigned rows, unsigned cols, double resolution, double groundZ)
+{
+    BevGridSpec g;
+    g.xMax = 0.5 * rows * resolution;
+    g.yMax = 0.5 * cols * resolution;
+    g.resolution = resolution;
+    g.rows = rows;
+    g.cols = cols;
+    g.plane = GroundPlane{ 0.0, 0.0, 1.0, -groundZ };
+    return g;
+}
+
+/** @brief 8-bit interleaved image (caller-owned). */
+struct ImageU8 {
+    unsigned char *data; /**< first pixel of row 0 */
+    int width;
+    int height;
+    int channels;  /**< 1..4 interleaved bytes per pixel */
+    size_t stride; /**< bytes between rows (>= width * channels) */
+};
+
+/**
+ * @brief Precomputed camera-to-BEV remap for a fixed rig and grid.
+ *
+ * Each cell samples its best camera (the one where the cell projects
+ * furthest from the image border). Where a second camera also sees the cell
+ * the two are blended with weights proportional to their border distances
+ * clipped at `featherPixels`, which hides the seams of a surround rig.
+ */
+class BevRemap {
+public:
+    BevRemap();
+    ~BevRemap();
+    BevRemap(const BevRemap &) = delete;
+    BevRemap &operator=(const BevRemap &) = delete;
+
+    /**
+     * @brief Build the table (call when the calibration or the grid changes).
+     * @param cameras Rig, in the vehicle frame (extrinsic: vehicle -> camera)
+     * @param count Number of cameras (at most kBevMaxCameras)
+     * @param grid Ground grid
+     * @param featherPixels Blend width at image borders (0 = best camera only)
+     * @param pool Task pool for the rows (nullptr = defaultTaskPool())
+     * @return false on invalid arguments or allocation failure (the table is then empty)
+     */
+    bool build(const CameraModel *cameras, size_t count, const BevGridSpec &grid, double featherPixels = 32.0,
+               TaskPool *pool = nullptr);
+
+    /**
+     * @brief Warp one frame per camera into a top-down image.
+     * @param frames cameraCount() images, frames[i] of the size given for camera i;
+     *               all with the same channel count
+     * @param bev Output, grid.cols x grid.rows with the frames' channel count;
+     *            cells no camera sees are set to 0
+     * @param pool Task pool for the rows (nullptr = defaultTaskPool())
+     * @return false if the table is empty or an image does not match
+     */
+    bool warp(const ImageU8 *frames, ImageU8 &bev, TaskPool *pool = nullptr) const;
+
+    unsigned rows() const { return grid_.rows; }
+    unsigned cols() const { return grid_.cols; }
+    size_t cameraCount() const { return count_; }
+
+    /** @brief Cells seen by at least one camera. */
+    size_t coveredCells() const { return covered_; }
+
+    /** @brief Vehicle-frame point on the ground plane at the center of a cell. */
+    Point3 cellCenter(unsigned row, unsigned col) const;
+
+    /** @brief Camera sampled first by a cell, or -1 if none sees it. */
+    int cellCamera(unsigned row, unsigned col) const;
+
+    /** @brief Table size in bytes. */
+    size_t tableBytes() const;
+
+private:
+    struct Camera {
+        int width, height;
+    };
+
+    BevGridSpec grid_;
+    Camera cams_[kBevMaxCameras];
+    size_t count_;
+    size_t covered_;
+    BevSample *table_; /**< two fixed-point samples per cell, row-major */
+};
+
+} // namespace AdasTools
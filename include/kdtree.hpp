@@ -0,0 +1,81 @@
+/* *******************************************************************************
+ * File: include/kdtree.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Flat 3D KD-tree for nearest-neighbour queries. Nodes live in
+ *              one array in depth-first order (left child = next node), the
+ *              points are copied into float SoA arrays in leaf order, and the
+ *              queries walk the tree with a small fixed stack, so a lookup
+ *              touches no pointers and allocates nothing. Queries are const
+ *              and may run concurrently from any number of threads.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+/** @brief Returned by nearest() when no point is within range. */
+const unsigned int kNoNeighbor = 0xFFFFFFFFu;
+
+/**
+ * @brief Static KD-tree over a point cloud (rebuild for a new cloud).
+ *
+ * Coordinates are stored as floats: distances are exact to float rounding,
+ * which is far below lidar noise. Indices in and out of the queries refer to
+ * the array passed to build().
+ */
+class PointKdTree {
+public:
+    PointKdTree();
+    ~PointKdTree();
+    PointKdTree(const PointKdTree &) = delete;
+    PointKdTree &operator=(const PointKdTree &) = delete;
+
+    /**
+     * @brief Build the tree (median split on the widest axis, leaves of at
+     *        most 16 points). Storage is reused when it is large enough.
+     * @return false on allocation failure or more than 2^32-2 points
+     */
+    bool build(const Point3 *points, size_t n);
+
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Nearest point to q closer than maxDistance.
+     * @param q Query point
+     * @param maxDistance Search radius (m)
+     * @param distanceSq Output squared distance (may be nullptr)
+     * @param hint Index of a point expected to be close (e.g. last frame's
+     *             match) or kNoNeighbor; it only tightens the initial bound
+     * @return Index of the nearest point, or kNoNeighbor
+     */
+    unsigned int nearest(const Point3 &q, double maxDistance, double *distanceSq = nullptr,
+                         unsigned int hint = kNoNeighbor) const;
+
+    /**
+     * @brief Up to k nearest points closer than maxDistance, closest first.
+     * @param k Neighbours wanted (at most 64)
+     * @param indices Output, room for k
+     * @param distancesSq Output squared distances, room for k (may be nullptr)
+     * @return Number of neighbours written
+     */
+    size_t nearestK(const Point3 &q, size_t k, double maxDistance, unsigned int *indices,
+                    double *distancesSq = nullptr) const;
+
+private:
+    struct Node;
+    size_t buildRange(size_t first, size_t count, size_t &used);
+
+    void *block_;
+    Node *nodes_;
+    float *xs_, *ys_, *zs_;
+    unsigned int *index_; /**< leaf order -> original index */
+    unsigned int *slot_;  /**< original index -> leaf order */
+    size_t size_;
+    size_t capacity_;
+};
+
+} // namespace AdasTools
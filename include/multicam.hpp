@@ -0,0 +1,137 @@
+/* *******************************************************************************
+ * File: include/multicam.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: One-pass projection of a point cloud into several pinhole
+ *              cameras (e.g. a six-camera surround rig). The cloud is read
+ *              once; every point is projected only into the cameras whose
+ *              horizontal field of view can contain it (azimuth-sector masks
+ *              precomputed per rig) and each camera gets a compact list of
+ *              (point index, u, v, depth) hits.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+struct PointI16;
+struct PointF16;
+struct PointQuantization;
+
+/** Cameras per MultiCameraProjector (one bit each in a sector mask). */
+constexpr size_t kMultiCameraMaxCameras = 32;
+
+/** Azimuth sectors used for pre-bucketing. */
+constexpr size_t kMultiCameraSectors = 64;
+
+/**
+ * @brief One pinhole camera of a rig, in the conventions of projectPointCamera().
+ */
+struct CameraModel {
+    double extrinsic[16]; /**< cloud frame -> camera frame, row-major 4x4 (z forward) */
+    double intrinsic[9];  /**< K, row-major 3x3 [fx s cx; 0 fy cy; 0 0 1] */
+    int width;            /**< image width in pixels; hits satisfy 0 <= u < width */
+    int height;           /**< image height in pixels; hits satisfy 0 <= v < height */
+    double minDepth;      /**< points with camera depth <= minDepth are rejected */
+};
+
+/**
+ * @brief A point that landed inside one camera image.
+ */
+struct CameraHit {
+    unsigned int index; /**< index of the point in the input cloud */
+    float u;            /**< pixel column */
+    float v;            /**< pixel row */
+    float depth;        /**< camera-frame z in meters */
+};
+
+/**
+ * @brief Caller-owned output list for one camera (e.g. from FrameArena::allocArray).
+ *        Hits are appended in increasing point index; hits beyond `capacity`
+ *        are counted in `overflow` and dropped.
+ */
+struct CameraHitList {
+    CameraHit *hits;  /**< storage for `capacity` hits */
+    size_t capacity;  /**< size of `hits` */
+    size_t count;     /**< hits written by the last project() */
+    size_t overflow;  /**< hits that did not fit */
+};
+
+/**
+ * @brief Projects a cloud into up to kMultiCameraMaxCameras cameras in one sweep.
+ *
+ * setCameras() is called when the rig calibration changes; it precomputes,
+ * for each azimuth sector around the cloud origin, the cameras that can see
+ * it. Points closer (horizontally) than `bucketRadius` are tested against
+ * every camera, so the masks stay exact despite camera mounting offsets.
+ */
+class MultiCameraProjector {
+public:
+    MultiCameraProjector();
+
+    /**
+     * @brief Set the rig and rebuild the sector masks.
+     * @param cameras Camera descriptions (copied)
+     * @param count Number of cameras (at most kMultiCameraMaxCameras)
+     * @param bucketRadius Horizontal range (m) beyond which sector masks are used;
+     *        must exceed the cameras' horizontal distance from the origin to help
+     * @return false if count is too large (the projector is left empty)
+     */
+    bool setCameras(const CameraModel *cameras, size_t count, double bucketRadius = 5.0);
+
+    /** @brief Enable/disable angular pre-bucketing (default on); results are identical. */
+    void setBucketing(bool enabled) { bucketing_ = enabled; }
+
+    size_t cameraCount() const { return count_; }
+
+    /** @brief Bit i set when camera i can see azimuth sector `sector`. */
+    unsigned int sectorMask(size_t sector) const { return masks_[sector]; }
+
+    /**
+     * @brief Sector of a horizontal direction (x, y) in the cloud frame.
+     *        Uses a monotonic "diamond angle" instead of atan2.
+     */
+    static size_t sectorOf(double x, double y)
+    {
+        double d;
+        if (y >= 0.0) d = x >= 0.0 ? y / (x + y) : 1.0 - x / (y - x);
+        else d = x < 0.0 ? 2.0 - y / (-x - y) : 3.0 + x / (x - y);
+        size_t s = (size_t)(d * (double)(kMultiCameraSectors / 4));
+        return s < kMultiCameraSectors ? s : kMultiCameraSectors - 1;
+    }
+
+    /**
+     * @brief Project `n` points into every camera in one pass.
+     * @param points Cloud (in the frame the extrinsics map from)
+     * @param n Number of points
+     * @param outs cameraCount() hit lists; count/overflow are reset first
+     * @return Total hits written over all cameras
+     */
+    size_t project(const Point3 *points, size_t n, CameraHitList *outs) const;
+
+    /** @brief project() reading int16 points (decoded in L1-sized chunks; see compact.hpp). */
+    size_t project(const PointI16 *points, size_t n, const PointQuantization &q, CameraHitList *outs) const;
+
+    /** @brief project() reading half-float points. */
+    size_t project(const PointF16 *points, size_t n, const PointQuantization &q, CameraHitList *outs) const;
+
+private:
+    size_t projectRange(const Point3 *points, size_t n, size_t base, CameraHitList *outs) const;
+
+    struct PackedCamera {
+        double r[12];
+        double fx, s, cx, fy, cy;
+        double width, height, minDepth;
+    };
+
+    PackedCamera cams_[kMultiCameraMaxCameras];
+    unsigned int masks_[kMultiCameraSectors];
+    size_t count_;
+    double radius2_;
+    bool bucketing_;
+};
+
+} // namespace AdasTools
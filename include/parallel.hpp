@@ -0,0 +1,65 @@
+/* *******************************************************************************
+ * File: include/parallel.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Minimal fork-join task pool used by the parallel batch
+ *              routines (segmentation, clustering, ...). Worker threads are
+ *              created once and parked between runs; the calling thread takes
+ *              part in every run, so a pool with zero workers runs serially.
+ *              Task i is always the same piece of work regardless of which
+ *              thread executes it, keeping results deterministic.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+
+namespace AdasTools {
+
+/**
+ * @brief Fixed set of worker threads executing indexed tasks.
+ */
+class TaskPool {
+public:
+    /** @param workers Extra threads besides the caller (0 = run on the caller only) */
+    explicit TaskPool(size_t workers);
+    ~TaskPool();
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    /** @brief Threads available to a run (workers + the caller). */
+    size_t concurrency() const { return workers_ + 1; }
+
+    /**
+     * @brief Call fn(ctx, i) for every i in [0, tasks) and wait for all of them.
+     *        Runs from different threads are serialized. A run started from
+     *        inside one of this pool's tasks (e.g. a batch routine called
+     *        from a parallelFor body with the same pool) executes its tasks
+     *        inline on the calling thread instead of deadlocking; nesting on
+     *        a different pool runs normally.
+     */
+    void run(size_t tasks, void (*fn)(void *ctx, size_t task), void *ctx);
+
+    /** @brief run() with a callable taking the task index. */
+    template <typename F>
+    void parallelFor(size_t tasks, F &f)
+    {
+        run(tasks, &TaskPool::invoke<F>, &f);
+    }
+
+private:
+    template <typename F>
+    static void invoke(void *ctx, size_t task) { (*static_cast<F *>(ctx))(task); }
+
+    struct State;
+    State *state_;
+    size_t workers_;
+};
+
+/**
+ * @brief Process-wide pool with (hardware threads - 1) workers, created on
+ *        first use. Batch routines use it when passed a null pool.
+ */
+TaskPool *defaultTaskPool();
+
+} // namespace AdasTools
@@ -0,0 +1,167 @@
+/* *******************************************************************************
+ * File: include/poselog.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Streaming reader/writer for stamped pose logs. Two formats:
+ *              CSV text (`stamp,x,y,z,roll,pitch,yaw` per line, parsed from a
+ *              fixed buffer without allocation) and a compact binary format
+ *              (fixed 56-byte records plus an index footer for O(log n) time
+ *              seeks). Readers fill caller arrays or a Trajectory directly.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+class Trajectory;
+
+/** @brief On-disk format of a pose log. */
+enum PoseLogFormat {
+    POSE_LOG_CSV = 0,   /**< text, one `stamp,x,y,z,roll,pitch,yaw` line per pose */
+    POSE_LOG_BINARY = 1 /**< header + 7-double records + index footer (native little-endian) */
+};
+
+/** @brief One log record: time stamp (seconds) and pose. 56 bytes, no padding. */
+struct StampedPose {
+    double stamp; /**< seconds */
+    Pose pose;    /**< x,y,z (m), roll,pitch,yaw (rad) */
+};
+
+/** Records between binary index entries. */
+constexpr size_t kPoseLogIndexStride = 1024;
+
+/** Size of the reader/writer I/O buffer (also the longest accepted CSV line). */
+constexpr size_t kPoseLogBufferSize = 64 * 1024;
+
+/**
+ * @brief Parse one decimal number (as written by printf %g/%f/%e).
+ *
+ * Exact for the common case (<= 19 significant digits, small exponent) via
+ * an integer mantissa and one multiply/divide by an exact power of ten;
+ * other spellings (nan, inf, long mantissas) use std::from_chars.
+ * @param p In: start of the text; out: first character after the number
+ * @param end End of the text
+ * @param out Parsed value
+ * @return false if no number starts at p (leading blanks are skipped)
+ */
+bool parsePoseLogNumber(const char *&p, const char *end, double &out);
+
+/**
+ * @brief Buffered pose log writer. The binary index footer is written by close().
+ */
+class PoseLogWriter {
+public:
+    PoseLogWriter();
+    ~PoseLogWriter();
+    PoseLogWriter(const PoseLogWriter &) = delete;
+    PoseLogWriter &operator=(const PoseLogWriter &) = delete;
+
+    /** @brief Create/truncate `path`. @return false if the file cannot be opened */
+    bool open(const char *path, PoseLogFormat format);
+
+    /** @brief Append one record. @return false on I/O or allocation error */
+    bool write(const StampedPose &record);
+
+    /** @brief Append `n` records. */
+    bool write(const StampedPose *records, size_t n);
+
+    /** @brief Flush, write the index footer (binary) and close. @return false on I/O error */
+    bool close();
+
+    /** @brief Records written since open(). */
+    unsigned long long count() const { return count_; }
+
+private:
+    bool flushBuffer();
+    bool addIndexEntry(double stamp);
+
+    FILE *file_;
+    PoseLogFormat format_;
+    unsigned long long count_;
+    bool failed_;
+    size_t used_;
+    double *index_;          /**< (stamp, record) pairs, grown by doubling */
+    size_t indexCount_;
+    size_t indexCapacity_;
+    char buffer_[kPoseLogBufferSize];
+};
+
+/**
+ * @brief Streaming pose log reader (format detected from the file header).
+ */
+class PoseLogReader {
+public:
+    PoseLogReader();
+    ~PoseLogReader();
+    PoseLogReader(const PoseLogReader &) = delete;
+    PoseLogReader &operator=(const PoseLogReader &) = delete;
+
+    /**
+     * @brief Open a CSV or binary log. A binary log without a footer (writer
+     *        not closed) is still readable; seek() then scans linearly.
+     * @return false if the file cannot be opened or the binary header is invalid
+     */
+    bool open(const char *path);
+
+    void close();
+
+    PoseLogFormat format() const { return format_; }
+
+    /**
+     * @brief Read up to `maxCount` records in file order.
+     * @return Number of records stored in `out` (0 at end of file)
+     */
+    size_t read(StampedPose *out, size_t maxCount);
+
+    /**
+     * @brief Position the reader at the first record with stamp >= `stamp`
+     *        (binary: index lookup + short scan; CSV: scan from the start).
+     * @return false if no such record exists (the reader is then at EOF)
+     */
+    bool seek(double stamp);
+
+    /** @brief Binary: records in the file; CSV: 0 (unknown until read). */
+    unsigned long long recordCount() const { return recordCount_; }
+
+    /**
+     * @brief CSV lines that could not be parsed (header/comment lines
+     *        excluded) up to the current position. Lines longer than
+     *        kPoseLogBufferSize are rejected whole and counted here once.
+     */
+    unsigned long long malformedLines() const { return malformed_; }
+
+private:
+    size_t readRecords(StampedPose *out, size_t maxCount);
+    bool refill();
+    bool nextCsv(StampedPose &out);
+    bool nextRecord(StampedPose &out);
+    bool rewindData();
+
+    FILE *file_;
+    PoseLogFormat format_;
+    unsigned long long recordCount_;
+    unsigned long long recordsRead_; /**< binary: records consumed so far */
+    unsigned long long malformed_;
+    double *index_;
+    size_t indexCount_;
+    size_t pos_;
+    size_t end_;
+    bool eof_;
+    bool sawContent_;
+    bool skipLine_; /**< CSV: discarding the rest of an over-long line */
+    bool hasPending_;
+    StampedPose pending_;
+    char buffer_[kPoseLogBufferSize];
+};
+
+/**
+ * @brief Append every record of a log to a trajectory (in file order).
+ * @return Number of records appended, or -1 if the file cannot be read
+ */
+long long loadPoseLog(const char *path, Trajectory &out);
+
+} // namespace AdasTools
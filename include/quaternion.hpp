@@ -65,4 +65,24 @@ Quaternion normalizeQuaternion(const Quaternion &q);
  */
 Quaternion slerp(const Quaternion &a, const Quaternion &b, double t);
 
+/**
+ * @brief Exponential map: unit quaternion of the rotation by |v| radians
+ *        about v (series near zero, so tiny increments stay exact). Uses
+ *        TRIG_SINCOS whatever the process-wide tier, since integrators
+ *        accumulate its error once per step.
+ * @param v Rotation vector (axis * angle, radians)
+ */
+Quaternion quaternionExp(const Point3 &v);
+
+/**
+ * @brief Logarithm map (inverse of quaternionExp): rotation vector with
+ *        angle in [0, pi]; q and -q give the same result.
+ * @param q Unit quaternion
+ */
+Point3 quaternionLog(const Quaternion &q);
+
 } // namespace AdasTools
+
+#if defined(ADAS_TOOLS_HEADER_ONLY)
+#include "quaternion_inl.hpp"
+#endif
@@ -0,0 +1,179 @@
+/* *******************************************************************************
+ * File: include/quaternion_inl.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Definitions of the quaternion utilities (no STL). Included by
+ *              src/quaternion.cpp for the default library build, or by
+ *              quaternion.hpp when ADAS_TOOLS_HEADER_ONLY is defined.
+ * Author: VineetKP
+ * Created: 2025-10-31
+ * *******************************************************************************/
+
+#pragma once
+#include "quaternion.hpp"
+#include "instrumentation.hpp"
+#include "trace.hpp"
+#include "trig.hpp"
+#include <math.h>
+
+namespace AdasTools {
+
+ADAS_CORE_INLINE Quaternion quaternionFromRPY(double roll, double pitch, double yaw)
+{
+    // Convert half-angles
+    double hr = roll * 0.5;
+    double hp = pitch * 0.5;
+    double hy = yaw * 0.5;
+
+    double sr, cr;
+    sinCos(hr, sr, cr);
+    double sp, cp;
+    sinCos(hp, sp, cp);
+    double sy, cy;
+    sinCos(hy, sy, cy);
+
+    Quaternion q;
+    // Using the z-y-x intrinsic order (same as Rz*Ry*Rx)
+    q.w = cr*cp*cy + sr*sp*sy;
+    q.x = sr*cp*cy - cr*sp*sy;
+    q.y = cr*sp*cy + sr*cp*sy;
+    q.z = cr*cp*sy - sr*sp*cy;
+    return q;
+}
+
+ADAS_CORE_INLINE Quaternion multiplyQuaternion(const Quaternion &q1, const Quaternion &q2)
+{
+    Quaternion r;
+    r.w = q1.w*q2.w - q1.x*q2.x - q1.y*q2.y - q1.z*q2.z;
+    r.x = q1.w*q2.x + q1.x*q2.w + q1.y*q2.z - q1.z*q2.y;
+    r.y = q1.w*q2.y - q1.x*q2.z + q1.y*q2.w + q1.z*q2.x;
+    r.z = q1.w*q2.z + q1.x*q2.y - q1.y*q2.x + q1.z*q2.w;
+    return r;
+}
+
+ADAS_CORE_INLINE Quaternion normalizeQuaternion(const Quaternion &q)
+{
+    double norm = sqrt(q.w*q.w + q.x*q.x + q.y*q.y + q.z*q.z);
+    Quaternion out;
+    if (norm == 0.0) {
+        out.w = 1.0; out.x = 0.0; out.y = 0.0; out.z = 0.0;
+    } else {
+        out.w = q.w / norm;
+        out.x = q.x / norm;
+        out.y = q.y / norm;
+        out.z = q.z / norm;
+    }
+    return out;
+}
+
+ADAS_CORE_INLINE Point3 rotateByQuaternion(const Quaternion &q, const Point3 &p)
+{
+    // Convert quaternion to rotation matrix and apply to p
+    double ww = q.w*q.w;
+    double xx = q.x*q.x;
+    double yy = q.y*q.y;
+    double zz = q.z*q.z;
+
+    double wx = q.w*q.x;
+    double wy = q.w*q.y;
+    double wz = q.w*q.z;
+
+    double xy = q.x*q.y;
+    double xz = q.x*q.z;
+    double yz = q.y*q.z;
+
+    double r00 = ww + xx - yy - zz;
+    double r01 = 2.0*(xy - wz);
+    double r02 = 2.0*(xz + wy);
+
+    double r10 = 2.0*(xy + wz);
+    double r11 = ww - xx + yy - zz;
+    double r12 = 2.0*(yz - wx);
+
+    double r20 = 2.0*(xz - wy);
+    double r21 = 2.0*(yz + wx);
+    double r22 = ww - xx - yy + zz;
+
+    Point3 out;
+    out.x = r00 * p.x + r01 * p.y + r02 * p.z;
+    out.y = r10 * p.x + r11 * p.y + r12 * p.z;
+    out.z = r20 * p.x + r21 * p.y + r22 * p.z;
+    return out;
+}
+
+ADAS_CORE_INLINE Quaternion slerp(const Quaternion &a, const Quaternion &b, double t)
+{
+    ADAS_PROFILE_SCOPE(PROBE_SLERP, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_INTERPOLATE, "slerp");
+    // Compute the cosine of the angle between the two quaternions.
+    double cosom = a.w*b.w + a.x*b.x + a.y*b.y + a.z*b.z;
+
+    // If negative dot, negate one quaternion to take shorter path
+    Quaternion bcopy = b;
+    if (cosom < 0.0) {
+        cosom = -cosom;
+        bcopy.w = -bcopy.w;
+        bcopy.x = -bcopy.x;
+        bcopy.y = -bcopy.y;
+        bcopy.z = -bcopy.z;
+    }
+
+    double scale0, scale1;
+    if ((1.0 - cosom) > 1e-6) {
+        // Standard case (slerp)
+        double omega = acos(cosom);
+        double invSin = 1.0 / sin(omega);
+        scale0 = sin((1.0 - t) * omega) * invSin;
+        scale1 = sin(t * omega) * invSin;
+    } else {
+        // Quaternions are very close, use linear interpolation
+        scale0 = 1.0 - t;
+        scale1 = t;
+    }
+
+    Quaternion out;
+    out.w = scale0 * a.w + scale1 * bcopy.w;
+    out.x = scale0 * a.x + scale1 * bcopy.x;
+    out.y = scale0 * a.y + scale1 * bcopy.y;
+    out.z = scale0 * a.z + scale1 * bcopy.z;
+    return normalizeQuaternion(out);
+}
+
+ADAS_CORE_INLINE Quaternion quaternionExp(const Point3 &v)
+{
+    const double theta2 = v.x*v.x + v.y*v.y + v.z*v.z;
+    Quaternion q;
+    double k; // sin(theta/2) / theta
+    if (theta2 < 1e-8) {
+        // Taylor terms up to theta^4: error below 1e-25
+        q.w = 1.0 - theta2 / 8.0 + theta2 * theta2 / 384.0;
+        k = 0.5 - theta2 / 48.0 + theta2 * theta2 / 3840.0;
+    } else {
+        const double theta = sqrt(theta2);
+        double s, c;
+        sinCos(0.5 * theta, s, c, TRIG_SINCOS); // integrated every IMU sample: no fast tier
+        q.w = c;
+        k = s / theta;
+    }
+    q.x = k * v.x;
+    q.y = k * v.y;
+    q.z = k * v.z;
+    return q;
+}
+
+ADAS_CORE_INLINE Point3 quaternionLog(const Quaternion &q)
+{
+    // Shorter of the two equivalent rotations: w >= 0
+    const double sign = q.w < 0.0 ? -1.0 : 1.0;
+    const double w = sign * q.w;
+    const double n = sqrt(q.x*q.x + q.y*q.y + q.z*q.z);
+    double k; // theta / sin(theta/2), applied to the signed vector part
+    if (n < 1e-8) {
+        k = 2.0 / w; // first order, relative error < 1e-16
+    } else {
+        k = 2.0 * atan2(n, w) / n;
+    }
+    k *= sign;
+    return Point3{ k * q.x, k * q.y, k * q.z };
+}
+
+} // namespace AdasTools
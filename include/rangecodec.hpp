@@ -0,0 +1,87 @@
+/* *******************************************************************************
+ * File: include/rangecodec.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Compression of rotating-lidar sweeps stored as range images
+ *              (one row per laser, one column per azimuth step). Ranges are
+ *              quantized to a configurable precision (or kept bit-exact),
+ *              delta coded along each scan line and written with adaptive
+ *              Rice codes. Blocks of rows are independent, so encoding and
+ *              decoding run in parallel on a TaskPool.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+
+namespace AdasTools {
+
+class TaskPool;
+
+/** @brief One sweep in range-image layout (row-major, caller-owned buffers). */
+struct RangeImage {
+    unsigned rows;            /**< lasers / rings */
+    unsigned cols;            /**< azimuth steps per sweep */
+    float *range;             /**< rows * cols ranges (m); 0 = no return */
+    unsigned char *intensity; /**< rows * cols intensities, or nullptr */
+};
+
+/** @brief Tuning for encodeRangeImage(). */
+struct RangeCodecConfig {
+    double precision;      /**< quantization step (m); 0 = lossless (float bits kept exactly) */
+    unsigned rowsPerBlock; /**< rows per independently coded block (unit of parallelism) */
+    bool intensity;        /**< also code RangeImage::intensity */
+};
+
+/** @brief 1 mm steps, 4 rows per block, ranges only. */
+inline RangeCodecConfig defaultRangeCodecConfig()
+{
+    RangeCodecConfig c;
+    c.precision = 0.001;
+    c.rowsPerBlock = 4;
+    c.intensity = false;
+    return c;
+}
+
+/** @brief Image properties stored in an encoded sweep. */
+struct RangeImageInfo {
+    unsigned rows;
+    unsigned cols;
+    double precision; /**< 0 = lossless */
+    bool intensity;   /**< intensities present */
+};
+
+/** @brief Output capacity encodeRangeImage() needs (worst case, incompressible data). */
+size_t rangeImageEncodedBound(unsigned rows, unsigned cols, const RangeCodecConfig &config);
+
+/**
+ * @brief Compress one sweep into a self-contained byte buffer.
+ *
+ * In quantized mode, ranges that are not positive and finite (or below half
+ * a step) are stored as "no return" (decoded as 0); ranges beyond 2^31 steps
+ * are saturated. Decoded ranges are within precision / 2 of the input.
+ * @param image Sweep to encode (intensity read only if config.intensity)
+ * @param config Precision and block size (see defaultRangeCodecConfig())
+ * @param out Output buffer
+ * @param capacity Size of `out`; must be at least rangeImageEncodedBound()
+ * @param pool Task pool for the blocks (nullptr = defaultTaskPool())
+ * @return Bytes written, 0 if the image or config is invalid or `out` is too small
+ */
+size_t encodeRangeImage(const RangeImage &image, const RangeCodecConfig &config, unsigned char *out, size_t capacity,
+                        TaskPool *pool = nullptr);
+
+/** @brief Read the header of an encoded sweep. @return false if it is not a valid sweep */
+bool rangeImageInfo(const unsigned char *data, size_t bytes, RangeImageInfo &info);
+
+/**
+ * @brief Decompress a sweep.
+ * @param data Encoded sweep
+ * @param bytes Size of `data`
+ * @param image Output: rows/cols must match rangeImageInfo(); `range` is
+ *              required, `intensity` is filled if both it and the stream have one
+ * @param pool Task pool for the blocks (nullptr = defaultTaskPool())
+ * @return false if the data is corrupt or truncated, or the sizes do not match
+ */
+bool decodeRangeImage(const unsigned char *data, size_t bytes, const RangeImage &image, TaskPool *pool = nullptr);
+
+} // namespace AdasTools
@@ -0,0 +1,119 @@
+/* *******************************************************************************
+ * File: include/raycast.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Ray casting over a dense voxel occupancy grid for occlusion
+ *              and free-space queries. Rays are walked with a 3D DDA
+ *              (Amanatides & Woo): clipped to the grid box once, then one
+ *              compare and one add per voxel crossed, stopping at the first
+ *              occupied voxel. Batches of rays from one sensor origin run
+ *              in parallel blocks.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+class TaskPool;
+
+/** @brief Voxel state bits stored by VoxelGrid. */
+enum VoxelState {
+    VOXEL_OCCUPIED = 1, /**< a point was inserted */
+    VOXEL_FREE = 2      /**< a ray passed through (carveFreeSpace) */
+};
+
+/** @brief "No voxel" in castRays() output. */
+const unsigned int kNoVoxel = 0xFFFFFFFFu;
+
+/** @brief Axis-aligned grid: nx * ny * nz cubes of `resolution` from the min corner `origin`. */
+struct VoxelGridSpec {
+    Point3 origin;     /**< min corner (m) */
+    double resolution; /**< voxel edge (m) */
+    int nx, ny, nz;    /**< voxels per axis */
+};
+
+/** @brief Grid of nx * ny * nz voxels centred on (cx, cy) with its floor at z0. */
+VoxelGridSpec centeredVoxelGrid(double cx, double cy, double z0, double resolution, int nx, int ny, int nz);
+
+/** @brief Sensor origin for ray casting: the translation of a pose. */
+inline Point3 sensorOrigin(const Pose &pose) { return Point3{ pose.x, pose.y, pose.z }; }
+inline Point3 sensorOrigin(const Frame3D &frame) { return Point3{ frame.x, frame.y, frame.z }; }
+
+/**
+ * @brief Dense byte-per-voxel occupancy grid (index (iz * ny + iy) * nx + ix).
+ */
+class VoxelGrid {
+public:
+    VoxelGrid();
+    ~VoxelGrid();
+    VoxelGrid(const VoxelGrid &) = delete;
+    VoxelGrid &operator=(const VoxelGrid &) = delete;
+
+    /** @brief Allocate a cleared grid. @return false on invalid spec (or > 2^32-1 voxels) or allocation failure */
+    bool init(const VoxelGridSpec &spec);
+
+    /** @brief Reset every voxel to 0 (unknown). */
+    void clear();
+
+    /** @brief Mark the voxels of the points occupied. @return points inside the grid */
+    size_t insertPoints(const Point3 *points, size_t n);
+
+    /** @brief Linear index of the voxel holding p, or kNoVoxel outside the grid. */
+    unsigned int voxelIndex(const Point3 &p) const;
+
+    /** @brief Center of a voxel by linear index. */
+    Point3 voxelCenter(unsigned int index) const;
+
+    const VoxelGridSpec &spec() const { return spec_; }
+    size_t voxelCount() const { return (size_t)spec_.nx * spec_.ny * spec_.nz; }
+    const unsigned char *data() const { return cells_; }
+    unsigned char *data() { return cells_; }
+    bool occupied(unsigned int index) const { return (cells_[index] & VOXEL_OCCUPIED) != 0; }
+
+private:
+    VoxelGridSpec spec_;
+    double invResolution_;
+    unsigned char *cells_; /**< VoxelState bits per voxel */
+};
+
+/**
+ * @brief First occupied voxel along each ray.
+ *
+ * The voxel holding the origin is never reported (the sensor's own mount).
+ * @param grid Occupancy grid
+ * @param origin Sensor position (world frame of the grid)
+ * @param directions Ray directions (any non-zero length)
+ * @param n Number of rays
+ * @param maxRange Rays stop after this distance (m)
+ * @param hitRange Output per ray: distance (m) to where the ray enters the hit voxel, or maxRange if none
+ * @param hitVoxel Optional output per ray: linear index of the hit voxel, or kNoVoxel
+ * @param pool Task pool for blocks of rays (nullptr = defaultTaskPool())
+ * @return Rays that hit an occupied voxel
+ */
+size_t castRays(const VoxelGrid &grid, const Point3 &origin, const Point3 *directions, size_t n, double maxRange,
+                double *hitRange, unsigned int *hitVoxel = nullptr, TaskPool *pool = nullptr);
+
+/**
+ * @brief Line-of-sight test from the origin to each point.
+ *
+ * A point is visible when no occupied voxel lies between the origin's voxel
+ * and its own voxel (both excluded), so a point never occludes itself.
+ * @param visible Output per point: 1 visible, 0 occluded
+ * @return Visible points
+ */
+size_t checkVisibility(const VoxelGrid &grid, const Point3 &origin, const Point3 *points, size_t n,
+                       unsigned char *visible, TaskPool *pool = nullptr);
+
+/**
+ * @brief Set VOXEL_FREE on every voxel each ray from the origin to a point
+ *        passes through, excluding the point's own voxel. Occupancy bits
+ *        are left alone, so the result does not depend on ray order.
+ * @return Voxel visits (free-space evidence count)
+ */
+size_t carveFreeSpace(VoxelGrid &grid, const Point3 &origin, const Point3 *points, size_t n,
+                      TaskPool *pool = nullptr);
+
+} // namespace AdasTools
@@ -0,0 +1,86 @@
+/* *******************************************************************************
+ * File: include/reprojection.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Batch reprojection-error evaluation for camera-lidar
+ *              calibration. 3D points are projected with the same model as
+ *              projectPointCamera() and compared against detected image
+ *              points; per-point residuals, analytic Jacobians with respect to
+ *              the 6-DOF extrinsic pose and the intrinsics, and summary
+ *              statistics are produced in parallel over fixed blocks.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+class FrameArena;
+class TaskPool;
+
+/** @brief A 3D point (sensor frame) and the image point it was detected at. */
+struct ImageCorrespondence {
+    Point3 point; /**< point in the frame the extrinsic maps from */
+    double u;     /**< detected pixel column */
+    double v;     /**< detected pixel row */
+};
+
+/**
+ * @brief Caller-owned per-point outputs; any pointer may be nullptr.
+ *
+ * Residuals are predicted - observed. Jacobian rows are d(u)/d(params) then
+ * d(v)/d(params). Pose parameters are (x, y, z, roll, pitch, yaw) of the
+ * extrinsic, i.e. the matrix is poseToMatrix(extrinsic) with R = Rz*Ry*Rx;
+ * intrinsic parameters are (fx, fy, cx, cy, s) of K = [fx s cx; 0 fy cy; 0 0 1].
+ * Points at or behind minDepth get zero residuals and Jacobians.
+ */
+struct ReprojectionOutputs {
+    double *residuals;         /**< 2 per point: du, dv (pixels) */
+    double *poseJacobian;      /**< 2 x 6 per point, row-major */
+    double *intrinsicJacobian; /**< 2 x 5 per point, row-major */
+    unsigned char *valid;      /**< 1 if the point projected (depth > minDepth), else 0 */
+};
+
+/** @brief Summary over the valid points of one evaluation. */
+struct ReprojectionStats {
+    size_t valid;     /**< points in front of the camera */
+    double rms;       /**< sqrt(mean(du^2 + dv^2)) in pixels */
+    double mean;      /**< mean pixel distance */
+    double max;       /**< largest pixel distance */
+    size_t maxIndex;  /**< correspondence with the largest distance (n if none) */
+};
+
+/** @brief Scratch bytes evaluateReprojection() needs for n correspondences. */
+size_t reprojectionScratchBytes(size_t n);
+
+/**
+ * @brief Evaluate a candidate extrinsic/intrinsic pair on n correspondences.
+ *
+ * Blocks of correspondences are reduced in block order, so the statistics do
+ * not depend on the thread count.
+ * @param correspondences 3D-2D pairs
+ * @param n Number of pairs
+ * @param extrinsic Sensor-to-camera pose (camera z forward)
+ * @param intrinsic 3x3 K (row-major, length 9)
+ * @param outputs Per-point outputs (fields may be nullptr)
+ * @param stats Summary statistics
+ * @param minDepth Points with camera depth <= minDepth are invalid
+ * @param scratch Arena for per-block partial sums (nullptr = threadScratchArena(), heap if none)
+ * @param pool Task pool (nullptr = defaultTaskPool())
+ * @return false if scratch could not be allocated (outputs untouched)
+ */
+bool evaluateReprojection(const ImageCorrespondence *correspondences, size_t n, const Pose &extrinsic,
+                          const double intrinsic[9], const ReprojectionOutputs &outputs, ReprojectionStats &stats,
+                          double minDepth = 1e-6, FrameArena *scratch = nullptr, TaskPool *pool = nullptr);
+
+/**
+ * @brief Overload taking the extrinsic as a rigid 4x4 matrix; the pose
+ *        Jacobian is with respect to matrixToPose(extrinsic).
+ */
+bool evaluateReprojection(const ImageCorrespondence *correspondences, size_t n, const double extrinsic[16],
+                          const double intrinsic[9], const ReprojectionOutputs &outputs, ReprojectionStats &stats,
+                          double minDepth = 1e-6, FrameArena *scratch = nullptr, TaskPool *pool = nullptr);
+
+} // namespace AdasTools
@@ -0,0 +1,146 @@
+/* *******************************************************************************
+ * File: include/rigid.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Small rigid/affine 4x4 matrix module. Matrices use the same
+ *              row-major 16-double layout as pose6ToMatrix() and the camera
+ *              extrinsics; the bottom row is assumed to be [0 0 0 1] and is
+ *              never multiplied, so a compose is a 3x4 affine product. Single
+ *              operations are inline; batch compose and point transforms live
+ *              in src/rigid.cpp with an AVX2/FMA path selected at run time.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <math.h>
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+/**
+ * @brief out = a * b for rigid/affine transforms (row-major 4x4).
+ *
+ * Only the top 3x4 block is computed; out's bottom row is set to [0 0 0 1].
+ * `out` may alias `a` or `b`.
+ */
+inline void rigidCompose(const double a[16], const double b[16], double out[16])
+{
+    double m[12];
+    for (int r = 0; r < 3; ++r) {
+        const double a0 = a[r*4 + 0], a1 = a[r*4 + 1], a2 = a[r*4 + 2], a3 = a[r*4 + 3];
+        m[r*4 + 0] = a0 * b[0] + a1 * b[4] + a2 * b[8];
+        m[r*4 + 1] = a0 * b[1] + a1 * b[5] + a2 * b[9];
+        m[r*4 + 2] = a0 * b[2] + a1 * b[6] + a2 * b[10];
+        m[r*4 + 3] = a0 * b[3] + a1 * b[7] + a2 * b[11] + a3;
+    }
+    for (int i = 0; i < 12; ++i) out[i] = m[i];
+    out[12] = 0.0; out[13] = 0.0; out[14] = 0.0; out[15] = 1.0;
+}
+
+/**
+ * @brief Inverse of a rigid transform: [R t; 0 1]^-1 = [R^T, -R^T t; 0 1].
+ *        `out` may alias `m`.
+ */
+inline void rigidInverse(const double m[16], double out[16])
+{
+    const double r00 = m[0], r01 = m[1], r02 = m[2], tx = m[3];
+    const double r10 = m[4], r11 = m[5], r12 = m[6], ty = m[7];
+    const double r20 = m[8], r21 = m[9], r22 = m[10], tz = m[11];
+    out[0] = r00; out[1] = r10; out[2]  = r20; out[3]  = -(r00*tx + r10*ty + r20*tz);
+    out[4] = r01; out[5] = r11; out[6]  = r21; out[7]  = -(r01*tx + r11*ty + r21*tz);
+    out[8] = r02; out[9] = r12; out[10] = r22; out[11] = -(r02*tx + r12*ty + r22*tz);
+    out[12] = 0.0; out[13] = 0.0; out[14] = 0.0; out[15] = 1.0;
+}
+
+/** @brief Full 4x4 transpose (row-major in, row-major out). `out` may alias `m`. */
+inline void matrixTranspose4(const double m[16], double out[16])
+{
+    double t[16];
+    for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) t[c*4 + r] = m[r*4 + c];
+    for (int i = 0; i < 16; ++i) out[i] = t[i];
+}
+
+/** @brief Apply a rigid/affine transform to one point. */
+inline Point3 rigidTransformPoint(const double m[16], const Point3 &p)
+{
+    Point3 out;
+    out.x = m[0]*p.x + m[1]*p.y + m[2]*p.z + m[3];
+    out.y = m[4]*p.x + m[5]*p.y + m[6]*p.z + m[7];
+    out.z = m[8]*p.x + m[9]*p.y + m[10]*p.z + m[11];
+    return out;
+}
+
+/**
+ * @brief Recover x,y,z,roll,pitch,yaw from a rigid matrix assuming
+ *        R = Rz(yaw) * Ry(pitch) * Rx(roll). At gimbal lock (|cos(pitch)| ~ 0)
+ *        yaw is set to 0 and the remaining angle is reported as roll.
+ */
+inline Pose matrixToPose(const double m[16])
+{
+    Pose out;
+    out.x = m[3]; out.y = m[7]; out.z = m[11];
+    double pitch = -asin(m[8]);
+    double cp = cos(pitch);
+    double roll = 0.0;
+    double yaw = 0.0;
+    if (fabs(cp) > 1e-8) {
+        roll = atan2(m[9] / cp, m[10] / cp);
+        yaw  = atan2(m[4] / cp, m[0] / cp);
+    } else {
+        roll = atan2(-m[1], m[5]);
+    }
+    out.roll = roll; out.pitch = pitch; out.yaw = yaw;
+    return out;
+}
+
+/**
+ * @brief outs[i] = a * bs[i] for i in [0, n): one vehicle pose against many
+ *        sensor extrinsics. Matrices are consecutive 16-double blocks.
+ * @param a Left transform
+ * @param bs n right transforms
+ * @param outs n results (must not overlap `bs`)
+ * @param n Number of matrices
+ */
+void rigidComposeBatch(const double a[16], const double *bs, double *outs, size_t n);
+
+/**
+ * @brief outs[i] = as[i] * b for i in [0, n): many historical vehicle poses
+ *        against one extrinsic.
+ * @param as n left transforms
+ * @param b Right transform
+ * @param outs n results (must not overlap `as`)
+ * @param n Number of matrices
+ */
+void rigidComposeBatchRight(const double *as, const double b[16], double *outs, size_t n);
+
+/**
+ * @brief outs[i] = as[i] * bs[i] for i in [0, n) (pairwise compose).
+ */
+void rigidComposePairs(const double *as, const double *bs, double *outs, size_t n);
+
+/**
+ * @brief Inverse of n rigid transforms.
+ */
+void rigidInverseBatch(const double *ms, double *outs, size_t n);
+
+/**
+ * @brief poseToMatrix() for n poses (identical results). The angles go
+ *        through sinCosBatch() in blocks with the process-wide trig tier, so
+ *        the polynomial tiers vectorize across poses.
+ * @param poses Input poses
+ * @param outs n row-major 4x4 matrices (consecutive 16-double blocks)
+ * @param n Number of poses
+ */
+void posesToMatrices(const Pose *poses, double *outs, size_t n);
+
+/**
+ * @brief Transform n points by one rigid/affine matrix.
+ * @param m Transform (row-major 4x4)
+ * @param in Input points
+ * @param out Output points (may equal `in`)
+ * @param n Number of points
+ */
+void rigidTransformPoints(const double m[16], const Point3 *in, Point3 *out, size_t n);
+
+} // namespace AdasTools
@@ -0,0 +1,250 @@
+/* *******************************************************************************
+ * File: include/ringbuffer.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Bounded lock-free queues for handing sensor frames between
+ *              threads. Provides a single-producer/single-consumer ring, a
+ *              multi-producer ring and a latest-value-wins mailbox (for poses).
+ *              All storage is fixed at compile time: no heap, no STL
+ *              containers, only <atomic> for the synchronisation itself.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+/** Assumed destructive-interference size; keeps producer/consumer indices apart. */
+constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @brief A reusable, preallocated point buffer handed between threads.
+ *
+ * The owner allocates `points` once (e.g. a static array per slot) and the
+ * slot is recycled for every frame. Queues carry `PointFrame*` (or a slot
+ * index), never the points themselves, so a push/pop is a single word copy.
+ */
+struct PointFrame {
+    Point3 *points;      /**< caller-owned storage of length `capacity` */
+    size_t capacity;     /**< number of Point3 the storage can hold */
+    size_t count;        /**< number of valid points in this frame */
+    double stamp;        /**< acquisition time in seconds */
+    unsigned long long sequence; /**< producer frame counter */
+};
+
+/**
+ * @brief Wait-free single-producer/single-consumer bounded ring.
+ *
+ * Exactly one thread may call tryPush() and exactly one (other) thread may
+ * call tryPop(). `T` should be trivially copyable (pointers, indices, PODs).
+ * Capacity must be a power of two; one slot is not sacrificed because the
+ * head/tail counters run freely and are masked on access.
+ *
+ * @tparam T Element type
+ * @tparam Capacity Number of slots (power of two)
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+public:
+    SpscRing() : head_(0), cachedTail_(0), tail_(0), cachedHead_(0) {}
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * @brief Enqueue a value (producer thread only).
+     * @return false if the ring is full
+     */
+    bool tryPush(const T &value)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == Capacity) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == Capacity) return false;
+        }
+        slots_[tail & (Capacity - 1)] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeue a value (consumer thread only).
+     * @return false if the ring is empty
+     */
+    bool tryPop(T &out)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) return false;
+        }
+        out = slots_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Approximate number of queued elements (exact when quiescent). */
+    size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    // Consumer-owned line: head plus the consumer's cached copy of tail.
+    alignas(kCacheLineSize) std::atomic<size_t> head_;
+    size_t cachedTail_;
+    // Producer-owned line: tail plus the producer's cached copy of head.
+    alignas(kCacheLineSize) std::atomic<size_t> tail_;
+    size_t cachedHead_;
+    alignas(kCacheLineSize) T slots_[Capacity];
+};
+
+/**
+ * @brief Lock-free bounded multi-producer ring (Vyukov sequence scheme).
+ *
+ * Any number of threads may call tryPush() concurrently. Each slot carries a
+ * sequence number so the consumer side is also safe for several threads,
+ * which makes this ring usable as a shared free-list of frame slots.
+ *
+ * @tparam T Element type (trivially copyable)
+ * @tparam Capacity Number of slots (power of two)
+ */
+template <typename T, size_t Capacity>
+class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscRing capacity must be a power of two");
+public:
+    MpscRing() : enqueuePos_(0), dequeuePos_(0)
+    {
+        for (size_t i = 0; i < Capacity; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /**
+     * @brief Enqueue a value (any producer thread).
+     * @return false if the ring is full
+     */
+    bool tryPush(const T &value)
+    {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[pos & (Capacity - 1)];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const long diff = (long)seq - (long)pos;
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Dequeue a value.
+     * @return false if the ring is empty
+     */
+    bool tryPop(T &out)
+    {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[pos & (Capacity - 1)];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const long diff = (long)seq - (long)(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = cell.value;
+                    cell.sequence.store(pos + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+    alignas(kCacheLineSize) std::atomic<size_t> enqueuePos_;
+    alignas(kCacheLineSize) std::atomic<size_t> dequeuePos_;
+    alignas(kCacheLineSize) Cell cells_[Capacity];
+};
+
+/**
+ * @brief Latest-value-wins mailbox (wait-free triple buffer).
+ *
+ * One writer publishes values (e.g. the newest vehicle Pose); one reader
+ * fetches the most recent one. Older unread values are overwritten, neither
+ * side ever blocks and no value is torn, because writer and reader always
+ * touch different buffers and only exchange buffer indices atomically.
+ *
+ * @tparam T Value type (trivially copyable)
+ */
+template <typename T>
+class Mailbox {
+public:
+    Mailbox() : middle_(1), writeIdx_(0), readIdx_(2), published_(0) {}
+    Mailbox(const Mailbox &) = delete;
+    Mailbox &operator=(const Mailbox &) = delete;
+
+    /** @brief Publish a new value (writer thread only). */
+    void publish(const T &value)
+    {
+        buffers_[writeIdx_] = value;
+        // Hand the written buffer to the middle slot and flag it as fresh.
+        const unsigned prev = middle_.exchange(writeIdx_ | kFreshBit, std::memory_order_acq_rel);
+        writeIdx_ = prev & kIndexMask;
+        published_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Fetch the latest value (reader thread only).
+     * @param out Receives the newest value if one was published since the
+     *            last successful read; otherwise the previous value is kept.
+     * @return true if `out` holds a value newer than the previous call
+     */
+    bool read(T &out)
+    {
+        if ((middle_.load(std::memory_order_relaxed) & kFreshBit) == 0) {
+            return false;
+        }
+        const unsigned prev = middle_.exchange(readIdx_, std::memory_order_acq_rel);
+        readIdx_ = prev & kIndexMask;
+        out = buffers_[readIdx_];
+        return true;
+    }
+
+    /** @brief Total number of publish() calls so far. */
+    unsigned long long publishedCount() const { return published_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr unsigned kFreshBit = 4u;
+    static constexpr unsigned kIndexMask = 3u;
+
+    T buffers_[3];
+    alignas(kCacheLineSize) std::atomic<unsigned> middle_;
+    alignas(kCacheLineSize) unsigned writeIdx_;
+    alignas(kCacheLineSize) unsigned readIdx_;
+    std::atomic<unsigned long long> published_;
+};
+
+} // namespace AdasTools
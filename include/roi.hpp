@@ -0,0 +1,115 @@
+/* *******************************************************************************
+ * File: include/roi.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Region-of-interest point filters: axis-aligned boxes, oriented
+ *              boxes and vertical cylinders, each used to keep or remove the
+ *              points inside it (e.g. drop ego-vehicle self-returns, keep
+ *              points within range). Filters run in the sensor frame before
+ *              any transform, or fused with one so only surviving points are
+ *              transformed. Output is compacted without data-dependent branches.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "boxes.hpp"
+#include "helpers.hpp"
+
+namespace AdasTools {
+
+/** Regions per PointFilter. */
+constexpr size_t kRoiMaxRegions = 8;
+
+/** @brief What a region does with the points inside it. */
+enum RoiMode {
+    ROI_KEEP_INSIDE = 0,  /**< drop points outside the region */
+    ROI_REMOVE_INSIDE = 1 /**< drop points inside the region */
+};
+
+/** @brief Axis-aligned box [min, max] in the point frame. */
+struct AxisAlignedBox {
+    Point3 min;
+    Point3 max;
+};
+
+/** @brief Cylinder with a vertical (z) axis through (cx, cy), spanning [zMin, zMax]. */
+struct RoiCylinder {
+    double cx;
+    double cy;
+    double radius;
+    double zMin;
+    double zMax;
+};
+
+/**
+ * @brief A conjunction of up to kRoiMaxRegions regions: a point survives if
+ *        every region lets it through. Regions are expressed in the frame of
+ *        the points passed to the filter calls (normally the sensor frame;
+ *        move vehicle-frame boxes there with boxesTransform()).
+ */
+class PointFilter {
+public:
+    PointFilter() : count_(0) {}
+
+    /** @brief Add an axis-aligned box. @return false if the filter is full */
+    bool addBox(const AxisAlignedBox &box, RoiMode mode);
+
+    /** @brief Add an oriented box. @return false if the filter is full */
+    bool addOrientedBox(const OrientedBox &box, RoiMode mode);
+
+    /** @brief Add a vertical cylinder. @return false if the filter is full */
+    bool addCylinder(const RoiCylinder &cylinder, RoiMode mode);
+
+    void clear() { count_ = 0; }
+    size_t regionCount() const { return count_; }
+
+    /** @brief true if `p` survives every region. */
+    bool passes(const Point3 &p) const;
+
+    /**
+     * @brief Compact surviving points, preserving order.
+     * @param in Input points
+     * @param n Number of input points
+     * @param out Output array with room for n points (may equal `in`)
+     * @return Number of surviving points
+     */
+    size_t filterPoints(const Point3 *in, size_t n, Point3 *out) const;
+
+    /**
+     * @brief Write the indices of surviving points (ascending).
+     * @param indices Output array with room for n entries
+     * @return Number of surviving points
+     */
+    size_t filterIndices(const Point3 *in, size_t n, unsigned int *indices) const;
+
+    /**
+     * @brief Filter in the input frame and write the survivors transformed by
+     *        `transform` (e.g. sensor -> vehicle/world); rejected points are
+     *        never transformed.
+     * @param transform Row-major 4x4 rigid/affine transform
+     * @param out Output array with room for n points (may equal `in`)
+     * @return Number of surviving points
+     */
+    size_t filterTransform(const Point3 *in, size_t n, const double transform[16], Point3 *out) const;
+
+private:
+    enum Shape { SHAPE_BOX = 0, SHAPE_CYLINDER = 1 };
+
+    /** Point -> region frame (3x4), half extents and the keep/remove flip. */
+    struct Region {
+        double m[12];
+        double hx, hy, hz;
+        double r2;
+        int shape;
+        unsigned char removeInside;
+    };
+
+    bool add(const Region &r);
+    void keepMask(const Point3 *in, size_t n, unsigned char *keep) const;
+
+    Region regions_[kRoiMaxRegions];
+    size_t count_;
+};
+
+} // namespace AdasTools
@@ -0,0 +1,111 @@
+/* *******************************************************************************
+ * File: include/trace.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Scoped trace events for pipeline stages (transform, project,
+ *              rasterize, interpolate) recorded into fixed-size per-thread
+ *              buffers without locks, and exported as Chrome trace JSON
+ *              (loadable in chrome://tracing and Perfetto). Compiled in with
+ *              ADAS_TOOLS_ENABLE_INSTRUMENTATION and switched on at run time
+ *              with traceSetEnabled().
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+
+namespace AdasTools {
+
+/**
+ * @brief Pipeline stage of a trace event; exported as the event category.
+ */
+enum TraceStage {
+    TRACE_STAGE_TRANSFORM = 0, /**< frame changes: localToGlobal, rigidTransformPoints, geodesy, ... */
+    TRACE_STAGE_PROJECT,       /**< projection into cameras/grids: projectPointCamera, castRays, ... */
+    TRACE_STAGE_RASTERIZE,     /**< writing image pixels: BevRemap::warp */
+    TRACE_STAGE_INTERPOLATE,   /**< pose interpolation: slerp, Trajectory::interpolate */
+    TRACE_STAGE_USER,          /**< everything else (segmentation, clustering, codecs, ICP) */
+    TRACE_STAGE_COUNT
+};
+
+/** Events each thread can hold before further events are dropped (and counted). */
+constexpr size_t kTraceEventsPerThread = 16384;
+
+/** @brief Start/stop recording (process wide, default off). */
+void traceSetEnabled(bool enabled);
+
+/** @brief true while recording is on. */
+bool traceEnabled();
+
+/** @brief true while tracing or stage latency metrics are recording. */
+bool stageTimingEnabled();
+
+/** @brief Monotonic timestamp in nanoseconds (steady clock) used by events. */
+unsigned long long traceNowNs();
+
+/**
+ * @brief Record a complete event into the calling thread's buffer (while
+ *        traceEnabled()) and its duration into the stage latency histogram
+ *        (while latencyEnabled(), see histogram.hpp).
+ * @param stage Pipeline stage (category)
+ * @param name Event name; must be a string with static storage duration
+ * @param beginNs Start time from traceNowNs()
+ * @param endNs End time from traceNowNs()
+ */
+void traceRecord(TraceStage stage, const char *name, unsigned long long beginNs, unsigned long long endNs);
+
+/**
+ * @brief Label the calling thread in the exported timeline (e.g. "lidar_driver").
+ * @param name Thread name, truncated to 31 characters
+ */
+void traceSetThreadName(const char *name);
+
+/**
+ * @brief Write all recorded events as Chrome trace JSON ("X" complete events,
+ *        microsecond timestamps, one tid per recording thread).
+ * @param path Output file path
+ * @return true if the file was written completely
+ */
+bool traceWriteChromeJson(const char *path);
+
+/** @brief Discard recorded events (call while no thread is recording). */
+void traceClear();
+
+/** @brief Number of events currently held across all threads. */
+size_t traceEventCount();
+
+/** @brief Number of events dropped because a thread buffer was full. */
+size_t traceDroppedCount();
+
+/** @brief Category string of a stage, e.g. "transform". */
+const char *traceStageName(TraceStage stage);
+
+/**
+ * @brief RAII helper emitting one complete event spanning its lifetime.
+ *        Costs two relaxed loads when tracing and latency metrics are off.
+ */
+class TraceScope {
+public:
+    TraceScope(TraceStage stage, const char *name)
+        : stage_(stage), name_(name), begin_(stageTimingEnabled() ? traceNowNs() : 0) {}
+    ~TraceScope() { if (begin_ != 0) traceRecord(stage_, name_, begin_, traceNowNs()); }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    TraceStage stage_;
+    const char *name_;
+    unsigned long long begin_;
+};
+
+} // namespace AdasTools
+
+#if defined(ADAS_TOOLS_ENABLE_INSTRUMENTATION)
+#define ADAS_TRACE_CONCAT_INNER(a, b) a##b
+#define ADAS_TRACE_CONCAT(a, b) ADAS_TRACE_CONCAT_INNER(a, b)
+/** Emit a trace event named `name` (string literal) for the enclosing scope. */
+#define ADAS_TRACE_SCOPE(stage, name) \
+    ::AdasTools::TraceScope ADAS_TRACE_CONCAT(adasTraceScope_, __LINE__)((stage), (name))
+#else
+#define ADAS_TRACE_SCOPE(stage, name) ((void)0)
+#endif
@@ -0,0 +1,171 @@
+/* *******************************************************************************
+ * File: include/trajectory.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Stamped vehicle trajectory stored as structure-of-arrays
+ *              (time, unit quaternion, translation) with the absolute
+ *              transform of every sample cached, so the relative pose between
+ *              any two samples is O(1) and batch odometry deltas run as one
+ *              vectorizable loop. Also provides the small RigidTransform
+ *              (quaternion + translation) value type used by trajectory code.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <stddef.h>
+#include "helpers.hpp"
+#include "quaternion.hpp"
+
+namespace AdasTools {
+
+/**
+ * @brief Rigid transform as unit quaternion + translation: p' = R(q) p + t.
+ */
+struct RigidTransform {
+    Quaternion q; /**< rotation (unit) */
+    Point3 t;     /**< translation in meters */
+};
+
+/** @brief Identity transform. */
+inline RigidTransform identityTransform()
+{
+    RigidTransform r;
+    r.q = Quaternion{ 1.0, 0.0, 0.0, 0.0 };
+    r.t = Point3{ 0.0, 0.0, 0.0 };
+    return r;
+}
+
+/** @brief a * b (apply b first, then a). */
+inline RigidTransform composeTransform(const RigidTransform &a, const RigidTransform &b)
+{
+    RigidTransform r;
+    r.q = multiplyQuaternion(a.q, b.q);
+    Point3 bt = rotateByQuaternion(a.q, b.t);
+    r.t = Point3{ bt.x + a.t.x, bt.y + a.t.y, bt.z + a.t.z };
+    return r;
+}
+
+/** @brief Inverse of a rigid transform: (R^T, -R^T t). */
+inline RigidTransform inverseTransform(const RigidTransform &a)
+{
+    RigidTransform r;
+    r.q = Quaternion{ a.q.w, -a.q.x, -a.q.y, -a.q.z };
+    Point3 t = rotateByQuaternion(r.q, a.t);
+    r.t = Point3{ -t.x, -t.y, -t.z };
+    return r;
+}
+
+/** @brief Convert a Pose (R = Rz*Ry*Rx) to a RigidTransform. */
+RigidTransform poseToTransform(const Pose &pose);
+
+/**
+ * @brief poseToTransform() for n poses (identical results); the half angles
+ *        go through sinCosBatch() in blocks like posesToMatrices().
+ */
+void posesToTransforms(const Pose *poses, RigidTransform *out, size_t n);
+
+/** @brief Convert a RigidTransform back to x,y,z,roll,pitch,yaw. */
+Pose transformToPose(const RigidTransform &tf);
+
+/** @brief Row-major 4x4 matrix of a RigidTransform (same layout as poseToMatrix). */
+void transformToMatrix(const RigidTransform &tf, double outMat16[16]);
+
+/**
+ * @brief Stamped trajectory in SoA form with cached absolute transforms.
+ *
+ * Samples are appended in time order, either as absolute poses or as
+ * deltas that are composed onto the previous sample (prefix composition), so
+ * every stored sample is an absolute transform. Storage is one heap block
+ * that grows by doubling; call reserve() up front to avoid regrowth.
+ * Quaternion signs are kept continuous (q and -q are the same rotation).
+ */
+class Trajectory {
+public:
+    Trajectory();
+    ~Trajectory();
+    Trajectory(const Trajectory &) = delete;
+    Trajectory &operator=(const Trajectory &) = delete;
+
+    /** @brief Make room for `capacity` samples. @return false on allocation failure or size overflow */
+    bool reserve(size_t capacity);
+
+    /** @brief Drop all samples (keeps storage). */
+    void clear() { size_ = 0; }
+
+    /** @brief Append an absolute pose. @return false on allocation failure */
+    bool append(double stamp, const Pose &pose);
+
+    /** @brief Append an absolute transform. @return false on allocation failure */
+    bool append(double stamp, const RigidTransform &absolute);
+
+    /**
+     * @brief Append last() * delta (odometry increment). The first sample is
+     *        taken as the delta from the identity.
+     */
+    bool appendDelta(double stamp, const RigidTransform &delta);
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    double stamp(size_t i) const { return stamp_[i]; }
+
+    /** @brief Absolute transform of sample i. */
+    RigidTransform transform(size_t i) const
+    {
+        RigidTransform r;
+        r.q = Quaternion{ qw_[i], qx_[i], qy_[i], qz_[i] };
+        r.t = Point3{ tx_[i], ty_[i], tz_[i] };
+        return r;
+    }
+
+    /** @brief Absolute pose of sample i (Euler angles extracted on demand). */
+    Pose pose(size_t i) const { return transformToPose(transform(i)); }
+
+    /**
+     * @brief Pose of sample j expressed in the frame of sample i: T_i^-1 * T_j.
+     *        Matches globalToLocalFromMatrix(pose(i), pose(j)), in O(1).
+     */
+    RigidTransform relative(size_t i, size_t j) const;
+
+    /**
+     * @brief out[k] = relative(from[k], to[k]) for k in [0, n).
+     */
+    void relativeBatch(const size_t *from, const size_t *to, RigidTransform *out, size_t n) const;
+
+    /**
+     * @brief Odometry deltas: out[k] = relative(first + k*stride, first + (k+1)*stride)
+     *        for k in [0, count). Indices must stay below size().
+     */
+    void deltas(size_t first, size_t count, size_t stride, RigidTransform *out) const;
+
+    /**
+     * @brief Index of the last sample with stamp <= `t` (binary search).
+     * @return size() if `t` precedes the first sample or the trajectory is empty
+     */
+    size_t indexAtOrBefore(double t) const;
+
+    /**
+     * @brief Transform at time `t`: slerp/lerp between the bracketing samples.
+     * @return false if `t` lies outside [stamp(0), stamp(size()-1)]
+     */
+    bool interpolate(double t, RigidTransform &out) const;
+
+    /** @brief SoA columns (size() entries each) for vectorized consumers. */
+    const double *stamps() const { return stamp_; }
+    const double *qw() const { return qw_; }
+    const double *qx() const { return qx_; }
+    const double *qy() const { return qy_; }
+    const double *qz() const { return qz_; }
+    const double *tx() const { return tx_; }
+    const double *ty() const { return ty_; }
+    const double *tz() const { return tz_; }
+
+private:
+    bool grow();
+
+    double *block_;
+    double *stamp_, *qw_, *qx_, *qy_, *qz_, *tx_, *ty_, *tz_;
+    size_t size_;
+    size_t capacity_;
+};
+
+} // namespace AdasTools
@@ -125,3 +125,7 @@ Pose projectPointCamera(const Pose &pointLocal, const double extrinsic[16], cons
 Point3 projectPointCamera(const Point3 &pointLocal, const double extrinsic[16], const double intrinsic[9]);
 
 } // namespace AdasTools
+
+#if defined(ADAS_TOOLS_HEADER_ONLY)
+#include "transformers_inl.hpp"
+#endif
@@ -0,0 +1,347 @@
+/* *******************************************************************************
+ * File: include/transformers_inl.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Definitions of the coordinate transformers. Included by
+ *              src/transformers.cpp for the default library build, or by
+ *              transformers.hpp when ADAS_TOOLS_HEADER_ONLY is defined so the
+ *              small per-point functions can be inlined into caller loops.
+ *              No STL containers are used.
+ * Author: VineetKP
+ * Created: 2025-10-31
+ * *******************************************************************************/
+
+#pragma once
+#include "transformers.hpp"
+#include "instrumentation.hpp"
+#include "trace.hpp"
+#include "trig.hpp"
+#include "rigid.hpp"
+#include <math.h>
+
+namespace AdasTools {
+
+ADAS_CORE_INLINE Point3 scalePosition(const Point3 &p, double scale)
+{
+    Point3 out;
+    out.x = p.x * scale;
+    out.y = p.y * scale;
+    out.z = p.z * scale;
+    return out;
+}
+
+
+// Helper: rotate a point by roll (X), pitch (Y), yaw (Z)
+// Rotation applied as R = Rz(yaw) * Ry(pitch) * Rx(roll)
+ADAS_CORE_INLINE Point3 rotatePosition(const Point3 &p, double roll, double pitch, double yaw)
+{
+    // Precompute sines and cosines
+    double sr, cr;
+    sinCos(roll, sr, cr);
+    double sp, cp;
+    sinCos(pitch, sp, cp);
+    double sy, cy;
+    sinCos(yaw, sy, cy);
+
+    // Combined rotation matrix R = Rz * Ry * Rx
+    // R elements (row-major)
+    double r00 = cy*cp;
+    double r01 = cy*sp*sr - sy*cr;
+    double r02 = cy*sp*cr + sy*sr;
+
+    double r10 = sy*cp;
+    double r11 = sy*sp*sr + cy*cr;
+    double r12 = sy*sp*cr - cy*sr;
+
+    double r20 = -sp;
+    double r21 = cp*sr;
+    double r22 = cp*cr;
+
+    Point3 out;
+    out.x = r00 * p.x + r01 * p.y + r02 * p.z;
+    out.y = r10 * p.x + r11 * p.y + r12 * p.z;
+    out.z = r20 * p.x + r21 * p.y + r22 * p.z;
+    return out;
+}
+
+ADAS_CORE_INLINE Point3 translatePosition(const Point3 &p, double dx, double dy, double dz)
+{
+    Point3 out;
+    out.x = p.x + dx;
+    out.y = p.y + dy;
+    out.z = p.z + dz;
+    return out;
+}
+
+
+ADAS_CORE_INLINE Pose globalToLocal(const Pose &globalPose, const Frame3D &frame)
+{
+    ADAS_PROFILE_SCOPE(PROBE_GLOBAL_TO_LOCAL, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "globalToLocal");
+    // Translate global so the frame origin is at the origin
+    Pose t;
+    t.x = globalPose.x - frame.x;
+    t.y = globalPose.y - frame.y;
+    t.z = globalPose.z - frame.z;
+
+    // To go from global to local we need to apply the inverse rotation.
+    // For a rotation matrix R (frame orientation), the inverse is R^T.
+    // Since rotatePosition applies R = Rz*Ry*Rx, the inverse is rotation
+    // by -roll, -pitch, -yaw in reverse order. We can perform the inverse
+    // by using the transpose of R computed from roll/pitch/yaw.
+
+    // Precompute sines and cosines for frame angles
+    double sr, cr;
+    sinCos(frame.roll, sr, cr);
+    double sp, cp;
+    sinCos(frame.pitch, sp, cp);
+    double sy, cy;
+    sinCos(frame.yaw, sy, cy);
+
+    // R (as in rotatePosition) rows
+    double r00 = cy*cp;
+    double r01 = cy*sp*sr - sy*cr;
+    double r02 = cy*sp*cr + sy*sr;
+
+    double r10 = sy*cp;
+    double r11 = sy*sp*sr + cy*cr;
+    double r12 = sy*sp*cr - cy*sr;
+
+    double r20 = -sp;
+    double r21 = cp*sr;
+    double r22 = cp*cr;
+
+    // Apply R^T * t
+    Pose local;
+    // Apply R^T * t (note: using transpose rows/cols)
+    local.x = r00 * t.x + r10 * t.y + r20 * t.z;
+    local.y = r01 * t.x + r11 * t.y + r21 * t.z;
+    local.z = r02 * t.x + r12 * t.y + r22 * t.z;
+    // preserve orientation (transforming positions only)
+    local.roll = globalPose.roll; local.pitch = globalPose.pitch; local.yaw = globalPose.yaw;
+    return local;
+}
+
+ADAS_CORE_INLINE Pose localToGlobal(const Pose &localPos, const Frame3D &frame)
+{
+    ADAS_PROFILE_SCOPE(PROBE_LOCAL_TO_GLOBAL, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "localToGlobal");
+    // First rotate local position part by frame orientation (R * localPos.position)
+    Point3 localPt{ localPos.x, localPos.y, localPos.z };
+    Point3 rotated = rotatePosition(localPt, frame.roll, frame.pitch, frame.yaw);
+
+    // Then translate by frame origin
+    Pose global;
+    global.x = rotated.x + frame.x;
+    global.y = rotated.y + frame.y;
+    global.z = rotated.z + frame.z;
+    // preserve orientation fields from localPos
+    global.roll = localPos.roll; global.pitch = localPos.pitch; global.yaw = localPos.yaw;
+    return global;
+}
+
+ADAS_CORE_INLINE void pose6ToMatrix(const double pose6[6], double outMat16[16])
+{
+    // pose6 = {x, y, z, roll, pitch, yaw}
+    double x = pose6[0];
+    double y = pose6[1];
+    double z = pose6[2];
+    double roll = pose6[3];
+    double pitch = pose6[4];
+    double yaw = pose6[5];
+
+    double sr, cr;
+    sinCos(roll, sr, cr);
+    double sp, cp;
+    sinCos(pitch, sp, cp);
+    double sy, cy;
+    sinCos(yaw, sy, cy);
+
+    // R = Rz * Ry * Rx
+    double r00 = cy*cp;
+    double r01 = cy*sp*sr - sy*cr;
+    double r02 = cy*sp*cr + sy*sr;
+
+    double r10 = sy*cp;
+    double r11 = sy*sp*sr + cy*cr;
+    double r12 = sy*sp*cr - cy*sr;
+
+    double r20 = -sp;
+    double r21 = cp*sr;
+    double r22 = cp*cr;
+
+    // Row-major 4x4
+    outMat16[0] = r00; outMat16[1] = r01; outMat16[2] = r02; outMat16[3] = x;
+    outMat16[4] = r10; outMat16[5] = r11; outMat16[6] = r12; outMat16[7] = y;
+    outMat16[8] = r20; outMat16[9] = r21; outMat16[10] = r22; outMat16[11] = z;
+    outMat16[12] = 0.0; outMat16[13] = 0.0; outMat16[14] = 0.0; outMat16[15] = 1.0;
+}
+
+ADAS_CORE_INLINE void poseToMatrix(const Pose &pose, double outMat16[16])
+{
+    double p[6];
+    p[0] = pose.x; p[1] = pose.y; p[2] = pose.z;
+    p[3] = pose.roll; p[4] = pose.pitch; p[5] = pose.yaw;
+    pose6ToMatrix(p, outMat16);
+}
+
+ADAS_CORE_INLINE Pose localToGlobalFromMatrix(const Pose &vehiclePose, const Pose &sensorPose)
+{
+    ADAS_PROFILE_SCOPE(PROBE_LOCAL_TO_GLOBAL_FROM_MATRIX, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "localToGlobalFromMatrix");
+    // Build 4x4 matrices for vehicle and sensor
+    double Mv[16];
+    double Ms[16];
+    poseToMatrix(vehiclePose, Mv);
+    poseToMatrix(sensorPose, Ms);
+
+    // M = Mv * Ms (3x4 affine product; the constant bottom row is skipped)
+    double M[16];
+    rigidCompose(Mv, Ms, M);
+
+    // Recover roll, pitch, yaw assuming R = Rz * Ry * Rx
+    return matrixToPose(M);
+}
+
+ADAS_CORE_INLINE Pose globalToLocalFromMatrix(const Pose &vehiclePose, const Pose &sensorGlobalPose)
+{
+    ADAS_PROFILE_SCOPE(PROBE_GLOBAL_TO_LOCAL_FROM_MATRIX, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "globalToLocalFromMatrix");
+    // We want sensor_local = inverse(Mv) * Ms_global
+    double Mv[16];
+    double Mg[16];
+    poseToMatrix(vehiclePose, Mv);
+    poseToMatrix(sensorGlobalPose, Mg);
+
+    // Rigid inverse: inv(Mv) = [R^T, -R^T t; 0 1]
+    double Minv[16];
+    rigidInverse(Mv, Minv);
+
+    double Mloc[16];
+    rigidCompose(Minv, Mg, Mloc);
+    return matrixToPose(Mloc);
+}
+
+// Point3 overloads
+ADAS_CORE_INLINE Point3 localToGlobal(const Point3 &localPos, const Frame3D &frame)
+{
+    ADAS_PROFILE_SCOPE(PROBE_LOCAL_TO_GLOBAL, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "localToGlobal");
+    Point3 rotated = rotatePosition(localPos, frame.roll, frame.pitch, frame.yaw);
+    Point3 out;
+    out.x = rotated.x + frame.x;
+    out.y = rotated.y + frame.y;
+    out.z = rotated.z + frame.z;
+    return out;
+}
+
+ADAS_CORE_INLINE Point3 globalToLocal(const Point3 &globalPos, const Frame3D &frame)
+{
+    ADAS_PROFILE_SCOPE(PROBE_GLOBAL_TO_LOCAL, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "globalToLocal");
+    // Translate global so the frame origin is at the origin
+    Point3 t;
+    t.x = globalPos.x - frame.x;
+    t.y = globalPos.y - frame.y;
+    t.z = globalPos.z - frame.z;
+
+    // Build R (same as in Pose path)
+    double sr, cr;
+    sinCos(frame.roll, sr, cr);
+    double sp, cp;
+    sinCos(frame.pitch, sp, cp);
+    double sy, cy;
+    sinCos(frame.yaw, sy, cy);
+
+    double r00 = cy*cp;
+    double r01 = cy*sp*sr - sy*cr;
+    double r02 = cy*sp*cr + sy*sr;
+
+    double r10 = sy*cp;
+    double r11 = sy*sp*sr + cy*cr;
+    double r12 = sy*sp*cr - cy*sr;
+
+    double r20 = -sp;
+    double r21 = cp*sr;
+    double r22 = cp*cr;
+
+    Point3 local;
+    local.x = r00 * t.x + r10 * t.y + r20 * t.z;
+    local.y = r01 * t.x + r11 * t.y + r21 * t.z;
+    local.z = r02 * t.x + r12 * t.y + r22 * t.z;
+    return local;
+}
+
+ADAS_CORE_INLINE Point3 projectPointCamera(const Point3 &pointLocal, const double extrinsic[16], const double intrinsic[9])
+{
+    ADAS_PROFILE_SCOPE(PROBE_PROJECT_POINT_CAMERA, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "projectPointCamera");
+    // Map local point to camera coordinates: p_cam = Extrinsic * [X Y Z 1]^T
+    double X = pointLocal.x;
+    double Y = pointLocal.y;
+    double Z = pointLocal.z;
+
+    double cx = extrinsic[3];
+    double cy = extrinsic[7];
+    double cz = extrinsic[11];
+
+    double x_cam = extrinsic[0]*X + extrinsic[1]*Y + extrinsic[2]*Z + cx;
+    double y_cam = extrinsic[4]*X + extrinsic[5]*Y + extrinsic[6]*Z + cy;
+    double z_cam = extrinsic[8]*X + extrinsic[9]*Y + extrinsic[10]*Z + cz;
+
+    Point3 out;
+    if (z_cam == 0.0) {
+        out.x = 0.0; out.y = 0.0; out.z = 0.0;
+        return out;
+    }
+
+    double fx = intrinsic[0];
+    double s  = intrinsic[1];
+    double cx_i = intrinsic[2];
+    double fy = intrinsic[4];
+    double cy_i = intrinsic[5];
+
+    double u = (fx * x_cam + s * y_cam) / z_cam + cx_i;
+    double v = (fy * y_cam) / z_cam + cy_i;
+
+    out.x = u; out.y = v; out.z = z_cam;
+    return out;
+}
+
+ADAS_CORE_INLINE Pose projectPointCamera(const Pose &pointLocal, const double extrinsic[16], const double intrinsic[9])
+{
+    ADAS_PROFILE_SCOPE(PROBE_PROJECT_POINT_CAMERA, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "projectPointCamera");
+    // Map local point to camera coordinates: p_cam = Extrinsic * [X Y Z 1]^T
+    double X = pointLocal.x;
+    double Y = pointLocal.y;
+    double Z = pointLocal.z;
+
+    double cx = extrinsic[3];
+    double cy = extrinsic[7];
+    double cz = extrinsic[11];
+
+    double x_cam = extrinsic[0]*X + extrinsic[1]*Y + extrinsic[2]*Z + cx;
+    double y_cam = extrinsic[4]*X + extrinsic[5]*Y + extrinsic[6]*Z + cy;
+    double z_cam = extrinsic[8]*X + extrinsic[9]*Y + extrinsic[10]*Z + cz;
+
+    Pose out;
+    if (z_cam == 0.0) {
+        out.x = 0.0; out.y = 0.0; out.z = 0.0;
+        return out;
+    }
+
+    // Intrinsic K (row-major): [fx s cx; 0 fy cy; 0 0 1]
+    double fx = intrinsic[0];
+    double s  = intrinsic[1];
+    double cx_i = intrinsic[2];
+    double fy = intrinsic[4];
+    double cy_i = intrinsic[5];
+
+    double u = (fx * x_cam + s * y_cam) / z_cam + cx_i;
+    double v = (fy * y_cam) / z_cam + cy_i;
+
+    out.x = u; out.y = v; out.z = z_cam;
+    return out;
+}
+
+} // namespace AdasTools
@@ -0,0 +1,168 @@
+/* *******************************************************************************
+ * File: include/trig.hpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Internal sine/cosine layer with selectable accuracy tiers:
+ *              libm (reference), fused sincos, and branch-free polynomial
+ *              kernels with documented error bounds. Used by every Euler-based
+ *              routine (one sinCos per angle instead of separate sin/cos) and
+ *              by batch APIs through sinCosBatch(), whose loop is written to
+ *              auto-vectorize. Header-only so it inlines into the core.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace AdasTools {
+
+/**
+ * @brief Accuracy/speed tier for sinCos().
+ *
+ * Max absolute error vs. libm, measured for |x| <= kTrigPolyRangeLimit
+ * (tests/test_trig.cpp): TRIG_POLY_1E12 < 1e-15, TRIG_POLY_1E7 < 3e-8.
+ * Polynomial tiers fall back to libm beyond kTrigPolyRangeLimit.
+ */
+enum TrigTier {
+    TRIG_LIBM = 0,      /**< separate libm sin() and cos() (bit-exact reference) */
+    TRIG_SINCOS = 1,    /**< fused sincos (same accuracy as libm, one range reduction) */
+    TRIG_POLY_1E12 = 2, /**< degree 13/14 minimax kernel, error well below 1e-12 */
+    TRIG_POLY_1E7 = 3   /**< degree 9/8 Taylor kernel, error below 1e-7 */
+};
+
+/** Largest |x| (radians) handled by the polynomial tiers before falling back to libm. */
+constexpr double kTrigPolyRangeLimit = 1.0e5;
+
+namespace trig_detail {
+
+inline std::atomic<int> &defaultTierStorage()
+{
+    static std::atomic<int> tier{ TRIG_LIBM };
+    return tier;
+}
+
+/**
+ * Branch-free reduction to [-pi/4, pi/4] plus quadrant fix-up. Rounding to the
+ * nearest multiple of pi/2 uses the 1.5*2^52 trick so the quadrant comes from
+ * the mantissa bits; the whole kernel vectorizes with plain SSE2.
+ */
+template <bool HighAccuracy>
+inline void polySinCos(double x, double &s, double &c)
+{
+    const double kTwoOverPi = 6.36619772367581382433e-01;
+    const double kPio2Hi = 1.57079632673412561417e+00;  // first 33 bits of pi/2
+    const double kPio2Lo = 6.07710050650619224932e-11;  // pi/2 - kPio2Hi
+    const double kRound = 6755399441055744.0;           // 1.5 * 2^52
+
+    double t = x * kTwoOverPi + kRound;
+    unsigned long long bits;
+    memcpy(&bits, &t, sizeof(bits));
+    double k = t - kRound;
+    double r = (x - k * kPio2Hi) - k * kPio2Lo;
+    double z = r * r;
+
+    double ps, pc;
+    if (HighAccuracy) {
+        // fdlibm __kernel_sin / __kernel_cos minimax coefficients
+        ps = r + r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 +
+             z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06 +
+             z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+        pc = 1.0 - 0.5 * z + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+             z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+             z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+    } else {
+        ps = r + r * z * (-1.0 / 6.0 + z * (1.0 / 120.0 + z * (-1.0 / 5040.0 + z * (1.0 / 362880.0))));
+        pc = 1.0 - 0.5 * z + z * z * (1.0 / 24.0 + z * (-1.0 / 720.0 + z * (1.0 / 40320.0)));
+    }
+
+    // Quadrant q = k mod 4: odd quadrants swap sin/cos, signs follow q.
+    unsigned q = (unsigned)(bits & 3u);
+    double sv = (q & 1u) ? pc : ps;
+    double cv = (q & 1u) ? ps : pc;
+    s = (q & 2u) ? -sv : sv;
+    c = ((q + 1u) & 2u) ? -cv : cv;
+}
+
+} // namespace trig_detail
+
+/** @brief Select the tier used by sinCos(x, s, c) and the Euler-based core. */
+inline void setTrigTier(TrigTier tier)
+{
+    trig_detail::defaultTierStorage().store((int)tier, std::memory_order_relaxed);
+}
+
+/** @brief The process-wide default tier (TRIG_LIBM unless changed). */
+inline TrigTier trigTier()
+{
+    return (TrigTier)trig_detail::defaultTierStorage().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sine and cosine of `x` with an explicit tier (per call site).
+ * @param x Angle in radians
+ * @param s Receives sin(x)
+ * @param c Receives cos(x)
+ * @param tier Accuracy tier
+ */
+inline void sinCos(double x, double &s, double &c, TrigTier tier)
+{
+    switch (tier) {
+    case TRIG_SINCOS:
+#if defined(__GNUC__)
+        __builtin_sincos(x, &s, &c);
+#else
+        s = sin(x); c = cos(x);
+#endif
+        return;
+    case TRIG_POLY_1E12:
+        if (fabs(x) <= kTrigPolyRangeLimit) { trig_detail::polySinCos<true>(x, s, c); return; }
+        break;
+    case TRIG_POLY_1E7:
+        if (fabs(x) <= kTrigPolyRangeLimit) { trig_detail::polySinCos<false>(x, s, c); return; }
+        break;
+    case TRIG_LIBM:
+    default:
+        break;
+    }
+    s = sin(x);
+    c = cos(x);
+}
+
+/** @brief Sine and cosine of `x` using the process-wide tier. */
+inline void sinCos(double x, double &s, double &c)
+{
+    sinCos(x, s, c, trigTier());
+}
+
+/**
+ * @brief Sine and cosine of `n` angles (vectorizable for the polynomial tiers).
+ * @param x Input angles (radians)
+ * @param s Output sines
+ * @param c Output cosines (x, s and c must not overlap)
+ * @param n Number of angles
+ * @param tier Accuracy tier
+ */
+inline void sinCosBatch(const double *x, double *s, double *c, size_t n, TrigTier tier)
+{
+    if (tier == TRIG_POLY_1E12 || tier == TRIG_POLY_1E7) {
+        const double *__restrict xi = x;
+        double *__restrict so = s;
+        double *__restrict co = c;
+        if (tier == TRIG_POLY_1E12) {
+            for (size_t i = 0; i < n; ++i) trig_detail::polySinCos<true>(xi[i], so[i], co[i]);
+        } else {
+            for (size_t i = 0; i < n; ++i) trig_detail::polySinCos<false>(xi[i], so[i], co[i]);
+        }
+        // Rare out-of-range angles are redone with libm after the vector pass.
+        for (size_t i = 0; i < n; ++i) {
+            if (fabs(x[i]) > kTrigPolyRangeLimit) { s[i] = sin(x[i]); c[i] = cos(x[i]); }
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) sinCos(x[i], s[i], c[i], tier);
+}
+
+} // namespace AdasTools
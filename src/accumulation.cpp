@@ -0,0 +1,328 @@
+/* *******************************************************************************
+ * File: src/accumulation.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Rolling voxel accumulation map. Voxels live in dense arrays
+ *              (swap-remove on eviction) indexed by a linear-probing hash
+ *              with backward-shift deletion, so the table never fills with
+ *              tombstones however long the map rolls. Eviction is one pass
+ *              over the voxels per sweep; each voxel's ring keeps its oldest
+ *              point first, so most voxels are checked with one compare.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "accumulation.hpp"
+#include "arena.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace AdasTools {
+
+namespace {
+
+const int kKeyBits = 21;
+const long long kKeyBias = 1ll << (kKeyBits - 1);
+const unsigned long long kKeyMask = (1ull << kKeyBits) - 1ull;
+const size_t kChunk = 256;        // points transformed per step on insert
+const size_t kVoxelBlock = 2048;  // voxels per extraction task
+const size_t kAlign = 32;
+
+inline size_t alignUp(size_t v) { return (v + kAlign - 1) & ~(kAlign - 1); }
+
+// rigidTransformPoints() without the probe/trace scope, for the many short runs of extract()
+inline void transformRun(const double *m, const Point3 *__restrict in, Point3 *__restrict out, size_t n)
+{
+    const double r00 = m[0], r01 = m[1], r02 = m[2], tx = m[3];
+    const double r10 = m[4], r11 = m[5], r12 = m[6], ty = m[7];
+    const double r20 = m[8], r21 = m[9], r22 = m[10], tz = m[11];
+    for (size_t i = 0; i < n; ++i) {
+        const double x = in[i].x, y = in[i].y, z = in[i].z;
+        out[i].x = r00*x + r01*y + r02*z + tx;
+        out[i].y = r10*x + r11*y + r12*z + ty;
+        out[i].z = r20*x + r21*y + r22*z + tz;
+    }
+}
+
+struct ExtractJob {
+    const unsigned char *counts;
+    const Point3 *slots;
+    const double *stamps;
+    unsigned perVoxel;
+    size_t voxels;
+    const size_t *offsets; // first output index per block
+    size_t capacity;
+    const double *m;       // world -> vehicle
+    Point3 *out;
+    double *outStamps;
+
+    void operator()(size_t block)
+    {
+        const size_t first = block * kVoxelBlock;
+        const size_t last = first + kVoxelBlock < voxels ? first + kVoxelBlock : voxels;
+        const size_t begin = offsets[block];
+        if (begin >= capacity) return;
+        // gather and transform in one pass: each slot is read once and each output
+        // written once. Full voxels are contiguous in slots_, so runs of them go
+        // through one straight loop instead of a short loop per voxel.
+        size_t k = begin;
+        for (size_t v = first; v < last && k < capacity;) {
+            size_t run = v;
+            while (run < last && counts[run] == perVoxel) ++run;
+            size_t c = run > v ? (run - v) * perVoxel : counts[v];
+            if (c > capacity - k) c = capacity - k;
+            transformRun(m, slots + v * perVoxel, out + k, c);
+            if (outStamps) memcpy(outStamps + k, stamps + v * perVoxel, c * sizeof(double));
+            k += c;
+            v = run > v ? run : v + 1;
+        }
+    }
+};
+
+} // namespace
+
+AccumulationMap::AccumulationMap()
+    : config_(defaultAccumulationConfig()), invVoxel_(0.0), memory_(nullptr), keys_(nullptr), counts_(nullptr),
+      next_(nullptr), slots_(nullptr), stamps_(nullptr), buckets_(nullptr), bucketMask_(0), bucketShift_(0),
+      voxels_(0), points_(0), dropped_(0)
+{
+}
+
+AccumulationMap::~AccumulationMap() { free(memory_); }
+
+bool AccumulationMap::init(const AccumulationConfig &config)
+{
+    free(memory_);
+    memory_ = nullptr;
+    voxels_ = points_ = 0;
+    dropped_ = 0;
+    if (!(config.voxelSize > 0.0) || config.pointsPerVoxel == 0 || config.pointsPerVoxel > kAccumulationMaxPointsPerVoxel ||
+        config.maxVoxels == 0 || config.maxVoxels >= 0x80000000u || !(config.maxAge >= 0.0) || !(config.maxDistance > 0.0)) {
+        return false;
+    }
+    size_t buckets = 16;
+    unsigned bits = 4;
+    while (buckets < 2 * config.maxVoxels) { buckets <<= 1; ++bits; }
+
+    const size_t v = config.maxVoxels, slots = v * config.pointsPerVoxel;
+    const size_t slotBytes = alignUp(slots * sizeof(Point3)), stampBytes = alignUp(slots * sizeof(double));
+    const size_t keyBytes = alignUp(v * sizeof(unsigned long long)), bucketBytes = alignUp(buckets * sizeof(unsigned int));
+    unsigned char *p = (unsigned char *)malloc(slotBytes + stampBytes + keyBytes + bucketBytes + 2 * alignUp(v));
+    if (!p) return false;
+    memory_ = p;
+    slots_ = (Point3 *)p;
+    stamps_ = (double *)(p += slotBytes);
+    keys_ = (unsigned long long *)(p += stampBytes);
+    buckets_ = (unsigned int *)(p += keyBytes);
+    counts_ = p += bucketBytes;
+    next_ = p + alignUp(v);
+    config_ = config;
+    invVoxel_ = 1.0 / config.voxelSize;
+    bucketMask_ = buckets - 1;
+    bucketShift_ = 64 - bits;
+    clear();
+    return true;
+}
+
+void AccumulationMap::clear()
+{
+    if (buckets_) memset(buckets_, 0, (bucketMask_ + 1) * sizeof(unsigned int));
+    voxels_ = points_ = 0;
+}
+
+size_t AccumulationMap::bucketOf(unsigned long long key) const
+{
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> bucketShift_);
+}
+
+bool AccumulationMap::findOrAdd(unsigned long long key, size_t &voxel)
+{
+    for (size_t i = bucketOf(key);; i = (i + 1) & bucketMask_) {
+        const unsigned int b = buckets_[i];
+        if (b == 0) {
+            if (voxels_ == config_.maxVoxels) return false;
+            voxel = voxels_++;
+            keys_[voxel] = key;
+            counts_[voxel] = 0;
+            next_[voxel] = 0;
+            buckets_[i] = (unsigned int)(voxel + 1);
+            return true;
+        }
+        if (keys_[b - 1] == key) {
+            voxel = b - 1;
+            return true;
+        }
+    }
+}
+
+void AccumulationMap::removeVoxel(size_t voxel)
+{
+    // backward-shift deletion: pull later cluster members whose home is not in (hole, j]
+    size_t hole = bucketOf(keys_[voxel]);
+    while (buckets_[hole] != voxel + 1) hole = (hole + 1) & bucketMask_;
+    for (size_t j = (hole + 1) & bucketMask_; buckets_[j] != 0; j = (j + 1) & bucketMask_) {
+        const size_t home = bucketOf(keys_[buckets_[j] - 1]);
+        const bool stays = hole < j ? (home > hole && home <= j) : (home > hole || home <= j);
+        if (!stays) {
+            buckets_[hole] = buckets_[j];
+            hole = j;
+        }
+    }
+    buckets_[hole] = 0;
+
+    const size_t last = --voxels_;
+    if (voxel == last) return;
+    const unsigned k = config_.pointsPerVoxel;
+    keys_[voxel] = keys_[last];
+    counts_[voxel] = counts_[last];
+    next_[voxel] = next_[last];
+    memcpy(slots_ + voxel * k, slots_ + last * k, counts_[last] * sizeof(Point3));
+    memcpy(stamps_ + voxel * k, stamps_ + last * k, counts_[last] * sizeof(double));
+    size_t i = bucketOf(keys_[voxel]);
+    while (buckets_[i] != last + 1) i = (i + 1) & bucketMask_;
+    buckets_[i] = (unsigned int)(voxel + 1);
+}
+
+void AccumulationMap::compactVoxel(size_t voxel, double cutoff)
+{
+    const unsigned k = config_.pointsPerVoxel, count = counts_[voxel];
+    const unsigned start = count == k ? next_[voxel] : 0;
+    Point3 *slots = slots_ + voxel * k;
+    double *stamps = stamps_ + voxel * k;
+    Point3 keptPoints[kAccumulationMaxPointsPerVoxel];
+    double keptStamps[kAccumulationMaxPointsPerVoxel];
+    unsigned kept = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        const unsigned s = start + i < k ? start + i : start + i - k; // oldest first
+        if (stamps[s] < cutoff) continue;
+        keptPoints[kept] = slots[s];
+        keptStamps[kept++] = stamps[s];
+    }
+    memcpy(slots, keptPoints, kept * sizeof(Point3));
+    memcpy(stamps, keptStamps, kept * sizeof(double));
+    points_ -= count - kept;
+    counts_[voxel] = (unsigned char)kept;
+    next_[voxel] = 0;
+}
+
+void AccumulationMap::evict(double now, const Point3 &position)
+{
+    if (!memory_) return;
+    const double cutoff = now - config_.maxAge;
+    const double maxD2 = config_.maxDistance * config_.maxDistance;
+    const unsigned k = config_.pointsPerVoxel;
+    // downwards: swap-remove moves an already visited voxel into the hole
+    for (size_t v = voxels_; v-- > 0;) {
+        const unsigned long long key = keys_[v];
+        const double cx = ((double)(long long)((key >> (2 * kKeyBits)) & kKeyMask) - kKeyBias + 0.5) * config_.voxelSize;
+        const double cy = ((double)(long long)((key >> kKeyBits) & kKeyMask) - kKeyBias + 0.5) * config_.voxelSize;
+        const double cz = ((double)(long long)(key & kKeyMask) - kKeyBias + 0.5) * config_.voxelSize;
+        const double dx = cx - position.x, dy = cy - position.y, dz = cz - position.z;
+        if (dx * dx + dy * dy + dz * dz > maxD2) {
+            points_ -= counts_[v];
+            removeVoxel(v);
+            continue;
+        }
+        const unsigned oldest = counts_[v] == k ? next_[v] : 0;
+        if (stamps_[v * k + oldest] >= cutoff) continue;
+        compactVoxel(v, cutoff);
+        if (counts_[v] == 0) removeVoxel(v);
+    }
+}
+
+size_t AccumulationMap::insert(const Point3 *points, size_t n, const RigidTransform &vehicleToWorld, double stamp)
+{
+    ADAS_PROFILE_SCOPE(PROBE_ACCUMULATE_INSERT, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "accumulateSweep");
+    if (!memory_) return 0;
+    evict(stamp, vehicleToWorld.t);
+    double m[16];
+    transformToMatrix(vehicleToWorld, m);
+    const unsigned k = config_.pointsPerVoxel;
+    const double limit = (double)kKeyBias;
+    const double maxD2 = config_.maxDistance * config_.maxDistance;
+    const Point3 &origin = vehicleToWorld.t;
+    Point3 world[kChunk];
+    size_t stored = 0;
+    for (size_t base = 0; base < n; base += kChunk) {
+        const size_t count = n - base < kChunk ? n - base : kChunk;
+        rigidTransformPoints(m, points + base, world, count);
+        for (size_t i = 0; i < count; ++i) {
+            const Point3 &p = world[i];
+            const double dx = p.x - origin.x, dy = p.y - origin.y, dz = p.z - origin.z;
+            if (!(dx * dx + dy * dy + dz * dz <= maxD2)) continue; // would be evicted next sweep
+            const double fx = floor(p.x * invVoxel_), fy = floor(p.y * invVoxel_), fz = floor(p.z * invVoxel_);
+            if (!(fx >= -limit && fx < limit && fy >= -limit && fy < limit && fz >= -limit && fz < limit)) continue;
+            const unsigned long long key = ((unsigned long long)((long long)fx + kKeyBias) << (2 * kKeyBits)) |
+                                           ((unsigned long long)((long long)fy + kKeyBias) << kKeyBits) |
+                                           (unsigned long long)((long long)fz + kKeyBias);
+            size_t v;
+            if (!findOrAdd(key, v)) continue;
+            unsigned slot;
+            if (counts_[v] < k) {
+                slot = counts_[v]++;
+                ++points_;
+            } else {
+                slot = next_[v];
+                next_[v] = (unsigned char)(slot + 1 < k ? slot + 1 : 0);
+            }
+            slots_[v * k + slot] = p;
+            stamps_[v * k + slot] = stamp;
+            ++stored;
+        }
+    }
+    dropped_ += n - stored;
+    return stored;
+}
+
+size_t AccumulationMap::insert(const Point3 *points, size_t n, const Pose &vehicleToWorld, double stamp)
+{
+    return insert(points, n, poseToTransform(vehicleToWorld), stamp);
+}
+
+size_t AccumulationMap::extractScratchBytes() const
+{
+    return ((config_.maxVoxels + kVoxelBlock - 1) / kVoxelBlock) * sizeof(size_t) + kAlign;
+}
+
+size_t AccumulationMap::extract(const RigidTransform &vehicleToWorld, Point3 *out, size_t capacity, double *stamps,
+                                FrameArena *scratch, TaskPool *pool) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_ACCUMULATE_EXTRACT, points_);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "extractAccumulated");
+    if (!memory_ || !out || voxels_ == 0 || capacity == 0) return 0;
+
+    if (!scratch) scratch = threadScratchArena();
+    const size_t blocks = (voxels_ + kVoxelBlock - 1) / kVoxelBlock;
+    const size_t bytes = blocks * sizeof(size_t) + kAlign;
+    const size_t marker = scratch ? scratch->mark() : 0;
+    size_t *offsets = scratch ? (size_t *)scratch->allocate(bytes, kAlign) : (size_t *)malloc(bytes);
+    if (!offsets) return 0;
+
+    size_t total = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        offsets[b] = total;
+        const size_t last = (b + 1) * kVoxelBlock < voxels_ ? (b + 1) * kVoxelBlock : voxels_;
+        for (size_t v = b * kVoxelBlock; v < last; ++v) total += counts_[v];
+    }
+    double m[16];
+    transformToMatrix(inverseTransform(vehicleToWorld), m);
+    ExtractJob job{ counts_, slots_, stamps_, config_.pointsPerVoxel, voxels_, offsets, capacity, m, out, stamps };
+    (pool ? pool : defaultTaskPool())->parallelFor(blocks, job);
+
+    if (scratch) scratch->rewind(marker);
+    else free(offsets);
+    return total < capacity ? total : capacity;
+}
+
+size_t AccumulationMap::extract(const Pose &vehicleToWorld, Point3 *out, size_t capacity, double *stamps,
+                                FrameArena *scratch, TaskPool *pool) const
+{
+    return extract(poseToTransform(vehicleToWorld), out, capacity, stamps, scratch, pool);
+}
+
+} // namespace AdasTools
@@ -0,0 +1,128 @@
+/* *******************************************************************************
+ * File: src/arena.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Backing-store management for the per-frame arena allocator.
+ *              Uses anonymous mmap on POSIX (with optional huge pages) and
+ *              aligned malloc elsewhere. The hot path (allocate/reset) is
+ *              inline in the header.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "arena.hpp"
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ADAS_ARENA_HAVE_MMAP 1
+#endif
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kHugePageSize = 2u * 1024u * 1024u;
+
+size_t roundUp(size_t v, size_t a) { return (v + a - 1) / a * a; }
+
+thread_local FrameArena *t_scratchArena = nullptr;
+
+} // namespace
+
+FrameArena::FrameArena()
+    : base_(nullptr), capacity_(0), offset_(0), highWater_(0), failed_(0),
+      mappedBytes_(0), mapped_(false), huge_(false)
+{
+}
+
+FrameArena::FrameArena(void *buffer, size_t bytes)
+    : base_(static_cast<unsigned char *>(buffer)), capacity_(bytes), offset_(0), highWater_(0),
+      failed_(0), mappedBytes_(0), mapped_(false), huge_(false)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    release();
+}
+
+bool FrameArena::reserve(size_t bytes, ArenaBacking backing)
+{
+    release();
+    if (bytes == 0 || bytes > (size_t)-1 - kHugePageSize) return false; // roundUp() must not wrap
+
+#if defined(ADAS_ARENA_HAVE_MMAP)
+    void *p = MAP_FAILED;
+    size_t len = 0;
+    if (backing == ARENA_BACKING_HUGE_PAGES) {
+        len = roundUp(bytes, kHugePageSize);
+#if defined(MAP_HUGETLB)
+        // Explicit huge pages only succeed when the admin reserved a pool.
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) huge_ = true;
+#endif
+    }
+    if (p == MAP_FAILED) {
+        long page = sysconf(_SC_PAGESIZE);
+        len = roundUp(bytes, backing == ARENA_BACKING_HUGE_PAGES ? kHugePageSize : (size_t)(page > 0 ? page : 4096));
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return false;
+#if defined(MADV_HUGEPAGE)
+        // Fall back to transparent huge pages where the kernel allows it.
+        if (backing == ARENA_BACKING_HUGE_PAGES && madvise(p, len, MADV_HUGEPAGE) == 0) huge_ = true;
+#endif
+    }
+    base_ = static_cast<unsigned char *>(p);
+    capacity_ = len;
+    mappedBytes_ = len;
+    mapped_ = true;
+#else
+    (void)backing;
+    size_t len = roundUp(bytes, 64);
+    void *p = aligned_alloc(64, len);
+    if (!p) return false;
+    base_ = static_cast<unsigned char *>(p);
+    capacity_ = len;
+    mappedBytes_ = len;
+    mapped_ = false;
+#endif
+    offset_ = 0;
+    return true;
+}
+
+void FrameArena::attach(void *buffer, size_t bytes)
+{
+    release();
+    base_ = static_cast<unsigned char *>(buffer);
+    capacity_ = bytes;
+}
+
+void FrameArena::release()
+{
+    if (mappedBytes_ != 0) {
+#if defined(ADAS_ARENA_HAVE_MMAP)
+        if (mapped_) munmap(base_, mappedBytes_);
+#else
+        free(base_);
+#endif
+    }
+    base_ = nullptr;
+    capacity_ = 0;
+    offset_ = 0;
+    mappedBytes_ = 0;
+    mapped_ = false;
+    huge_ = false;
+}
+
+void setThreadScratchArena(FrameArena *arena)
+{
+    t_scratchArena = arena;
+}
+
+FrameArena *threadScratchArena()
+{
+    return t_scratchArena;
+}
+
+} // namespace AdasTools
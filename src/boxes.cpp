@@ -0,0 +1,165 @@
+/* *******************************************************************************
+ * File: src/boxes.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Oriented bounding box batch operations. Box poses are
+ *              composed with rigidCompose(); projection works on the box in
+ *              camera coordinates (center + half-axis vectors), clipping its
+ *              12 edges against the near plane.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "boxes.hpp"
+#include "instrumentation.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include "transformers.hpp"
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kPoseBlock = 64; // boxes whose matrices are built together (posesToMatrices)
+
+// Corner pairs differing in exactly one sign bit.
+const unsigned char kEdges[12][2] = {
+    { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+    { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+    { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+};
+
+// Corners from a rigid matrix whose rotation columns are the box axes.
+void cornersFromMatrix(const double m[16], const Point3 &size, double cx[8], double cy[8], double cz[8])
+{
+    const double hx = 0.5 * size.x, hy = 0.5 * size.y, hz = 0.5 * size.z;
+    for (int i = 0; i < 8; ++i) {
+        const double sx = (i & 1) ? hx : -hx;
+        const double sy = (i & 2) ? hy : -hy;
+        const double sz = (i & 4) ? hz : -hz;
+        cx[i] = m[0] * sx + m[1] * sy + m[2] * sz + m[3];
+        cy[i] = m[4] * sx + m[5] * sy + m[6] * sz + m[7];
+        cz[i] = m[8] * sx + m[9] * sy + m[10] * sz + m[11];
+    }
+}
+
+// boxesTransform() without its probe, shared with boxesLocalToGlobal().
+void transformBoxes(const OrientedBox *in, OrientedBox *out, size_t n, const double transform[16])
+{
+    Pose centers[kPoseBlock];
+    double ms[kPoseBlock * 16];
+    for (size_t base = 0; base < n; base += kPoseBlock) {
+        const size_t k = n - base < kPoseBlock ? n - base : kPoseBlock;
+        for (size_t i = 0; i < k; ++i) centers[i] = in[base + i].center;
+        posesToMatrices(centers, ms, k);
+        for (size_t i = 0; i < k; ++i) {
+            double *m = ms + i * 16;
+            rigidCompose(transform, m, m);
+            out[base + i].center = matrixToPose(m);
+            out[base + i].size = in[base + i].size;
+        }
+    }
+}
+
+} // namespace
+
+void boxCorners(const OrientedBox &box, Point3 corners[8])
+{
+    double m[16], cx[8], cy[8], cz[8];
+    poseToMatrix(box.center, m);
+    cornersFromMatrix(m, box.size, cx, cy, cz);
+    for (int i = 0; i < 8; ++i) corners[i] = Point3{ cx[i], cy[i], cz[i] };
+}
+
+void boxesTransform(const OrientedBox *in, OrientedBox *out, size_t n, const double transform[16])
+{
+    ADAS_PROFILE_SCOPE(PROBE_BOXES_TRANSFORM, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "boxesTransform");
+    transformBoxes(in, out, n, transform);
+}
+
+void boxesLocalToGlobal(const OrientedBox *in, OrientedBox *out, size_t n, const Frame3D &frame)
+{
+    ADAS_PROFILE_SCOPE(PROBE_BOXES_LOCAL_TO_GLOBAL, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "boxesLocalToGlobal");
+    double f[6] = { frame.x, frame.y, frame.z, frame.roll, frame.pitch, frame.yaw };
+    double m[16];
+    pose6ToMatrix(f, m);
+    transformBoxes(in, out, n, m);
+}
+
+size_t projectBoxesToImage(const OrientedBox *boxes, size_t n, const double extrinsic[16], const double intrinsic[9],
+                           int width, int height, double nearPlane, ImageRect *out)
+{
+    ADAS_PROFILE_SCOPE(PROBE_PROJECT_BOXES, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "projectBoxesToImage");
+    const double fx = intrinsic[0], s = intrinsic[1], cxi = intrinsic[2];
+    const double fy = intrinsic[4], cyi = intrinsic[5];
+    const double w = (double)width, h = (double)height;
+    size_t visible = 0;
+    Pose centers[kPoseBlock];
+    double ms[kPoseBlock * 16];
+
+    for (size_t b = 0; b < n; ++b) {
+        if (b % kPoseBlock == 0) {
+            const size_t k = n - b < kPoseBlock ? n - b : kPoseBlock;
+            for (size_t i = 0; i < k; ++i) centers[i] = boxes[b + i].center;
+            posesToMatrices(centers, ms, k);
+        }
+        double *m = ms + (b % kPoseBlock) * 16, cx[8], cy[8], cz[8];
+        rigidCompose(extrinsic, m, m);
+        cornersFromMatrix(m, boxes[b].size, cx, cy, cz);
+
+        ImageRect &r = out[b];
+        double uMin = 1e300, vMin = 1e300, uMax = -1e300, vMax = -1e300, dMin = 1e300;
+        int front = 0;
+        for (int i = 0; i < 8; ++i) {
+            if (cz[i] < nearPlane) continue;
+            ++front;
+            const double inv = 1.0 / cz[i];
+            const double u = (fx * cx[i] + s * cy[i]) * inv + cxi;
+            const double v = fy * cy[i] * inv + cyi;
+            if (u < uMin) uMin = u;
+            if (u > uMax) uMax = u;
+            if (v < vMin) vMin = v;
+            if (v > vMax) vMax = v;
+            if (cz[i] < dMin) dMin = cz[i];
+        }
+        if (front == 0) {
+            r.uMin = r.vMin = r.uMax = r.vMax = 0.0;
+            r.minDepth = 0.0;
+            r.visibility = BOX_BEHIND;
+            continue;
+        }
+        if (front < 8) {
+            // Edges crossing the near plane add their intersection point.
+            for (int e = 0; e < 12; ++e) {
+                const int a = kEdges[e][0], c = kEdges[e][1];
+                if ((cz[a] < nearPlane) == (cz[c] < nearPlane)) continue;
+                const double t = (nearPlane - cz[a]) / (cz[c] - cz[a]);
+                const double x = cx[a] + t * (cx[c] - cx[a]);
+                const double y = cy[a] + t * (cy[c] - cy[a]);
+                const double u = (fx * x + s * y) / nearPlane + cxi;
+                const double v = fy * y / nearPlane + cyi;
+                if (u < uMin) uMin = u;
+                if (u > uMax) uMax = u;
+                if (v < vMin) vMin = v;
+                if (v > vMax) vMax = v;
+            }
+            dMin = nearPlane;
+        }
+        r.minDepth = dMin;
+        r.uMin = uMin < 0.0 ? 0.0 : uMin;
+        r.vMin = vMin < 0.0 ? 0.0 : vMin;
+        r.uMax = uMax > w ? w : uMax;
+        r.vMax = vMax > h ? h : vMax;
+        if (r.uMin >= r.uMax || r.vMin >= r.vMax) {
+            r.visibility = BOX_OUTSIDE_IMAGE;
+            continue;
+        }
+        r.visibility = front == 8 ? BOX_IN_FRONT : BOX_CLIPPED;
+        ++visible;
+    }
+    return visible;
+}
+
+} // namespace AdasTools
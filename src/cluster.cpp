@@ -0,0 +1,496 @@
+/* *******************************************************************************
+ * File: src/cluster.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Grid-accelerated Euclidean clustering. Cells have side
+ *              tolerance / sqrt(3), so each cell is connected internally and
+ *              linked neighbours differ by at most 2 in every index. Cells are
+ *              radix-sorted by a linear key; a neighbour at offset (dx, dy, dz)
+ *              is then key + constant, so every neighbour column is found by a
+ *              monotone pointer walk instead of hash lookups. Union-find links
+ *              larger roots under smaller ones, which makes the final roots
+ *              (and cluster order) independent of the linking order.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "cluster.hpp"
+#include "arena.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+#include <math.h>
+#include <stdlib.h>
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kAlign = 64;
+const unsigned kRadixBits = 11;
+const size_t kBoxesPerTask = 16;
+const unsigned kMixed = 0xFFFFFFFFu;
+
+// Forward column offsets (dx, dy) of the 5x5 neighbourhood, adjacent ones first.
+const size_t kColumns = 12;
+const size_t kNearColumns = 4;
+const long long kColumnDx[kColumns] = { 0, 1, 1, 1, 0, 1, 1, 2, 2, 2, 2, 2 };
+const long long kColumnDy[kColumns] = { 1, -1, 0, 1, 2, -2, 2, -2, -1, 0, 1, 2 };
+
+size_t alignUp(size_t v) { return (v + (kAlign - 1)) & ~(kAlign - 1); }
+
+// Bits lo..hi of a 64-bit segment mask, clipped to [0, 63].
+unsigned long long bitRange(int lo, int hi)
+{
+    lo = lo < 0 ? 0 : lo;
+    hi = hi > 63 ? 63 : hi;
+    if (lo > hi) return 0;
+    return (~0ull >> (63 - hi)) & (~0ull << lo);
+}
+
+// Cells are grouped into column segments of 64 z levels; a segment's cells
+// are contiguous and its occupancy is one mask, so the neighbours of a cell
+// in another segment are a mask AND and a popcount away.
+struct Grid {
+    const float *xs, *ys, *zs;                 // points sorted by cell, relative to the cloud minimum
+    const unsigned *cellStart;                 // cells + 1 entries
+    const float *bbox;                         // 6 per cell: min xyz, max xyz
+    const unsigned char *cellBit;              // z level of the cell within its segment
+    const unsigned long long *segKey;          // (column, z / 64), ascending
+    const unsigned long long *segMask;         // occupied z levels of the segment
+    const unsigned *segFirst;                  // first cell of each segment (segments + 1 entries)
+    unsigned long long columnOffset[kColumns]; // segment-key distance of each column offset
+    unsigned long long segmentsPerColumn;
+    unsigned *parent;                          // union-find over cells
+    unsigned *segRoot;                         // root shared by all cells of a segment after pass 0, else kMixed
+    float tol2;
+};
+
+unsigned findRoot(unsigned *parent, unsigned c)
+{
+    while (parent[c] != c) {
+        parent[c] = parent[parent[c]];
+        c = parent[c];
+    }
+    return c;
+}
+
+bool cellsTouch(const Grid &g, unsigned a, unsigned b)
+{
+    const float *ba = g.bbox + 6 * (size_t)a, *bb = g.bbox + 6 * (size_t)b;
+    float gap2 = 0.0f;
+    for (int k = 0; k < 3; ++k) {
+        float gap = ba[k] - bb[3 + k];
+        const float other = bb[k] - ba[3 + k];
+        gap = gap > other ? gap : other;
+        gap = gap > 0.0f ? gap : 0.0f;
+        gap2 += gap * gap;
+    }
+    if (gap2 > g.tol2) return false;
+    for (unsigned i = g.cellStart[a]; i < g.cellStart[a + 1]; ++i) {
+        const float px = g.xs[i], py = g.ys[i], pz = g.zs[i];
+        for (unsigned j = g.cellStart[b]; j < g.cellStart[b + 1]; ++j) {
+            const float dx = px - g.xs[j], dy = py - g.ys[j], dz = pz - g.zs[j];
+            if (dx * dx + dy * dy + dz * dz <= g.tol2) return true;
+        }
+    }
+    return false;
+}
+
+// Union cell c (current root ra) with the cells of segment seg selected by bits.
+void linkCandidates(Grid &g, unsigned c, unsigned &ra, size_t seg, unsigned long long bits)
+{
+    const unsigned long long mask = g.segMask[seg];
+    bits &= mask;
+    while (bits) {
+        const int j = __builtin_ctzll(bits);
+        bits &= bits - 1;
+        const unsigned p = g.segFirst[seg] + (unsigned)__builtin_popcountll(mask & ((1ull << j) - 1));
+        const unsigned rb = findRoot(g.parent, p);
+        if (ra == rb || !cellsTouch(g, c, p)) continue;
+        if (ra < rb) {
+            g.parent[rb] = ra;
+        } else {
+            g.parent[ra] = rb;
+            ra = rb;
+        }
+    }
+}
+
+// Link the cells of segments [sb, se) with their forward neighbours in
+// segments [nb, ne). Pass 0 covers offsets with |d| <= 1, pass 1 the rest; by
+// pass 1 most of the 2-apart pairs already share a root and cost no point test.
+void linkSegments(Grid &g, int pass, size_t sb, size_t se, size_t nb, size_t ne, bool ownColumn)
+{
+    const size_t columns = pass == 0 ? kNearColumns : kColumns;
+    const int step = pass == 0 ? 1 : 2;
+    size_t ptr[kColumns], first[kColumns], last[kColumns];
+    for (size_t k = 0; k < columns; ++k) ptr[k] = nb;
+    for (size_t s = sb; s < se; ++s) {
+        const unsigned long long key = g.segKey[s];
+        // segments z/64 - 1 .. z/64 + 1 of each neighbour column (clipped to the column)
+        const unsigned long long segment = key % g.segmentsPerColumn;
+        const unsigned long long below = segment > 0 ? 1 : 0, above = segment + 1 < g.segmentsPerColumn ? 1 : 0;
+        for (size_t k = 0; k < columns; ++k) {
+            const unsigned long long lo = key + g.columnOffset[k] - below, hi = key + g.columnOffset[k] + above;
+            size_t p = ptr[k];
+            while (p < ne && g.segKey[p] < lo) ++p;
+            ptr[k] = first[k] = p;
+            while (p < ne && g.segKey[p] <= hi) ++p;
+            last[k] = p;
+        }
+        const bool nextSegment = ownColumn && s + 1 < se && g.segKey[s + 1] == key + 1;
+        if (pass == 1 && g.segRoot[s] != kMixed) {
+            // Whole neighbourhood already one component: nothing left to link.
+            const unsigned r = findRoot(g.parent, g.segRoot[s]);
+            bool merged = !nextSegment || (g.segRoot[s + 1] != kMixed && findRoot(g.parent, g.segRoot[s + 1]) == r);
+            for (size_t k = 0; k < columns && merged; ++k) {
+                for (size_t t = first[k]; t < last[k] && merged; ++t) {
+                    merged = g.segRoot[t] != kMixed && findRoot(g.parent, g.segRoot[t]) == r;
+                }
+            }
+            if (merged) continue;
+        }
+        for (unsigned c = g.segFirst[s]; c < g.segFirst[s + 1]; ++c) {
+            const int b = g.cellBit[c];
+            unsigned ra = findRoot(g.parent, c);
+            if (ownColumn) {
+                linkCandidates(g, c, ra, s, bitRange(b + step, b + step));
+                if (nextSegment && b + step >= 64) linkCandidates(g, c, ra, s + 1, bitRange(b + step - 64, b + step - 64));
+            }
+            for (size_t k = 0; k < columns; ++k) {
+                for (size_t t = first[k]; t < last[k]; ++t) {
+                    const int base = b - 64 * (int)(long long)(g.segKey[t] - (key + g.columnOffset[k]));
+                    unsigned long long bits;
+                    if (pass == 0) bits = bitRange(base - 1, base + 1);
+                    else if (k < kNearColumns) bits = bitRange(base - 2, base - 2) | bitRange(base + 2, base + 2);
+                    else bits = bitRange(base - 2, base + 2);
+                    if ((bits & g.segMask[t]) && g.segRoot[t] != ra) linkCandidates(g, c, ra, t, bits);
+                }
+            }
+        }
+    }
+}
+
+void markSegmentRoots(Grid &g, size_t sb, size_t se)
+{
+    for (size_t s = sb; s < se; ++s) {
+        unsigned r = findRoot(g.parent, g.segFirst[s]);
+        for (unsigned c = g.segFirst[s] + 1; c < g.segFirst[s + 1] && r != kMixed; ++c) {
+            if (findRoot(g.parent, c) != r) r = kMixed;
+        }
+        g.segRoot[s] = r;
+    }
+}
+
+struct TileJob {
+    Grid *grid;
+    const unsigned *tileStart;
+
+    void operator()(size_t t)
+    {
+        const size_t sb = tileStart[t], se = tileStart[t + 1];
+        linkSegments(*grid, 0, sb, se, sb, se, true);
+        markSegmentRoots(*grid, sb, se);
+        linkSegments(*grid, 1, sb, se, sb, se, true);
+    }
+};
+
+struct BoxJob {
+    const Point3 *points;
+    const unsigned *members;
+    PointCluster *clusters;
+    size_t count;
+    bool fitYaw;
+
+    void operator()(size_t task)
+    {
+        const size_t last = (task + 1) * kBoxesPerTask < count ? (task + 1) * kBoxesPerTask : count;
+        for (size_t c = task * kBoxesPerTask; c < last; ++c) fit(clusters[c]);
+    }
+
+    void fit(PointCluster &cl) const
+    {
+        const unsigned *m = members + cl.firstMember;
+        const size_t n = cl.memberCount;
+        double sx = 0.0, sy = 0.0, sz = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sx += points[m[i]].x;
+            sy += points[m[i]].y;
+            sz += points[m[i]].z;
+        }
+        const double inv = 1.0 / (double)n;
+        const double cx = sx * inv, cy = sy * inv, cz = sz * inv;
+        double yaw = 0.0;
+        if (fitYaw) {
+            double cxx = 0.0, cxy = 0.0, cyy = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                const double x = points[m[i]].x - cx, y = points[m[i]].y - cy;
+                cxx += x * x;
+                cxy += x * y;
+                cyy += y * y;
+            }
+            yaw = 0.5 * atan2(2.0 * cxy, cxx - cyy);
+        }
+        const double c = cos(yaw), s = sin(yaw);
+        double uMin = 1e300, uMax = -1e300, vMin = 1e300, vMax = -1e300, zMin = 1e300, zMax = -1e300;
+        for (size_t i = 0; i < n; ++i) {
+            const double x = points[m[i]].x - cx, y = points[m[i]].y - cy, z = points[m[i]].z;
+            const double u = c * x + s * y, v = -s * x + c * y;
+            uMin = u < uMin ? u : uMin; uMax = u > uMax ? u : uMax;
+            vMin = v < vMin ? v : vMin; vMax = v > vMax ? v : vMax;
+            zMin = z < zMin ? z : zMin; zMax = z > zMax ? z : zMax;
+        }
+        const double um = 0.5 * (uMin + uMax), vm = 0.5 * (vMin + vMax);
+        cl.centroid = Point3{ cx, cy, cz };
+        cl.box.center = Pose{ cx + c * um - s * vm, cy + s * um + c * vm, 0.5 * (zMin + zMax), 0.0, 0.0, yaw };
+        cl.box.size = Point3{ uMax - uMin, vMax - vMin, zMax - zMin };
+    }
+};
+
+// LSD radix sort of (key, value) pairs on the low `bits` bits of key.
+void radixSort(unsigned long long *&keys, unsigned *&values, unsigned long long *tmpKeys, unsigned *tmpValues,
+               size_t n, unsigned bits)
+{
+    const size_t buckets = (size_t)1 << kRadixBits;
+    size_t count[(size_t)1 << kRadixBits];
+    for (unsigned shift = 0; shift < bits; shift += kRadixBits) {
+        for (size_t b = 0; b < buckets; ++b) count[b] = 0;
+        for (size_t i = 0; i < n; ++i) ++count[(keys[i] >> shift) & (buckets - 1)];
+        size_t sum = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            const size_t c = count[b];
+            count[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const size_t dst = count[(keys[i] >> shift) & (buckets - 1)]++;
+            tmpKeys[dst] = keys[i];
+            tmpValues[dst] = values[i];
+        }
+        unsigned long long *k = keys; keys = tmpKeys; tmpKeys = k;
+        unsigned *v = values; values = tmpValues; tmpValues = v;
+    }
+}
+
+size_t clusterImpl(const Point3 *points, const unsigned *indices, size_t n, const ClusterConfig &config,
+                   unsigned *labels, PointCluster *clusters, size_t maxClusters, unsigned *members,
+                   FrameArena *scratch, TaskPool *pool, bool &ok)
+{
+    ok = true;
+    if (labels) {
+        for (size_t i = 0; i < n; ++i) labels[i] = kClusterNoise;
+    }
+    if (n == 0) return 0;
+    if (!(config.tolerance > 0.0) || n > 0xFFFFFFFEu) {
+        ok = false;
+        return 0;
+    }
+
+    // Bounds of the finite points
+    double minX = 1e300, minY = 1e300, minZ = 1e300, maxX = -1e300, maxY = -1e300, maxZ = -1e300;
+    for (size_t i = 0; i < n; ++i) {
+        const Point3 &p = points[indices ? indices[i] : i];
+        if (!(fabs(p.x) < 1e30 && fabs(p.y) < 1e30 && fabs(p.z) < 1e30)) continue;
+        minX = p.x < minX ? p.x : minX; maxX = p.x > maxX ? p.x : maxX;
+        minY = p.y < minY ? p.y : minY; maxY = p.y > maxY ? p.y : maxY;
+        minZ = p.z < minZ ? p.z : minZ; maxZ = p.z > maxZ ? p.z : maxZ;
+    }
+    if (minX > maxX) return 0;
+    const double side = config.tolerance / sqrt(3.0) * (1.0 - 1e-6);
+    const double invSide = 1.0 / side;
+    // Two empty cells of padding on each side keep key + offset from wrapping.
+    const double nxD = floor((maxX - minX) * invSide) + 5.0;
+    const double nyD = floor((maxY - minY) * invSide) + 5.0;
+    const double nzD = floor((maxZ - minZ) * invSide) + 5.0;
+    if (nxD * nyD * nzD > 4.0e18) {
+        ok = false;
+        return 0;
+    }
+    const unsigned long long NY = (unsigned long long)nyD, NZ = (unsigned long long)nzD;
+    const unsigned long long maxKey = (unsigned long long)nxD * NY * NZ;
+    unsigned keyBits = 0;
+    while (keyBits < 64 && (maxKey >> keyBits) != 0) ++keyBits;
+
+    if (!scratch) scratch = threadScratchArena();
+    const size_t bytes = clusterScratchBytes(n);
+    const size_t marker = scratch ? scratch->mark() : 0;
+    char *block = scratch ? (char *)scratch->allocate(bytes, kAlign) : (char *)malloc(bytes);
+    if (!block) {
+        ok = false;
+        return 0;
+    }
+    char *cursor = (char *)(((size_t)block + (kAlign - 1)) & ~(kAlign - 1));
+    auto take = [&cursor](size_t size) { char *p = cursor; cursor += alignUp(size); return p; };
+    unsigned long long *keys = (unsigned long long *)take(n * 8);
+    unsigned long long *tmpKeys = (unsigned long long *)take(n * 8);
+    unsigned *order = (unsigned *)take(n * 4);
+    unsigned *tmpOrder = (unsigned *)take(n * 4);
+    float *xs = (float *)take(n * 4);
+    float *ys = (float *)take(n * 4);
+    float *zs = (float *)take(n * 4);
+    unsigned char *cellBit = (unsigned char *)take(n);
+    unsigned *cellStart = (unsigned *)take((n + 1) * 4);
+    unsigned long long *segKey = (unsigned long long *)take(n * 8);
+    unsigned long long *segMask = (unsigned long long *)take(n * 8);
+    unsigned *segFirst = (unsigned *)take((n + 1) * 4);
+    unsigned *segRoot = (unsigned *)take(n * 4);
+    float *bbox = (float *)take(n * 24);
+    unsigned *parent = (unsigned *)take(n * 4);
+    unsigned *sizes = (unsigned *)take(n * 4);
+    unsigned *tileStart = (unsigned *)take((n + 1) * 4);
+    unsigned *memberOut = members ? members : (unsigned *)take(n * 4);
+
+    size_t m = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Point3 &p = points[indices ? indices[i] : i];
+        if (!(fabs(p.x) < 1e30 && fabs(p.y) < 1e30 && fabs(p.z) < 1e30)) continue;
+        const unsigned long long ix = (unsigned long long)((p.x - minX) * invSide) + 2;
+        const unsigned long long iy = (unsigned long long)((p.y - minY) * invSide) + 2;
+        const unsigned long long iz = (unsigned long long)((p.z - minZ) * invSide) + 2;
+        keys[m] = (ix * NY + iy) * NZ + iz;
+        order[m] = (unsigned)i;
+        ++m;
+    }
+    radixSort(keys, order, tmpKeys, tmpOrder, m, keyBits);
+
+    // Cells = runs of equal keys, grouped into 64-level column segments;
+    // sorted SoA copy and per-cell bounds
+    const unsigned long long NSEG = (NZ + 63) / 64;
+    size_t cells = 0, segments = 0;
+    for (size_t i = 0; i < m; ++i) {
+        const Point3 &p = points[indices ? indices[order[i]] : order[i]];
+        const float x = (float)(p.x - minX), y = (float)(p.y - minY), z = (float)(p.z - minZ);
+        xs[i] = x; ys[i] = y; zs[i] = z;
+        if (i == 0 || keys[i] != keys[i - 1]) {
+            const unsigned long long iz = keys[i] % NZ;
+            const unsigned long long sk = keys[i] / NZ * NSEG + iz / 64;
+            if (segments == 0 || segKey[segments - 1] != sk) {
+                segKey[segments] = sk;
+                segMask[segments] = 0;
+                segRoot[segments] = kMixed;
+                segFirst[segments] = (unsigned)cells;
+                ++segments;
+            }
+            segMask[segments - 1] |= 1ull << (iz % 64);
+            cellBit[cells] = (unsigned char)(iz % 64);
+            cellStart[cells] = (unsigned)i;
+            float *b = bbox + 6 * cells;
+            b[0] = b[3] = x; b[1] = b[4] = y; b[2] = b[5] = z;
+            parent[cells] = (unsigned)cells;
+            ++cells;
+        } else {
+            float *b = bbox + 6 * (cells - 1);
+            b[0] = x < b[0] ? x : b[0]; b[3] = x > b[3] ? x : b[3];
+            b[1] = y < b[1] ? y : b[1]; b[4] = y > b[4] ? y : b[4];
+            b[2] = z < b[2] ? z : b[2]; b[5] = z > b[5] ? z : b[5];
+        }
+    }
+    cellStart[cells] = (unsigned)m;
+    segFirst[segments] = (unsigned)cells;
+
+    Grid grid;
+    grid.xs = xs; grid.ys = ys; grid.zs = zs;
+    grid.cellStart = cellStart;
+    grid.bbox = bbox;
+    grid.cellBit = cellBit;
+    grid.segKey = segKey;
+    grid.segMask = segMask;
+    grid.segFirst = segFirst;
+    for (size_t k = 0; k < kColumns; ++k) {
+        grid.columnOffset[k] = (unsigned long long)(kColumnDx[k] * (long long)NY + kColumnDy[k]) * NSEG;
+    }
+    grid.segmentsPerColumn = NSEG;
+    grid.parent = parent;
+    grid.segRoot = segRoot;
+    grid.tol2 = (float)(config.tolerance * config.tolerance);
+
+    // Tiles: runs of segments whose x index falls in the same tile of W >= 2 columns
+    const unsigned long long plane = NY * NSEG;
+    unsigned long long tileWidth = (unsigned long long)(config.tileSize * invSide);
+    if (tileWidth < 2) tileWidth = 2;
+    size_t tiles = 0;
+    for (size_t s = 0; s < segments; ++s) {
+        if (s == 0 || segKey[s] / plane / tileWidth != segKey[s - 1] / plane / tileWidth) tileStart[tiles++] = (unsigned)s;
+    }
+    tileStart[tiles] = (unsigned)segments;
+    TileJob tileJob{ &grid, tileStart };
+    (pool ? pool : defaultTaskPool())->parallelFor(tiles, tileJob);
+
+    // Seams: segments within 2 columns of a tile's end against everything after it
+    for (size_t t = 0; t + 1 < tiles; ++t) {
+        const size_t te = tileStart[t + 1];
+        const unsigned long long seam = (segKey[te - 1] / plane / tileWidth + 1) * tileWidth - 2;
+        size_t sb = te;
+        while (sb > tileStart[t] && segKey[sb - 1] / plane >= seam) --sb;
+        for (int pass = 0; pass < 2; ++pass) linkSegments(grid, pass, sb, te, te, segments, false);
+    }
+
+    // Roots are the smallest cell of each component; number them in cell order.
+    for (size_t c = 0; c < cells; ++c) sizes[c] = 0;
+    for (size_t c = 0; c < cells; ++c) {
+        parent[c] = findRoot(parent, (unsigned)c);
+        sizes[parent[c]] += cellStart[c + 1] - cellStart[c];
+    }
+    size_t clusterCount = 0, memberTotal = 0;
+    for (size_t c = 0; c < cells; ++c) {
+        if (parent[c] != c) continue;
+        if (sizes[c] < config.minPoints || sizes[c] > config.maxPoints || clusterCount >= maxClusters) {
+            sizes[c] = kClusterNoise;
+            continue;
+        }
+        clusters[clusterCount].firstMember = (unsigned)memberTotal;
+        clusters[clusterCount].memberCount = 0;
+        memberTotal += sizes[c];
+        sizes[c] = (unsigned)clusterCount++;
+    }
+    for (size_t c = 0; c < cells; ++c) {
+        const unsigned id = sizes[parent[c]];
+        if (id == kClusterNoise) continue;
+        PointCluster &cl = clusters[id];
+        for (unsigned i = cellStart[c]; i < cellStart[c + 1]; ++i) {
+            memberOut[cl.firstMember + cl.memberCount++] = indices ? indices[order[i]] : order[i];
+            if (labels) labels[order[i]] = id;
+        }
+    }
+
+    BoxJob boxJob{ points, memberOut, clusters, clusterCount, config.fitYaw };
+    (pool ? pool : defaultTaskPool())->parallelFor((clusterCount + kBoxesPerTask - 1) / kBoxesPerTask, boxJob);
+
+    if (scratch) scratch->rewind(marker);
+    else free(block);
+    return clusterCount;
+}
+
+} // namespace
+
+size_t clusterScratchBytes(size_t n)
+{
+    return 4 * alignUp(n * 8) + 9 * alignUp(n * 4) + 3 * alignUp((n + 1) * 4) + alignUp(n * 24) + alignUp(n) + kAlign;
+}
+
+size_t clusterPoints(const Point3 *points, size_t n, const ClusterConfig &config,
+                     unsigned int *labels, PointCluster *clusters, size_t maxClusters,
+                     unsigned int *members, FrameArena *scratch, TaskPool *pool, bool *ok)
+{
+    ADAS_PROFILE_SCOPE(PROBE_CLUSTER_POINTS, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_USER, "clusterPoints");
+    bool status;
+    const size_t count = clusterImpl(points, nullptr, n, config, labels, clusters, maxClusters, members, scratch, pool, status);
+    if (ok) *ok = status;
+    return count;
+}
+
+size_t clusterPointSubset(const Point3 *points, const unsigned int *indices, size_t count, const ClusterConfig &config,
+                          unsigned int *labels, PointCluster *clusters, size_t maxClusters,
+                          unsigned int *members, FrameArena *scratch, TaskPool *pool, bool *ok)
+{
+    ADAS_PROFILE_SCOPE(PROBE_CLUSTER_POINTS, count);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_USER, "clusterPointSubset");
+    bool status;
+    const size_t clusterCount =
+        clusterImpl(points, indices, count, config, labels, clusters, maxClusters, members, scratch, pool, status);
+    if (ok) *ok = status;
+    return clusterCount;
+}
+
+} // namespace AdasTools
@@ -0,0 +1,309 @@
+/* *******************************************************************************
+ * File: src/compact.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Compact point encode/decode. Points are treated as flat
+ *              arrays of 3n values; the AVX2 kernels convert 4 points
+ *              (three 4-lane vectors) per step with the per-axis offset and
+ *              scale laid out as three repeating lane patterns. Half floats
+ *              use F16C when present and exact bit manipulation otherwise.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "compact.hpp"
+#include "instrumentation.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ADAS_COMPACT_HAVE_AVX2 1
+#endif
+
+namespace AdasTools {
+
+static_assert(sizeof(PointI16) == 3 * sizeof(short), "PointI16 must be packed");
+static_assert(sizeof(PointF16) == 3 * sizeof(unsigned short), "PointF16 must be packed");
+static_assert(sizeof(Point3) == 3 * sizeof(double), "Point3 must be packed");
+
+namespace {
+
+const size_t kChunk = 256; // points decoded per step of the fused kernels (6 KB, stays in L1)
+
+void scalarDecodeI16(const short *v, size_t first, size_t points, const double o[3], const double s[3], double *out)
+{
+    for (size_t i = first; i < points; ++i) {
+        for (int k = 0; k < 3; ++k) out[3 * i + k] = o[k] + s[k] * (double)v[3 * i + k];
+    }
+}
+
+void scalarDecodeF16(const unsigned short *v, size_t first, size_t points, const double o[3], const double s[3], double *out)
+{
+    for (size_t i = first; i < points; ++i) {
+        for (int k = 0; k < 3; ++k) out[3 * i + k] = o[k] + s[k] * (double)halfToFloat(v[3 * i + k]);
+    }
+}
+
+#if defined(ADAS_COMPACT_HAVE_AVX2)
+
+bool cpuHasAvx2Fma()
+{
+    static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return ok;
+}
+
+bool cpuHasF16c()
+{
+    static const bool ok = cpuHasAvx2Fma() && __builtin_cpu_supports("f16c");
+    return ok;
+}
+
+// Lane patterns for 4 interleaved points: (x y z x) (y z x y) (z x y z).
+struct AxisPatterns {
+    double v[3][4];
+};
+
+AxisPatterns makePatterns(const double a[3])
+{
+    AxisPatterns p;
+    for (int r = 0; r < 3; ++r) {
+        for (int l = 0; l < 4; ++l) p.v[r][l] = a[(4 * r + l) % 3];
+    }
+    return p;
+}
+
+__attribute__((target("avx2,fma")))
+size_t decodeI16Avx2(const short *v, size_t points, const double o[3], const double s[3], double *out)
+{
+    const AxisPatterns op = makePatterns(o), sp = makePatterns(s);
+    const __m256d o0 = _mm256_loadu_pd(op.v[0]), o1 = _mm256_loadu_pd(op.v[1]), o2 = _mm256_loadu_pd(op.v[2]);
+    const __m256d s0 = _mm256_loadu_pd(sp.v[0]), s1 = _mm256_loadu_pd(sp.v[1]), s2 = _mm256_loadu_pd(sp.v[2]);
+    size_t i = 0;
+    for (; i + 4 <= points; i += 4) {
+        const short *p = v + 3 * i;
+        double *d = out + 3 * i;
+        const __m256d a = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(p + 0))));
+        const __m256d b = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(p + 4))));
+        const __m256d c = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(p + 8))));
+        _mm256_storeu_pd(d + 0, _mm256_fmadd_pd(a, s0, o0));
+        _mm256_storeu_pd(d + 4, _mm256_fmadd_pd(b, s1, o1));
+        _mm256_storeu_pd(d + 8, _mm256_fmadd_pd(c, s2, o2));
+    }
+    return i;
+}
+
+__attribute__((target("avx2,fma,f16c")))
+size_t decodeF16Avx2(const unsigned short *v, size_t points, const double o[3], const double s[3], double *out)
+{
+    const AxisPatterns op = makePatterns(o), sp = makePatterns(s);
+    const __m256d o0 = _mm256_loadu_pd(op.v[0]), o1 = _mm256_loadu_pd(op.v[1]), o2 = _mm256_loadu_pd(op.v[2]);
+    const __m256d s0 = _mm256_loadu_pd(sp.v[0]), s1 = _mm256_loadu_pd(sp.v[1]), s2 = _mm256_loadu_pd(sp.v[2]);
+    size_t i = 0;
+    for (; i + 4 <= points; i += 4) {
+        const unsigned short *p = v + 3 * i;
+        double *d = out + 3 * i;
+        const __m256d a = _mm256_cvtps_pd(_mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(p + 0))));
+        const __m256d b = _mm256_cvtps_pd(_mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(p + 4))));
+        const __m256d c = _mm256_cvtps_pd(_mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(p + 8))));
+        _mm256_storeu_pd(d + 0, _mm256_fmadd_pd(a, s0, o0));
+        _mm256_storeu_pd(d + 4, _mm256_fmadd_pd(b, s1, o1));
+        _mm256_storeu_pd(d + 8, _mm256_fmadd_pd(c, s2, o2));
+    }
+    return i;
+}
+
+// (value - offset) / scale rounded to float, then to half (same two roundings as the scalar path).
+__attribute__((target("avx2,fma,f16c")))
+size_t encodeF16Avx2(const double *in, size_t points, const double o[3], const double inv[3], unsigned short *v)
+{
+    const AxisPatterns op = makePatterns(o), ip = makePatterns(inv);
+    size_t i = 0;
+    for (; i + 4 <= points; i += 4) {
+        for (int r = 0; r < 3; ++r) {
+            const __m256d x = _mm256_loadu_pd(in + 3 * i + 4 * r);
+            const __m256d y = _mm256_mul_pd(_mm256_sub_pd(x, _mm256_loadu_pd(op.v[r])), _mm256_loadu_pd(ip.v[r]));
+            const __m128i h = _mm_cvtps_ph(_mm256_cvtpd_ps(y), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storel_epi64((__m128i *)(v + 3 * i + 4 * r), h);
+        }
+    }
+    return i;
+}
+
+#endif
+
+void decodeI16(const short *v, size_t points, const double o[3], const double s[3], double *out)
+{
+    size_t i = 0;
+#if defined(ADAS_COMPACT_HAVE_AVX2)
+    if (cpuHasAvx2Fma()) i = decodeI16Avx2(v, points, o, s, out);
+#endif
+    scalarDecodeI16(v, i, points, o, s, out);
+}
+
+void decodeF16(const unsigned short *v, size_t points, const double o[3], const double s[3], double *out)
+{
+    size_t i = 0;
+#if defined(ADAS_COMPACT_HAVE_AVX2)
+    if (cpuHasF16c()) i = decodeF16Avx2(v, points, o, s, out);
+#endif
+    scalarDecodeF16(v, i, points, o, s, out);
+}
+
+// m * (offset + diag(scale) * x) as one affine matrix acting on the raw values.
+void foldQuantization(const double m[16], const PointQuantization &q, double out[16])
+{
+    const double s[3] = { q.scale.x, q.scale.y, q.scale.z };
+    for (int r = 0; r < 3; ++r) {
+        const double *row = m + 4 * r;
+        for (int c = 0; c < 3; ++c) out[4 * r + c] = row[c] * s[c];
+        out[4 * r + 3] = row[0] * q.offset.x + row[1] * q.offset.y + row[2] * q.offset.z + row[3];
+    }
+    out[12] = 0.0; out[13] = 0.0; out[14] = 0.0; out[15] = 1.0;
+}
+
+} // namespace
+
+float halfToFloat(unsigned short h)
+{
+    const unsigned sign = (unsigned)(h & 0x8000u) << 16;
+    const unsigned exp = (h >> 10) & 0x1fu;
+    const unsigned mant = h & 0x3ffu;
+    if (exp == 0) {
+        const float f = (float)mant * 5.9604644775390625e-8f; // 2^-24, exact
+        return sign ? -f : f;
+    }
+    const unsigned bits = exp == 31 ? (sign | 0x7f800000u | (mant << 13)) : (sign | ((exp + 112u) << 23) | (mant << 13));
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+unsigned short floatToHalf(float f)
+{
+    unsigned x;
+    memcpy(&x, &f, sizeof(x));
+    const unsigned sign = (x >> 16) & 0x8000u;
+    const unsigned a = x & 0x7fffffffu;
+    if (a >= 0x7f800000u) return (unsigned short)(sign | 0x7c00u | (a > 0x7f800000u ? 0x200u : 0u)); // inf / NaN
+    if (a >= 0x477ff000u) return (unsigned short)(sign | 0x7c00u);                                     // rounds past 65504
+    if (a < 0x38800000u) {                                                                             // half subnormal
+        const unsigned e = a >> 23;
+        if (e < 102) return (unsigned short)sign;
+        const unsigned mant = (a & 0x7fffffu) | 0x800000u;
+        const unsigned shift = 126 - e;
+        unsigned h = mant >> shift;
+        const unsigned rem = mant & ((1u << shift) - 1u), half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1u))) ++h;
+        return (unsigned short)(sign | h);
+    }
+    unsigned h = (((a >> 23) - 112u) << 10) | ((a & 0x7fffffu) >> 13);
+    const unsigned rem = a & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) ++h; // a carry rolls into the exponent correctly
+    return (unsigned short)(sign | h);
+}
+
+PointQuantization quantizationForResolution(const Point3 &origin, double resolution)
+{
+    PointQuantization q;
+    q.offset = origin;
+    q.scale = Point3{ resolution, resolution, resolution };
+    return q;
+}
+
+PointQuantization quantizationForBounds(const Point3 &lo, const Point3 &hi)
+{
+    PointQuantization q;
+    q.offset = Point3{ 0.5 * (lo.x + hi.x), 0.5 * (lo.y + hi.y), 0.5 * (lo.z + hi.z) };
+    const double sx = 0.5 * (hi.x - lo.x) / 32767.0, sy = 0.5 * (hi.y - lo.y) / 32767.0, sz = 0.5 * (hi.z - lo.z) / 32767.0;
+    q.scale = Point3{ sx > 1e-12 ? sx : 1e-12, sy > 1e-12 ? sy : 1e-12, sz > 1e-12 ? sz : 1e-12 };
+    return q;
+}
+
+size_t encodePointsI16(const Point3 *in, size_t n, const PointQuantization &q, PointI16 *out)
+{
+    ADAS_PROFILE_SCOPE(PROBE_COMPACT_ENCODE, n);
+    if (n == 0) return 0;
+    const double o[3] = { q.offset.x, q.offset.y, q.offset.z };
+    const double inv[3] = { 1.0 / q.scale.x, 1.0 / q.scale.y, 1.0 / q.scale.z };
+    const double *src = &in[0].x;
+    short *dst = &out[0].x;
+    size_t clamped = 0;
+    for (size_t i = 0; i < n; ++i) {
+        bool clip = false;
+        for (int k = 0; k < 3; ++k) {
+            double v = nearbyint((src[3 * i + k] - o[k]) * inv[k]);
+            if (!(v >= -32767.0)) { v = -32767.0; clip = true; } // also catches NaN
+            if (v > 32767.0) { v = 32767.0; clip = true; }
+            dst[3 * i + k] = (short)v;
+        }
+        clamped += clip;
+    }
+    return clamped;
+}
+
+void decodePointsI16(const PointI16 *in, size_t n, const PointQuantization &q, Point3 *out)
+{
+    ADAS_PROFILE_SCOPE(PROBE_COMPACT_DECODE, n);
+    if (n == 0) return;
+    const double o[3] = { q.offset.x, q.offset.y, q.offset.z };
+    const double s[3] = { q.scale.x, q.scale.y, q.scale.z };
+    decodeI16(&in[0].x, n, o, s, &out[0].x);
+}
+
+void encodePointsF16(const Point3 *in, size_t n, const PointQuantization &q, PointF16 *out)
+{
+    ADAS_PROFILE_SCOPE(PROBE_COMPACT_ENCODE, n);
+    if (n == 0) return;
+    const double o[3] = { q.offset.x, q.offset.y, q.offset.z };
+    const double inv[3] = { 1.0 / q.scale.x, 1.0 / q.scale.y, 1.0 / q.scale.z };
+    const double *src = &in[0].x;
+    unsigned short *dst = &out[0].x;
+    size_t i = 0;
+#if defined(ADAS_COMPACT_HAVE_AVX2)
+    if (cpuHasF16c()) i = encodeF16Avx2(src, n, o, inv, dst);
+#endif
+    for (; i < n; ++i) {
+        for (int k = 0; k < 3; ++k) dst[3 * i + k] = floatToHalf((float)((src[3 * i + k] - o[k]) * inv[k]));
+    }
+}
+
+void decodePointsF16(const PointF16 *in, size_t n, const PointQuantization &q, Point3 *out)
+{
+    ADAS_PROFILE_SCOPE(PROBE_COMPACT_DECODE, n);
+    if (n == 0) return;
+    const double o[3] = { q.offset.x, q.offset.y, q.offset.z };
+    const double s[3] = { q.scale.x, q.scale.y, q.scale.z };
+    decodeF16(&in[0].x, n, o, s, &out[0].x);
+}
+
+void rigidTransformPointsI16(const double m[16], const PointI16 *in, size_t n, const PointQuantization &q, Point3 *out)
+{
+    ADAS_PROFILE_SCOPE(PROBE_COMPACT_TRANSFORM, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "rigidTransformPointsI16");
+    double f[16];
+    foldQuantization(m, q, f);
+    const double zero[3] = { 0.0, 0.0, 0.0 }, one[3] = { 1.0, 1.0, 1.0 };
+    for (size_t base = 0; base < n; base += kChunk) {
+        const size_t k = n - base < kChunk ? n - base : kChunk;
+        decodeI16(&in[base].x, k, zero, one, &out[base].x);
+        rigidTransformPoints(f, out + base, out + base, k);
+    }
+}
+
+void rigidTransformPointsF16(const double m[16], const PointF16 *in, size_t n, const PointQuantization &q, Point3 *out)
+{
+    ADAS_PROFILE_SCOPE(PROBE_COMPACT_TRANSFORM, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "rigidTransformPointsF16");
+    double f[16];
+    foldQuantization(m, q, f);
+    const double zero[3] = { 0.0, 0.0, 0.0 }, one[3] = { 1.0, 1.0, 1.0 };
+    for (size_t base = 0; base < n; base += kChunk) {
+        const size_t k = n - base < kChunk ? n - base : kChunk;
+        decodeF16(&in[base].x, k, zero, one, &out[base].x);
+        rigidTransformPoints(f, out + base, out + base, k);
+    }
+}
+
+} // namespace AdasTools
@@ -0,0 +1,204 @@
+/* *******************************************************************************
+ * File: src/geodesy.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: WGS84 conversions. Batches run in fixed blocks of points;
+ *              the ENU batches convert a block to ECEF (or back) in place
+ *              and apply the cached rigid transform to the whole block.
+ *              Ellipsoid trigonometry always uses TRIG_SINCOS, whatever the
+ *              process-wide tier.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "geodesy.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include "transformers.hpp"
+#include "trig.hpp"
+#include <math.h>
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kBlock = 1024; // points per task
+
+const double kB = kWgs84A * (1.0 - kWgs84F);          // semi-minor axis
+const double kE2 = kWgs84F * (2.0 - kWgs84F);         // first eccentricity squared
+const double kEp2 = kE2 / (1.0 - kE2);                // second eccentricity squared
+const double kA2 = kWgs84A * kWgs84A, kB2 = kB * kB;
+
+inline size_t blockEnd(size_t block, size_t n) { return (block + 1) * kBlock < n ? (block + 1) * kBlock : n; }
+
+struct ToEcefJob {
+    const GeodeticPoint *in;
+    Point3 *out;
+    size_t n;
+    const double *m; // optional ECEF -> ENU
+
+    void operator()(size_t block)
+    {
+        const size_t first = block * kBlock, last = blockEnd(block, n);
+        for (size_t i = first; i < last; ++i) out[i] = geodeticToEcef(in[i]);
+        if (m) rigidTransformPoints(m, out + first, out + first, last - first);
+    }
+};
+
+struct ToGeodeticJob {
+    const Point3 *in;
+    GeodeticPoint *out;
+    size_t n;
+    const double *m; // optional ENU -> ECEF
+
+    void operator()(size_t block)
+    {
+        const size_t first = block * kBlock, last = blockEnd(block, n);
+        Point3 ecef[kBlock];
+        const Point3 *src = in + first;
+        if (m) {
+            rigidTransformPoints(m, src, ecef, last - first);
+            src = ecef;
+        }
+        for (size_t i = first; i < last; ++i) out[i] = ecefToGeodetic(src[i - first]);
+    }
+};
+
+template <typename Job>
+void runBlocks(Job &job, size_t n, TaskPool *pool)
+{
+    (pool ? pool : defaultTaskPool())->parallelFor((n + kBlock - 1) / kBlock, job);
+}
+
+} // namespace
+
+Point3 geodeticToEcef(const GeodeticPoint &g)
+{
+    // Accurate tier regardless of setTrigTier(): 3e-8 rad of TRIG_POLY_1E7 is up to
+    // ~20 cm on the Earth's radius
+    double sl, cl, so, co;
+    sinCos(g.latitude, sl, cl, TRIG_SINCOS);
+    sinCos(g.longitude, so, co, TRIG_SINCOS);
+    const double N = kWgs84A / sqrt(1.0 - kE2 * sl * sl); // prime vertical radius
+    return Point3{ (N + g.altitude) * cl * co, (N + g.altitude) * cl * so, (N * (1.0 - kE2) + g.altitude) * sl };
+}
+
+GeodeticPoint ecefToGeodetic(const Point3 &ecef)
+{
+    const double z = ecef.z, z2 = z * z;
+    const double p2 = ecef.x * ecef.x + ecef.y * ecef.y, p = sqrt(p2);
+    const double F = 54.0 * kB2 * z2;
+    const double G = p2 + (1.0 - kE2) * z2 - kE2 * (kA2 - kB2);
+    const double c = kE2 * kE2 * F * p2 / (G * G * G);
+    const double s = cbrt(1.0 + c + sqrt(c * c + 2.0 * c));
+    const double k = s + 1.0 + 1.0 / s;
+    const double P = F / (3.0 * k * k * G * G);
+    const double Q = sqrt(1.0 + 2.0 * kE2 * kE2 * P);
+    double r0 = -P * kE2 * p / (1.0 + Q) +
+                sqrt(0.5 * kA2 * (1.0 + 1.0 / Q) - P * (1.0 - kE2) * z2 / (Q * (1.0 + Q)) - 0.5 * P * p2);
+    if (!(r0 == r0)) r0 = 0.0; // on the polar axis the radicand can round below zero
+    const double d = p - kE2 * r0, d2 = d * d;
+    const double U = sqrt(d2 + z2), V = sqrt(d2 + (1.0 - kE2) * z2);
+    const double z0 = kB2 * z / (kWgs84A * V);
+    GeodeticPoint g;
+    g.latitude = atan2(z + kEp2 * z0, p);
+    g.longitude = atan2(ecef.y, ecef.x);
+    g.altitude = U * (1.0 - kB2 / (kWgs84A * V));
+    return g;
+}
+
+EnuFrame makeEnuFrame(const GeodeticPoint &origin)
+{
+    EnuFrame f;
+    f.origin = origin;
+    f.originEcef = geodeticToEcef(origin);
+    double sl, cl, so, co;
+    sinCos(origin.latitude, sl, cl, TRIG_SINCOS);
+    sinCos(origin.longitude, so, co, TRIG_SINCOS);
+    // rows: east, north, up in ECEF
+    const double R[9] = { -so, co, 0.0, -sl * co, -sl * so, cl, cl * co, cl * so, sl };
+    const Point3 &o = f.originEcef;
+    for (int r = 0; r < 3; ++r) {
+        f.ecefToEnu[4 * r + 0] = R[3 * r + 0];
+        f.ecefToEnu[4 * r + 1] = R[3 * r + 1];
+        f.ecefToEnu[4 * r + 2] = R[3 * r + 2];
+        f.ecefToEnu[4 * r + 3] = -(R[3 * r + 0] * o.x + R[3 * r + 1] * o.y + R[3 * r + 2] * o.z);
+        f.enuToEcef[4 * r + 0] = R[r];
+        f.enuToEcef[4 * r + 1] = R[3 + r];
+        f.enuToEcef[4 * r + 2] = R[6 + r];
+    }
+    f.enuToEcef[3] = o.x;
+    f.enuToEcef[7] = o.y;
+    f.enuToEcef[11] = o.z;
+    f.ecefToEnu[12] = f.ecefToEnu[13] = f.ecefToEnu[14] = 0.0;
+    f.enuToEcef[12] = f.enuToEcef[13] = f.enuToEcef[14] = 0.0;
+    f.ecefToEnu[15] = f.enuToEcef[15] = 1.0;
+    return f;
+}
+
+Point3 geodeticToEnu(const EnuFrame &frame, const GeodeticPoint &g)
+{
+    return rigidTransformPoint(frame.ecefToEnu, geodeticToEcef(g));
+}
+
+GeodeticPoint enuToGeodetic(const EnuFrame &frame, const Point3 &enu)
+{
+    return ecefToGeodetic(rigidTransformPoint(frame.enuToEcef, enu));
+}
+
+void geodeticToEcefBatch(const GeodeticPoint *in, Point3 *out, size_t n, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_GEODETIC_TO_CARTESIAN, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "geodeticToEcef");
+    if (!in || !out || n == 0) return;
+    ToEcefJob job{ in, out, n, nullptr };
+    runBlocks(job, n, pool);
+}
+
+void ecefToGeodeticBatch(const Point3 *in, GeodeticPoint *out, size_t n, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_CARTESIAN_TO_GEODETIC, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "ecefToGeodetic");
+    if (!in || !out || n == 0) return;
+    ToGeodeticJob job{ in, out, n, nullptr };
+    runBlocks(job, n, pool);
+}
+
+void geodeticToEnuBatch(const EnuFrame &frame, const GeodeticPoint *in, Point3 *out, size_t n, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_GEODETIC_TO_CARTESIAN, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "geodeticToEnu");
+    if (!in || !out || n == 0) return;
+    ToEcefJob job{ in, out, n, frame.ecefToEnu };
+    runBlocks(job, n, pool);
+}
+
+void enuToGeodeticBatch(const EnuFrame &frame, const Point3 *in, GeodeticPoint *out, size_t n, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_CARTESIAN_TO_GEODETIC, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "enuToGeodetic");
+    if (!in || !out || n == 0) return;
+    ToGeodeticJob job{ in, out, n, frame.enuToEcef };
+    runBlocks(job, n, pool);
+}
+
+Pose geodeticPoseToEnu(const EnuFrame &frame, const GeodeticPoint &position, double roll, double pitch, double yaw)
+{
+    // body -> local ENU at the position -> ECEF -> reference ENU; the tangent
+    // planes tilt by ~1.6e-5 rad per 100 m, so the attitude is carried over exactly
+    const EnuFrame local = makeEnuFrame(position);
+    double body[16], toEcef[16], toRef[16];
+    poseToMatrix(Pose{ 0.0, 0.0, 0.0, roll, pitch, yaw }, body);
+    rigidCompose(local.enuToEcef, body, toEcef);
+    rigidCompose(frame.ecefToEnu, toEcef, toRef);
+    return matrixToPose(toRef);
+}
+
+Frame3D enuFrameInEcef(const EnuFrame &frame)
+{
+    const Pose p = matrixToPose(frame.enuToEcef);
+    return Frame3D{ p.x, p.y, p.z, p.roll, p.pitch, p.yaw };
+}
+
+} // namespace AdasTools
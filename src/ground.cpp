@@ -0,0 +1,309 @@
+/* *******************************************************************************
+ * File: src/ground.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: RANSAC ground segmentation. An evenly strided subsample is
+ *              copied to float SoA arrays; hypothesis h is drawn from its own
+ *              RNG stream (seed, h), so blocks of hypotheses can be scored on
+ *              any thread with identical results. The inlier count kernel is
+ *              8-wide AVX2/FMA where available (run-time dispatch as in
+ *              rigid.cpp) with a portable scalar fallback.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "ground.hpp"
+#include "arena.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ADAS_GROUND_HAVE_AVX2 1
+#endif
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kHypothesesPerTask = 8;
+const size_t kAlign = 32;
+
+size_t alignUp(size_t v) { return (v + (kAlign - 1)) & ~(kAlign - 1); }
+
+unsigned countInliersScalar(const float *xs, const float *ys, const float *zs, size_t n,
+                            float nx, float ny, float nz, float d, float threshold)
+{
+    unsigned count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const float dist = nx * xs[i] + ny * ys[i] + nz * zs[i] + d;
+        count += (unsigned)(fabsf(dist) <= threshold);
+    }
+    return count;
+}
+
+#if defined(ADAS_GROUND_HAVE_AVX2)
+
+bool cpuHasAvx2Fma()
+{
+    static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return ok;
+}
+
+__attribute__((target("avx2,fma")))
+unsigned countInliersAvx2(const float *xs, const float *ys, const float *zs, size_t n,
+                          float nx, float ny, float nz, float d, float threshold)
+{
+    const __m256 vnx = _mm256_set1_ps(nx), vny = _mm256_set1_ps(ny), vnz = _mm256_set1_ps(nz);
+    const __m256 vd = _mm256_set1_ps(d), vt = _mm256_set1_ps(threshold);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 dist = _mm256_fmadd_ps(vnx, _mm256_load_ps(xs + i), vd);
+        dist = _mm256_fmadd_ps(vny, _mm256_load_ps(ys + i), dist);
+        dist = _mm256_fmadd_ps(vnz, _mm256_load_ps(zs + i), dist);
+        const __m256 inside = _mm256_cmp_ps(_mm256_and_ps(dist, absMask), vt, _CMP_LE_OQ);
+        acc = _mm256_sub_epi32(acc, _mm256_castps_si256(inside)); // all-ones lane = -1
+    }
+    alignas(32) unsigned lanes[8];
+    _mm256_store_si256((__m256i *)lanes, acc);
+    unsigned count = 0;
+    for (int k = 0; k < 8; ++k) count += lanes[k];
+    return count + countInliersScalar(xs + i, ys + i, zs + i, n - i, nx, ny, nz, d, threshold);
+}
+
+#endif
+
+unsigned countInliers(const float *xs, const float *ys, const float *zs, size_t n,
+                      float nx, float ny, float nz, float d, float threshold)
+{
+#if defined(ADAS_GROUND_HAVE_AVX2)
+    if (cpuHasAvx2Fma()) return countInliersAvx2(xs, ys, zs, n, nx, ny, nz, d, threshold);
+#endif
+    return countInliersScalar(xs, ys, zs, n, nx, ny, nz, d, threshold);
+}
+
+// splitmix32-style mix: an independent stream per (seed, hypothesis).
+unsigned mixSeed(unsigned seed, unsigned h)
+{
+    unsigned z = seed * 0x9E3779B9u + h * 0x85EBCA6Bu + 0x27D4EB2Fu;
+    z = (z ^ (z >> 16)) * 0x7FEB352Du;
+    z = (z ^ (z >> 15)) * 0x846CA68Bu;
+    return z ^ (z >> 16);
+}
+
+unsigned nextRandom(unsigned &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Plane through three points with the normal flipped up; false when the
+// points are (nearly) collinear or the plane is steeper than minNz allows.
+bool planeFromPoints(const double a[3], const double b[3], const double c[3], double minNz, double plane[4])
+{
+    const double ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+    const double vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+    double nx = uy * vz - uz * vy;
+    double ny = uz * vx - ux * vz;
+    double nz = ux * vy - uy * vx;
+    const double len = sqrt(nx * nx + ny * ny + nz * nz);
+    const double scale = (ux * ux + uy * uy + uz * uz) * (vx * vx + vy * vy + vz * vz);
+    if (len <= 1e-6 * sqrt(scale) || len == 0.0) return false;
+    const double inv = (nz < 0.0 ? -1.0 : 1.0) / len;
+    nx *= inv; ny *= inv; nz *= inv;
+    if (nz < minNz) return false;
+    plane[0] = nx;
+    plane[1] = ny;
+    plane[2] = nz;
+    plane[3] = -(nx * a[0] + ny * a[1] + nz * a[2]);
+    return true;
+}
+
+struct HypothesisJob {
+    const float *xs, *ys, *zs;
+    size_t sampleCount;
+    const unsigned *candidates;
+    size_t candidateCount;
+    const GroundSegmentationConfig *config;
+    double minNz;
+    double *planes;    // 4 per hypothesis
+    unsigned *counts;  // 0 for rejected hypotheses
+
+    void operator()(size_t task)
+    {
+        const size_t first = task * kHypothesesPerTask;
+        const size_t last = first + kHypothesesPerTask < config->iterations ? first + kHypothesesPerTask : config->iterations;
+        const float threshold = (float)config->distanceThreshold;
+        for (size_t h = first; h < last; ++h) {
+            unsigned state = mixSeed(config->seed, (unsigned)h) | 1u;
+            double p[3][3];
+            for (int k = 0; k < 3; ++k) {
+                const unsigned s = candidates[nextRandom(state) % candidateCount];
+                p[k][0] = xs[s]; p[k][1] = ys[s]; p[k][2] = zs[s];
+            }
+            double *plane = planes + 4 * h;
+            if (!planeFromPoints(p[0], p[1], p[2], minNz, plane)) {
+                counts[h] = 0;
+                continue;
+            }
+            counts[h] = countInliers(xs, ys, zs, sampleCount, (float)plane[0], (float)plane[1], (float)plane[2],
+                                     (float)plane[3], threshold);
+        }
+    }
+};
+
+// Least-squares z = a*x + b*y + c over the sample inliers of plane.
+bool refinePlane(const float *xs, const float *ys, const float *zs, size_t n, double threshold, double minNz, double plane[4])
+{
+    double sxx = 0, sxy = 0, sx = 0, syy = 0, sy = 0, sxz = 0, syz = 0, sz = 0, m = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double x = xs[i], y = ys[i], z = zs[i];
+        const double dist = plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+        const double w = fabs(dist) <= threshold ? 1.0 : 0.0;
+        sxx += w * x * x; sxy += w * x * y; sx += w * x;
+        syy += w * y * y; sy += w * y; m += w;
+        sxz += w * x * z; syz += w * y * z; sz += w * z;
+    }
+    if (m < 3.0) return false;
+    // | sxx sxy sx | |a|   |sxz|
+    // | sxy syy sy | |b| = |syz|
+    // | sx  sy  m  | |c|   |sz |
+    const double det = sxx * (syy * m - sy * sy) - sxy * (sxy * m - sy * sx) + sx * (sxy * sy - syy * sx);
+    if (fabs(det) <= 1e-12 * (sxx * syy * m + 1.0)) return false;
+    const double a = (sxz * (syy * m - sy * sy) - sxy * (syz * m - sy * sz) + sx * (syz * sy - syy * sz)) / det;
+    const double b = (sxx * (syz * m - sz * sy) - sxz * (sxy * m - sy * sx) + sx * (sxy * sz - syz * sx)) / det;
+    const double c = (sxx * (syy * sz - sy * syz) - sxy * (sxy * sz - syz * sx) + sxz * (sxy * sy - syy * sx)) / det;
+    const double inv = 1.0 / sqrt(a * a + b * b + 1.0);
+    if (inv < minNz) return false;
+    plane[0] = -a * inv;
+    plane[1] = -b * inv;
+    plane[2] = inv;
+    plane[3] = -c * inv;
+    return true;
+}
+
+} // namespace
+
+size_t groundSegmentationScratchBytes(const GroundSegmentationConfig &config)
+{
+    const size_t m = config.sampleSize;
+    return 3 * alignUp(m * sizeof(float)) + alignUp(m * sizeof(unsigned)) +
+           alignUp((size_t)config.iterations * 4 * sizeof(double)) + alignUp((size_t)config.iterations * sizeof(unsigned)) + kAlign;
+}
+
+Pose groundPlaneFrame(const GroundPlane &plane)
+{
+    // R = Ry(pitch) * Rx(roll) maps z to (sin(p)cos(r), -sin(r), cos(p)cos(r)).
+    Pose f;
+    f.x = -plane.d * plane.nx;
+    f.y = -plane.d * plane.ny;
+    f.z = -plane.d * plane.nz;
+    const double ny = plane.ny > 1.0 ? 1.0 : (plane.ny < -1.0 ? -1.0 : plane.ny);
+    f.roll = -asin(ny);
+    f.pitch = atan2(plane.nx, plane.nz);
+    f.yaw = 0.0;
+    return f;
+}
+
+bool segmentGround(const Point3 *points, size_t n, const GroundSegmentationConfig &config,
+                   unsigned int *groundIndices, unsigned int *obstacleIndices, GroundSegmentationResult &result,
+                   FrameArena *scratch, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_GROUND_SEGMENTATION, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_USER, "segmentGround");
+    result.groundCount = 0;
+    result.obstacleCount = 0;
+    result.sampleInliers = 0;
+    if (n < 3 || config.iterations == 0 || config.sampleSize < 3) return false;
+
+    if (!scratch) scratch = threadScratchArena();
+    const size_t bytes = groundSegmentationScratchBytes(config);
+    const size_t marker = scratch ? scratch->mark() : 0;
+    char *block = scratch ? (char *)scratch->allocate(bytes, kAlign) : (char *)malloc(bytes);
+    if (!block) return false;
+    char *cursor = (char *)(((size_t)block + (kAlign - 1)) & ~(kAlign - 1));
+
+    const size_t m = n < config.sampleSize ? n : config.sampleSize;
+    float *xs = (float *)cursor; cursor += alignUp(config.sampleSize * sizeof(float));
+    float *ys = (float *)cursor; cursor += alignUp(config.sampleSize * sizeof(float));
+    float *zs = (float *)cursor; cursor += alignUp(config.sampleSize * sizeof(float));
+    unsigned *candidates = (unsigned *)cursor; cursor += alignUp(config.sampleSize * sizeof(unsigned));
+    double *planes = (double *)cursor; cursor += alignUp((size_t)config.iterations * 4 * sizeof(double));
+    unsigned *counts = (unsigned *)cursor;
+
+    // Evenly strided subsample (fixed-point stride keeps it exact for any n).
+    size_t candidateCount = 0;
+    for (size_t i = 0; i < m; ++i) {
+        const Point3 &p = points[(size_t)(((unsigned long long)i * n) / m)];
+        xs[i] = (float)p.x;
+        ys[i] = (float)p.y;
+        zs[i] = (float)p.z;
+        candidates[candidateCount] = (unsigned)i;
+        candidateCount += p.z <= config.maxSeedHeight;
+    }
+
+    bool ok = false;
+    const double minNz = cos(config.maxSlope);
+    double best[4] = { 0.0, 0.0, 1.0, 0.0 };
+    if (candidateCount >= 3) {
+        HypothesisJob job{ xs, ys, zs, m, candidates, candidateCount, &config, minNz, planes, counts };
+        const size_t tasks = (config.iterations + kHypothesesPerTask - 1) / kHypothesesPerTask;
+        (pool ? pool : defaultTaskPool())->parallelFor(tasks, job);
+
+        // Serial arg-max: ties go to the lowest hypothesis index.
+        size_t bestIndex = 0;
+        for (size_t h = 1; h < config.iterations; ++h) {
+            if (counts[h] > counts[bestIndex]) bestIndex = h;
+        }
+        if (counts[bestIndex] >= 3) {
+            ok = true;
+            result.sampleInliers = counts[bestIndex];
+            for (int k = 0; k < 4; ++k) best[k] = planes[4 * bestIndex + k];
+            if (config.refine) {
+                double refined[4] = { best[0], best[1], best[2], best[3] };
+                if (refinePlane(xs, ys, zs, m, config.distanceThreshold, minNz, refined)) {
+                    for (int k = 0; k < 4; ++k) best[k] = refined[k];
+                }
+            }
+        }
+    }
+
+    if (scratch) scratch->rewind(marker);
+    else free(block);
+    if (!ok) return false;
+
+    result.plane = GroundPlane{ best[0], best[1], best[2], best[3] };
+    result.frame = groundPlaneFrame(result.plane);
+
+    // Classify every point; always store, advance by the class bit.
+    const double nx = best[0], ny = best[1], nz = best[2], d = best[3], t = config.distanceThreshold;
+    size_t g = 0, o = 0;
+    if (obstacleIndices) {
+        for (size_t i = 0; i < n; ++i) {
+            const double dist = nx * points[i].x + ny * points[i].y + nz * points[i].z + d;
+            const size_t isGround = fabs(dist) <= t;
+            groundIndices[g] = (unsigned)i;
+            obstacleIndices[o] = (unsigned)i;
+            g += isGround;
+            o += 1 - isGround;
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            const double dist = nx * points[i].x + ny * points[i].y + nz * points[i].z + d;
+            groundIndices[g] = (unsigned)i;
+            g += fabs(dist) <= t;
+        }
+        o = n - g;
+    }
+    result.groundCount = g;
+    result.obstacleCount = o;
+    return true;
+}
+
+} // namespace AdasTools
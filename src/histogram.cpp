@@ -0,0 +1,271 @@
+/* *******************************************************************************
+ * File: src/histogram.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Log-linear latency histogram and per-thread stage latency
+ *              metrics. Each thread owns one block of bucket counters (written
+ *              only by that thread with relaxed stores); snapshots merge all
+ *              blocks on read. Reports are formatted with snprintf, no STL.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "histogram.hpp"
+#include <atomic>
+#include <stdio.h>
+
+namespace AdasTools {
+
+LatencyHistogram::LatencyHistogram(const HistogramConfig &config)
+{
+    config_ = config;
+    if (config_.significantBits < 2) config_.significantBits = 2;
+    if (config_.significantBits > kHistogramMaxSignificantBits) config_.significantBits = kHistogramMaxSignificantBits;
+    bits_ = config_.significantBits;
+    linearLimit_ = 1ull << bits_;
+    halfLimit_ = 1ull << (bits_ - 1);
+    highest_ = config_.highestValue < linearLimit_ ? linearLimit_ - 1 : config_.highestValue;
+    config_.highestValue = highest_;
+    buckets_ = bucketIndex(highest_) + 1;
+    clear();
+}
+
+void LatencyHistogram::addBucket(size_t index, unsigned long long n)
+{
+    if (index >= buckets_) return;
+    counts_[index] += n;
+    total_ += n;
+}
+
+void LatencyHistogram::setSummary(unsigned long long sum, unsigned long long minValue, unsigned long long maxValue)
+{
+    sum_ = sum;
+    min_ = minValue;
+    max_ = maxValue;
+}
+
+bool LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.bits_ != bits_ || other.highest_ != highest_) return false;
+    for (size_t i = 0; i < buckets_; ++i) counts_[i] += other.counts_[i];
+    total_ += other.total_;
+    sum_ += other.sum_;
+    if (other.total_ && other.min_ < min_) min_ = other.min_;
+    if (other.max_ > max_) max_ = other.max_;
+    return true;
+}
+
+void LatencyHistogram::clear()
+{
+    for (size_t i = 0; i < kHistogramMaxBuckets; ++i) counts_[i] = 0;
+    total_ = 0;
+    sum_ = 0;
+    min_ = ~0ull;
+    max_ = 0;
+}
+
+unsigned long long LatencyHistogram::bucketUpperBound(size_t index) const
+{
+    if (index < linearLimit_) return (unsigned long long)index;
+    unsigned long long j = (unsigned long long)index - linearLimit_;
+    unsigned shift = (unsigned)(j / halfLimit_) + 1u;
+    unsigned long long mantissa = j % halfLimit_ + halfLimit_;
+    return ((mantissa + 1ull) << shift) - 1ull;
+}
+
+unsigned long long LatencyHistogram::percentile(double percent) const
+{
+    if (total_ == 0) return 0;
+    if (percent < 0.0) percent = 0.0;
+    if (percent > 100.0) percent = 100.0;
+    // Rank of the sample we report (1-based, at least the first sample).
+    unsigned long long rank = (unsigned long long)(percent / 100.0 * (double)total_ + 0.5);
+    if (rank < 1) rank = 1;
+    unsigned long long seen = 0;
+    for (size_t i = 0; i < buckets_; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            unsigned long long v = bucketUpperBound(i);
+            return v > max_ ? max_ : v;
+        }
+    }
+    return max_;
+}
+
+// ---------------------------------------------------------------------------
+// Per-thread stage metrics
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct ThreadLatency {
+    std::atomic<unsigned long long> counts[TRACE_STAGE_COUNT][kHistogramMaxBuckets];
+    std::atomic<unsigned long long> sum[TRACE_STAGE_COUNT];
+    std::atomic<unsigned long long> min[TRACE_STAGE_COUNT];
+    std::atomic<unsigned long long> max[TRACE_STAGE_COUNT];
+    ThreadLatency *next;
+};
+
+std::atomic<bool> g_latencyEnabled{ false };
+std::atomic<ThreadLatency *> g_latencyThreads{ nullptr };
+thread_local ThreadLatency *t_latency = nullptr;
+
+// Bucket layout shared by all threads; only replaced by latencyConfigure().
+LatencyHistogram &layout()
+{
+    static LatencyHistogram h;
+    return h;
+}
+
+void clearBlock(ThreadLatency *b)
+{
+    for (int s = 0; s < TRACE_STAGE_COUNT; ++s) {
+        for (size_t i = 0; i < kHistogramMaxBuckets; ++i) b->counts[s][i].store(0, std::memory_order_relaxed);
+        b->sum[s].store(0, std::memory_order_relaxed);
+        b->min[s].store(~0ull, std::memory_order_relaxed);
+        b->max[s].store(0, std::memory_order_relaxed);
+    }
+}
+
+ThreadLatency *threadLatency()
+{
+    if (t_latency) return t_latency;
+    // Blocks are never freed so samples of exited threads stay in the report.
+    ThreadLatency *b = new ThreadLatency();
+    clearBlock(b);
+    b->next = g_latencyThreads.load(std::memory_order_relaxed);
+    while (!g_latencyThreads.compare_exchange_weak(b->next, b, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    t_latency = b;
+    return b;
+}
+
+inline void ownerAdd(std::atomic<unsigned long long> &v, unsigned long long d)
+{
+    v.store(v.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+}
+
+size_t appendf(char *buffer, size_t capacity, size_t pos, const char *fmt, unsigned long long a)
+{
+    char *dst = pos < capacity ? buffer + pos : nullptr;
+    size_t room = pos < capacity ? capacity - pos : 0;
+    int n = snprintf(dst, room, fmt, a);
+    return n > 0 ? pos + (size_t)n : pos;
+}
+
+size_t appends(char *buffer, size_t capacity, size_t pos, const char *fmt, const char *s)
+{
+    char *dst = pos < capacity ? buffer + pos : nullptr;
+    size_t room = pos < capacity ? capacity - pos : 0;
+    int n = snprintf(dst, room, fmt, s);
+    return n > 0 ? pos + (size_t)n : pos;
+}
+
+} // namespace
+
+void latencyConfigure(const HistogramConfig &config)
+{
+    layout() = LatencyHistogram(config);
+    latencyReset();
+}
+
+void latencySetEnabled(bool enabled)
+{
+    if (enabled) (void)layout();
+    g_latencyEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool latencyEnabled()
+{
+    return g_latencyEnabled.load(std::memory_order_relaxed);
+}
+
+void latencyRecord(TraceStage stage, unsigned long long nanoseconds)
+{
+    if ((unsigned)stage >= (unsigned)TRACE_STAGE_COUNT) return;
+    const LatencyHistogram &l = layout();
+    unsigned long long v = nanoseconds > l.config().highestValue ? l.config().highestValue : nanoseconds;
+    ThreadLatency *b = threadLatency();
+    ownerAdd(b->counts[stage][l.bucketIndex(v)], 1);
+    ownerAdd(b->sum[stage], nanoseconds);
+    if (nanoseconds < b->min[stage].load(std::memory_order_relaxed)) b->min[stage].store(nanoseconds, std::memory_order_relaxed);
+    if (nanoseconds > b->max[stage].load(std::memory_order_relaxed)) b->max[stage].store(nanoseconds, std::memory_order_relaxed);
+}
+
+void latencySnapshot(TraceStage stage, LatencyHistogram &out)
+{
+    out = LatencyHistogram(layout().config());
+    if ((unsigned)stage >= (unsigned)TRACE_STAGE_COUNT) return;
+    unsigned long long sum = 0, mn = ~0ull, mx = 0;
+    for (ThreadLatency *b = g_latencyThreads.load(std::memory_order_acquire); b; b = b->next) {
+        for (size_t i = 0; i < out.bucketCount(); ++i) {
+            out.addBucket(i, b->counts[stage][i].load(std::memory_order_relaxed));
+        }
+        sum += b->sum[stage].load(std::memory_order_relaxed);
+        unsigned long long bmin = b->min[stage].load(std::memory_order_relaxed);
+        unsigned long long bmax = b->max[stage].load(std::memory_order_relaxed);
+        if (bmin < mn) mn = bmin;
+        if (bmax > mx) mx = bmax;
+    }
+    out.setSummary(sum, mn, mx);
+}
+
+void latencyReset()
+{
+    for (ThreadLatency *b = g_latencyThreads.load(std::memory_order_acquire); b; b = b->next) clearBlock(b);
+}
+
+size_t latencyFormatReport(char *buffer, size_t capacity, LatencyReportFormat format)
+{
+    static const double kQuantiles[3] = { 50.0, 99.0, 99.9 };
+    static const char *kQuantileNames[3] = { "0.5", "0.99", "0.999" };
+    static const char *kJsonKeys[3] = { "p50", "p99", "p999" };
+
+    if (capacity > 0) buffer[0] = '\0';
+    size_t pos = 0;
+    bool first = true;
+    if (format == LATENCY_REPORT_JSON) pos = appends(buffer, capacity, pos, "%s", "{");
+
+    LatencyHistogram h;
+    for (int s = 0; s < TRACE_STAGE_COUNT; ++s) {
+        latencySnapshot((TraceStage)s, h);
+        if (h.count() == 0) continue;
+        const char *name = traceStageName((TraceStage)s);
+        if (format == LATENCY_REPORT_JSON) {
+            pos = appends(buffer, capacity, pos, first ? "\"%s\":{" : ",\"%s\":{", name);
+            pos = appendf(buffer, capacity, pos, "\"count\":%llu", h.count());
+            for (int q = 0; q < 3; ++q) {
+                pos = appends(buffer, capacity, pos, ",\"%s\":", kJsonKeys[q]);
+                pos = appendf(buffer, capacity, pos, "%llu", h.percentile(kQuantiles[q]));
+            }
+            pos = appendf(buffer, capacity, pos, ",\"max\":%llu", h.max());
+            pos = appendf(buffer, capacity, pos, ",\"mean\":%llu}", (unsigned long long)h.mean());
+        } else {
+            for (int q = 0; q < 3; ++q) {
+                pos = appends(buffer, capacity, pos, "adas_latency_ns{stage=\"%s\",", name);
+                pos = appends(buffer, capacity, pos, "quantile=\"%s\"}", kQuantileNames[q]);
+                pos = appendf(buffer, capacity, pos, " %llu\n", h.percentile(kQuantiles[q]));
+            }
+            pos = appends(buffer, capacity, pos, "adas_latency_ns_max{stage=\"%s\"}", name);
+            pos = appendf(buffer, capacity, pos, " %llu\n", h.max());
+            pos = appends(buffer, capacity, pos, "adas_latency_ns_count{stage=\"%s\"}", name);
+            pos = appendf(buffer, capacity, pos, " %llu\n", h.count());
+        }
+        first = false;
+    }
+    if (format == LATENCY_REPORT_JSON) pos = appends(buffer, capacity, pos, "%s", "}\n");
+    return pos;
+}
+
+bool latencyWriteReport(const char *path, LatencyReportFormat format)
+{
+    char report[16384];
+    size_t n = latencyFormatReport(report, sizeof(report), format);
+    if (n >= sizeof(report)) return false;
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    bool ok = fwrite(report, 1, n, f) == n;
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+} // namespace AdasTools
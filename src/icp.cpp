@@ -0,0 +1,352 @@
+/* *******************************************************************************
+ * File: src/icp.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Normal estimation and point-to-plane ICP. Source points are
+ *              split into fixed blocks; each block transforms its points,
+ *              queries the KD-tree (seeded with the block's previous match)
+ *              and accumulates the rows [p x n, n, r] into a 7x8 outer-product
+ *              sum (AVX2/FMA with run-time dispatch as in rigid.cpp, scalar
+ *              fallback). Block sums are reduced serially in block order and
+ *              the 6x6 system is solved by Cholesky.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "icp.hpp"
+#include "arena.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ADAS_ICP_HAVE_AVX2 1
+#endif
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kBlock = 256;       // source points per task (fixed: keeps the sums deterministic)
+const size_t kNormalBlock = 512; // target points per normal-estimation task
+const size_t kSums = 7 * 8;      // [J r] outer products, 7 rows x 8 columns
+const size_t kAlign = 32;
+
+size_t alignUp(size_t v) { return (v + (kAlign - 1)) & ~(kAlign - 1); }
+
+struct BlockSums {
+    double m[kSums];
+    size_t count;
+};
+
+void accumulateRowsScalar(const double *rows, size_t count, double *out)
+{
+    for (size_t k = 0; k < kSums; ++k) out[k] = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const double *row = rows + 8 * i;
+        for (int j = 0; j < 7; ++j) {
+            for (int c = 0; c < 8; ++c) out[j * 8 + c] += row[j] * row[c];
+        }
+    }
+}
+
+#if defined(ADAS_ICP_HAVE_AVX2)
+
+bool cpuHasAvx2Fma()
+{
+    static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return ok;
+}
+
+// 14 accumulators (7 rows x two 4-lane halves) stay in registers.
+__attribute__((target("avx2,fma")))
+void accumulateRowsAvx2(const double *rows, size_t count, double *out)
+{
+    __m256d lo[7], hi[7];
+    for (int j = 0; j < 7; ++j) {
+        lo[j] = _mm256_setzero_pd();
+        hi[j] = _mm256_setzero_pd();
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const double *row = rows + 8 * i;
+        const __m256d a = _mm256_load_pd(row), b = _mm256_load_pd(row + 4);
+        for (int j = 0; j < 7; ++j) {
+            const __m256d s = _mm256_broadcast_sd(row + j);
+            lo[j] = _mm256_fmadd_pd(s, a, lo[j]);
+            hi[j] = _mm256_fmadd_pd(s, b, hi[j]);
+        }
+    }
+    for (int j = 0; j < 7; ++j) {
+        _mm256_storeu_pd(out + j * 8, lo[j]);
+        _mm256_storeu_pd(out + j * 8 + 4, hi[j]);
+    }
+}
+
+#endif
+
+void accumulateRows(const double *rows, size_t count, double *out)
+{
+#if defined(ADAS_ICP_HAVE_AVX2)
+    if (cpuHasAvx2Fma()) {
+        accumulateRowsAvx2(rows, count, out);
+        return;
+    }
+#endif
+    accumulateRowsScalar(rows, count, out);
+}
+
+// Unit eigenvector of the smallest eigenvalue of a symmetric 3x3 matrix
+// (closed-form eigenvalues); false when the spread is line- or blob-like.
+bool smallestEigenvector(const double a[6], Point3 &normal)
+{
+    const double a00 = a[0], a01 = a[1], a02 = a[2], a11 = a[3], a12 = a[4], a22 = a[5];
+    const double q = (a00 + a11 + a22) / 3.0;
+    const double p1 = a01 * a01 + a02 * a02 + a12 * a12;
+    const double p2 = (a00 - q) * (a00 - q) + (a11 - q) * (a11 - q) + (a22 - q) * (a22 - q) + 2.0 * p1;
+    if (p2 <= 1e-24) return false;
+    const double p = sqrt(p2 / 6.0), inv = 1.0 / p;
+    const double b00 = (a00 - q) * inv, b11 = (a11 - q) * inv, b22 = (a22 - q) * inv;
+    const double b01 = a01 * inv, b02 = a02 * inv, b12 = a12 * inv;
+    double r = 0.5 * (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) + b02 * (b01 * b12 - b11 * b02));
+    r = r < -1.0 ? -1.0 : (r > 1.0 ? 1.0 : r);
+    const double phi = acos(r) / 3.0;
+    const double l1 = q + 2.0 * p * cos(phi);
+    const double l3 = q + 2.0 * p * cos(phi + 2.0943951023931957);
+    const double l2 = 3.0 * q - l1 - l3;
+    if (l2 <= 1e-4 * l1 || l3 > 0.5 * l2) return false;
+
+    // Rows of A - l3 I span the plane orthogonal to the eigenvector.
+    const double r0[3] = { a00 - l3, a01, a02 }, r1[3] = { a01, a11 - l3, a12 }, r2[3] = { a02, a12, a22 - l3 };
+    const double c[3][3] = {
+        { r0[1] * r1[2] - r0[2] * r1[1], r0[2] * r1[0] - r0[0] * r1[2], r0[0] * r1[1] - r0[1] * r1[0] },
+        { r0[1] * r2[2] - r0[2] * r2[1], r0[2] * r2[0] - r0[0] * r2[2], r0[0] * r2[1] - r0[1] * r2[0] },
+        { r1[1] * r2[2] - r1[2] * r2[1], r1[2] * r2[0] - r1[0] * r2[2], r1[0] * r2[1] - r1[1] * r2[0] },
+    };
+    int best = 0;
+    double bestLen = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        const double len = c[k][0] * c[k][0] + c[k][1] * c[k][1] + c[k][2] * c[k][2];
+        if (len > bestLen) { bestLen = len; best = k; }
+    }
+    if (bestLen <= 0.0) return false;
+    const double s = 1.0 / sqrt(bestLen);
+    normal = Point3{ c[best][0] * s, c[best][1] * s, c[best][2] * s };
+    return true;
+}
+
+struct NormalJob {
+    const PointKdTree *tree;
+    const Point3 *points;
+    size_t n;
+    unsigned k;
+    double radius;
+    Point3 *normals;
+
+    void operator()(size_t task)
+    {
+        const size_t first = task * kNormalBlock;
+        const size_t last = first + kNormalBlock < n ? first + kNormalBlock : n;
+        unsigned idx[64];
+        for (size_t i = first; i < last; ++i) {
+            normals[i] = Point3{ 0.0, 0.0, 0.0 };
+            const size_t found = tree->nearestK(points[i], k, radius, idx);
+            if (found < 3) continue;
+            double mx = 0, my = 0, mz = 0;
+            for (size_t j = 0; j < found; ++j) {
+                mx += points[idx[j]].x; my += points[idx[j]].y; mz += points[idx[j]].z;
+            }
+            const double inv = 1.0 / (double)found;
+            mx *= inv; my *= inv; mz *= inv;
+            double cov[6] = { 0, 0, 0, 0, 0, 0 };
+            for (size_t j = 0; j < found; ++j) {
+                const double dx = points[idx[j]].x - mx, dy = points[idx[j]].y - my, dz = points[idx[j]].z - mz;
+                cov[0] += dx * dx; cov[1] += dx * dy; cov[2] += dx * dz;
+                cov[3] += dy * dy; cov[4] += dy * dz; cov[5] += dz * dz;
+            }
+            smallestEigenvector(cov, normals[i]);
+        }
+    }
+};
+
+struct CorrespondenceJob {
+    const PointKdTree *tree;
+    const Point3 *targetPoints;
+    const Point3 *targetNormals;
+    const Point3 *source;
+    size_t n;
+    const double *m; // current source-to-target matrix
+    double maxDistance;
+    unsigned *hints; // last match per source point
+    BlockSums *sums;
+
+    void operator()(size_t task)
+    {
+        alignas(32) double rows[kBlock * 8];
+        const size_t first = task * kBlock;
+        const size_t last = first + kBlock < n ? first + kBlock : n;
+        size_t count = 0;
+        for (size_t i = first; i < last; ++i) {
+            const Point3 p = rigidTransformPoint(m, source[i]);
+            const unsigned j = tree->nearest(p, maxDistance, nullptr, hints[i]);
+            hints[i] = j;
+            if (j == kNoNeighbor) continue;
+            const Point3 &nr = targetNormals[j];
+            if (nr.x == 0.0 && nr.y == 0.0 && nr.z == 0.0) continue;
+            const Point3 &q = targetPoints[j];
+            double *row = rows + 8 * count++;
+            row[0] = p.y * nr.z - p.z * nr.y;
+            row[1] = p.z * nr.x - p.x * nr.z;
+            row[2] = p.x * nr.y - p.y * nr.x;
+            row[3] = nr.x;
+            row[4] = nr.y;
+            row[5] = nr.z;
+            row[6] = nr.x * (p.x - q.x) + nr.y * (p.y - q.y) + nr.z * (p.z - q.z);
+            row[7] = 0.0;
+        }
+        accumulateRows(rows, count, sums[task].m);
+        sums[task].count = count;
+    }
+};
+
+// Solve H x = b (6x6 symmetric positive definite) in place; false if not PD.
+bool solveCholesky6(double H[36], double b[6])
+{
+    double maxDiag = 0.0;
+    for (int i = 0; i < 6; ++i) maxDiag = H[i * 7] > maxDiag ? H[i * 7] : maxDiag;
+    for (int j = 0; j < 6; ++j) {
+        double d = H[j * 6 + j];
+        for (int k = 0; k < j; ++k) d -= H[j * 6 + k] * H[j * 6 + k];
+        if (d <= 1e-12 * maxDiag || d <= 0.0) return false;
+        d = sqrt(d);
+        H[j * 6 + j] = d;
+        for (int i = j + 1; i < 6; ++i) {
+            double s = H[i * 6 + j];
+            for (int k = 0; k < j; ++k) s -= H[i * 6 + k] * H[j * 6 + k];
+            H[i * 6 + j] = s / d;
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        double s = b[i];
+        for (int k = 0; k < i; ++k) s -= H[i * 6 + k] * b[k];
+        b[i] = s / H[i * 6 + i];
+    }
+    for (int i = 5; i >= 0; --i) {
+        double s = b[i];
+        for (int k = i + 1; k < 6; ++k) s -= H[k * 6 + i] * b[k];
+        b[i] = s / H[i * 6 + i];
+    }
+    return true;
+}
+
+} // namespace
+
+void estimatePointNormals(const PointKdTree &tree, const Point3 *points, size_t n, unsigned k, double radius,
+                          Point3 *normals, TaskPool *pool)
+{
+    if (k < 3) k = 3;
+    if (k > 64) k = 64;
+    NormalJob job{ &tree, points, n, k, radius, normals };
+    (pool ? pool : defaultTaskPool())->parallelFor((n + kNormalBlock - 1) / kNormalBlock, job);
+}
+
+size_t icpScratchBytes(size_t n)
+{
+    const size_t tasks = (n + kBlock - 1) / kBlock;
+    return alignUp(n * sizeof(unsigned)) + alignUp(tasks * sizeof(BlockSums)) + kAlign;
+}
+
+bool registerPointToPlane(const PointKdTree &target, const Point3 *targetPoints, const Point3 *targetNormals,
+                          const Point3 *source, size_t n, const RigidTransform &initial, const IcpConfig &config,
+                          IcpResult &result, FrameArena *scratch, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_ICP_REGISTRATION, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_USER, "registerPointToPlane");
+    RigidTransform T = initial;
+    T.q = normalizeQuaternion(T.q);
+    result.transform = T;
+    result.pose = transformToPose(T);
+    result.iterations = 0;
+    result.correspondences = 0;
+    result.rms = 0.0;
+    result.converged = false;
+    if (n == 0 || target.size() == 0) return false;
+
+    if (!scratch) scratch = threadScratchArena();
+    const size_t bytes = icpScratchBytes(n);
+    const size_t marker = scratch ? scratch->mark() : 0;
+    char *block = scratch ? (char *)scratch->allocate(bytes, kAlign) : (char *)malloc(bytes);
+    if (!block) return false;
+    char *cursor = (char *)(((size_t)block + (kAlign - 1)) & ~(kAlign - 1));
+    const size_t tasks = (n + kBlock - 1) / kBlock;
+    unsigned *hints = (unsigned *)cursor; cursor += alignUp(n * sizeof(unsigned));
+    BlockSums *sums = (BlockSums *)cursor;
+    for (size_t i = 0; i < n; ++i) hints[i] = kNoNeighbor;
+
+    bool ok = true;
+    double m[16];
+    CorrespondenceJob job{ &target, targetPoints, targetNormals, source, n, m, config.maxCorrespondenceDistance, hints, sums };
+    TaskPool *run = pool ? pool : defaultTaskPool();
+    for (unsigned it = 0; it < config.maxIterations; ++it) {
+        transformToMatrix(T, m);
+        run->parallelFor(tasks, job);
+
+        double total[kSums];
+        size_t count = 0;
+        for (size_t k = 0; k < kSums; ++k) total[k] = 0.0;
+        for (size_t t = 0; t < tasks; ++t) {
+            for (size_t k = 0; k < kSums; ++k) total[k] += sums[t].m[k];
+            count += sums[t].count;
+        }
+        result.correspondences = count;
+        result.rms = count ? sqrt(total[6 * 8 + 6] / (double)count) : 0.0;
+        if (count < config.minCorrespondences || count < 6) {
+            ok = false;
+            break;
+        }
+        double H[36], x[6];
+        for (int r = 0; r < 6; ++r) {
+            for (int c = 0; c < 6; ++c) H[r * 6 + c] = total[r * 8 + c];
+            x[r] = -total[r * 8 + 6];
+        }
+        if (!solveCholesky6(H, x)) {
+            ok = false;
+            break;
+        }
+
+        // Exact rotation for the twist (w, t): q = [cos(|w|/2), sin(|w|/2) w/|w|].
+        const double angle = sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+        const double half = 0.5 * angle;
+        const double s = angle > 1e-12 ? sin(half) / angle : 0.5;
+        RigidTransform delta;
+        delta.q = Quaternion{ cos(half), s * x[0], s * x[1], s * x[2] };
+        delta.t = Point3{ x[3], x[4], x[5] };
+        T = composeTransform(delta, T);
+        T.q = normalizeQuaternion(T.q);
+        result.iterations = it + 1;
+
+        const double move = sqrt(x[3] * x[3] + x[4] * x[4] + x[5] * x[5]);
+        if (angle < config.rotationEpsilon && move < config.translationEpsilon) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    if (scratch) scratch->rewind(marker);
+    else free(block);
+    result.transform = T;
+    result.pose = transformToPose(T);
+    return ok;
+}
+
+bool registerPointToPlane(const PointKdTree &target, const Point3 *targetPoints, const Point3 *targetNormals,
+                          const Point3 *source, size_t n, const Pose &initial, const IcpConfig &config,
+                          IcpResult &result, FrameArena *scratch, TaskPool *pool)
+{
+    return registerPointToPlane(target, targetPoints, targetNormals, source, n, poseToTransform(initial), config,
+                                result, scratch, pool);
+}
+
+} // namespace AdasTools
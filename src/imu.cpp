@@ -0,0 +1,167 @@
+/* *******************************************************************************
+ * File: src/imu.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Strapdown integration. Over one interval with constant rate w
+ *              and specific force a, phi = w dt and R(s) = R_k Exp(w s):
+ *                v += g dt   + R_k G1(phi) a dt
+ *                p += v dt + g dt^2 / 2 + R_k G2(phi) a dt^2
+ *                R  = R_k Exp(phi)
+ *              with G1 = I + c1 [phi]x + c2 [phi]x^2 and
+ *              G2 = I/2 + c2 [phi]x + c3 [phi]x^2 the first and second
+ *              integrals of Exp. Preintegration runs the same step with
+ *              R_k relative to the keyframe and g = 0.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "imu.hpp"
+#include "instrumentation.hpp"
+#include "quaternion.hpp"
+#include "trig.hpp"
+#include <math.h>
+
+namespace AdasTools {
+
+namespace {
+
+inline Point3 cross(const Point3 &a, const Point3 &b)
+{
+    return Point3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+/** Result of one interval relative to the orientation at its start. */
+struct Step {
+    Quaternion rotation; // R_k Exp(phi), normalized
+    Point3 dv;           // R_k G1 a dt
+    Point3 dp;           // R_k G2 a dt^2
+};
+
+inline Step integrateStep(const Quaternion &q, const Point3 &w, const Point3 &a, double dt)
+{
+    const Point3 phi{ w.x * dt, w.y * dt, w.z * dt };
+    const double t2 = phi.x * phi.x + phi.y * phi.y + phi.z * phi.z;
+    double c1, c2, c3; // (1 - cos)/t^2, (t - sin)/t^3, (t^2/2 + cos - 1)/t^4
+    if (t2 < 2.5e-3) {
+        // |phi| < 0.05: series, truncation below 1e-13 relative (closed forms cancel here)
+        c1 = 0.5 - t2 / 24.0 + t2 * t2 / 720.0;
+        c2 = 1.0 / 6.0 - t2 / 120.0 + t2 * t2 / 5040.0;
+        c3 = 1.0 / 24.0 - t2 / 720.0 + t2 * t2 / 40320.0;
+    } else {
+        const double t = sqrt(t2);
+        double s, c;
+        sinCos(t, s, c, TRIG_SINCOS); // the closed forms cancel; keep full accuracy
+        c1 = (1.0 - c) / t2;
+        c2 = (t - s) / (t2 * t);
+        c3 = (0.5 * t2 + c - 1.0) / (t2 * t2);
+    }
+    const Point3 pa = cross(phi, a), ppa = cross(phi, pa);
+    const Point3 g1{ a.x + c1 * pa.x + c2 * ppa.x, a.y + c1 * pa.y + c2 * ppa.y, a.z + c1 * pa.z + c2 * ppa.z };
+    const Point3 g2{ 0.5 * a.x + c2 * pa.x + c3 * ppa.x, 0.5 * a.y + c2 * pa.y + c3 * ppa.y,
+                     0.5 * a.z + c2 * pa.z + c3 * ppa.z };
+    Step s;
+    const Point3 v = rotateByQuaternion(q, g1), p = rotateByQuaternion(q, g2);
+    s.dv = Point3{ v.x * dt, v.y * dt, v.z * dt };
+    s.dp = Point3{ p.x * dt * dt, p.y * dt * dt, p.z * dt * dt };
+    s.rotation = normalizeQuaternion(multiplyQuaternion(q, quaternionExp(phi)));
+    return s;
+}
+
+inline Point3 unbiased(const Point3 &m, const Point3 &b) { return Point3{ m.x - b.x, m.y - b.y, m.z - b.z }; }
+
+} // namespace
+
+ImuPreintegration startPreintegration(double stamp)
+{
+    ImuPreintegration pre;
+    pre.startStamp = pre.stamp = stamp;
+    pre.rotation = Quaternion{ 1.0, 0.0, 0.0, 0.0 };
+    pre.velocity = pre.position = Point3{ 0.0, 0.0, 0.0 };
+    return pre;
+}
+
+size_t preintegrateImu(ImuPreintegration &pre, const ImuSample *samples, size_t n, const ImuBias &bias)
+{
+    ADAS_PROFILE_SCOPE(PROBE_IMU_PREINTEGRATE, n);
+    size_t used = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double dt = samples[i].stamp - pre.stamp;
+        if (!(dt > 0.0)) continue;
+        const Step s = integrateStep(pre.rotation, unbiased(samples[i].gyro, bias.gyro),
+                                     unbiased(samples[i].accel, bias.accel), dt);
+        pre.position.x += pre.velocity.x * dt + s.dp.x;
+        pre.position.y += pre.velocity.y * dt + s.dp.y;
+        pre.position.z += pre.velocity.z * dt + s.dp.z;
+        pre.velocity.x += s.dv.x;
+        pre.velocity.y += s.dv.y;
+        pre.velocity.z += s.dv.z;
+        pre.rotation = s.rotation;
+        pre.stamp = samples[i].stamp;
+        ++used;
+    }
+    return used;
+}
+
+NavState predictNavState(const NavState &start, const ImuPreintegration &pre, const Point3 &gravity)
+{
+    const double T = pre.stamp - pre.startStamp;
+    const Quaternion &q = start.pose.q;
+    const Point3 dv = rotateByQuaternion(q, pre.velocity), dp = rotateByQuaternion(q, pre.position);
+    NavState out;
+    out.stamp = pre.stamp;
+    out.pose.q = normalizeQuaternion(multiplyQuaternion(q, pre.rotation));
+    out.pose.t = Point3{ start.pose.t.x + start.velocity.x * T + 0.5 * gravity.x * T * T + dp.x,
+                         start.pose.t.y + start.velocity.y * T + 0.5 * gravity.y * T * T + dp.y,
+                         start.pose.t.z + start.velocity.z * T + 0.5 * gravity.z * T * T + dp.z };
+    out.velocity = Point3{ start.velocity.x + gravity.x * T + dv.x, start.velocity.y + gravity.y * T + dv.y,
+                           start.velocity.z + gravity.z * T + dv.z };
+    return out;
+}
+
+ImuPropagator::ImuPropagator() : state_(), gravity_{ 0.0, 0.0, -kStandardGravity }, bias_()
+{
+    state_.pose = identityTransform();
+}
+
+size_t ImuPropagator::integrate(const ImuSample *samples, size_t n, NavState *outputs, Trajectory *trajectory)
+{
+    size_t used = 0;
+    NavState prev = state_, st = state_;
+    for (size_t i = 0; i < n; ++i) {
+        const double dt = samples[i].stamp - st.stamp;
+        if (!(dt > 0.0)) continue;
+        const Step s = integrateStep(st.pose.q, unbiased(samples[i].gyro, bias_.gyro),
+                                     unbiased(samples[i].accel, bias_.accel), dt);
+        st.pose.t.x += st.velocity.x * dt + 0.5 * gravity_.x * dt * dt + s.dp.x;
+        st.pose.t.y += st.velocity.y * dt + 0.5 * gravity_.y * dt * dt + s.dp.y;
+        st.pose.t.z += st.velocity.z * dt + 0.5 * gravity_.z * dt * dt + s.dp.z;
+        st.velocity.x += gravity_.x * dt + s.dv.x;
+        st.velocity.y += gravity_.y * dt + s.dv.y;
+        st.velocity.z += gravity_.z * dt + s.dv.z;
+        st.pose.q = s.rotation;
+        st.stamp = samples[i].stamp;
+        if (trajectory && !trajectory->append(st.stamp, st.pose)) {
+            st = prev; // not recorded: leave the state at the last recorded sample
+            break;
+        }
+        if (outputs) outputs[used] = st;
+        prev = st;
+        ++used;
+    }
+    state_ = st;
+    return used;
+}
+
+size_t ImuPropagator::propagate(const ImuSample *samples, size_t n, NavState *outputs)
+{
+    ADAS_PROFILE_SCOPE(PROBE_IMU_PROPAGATE, n);
+    return integrate(samples, n, outputs, nullptr);
+}
+
+size_t ImuPropagator::propagate(const ImuSample *samples, size_t n, Trajectory &trajectory)
+{
+    ADAS_PROFILE_SCOPE(PROBE_IMU_PROPAGATE, n);
+    trajectory.reserve(trajectory.size() + n); // one allocation up front; append() still grows on its own
+    return integrate(samples, n, nullptr, &trajectory);
+}
+
+} // namespace AdasTools
@@ -0,0 +1,184 @@
+/* *******************************************************************************
+ * File: src/instrumentation.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Per-thread counter blocks for the hot-path instrumentation.
+ *              Each thread owns one block (allocated on its first record and
+ *              linked into a global lock-free list); only the owner writes it,
+ *              readers sum all blocks with relaxed atomic loads.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "instrumentation.hpp"
+#include <atomic>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ADAS_PROFILE_HAVE_TSC 1
+#endif
+
+namespace AdasTools {
+
+namespace {
+
+struct ThreadCounters {
+    std::atomic<unsigned long long> calls[PROBE_COUNT];
+    std::atomic<unsigned long long> points[PROBE_COUNT];
+    std::atomic<unsigned long long> ticks[PROBE_COUNT];
+    ThreadCounters *next;
+};
+
+std::atomic<ThreadCounters *> g_threadList{ nullptr };
+thread_local ThreadCounters *t_counters = nullptr;
+
+ThreadCounters *threadCounters()
+{
+    if (t_counters) return t_counters;
+    // Blocks are never freed so counts of exited threads stay visible.
+    ThreadCounters *c = new ThreadCounters();
+    for (int i = 0; i < PROBE_COUNT; ++i) {
+        c->calls[i].store(0, std::memory_order_relaxed);
+        c->points[i].store(0, std::memory_order_relaxed);
+        c->ticks[i].store(0, std::memory_order_relaxed);
+    }
+    c->next = g_threadList.load(std::memory_order_relaxed);
+    while (!g_threadList.compare_exchange_weak(c->next, c, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    t_counters = c;
+    return c;
+}
+
+// Owner-only increment: a plain load/store pair avoids a locked RMW.
+inline void bump(std::atomic<unsigned long long> &v, unsigned long long d)
+{
+    v.store(v.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+}
+
+unsigned long long steadyNanoseconds()
+{
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double calibrateTicksPerSecond()
+{
+#if defined(ADAS_PROFILE_HAVE_TSC)
+    // Measure the TSC against the steady clock over ~10 ms.
+    unsigned long long n0 = steadyNanoseconds();
+    unsigned long long t0 = __rdtsc();
+    unsigned long long n1 = n0;
+    while (n1 - n0 < 10000000ull) n1 = steadyNanoseconds();
+    unsigned long long t1 = __rdtsc();
+    return (double)(t1 - t0) * 1e9 / (double)(n1 - n0);
+#else
+    return 1e9;
+#endif
+}
+
+} // namespace
+
+bool profileEnabled()
+{
+#if defined(ADAS_TOOLS_ENABLE_INSTRUMENTATION)
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned long long profileTicks()
+{
+#if defined(ADAS_PROFILE_HAVE_TSC)
+    return __rdtsc();
+#else
+    return steadyNanoseconds();
+#endif
+}
+
+void profileRecord(ProfileProbe probe, unsigned long long points, unsigned long long ticks)
+{
+    if ((unsigned)probe >= (unsigned)PROBE_COUNT) return;
+    ThreadCounters *c = threadCounters();
+    bump(c->calls[probe], 1);
+    bump(c->points[probe], points);
+    bump(c->ticks[probe], ticks);
+}
+
+void profileSnapshot(ProfileSnapshot &out)
+{
+    static const double ticksPerSecond = calibrateTicksPerSecond();
+    for (int i = 0; i < PROBE_COUNT; ++i) {
+        out.probes[i].calls = 0;
+        out.probes[i].points = 0;
+        out.probes[i].ticks = 0;
+    }
+    for (ThreadCounters *c = g_threadList.load(std::memory_order_acquire); c; c = c->next) {
+        for (int i = 0; i < PROBE_COUNT; ++i) {
+            out.probes[i].calls += c->calls[i].load(std::memory_order_relaxed);
+            out.probes[i].points += c->points[i].load(std::memory_order_relaxed);
+            out.probes[i].ticks += c->ticks[i].load(std::memory_order_relaxed);
+        }
+    }
+    out.ticksPerSecond = ticksPerSecond;
+}
+
+void profileReset()
+{
+    for (ThreadCounters *c = g_threadList.load(std::memory_order_acquire); c; c = c->next) {
+        for (int i = 0; i < PROBE_COUNT; ++i) {
+            c->calls[i].store(0, std::memory_order_relaxed);
+            c->points[i].store(0, std::memory_order_relaxed);
+            c->ticks[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const char *profileProbeName(ProfileProbe probe)
+{
+    switch (probe) {
+    case PROBE_LOCAL_TO_GLOBAL: return "localToGlobal";
+    case PROBE_GLOBAL_TO_LOCAL: return "globalToLocal";
+    case PROBE_LOCAL_TO_GLOBAL_FROM_MATRIX: return "localToGlobalFromMatrix";
+    case PROBE_GLOBAL_TO_LOCAL_FROM_MATRIX: return "globalToLocalFromMatrix";
+    case PROBE_PROJECT_POINT_CAMERA: return "projectPointCamera";
+    case PROBE_SLERP: return "slerp";
+    case PROBE_PROJECT_MULTI_CAMERA: return "projectMultiCamera";
+    case PROBE_PROJECT_BOXES: return "projectBoxesToImage";
+    case PROBE_FILTER_POINTS: return "filterPoints";
+    case PROBE_GROUND_SEGMENTATION: return "segmentGround";
+    case PROBE_CLUSTER_POINTS: return "clusterPoints";
+    case PROBE_ICP_REGISTRATION: return "registerPointToPlane";
+    case PROBE_REPROJECTION_ERROR: return "evaluateReprojection";
+    case PROBE_RANGE_ENCODE: return "encodeRangeImage";
+    case PROBE_RANGE_DECODE: return "decodeRangeImage";
+    case PROBE_BEV_WARP: return "warpBev";
+    case PROBE_DEPTH_UNPROJECT: return "unprojectDepth";
+    case PROBE_ACCUMULATE_INSERT: return "accumulateSweep";
+    case PROBE_ACCUMULATE_EXTRACT: return "extractAccumulated";
+    case PROBE_RAY_CAST: return "castRays";
+    case PROBE_VISIBILITY: return "checkVisibility";
+    case PROBE_CARVE_FREE_SPACE: return "carveFreeSpace";
+    case PROBE_IMU_PROPAGATE: return "propagateImu";
+    case PROBE_IMU_PREINTEGRATE: return "preintegrateImu";
+    case PROBE_GEODETIC_TO_CARTESIAN: return "geodeticToCartesian";
+    case PROBE_CARTESIAN_TO_GEODETIC: return "cartesianToGeodetic";
+    case PROBE_RIGID_COMPOSE: return "rigidComposeBatch";
+    case PROBE_RIGID_INVERSE: return "rigidInverseBatch";
+    case PROBE_RIGID_TRANSFORM_POINTS: return "rigidTransformPoints";
+    case PROBE_TRAJECTORY_RELATIVE: return "trajectoryRelative";
+    case PROBE_TRAJECTORY_INTERPOLATE: return "trajectoryInterpolate";
+    case PROBE_POSE_LOG_READ: return "readPoseLog";
+    case PROBE_POSE_LOG_WRITE: return "writePoseLog";
+    case PROBE_COMPACT_ENCODE: return "encodePoints";
+    case PROBE_COMPACT_DECODE: return "decodePoints";
+    case PROBE_COMPACT_TRANSFORM: return "rigidTransformPointsCompact";
+    case PROBE_POSES_TO_MATRICES: return "posesToMatrices";
+    case PROBE_POSES_TO_TRANSFORMS: return "posesToTransforms";
+    case PROBE_BOXES_TRANSFORM: return "boxesTransform";
+    case PROBE_BOXES_LOCAL_TO_GLOBAL: return "boxesLocalToGlobal";
+    default: return "unknown";
+    }
+}
+
+} // namespace AdasTools
@@ -0,0 +1,331 @@
+/* *******************************************************************************
+ * File: src/ipm.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Camera-to-BEV remap tables and warping. Samples store the
+ *              top-left pixel of the bilinear footprint and 7-bit fractions,
+ *              so a 2x2 interpolation is four 16-bit multiply-adds; 3- and
+ *              4-channel images do all channels at once with SSE2 madd
+ *              (x86-64 baseline, no run-time dispatch needed). The scalar
+ *              path computes the same integers.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "ipm.hpp"
+#include "instrumentation.hpp"
+#include "multicam.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ADAS_IPM_SSE2 1
+#endif
+
+namespace AdasTools {
+
+/** One source of a BEV cell. */
+struct BevSample {
+    unsigned short x;     // left column of the 2x2 footprint
+    unsigned short y;     // top row of the 2x2 footprint
+    unsigned char fx;     // horizontal fraction, 0..128
+    unsigned char fy;     // vertical fraction, 0..128
+    unsigned char camera; // source camera, kNoCamera = none
+    unsigned char weight; // blend weight, 0..128
+};
+
+static_assert(sizeof(BevSample) == 8, "BevSample must stay 8 bytes");
+
+namespace {
+
+const unsigned char kNoCamera = 0xFF;
+const unsigned kRowBlock = 8; // BEV rows per task
+
+struct PackedCamera {
+    double r[12];
+    double fx, s, cx, fy, cy;
+    double maxU, maxV, minDepth;
+};
+
+BevSample makeSample(double u, double v, unsigned char camera, unsigned char weight, const PackedCamera &c)
+{
+    BevSample s;
+    double x0 = floor(u), y0 = floor(v);
+    int fx = (int)lrint((u - x0) * 128.0), fy = (int)lrint((v - y0) * 128.0);
+    if (fx == 128) { x0 += 1.0; fx = 0; }
+    if (fy == 128) { y0 += 1.0; fy = 0; }
+    // keep the 2x2 footprint inside the image: the last column/row is reached with fraction 128
+    if (x0 > c.maxU - 1.0) { x0 = c.maxU - 1.0; fx = 128; }
+    if (y0 > c.maxV - 1.0) { y0 = c.maxV - 1.0; fy = 128; }
+    s.x = (unsigned short)x0;
+    s.y = (unsigned short)y0;
+    s.fx = (unsigned char)fx;
+    s.fy = (unsigned char)fy;
+    s.camera = camera;
+    s.weight = weight;
+    return s;
+}
+
+struct BuildJob {
+    const PackedCamera *cams;
+    size_t count;
+    const BevGridSpec *grid;
+    double feather;
+    BevSample *table;
+
+    void operator()(size_t task)
+    {
+        const BevGridSpec &g = *grid;
+        const unsigned first = (unsigned)task * kRowBlock;
+        const unsigned last = first + kRowBlock < g.rows ? first + kRowBlock : g.rows;
+        const BevSample none{ 0, 0, 0, 0, kNoCamera, 0 };
+        for (unsigned row = first; row < last; ++row) {
+            const double x = g.xMax - (row + 0.5) * g.resolution;
+            for (unsigned col = 0; col < g.cols; ++col) {
+                const double y = g.yMax - (col + 0.5) * g.resolution;
+                const double z = -(g.plane.d + g.plane.nx * x + g.plane.ny * y) / g.plane.nz;
+                // two most interior projections
+                double best[2] = { -1.0, -1.0 }, bu[2] = { 0.0, 0.0 }, bv[2] = { 0.0, 0.0 };
+                size_t bc[2] = { 0, 0 };
+                for (size_t k = 0; k < count; ++k) {
+                    const PackedCamera &c = cams[k];
+                    const double xc = c.r[0] * x + c.r[1] * y + c.r[2] * z + c.r[3];
+                    const double yc = c.r[4] * x + c.r[5] * y + c.r[6] * z + c.r[7];
+                    const double zc = c.r[8] * x + c.r[9] * y + c.r[10] * z + c.r[11];
+                    if (!(zc > c.minDepth)) continue;
+                    const double iz = 1.0 / zc;
+                    const double u = c.fx * xc * iz + c.s * yc * iz + c.cx, v = c.fy * yc * iz + c.cy;
+                    if (!(u >= 0.0 && v >= 0.0 && u <= c.maxU && v <= c.maxV)) continue;
+                    double score = u < c.maxU - u ? u : c.maxU - u;
+                    score = v < score ? v : score;
+                    score = c.maxV - v < score ? c.maxV - v : score;
+                    if (score > best[0]) {
+                        best[1] = best[0]; bu[1] = bu[0]; bv[1] = bv[0]; bc[1] = bc[0];
+                        best[0] = score; bu[0] = u; bv[0] = v; bc[0] = k;
+                    } else if (score > best[1]) {
+                        best[1] = score; bu[1] = u; bv[1] = v; bc[1] = k;
+                    }
+                }
+                BevSample *out = table + 2 * ((size_t)row * g.cols + col);
+                out[0] = none;
+                out[1] = none;
+                if (best[0] < 0.0) continue;
+                unsigned weight = 128;
+                if (feather > 0.0 && best[1] >= 0.0) {
+                    const double wa = best[0] < feather ? best[0] : feather;
+                    const double wb = best[1] < feather ? best[1] : feather;
+                    if (wa + wb > 0.0) weight = (unsigned)lrint(128.0 * wa / (wa + wb));
+                }
+                out[0] = makeSample(bu[0], bv[0], (unsigned char)bc[0], (unsigned char)weight, cams[bc[0]]);
+                if (weight < 128) out[1] = makeSample(bu[1], bv[1], (unsigned char)bc[1], (unsigned char)(128 - weight), cams[bc[1]]);
+            }
+        }
+    }
+};
+
+// Bilinear sample of all C channels (rounded, same integers as the SSE2 path).
+template <int C>
+inline void sampleScalar(const ImageU8 &img, const BevSample &s, int out[4])
+{
+    const unsigned char *p = img.data + (size_t)s.y * img.stride + (size_t)s.x * C;
+    const unsigned char *q = p + img.stride;
+    const int w00 = (128 - s.fx) * (128 - s.fy), w01 = s.fx * (128 - s.fy);
+    const int w10 = (128 - s.fx) * s.fy, w11 = s.fx * s.fy;
+    for (int c = 0; c < C; ++c) out[c] = (p[c] * w00 + p[C + c] * w01 + q[c] * w10 + q[C + c] * w11 + 8192) >> 14;
+}
+
+template <int C>
+inline void warpCellScalar(const ImageU8 *frames, const BevSample *s, unsigned char *out)
+{
+    int a[4], b[4];
+    sampleScalar<C>(frames[s[0].camera], s[0], a);
+    if (s[1].camera != kNoCamera) {
+        sampleScalar<C>(frames[s[1].camera], s[1], b);
+        for (int c = 0; c < C; ++c) a[c] = (a[c] * s[0].weight + b[c] * s[1].weight + 64) >> 7;
+    }
+    for (int c = 0; c < C; ++c) out[c] = (unsigned char)a[c];
+}
+
+#if defined(ADAS_IPM_SSE2)
+inline __m128i load4(const unsigned char *p)
+{
+    int v;
+    memcpy(&v, p, 4);
+    return _mm_unpacklo_epi8(_mm_cvtsi32_si128(v), _mm_setzero_si128());
+}
+
+// Four channels of one bilinear sample as int32 lanes: (row0 . w0 + row1 . w1 + 8192) >> 14.
+inline __m128i sampleSse2(const ImageU8 &img, const BevSample &s, int C)
+{
+    const unsigned char *p = img.data + (size_t)s.y * img.stride + (size_t)s.x * C;
+    const unsigned char *q = p + img.stride;
+    const int w00 = (128 - s.fx) * (128 - s.fy), w01 = s.fx * (128 - s.fy);
+    const int w10 = (128 - s.fx) * s.fy, w11 = s.fx * s.fy;
+    const __m128i top = _mm_unpacklo_epi16(load4(p), load4(p + C));
+    const __m128i bottom = _mm_unpacklo_epi16(load4(q), load4(q + C));
+    __m128i sum = _mm_add_epi32(_mm_madd_epi16(top, _mm_set1_epi32(w00 | (w01 << 16))),
+                                _mm_madd_epi16(bottom, _mm_set1_epi32(w10 | (w11 << 16))));
+    return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(8192)), 14);
+}
+
+template <int C>
+inline void warpCellSse2(const ImageU8 *frames, const BevSample *s, unsigned char *out)
+{
+    __m128i a = sampleSse2(frames[s[0].camera], s[0], C);
+    if (s[1].camera != kNoCamera) {
+        const __m128i b = sampleSse2(frames[s[1].camera], s[1], C);
+        const __m128i ab = _mm_unpacklo_epi16(_mm_packs_epi32(a, a), _mm_packs_epi32(b, b));
+        a = _mm_madd_epi16(ab, _mm_set1_epi32(s[0].weight | (s[1].weight << 16)));
+        a = _mm_srai_epi32(_mm_add_epi32(a, _mm_set1_epi32(64)), 7);
+    }
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, a), a);
+    const int v = _mm_cvtsi128_si32(packed);
+    memcpy(out, &v, C);
+}
+
+// 4-byte loads of the right-hand pixels of a 3-channel footprint read one byte past
+// the pixel; only the very last pixel of an image has no byte after it.
+inline bool safeForWideLoads(const ImageU8 &img, const BevSample &s)
+{
+    return (int)s.y + 2 < img.height || (int)s.x + 2 < img.width;
+}
+#endif
+
+struct WarpJob {
+    const BevSample *table;
+    const ImageU8 *frames;
+    const ImageU8 *bev;
+    unsigned rows, cols;
+
+    template <int C>
+    void warpRows(unsigned first, unsigned last)
+    {
+        for (unsigned row = first; row < last; ++row) {
+            const BevSample *s = table + 2 * (size_t)row * cols;
+            unsigned char *out = bev->data + (size_t)row * bev->stride;
+            for (unsigned col = 0; col < cols; ++col, s += 2, out += C) {
+                if (s[0].camera == kNoCamera) {
+                    for (int c = 0; c < C; ++c) out[c] = 0;
+                    continue;
+                }
+#if defined(ADAS_IPM_SSE2)
+                if (C == 4 || (C == 3 && safeForWideLoads(frames[s[0].camera], s[0]) &&
+                               (s[1].camera == kNoCamera || safeForWideLoads(frames[s[1].camera], s[1])))) {
+                    warpCellSse2<C>(frames, s, out);
+                    continue;
+                }
+#endif
+                warpCellScalar<C>(frames, s, out);
+            }
+        }
+    }
+
+    void operator()(size_t task)
+    {
+        const unsigned first = (unsigned)task * kRowBlock;
+        const unsigned last = first + kRowBlock < rows ? first + kRowBlock : rows;
+        switch (bev->channels) {
+        case 1: warpRows<1>(first, last); break;
+        case 2: warpRows<2>(first, last); break;
+        case 3: warpRows<3>(first, last); break;
+        default: warpRows<4>(first, last); break;
+        }
+    }
+};
+
+} // namespace
+
+BevRemap::BevRemap() : grid_(), cams_(), count_(0), covered_(0), table_(nullptr) {}
+
+BevRemap::~BevRemap() { free(table_); }
+
+bool BevRemap::build(const CameraModel *cameras, size_t count, const BevGridSpec &grid, double featherPixels,
+                     TaskPool *pool)
+{
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "BevRemap::build");
+    free(table_);
+    table_ = nullptr;
+    count_ = 0;
+    covered_ = 0;
+    grid_ = BevGridSpec();
+    if (!cameras || count == 0 || count > kBevMaxCameras || grid.rows == 0 || grid.cols == 0 ||
+        !(grid.resolution > 0.0) || !(grid.plane.nz > 0.0)) {
+        return false;
+    }
+    PackedCamera cams[kBevMaxCameras];
+    for (size_t k = 0; k < count; ++k) {
+        const CameraModel &m = cameras[k];
+        if (m.width < 2 || m.height < 2 || m.width > 65535 || m.height > 65535) return false;
+        for (int i = 0; i < 12; ++i) cams[k].r[i] = m.extrinsic[i];
+        cams[k].fx = m.intrinsic[0];
+        cams[k].s = m.intrinsic[1];
+        cams[k].cx = m.intrinsic[2];
+        cams[k].fy = m.intrinsic[4];
+        cams[k].cy = m.intrinsic[5];
+        cams[k].maxU = m.width - 1.0;
+        cams[k].maxV = m.height - 1.0;
+        cams[k].minDepth = m.minDepth;
+    }
+    const size_t cells = (size_t)grid.rows * grid.cols;
+    table_ = (BevSample *)malloc(2 * cells * sizeof(BevSample));
+    if (!table_) return false;
+
+    BuildJob job{ cams, count, &grid, featherPixels, table_ };
+    (pool ? pool : defaultTaskPool())->parallelFor((grid.rows + kRowBlock - 1) / kRowBlock, job);
+
+    grid_ = grid;
+    count_ = count;
+    for (size_t k = 0; k < count; ++k) {
+        cams_[k].width = cameras[k].width;
+        cams_[k].height = cameras[k].height;
+    }
+    for (size_t i = 0; i < cells; ++i) covered_ += table_[2 * i].camera != kNoCamera;
+    return true;
+}
+
+bool BevRemap::warp(const ImageU8 *frames, ImageU8 &bev, TaskPool *pool) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_BEV_WARP, (size_t)grid_.rows * grid_.cols);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_RASTERIZE, "BevRemap::warp");
+    if (!table_ || !frames || !bev.data) return false;
+    const int channels = bev.channels;
+    if (channels < 1 || channels > 4 || bev.width != (int)grid_.cols || bev.height != (int)grid_.rows ||
+        bev.stride < (size_t)bev.width * channels) {
+        return false;
+    }
+    for (size_t k = 0; k < count_; ++k) {
+        const ImageU8 &f = frames[k];
+        if (!f.data || f.channels != channels || f.width != cams_[k].width || f.height != cams_[k].height ||
+            f.stride < (size_t)f.width * channels) {
+            return false;
+        }
+    }
+    WarpJob job{ table_, frames, &bev, grid_.rows, grid_.cols };
+    (pool ? pool : defaultTaskPool())->parallelFor((grid_.rows + kRowBlock - 1) / kRowBlock, job);
+    return true;
+}
+
+Point3 BevRemap::cellCenter(unsigned row, unsigned col) const
+{
+    const double x = grid_.xMax - (row + 0.5) * grid_.resolution;
+    const double y = grid_.yMax - (col + 0.5) * grid_.resolution;
+    const double nz = grid_.plane.nz > 0.0 ? grid_.plane.nz : 1.0;
+    return Point3{ x, y, -(grid_.plane.d + grid_.plane.nx * x + grid_.plane.ny * y) / nz };
+}
+
+int BevRemap::cellCamera(unsigned row, unsigned col) const
+{
+    if (!table_ || row >= grid_.rows || col >= grid_.cols) return -1;
+    const unsigned char c = table_[2 * ((size_t)row * grid_.cols + col)].camera;
+    return c == kNoCamera ? -1 : (int)c;
+}
+
+size_t BevRemap::tableBytes() const
+{
+    return table_ ? 2 * (size_t)grid_.rows * grid_.cols * sizeof(BevSample) : 0;
+}
+
+} // namespace AdasTools
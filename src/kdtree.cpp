@@ -0,0 +1,266 @@
+/* *******************************************************************************
+ * File: src/kdtree.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Flat KD-tree build (in-place quickselect on the widest axis)
+ *              and stack-based nearest / k-nearest queries.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "kdtree.hpp"
+#include <stdlib.h>
+
+namespace AdasTools {
+
+struct PointKdTree::Node {
+    float split;    /**< split coordinate (inner nodes) */
+    unsigned axis;  /**< 0..2, or kLeaf */
+    unsigned right; /**< right child (left child = this + 1) */
+    unsigned first; /**< first slot of the subtree */
+    unsigned count; /**< slots in the subtree */
+};
+
+namespace {
+
+const unsigned kLeaf = 3;
+const size_t kLeafSize = 16;
+const int kStackDepth = 64;
+const float kPadding = 1e30f; // coordinates of the slots after the last point
+
+// Leaves hold 8..16 points once n > 16, so a tree never has more than n/4 + 1 nodes.
+size_t maxNodes(size_t n) { return n / 4 + 1; }
+
+void swapSlots(float *c[3], unsigned *index, size_t a, size_t b)
+{
+    for (int k = 0; k < 3; ++k) {
+        const float t = c[k][a];
+        c[k][a] = c[k][b];
+        c[k][b] = t;
+    }
+    const unsigned t = index[a];
+    index[a] = index[b];
+    index[b] = t;
+}
+
+float median3(float a, float b, float c)
+{
+    if (a > b) { const float t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return a > b ? a : b;
+}
+
+// Quickselect: afterwards slot k holds the k-th smallest key of [lo, hi],
+// everything before it is <= and everything after it is >=.
+void selectNth(float *c[3], unsigned *index, long long lo, long long hi, long long k, unsigned axis)
+{
+    const float *key = c[axis];
+    while (hi > lo) {
+        const float pivot = median3(key[lo], key[lo + (hi - lo) / 2], key[hi]);
+        long long i = lo, j = hi;
+        while (i <= j) {
+            while (key[i] < pivot) ++i;
+            while (key[j] > pivot) --j;
+            if (i <= j) {
+                swapSlots(c, index, (size_t)i, (size_t)j);
+                ++i;
+                --j;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else return;
+    }
+}
+
+} // namespace
+
+size_t PointKdTree::buildRange(size_t first, size_t count, size_t &used)
+{
+    const size_t id = used++;
+    Node &node = nodes_[id];
+    node.first = (unsigned)first;
+    node.count = (unsigned)count;
+    node.right = 0;
+    node.split = 0.0f;
+    if (count <= kLeafSize) {
+        node.axis = kLeaf;
+        return id;
+    }
+    float *c[3] = { xs_, ys_, zs_ };
+    float lo[3], hi[3];
+    for (int k = 0; k < 3; ++k) lo[k] = hi[k] = c[k][first];
+    for (size_t s = first + 1; s < first + count; ++s) {
+        for (int k = 0; k < 3; ++k) {
+            const float v = c[k][s];
+            lo[k] = v < lo[k] ? v : lo[k];
+            hi[k] = v > hi[k] ? v : hi[k];
+        }
+    }
+    unsigned axis = 0;
+    for (unsigned k = 1; k < 3; ++k) {
+        if (hi[k] - lo[k] > hi[axis] - lo[axis]) axis = k;
+    }
+    const size_t half = count / 2;
+    selectNth(c, index_, (long long)first, (long long)(first + count - 1), (long long)(first + half), axis);
+    node.axis = axis;
+    node.split = c[axis][first + half];
+    buildRange(first, half, used);
+    node.right = (unsigned)buildRange(first + half, count - half, used);
+    return id;
+}
+
+PointKdTree::PointKdTree()
+    : block_(nullptr), nodes_(nullptr), xs_(nullptr), ys_(nullptr), zs_(nullptr), index_(nullptr), slot_(nullptr),
+      size_(0), capacity_(0)
+{
+}
+
+PointKdTree::~PointKdTree()
+{
+    free(block_);
+}
+
+bool PointKdTree::build(const Point3 *points, size_t n)
+{
+    size_ = 0;
+    if (n >= (size_t)kNoNeighbor) return false;
+    if (n > capacity_) {
+        const size_t slots = n + kLeafSize;
+        const size_t bytes = maxNodes(n) * sizeof(Node) + slots * 3 * sizeof(float) + n * 2 * sizeof(unsigned);
+        void *block = malloc(bytes);
+        if (!block) return false;
+        free(block_);
+        block_ = block;
+        capacity_ = n;
+        nodes_ = static_cast<Node *>(block_);
+        char *cursor = static_cast<char *>(block_) + maxNodes(n) * sizeof(Node);
+        xs_ = reinterpret_cast<float *>(cursor); cursor += slots * sizeof(float);
+        ys_ = reinterpret_cast<float *>(cursor); cursor += slots * sizeof(float);
+        zs_ = reinterpret_cast<float *>(cursor); cursor += slots * sizeof(float);
+        index_ = reinterpret_cast<unsigned *>(cursor); cursor += n * sizeof(unsigned);
+        slot_ = reinterpret_cast<unsigned *>(cursor);
+    }
+    if (n == 0) return true;
+    for (size_t i = 0; i < n; ++i) {
+        xs_[i] = (float)points[i].x;
+        ys_[i] = (float)points[i].y;
+        zs_[i] = (float)points[i].z;
+        index_[i] = (unsigned)i;
+    }
+    for (size_t i = n; i < n + kLeafSize; ++i) xs_[i] = ys_[i] = zs_[i] = kPadding;
+    size_t used = 0;
+    buildRange(0, n, used);
+    for (size_t s = 0; s < n; ++s) slot_[index_[s]] = (unsigned)s;
+    size_ = n;
+    return true;
+}
+
+unsigned int PointKdTree::nearest(const Point3 &q, double maxDistance, double *distanceSq, unsigned int hint) const
+{
+    if (size_ == 0) return kNoNeighbor;
+    const float qx = (float)q.x, qy = (float)q.y, qz = (float)q.z;
+    const float qv[3] = { qx, qy, qz };
+    float best = (float)(maxDistance * maxDistance);
+    unsigned bestSlot = kNoNeighbor;
+    if (hint < size_) {
+        const unsigned s = slot_[hint];
+        const float dx = xs_[s] - qx, dy = ys_[s] - qy, dz = zs_[s] - qz;
+        const float d = dx * dx + dy * dy + dz * dz;
+        if (d < best) { best = d; bestSlot = s; }
+    }
+
+    unsigned stackNode[kStackDepth];
+    float stackBound[kStackDepth];
+    int top = 0;
+    stackNode[top] = 0;
+    stackBound[top++] = 0.0f;
+    while (top > 0) {
+        --top;
+        const float reached = stackBound[top];
+        if (reached >= best) continue;
+        const Node *node = nodes_ + stackNode[top];
+        while (node->axis != kLeaf) {
+            const float diff = qv[node->axis] - node->split;
+            const unsigned nearChild = diff < 0.0f ? (unsigned)(node - nodes_) + 1 : node->right;
+            const unsigned farChild = diff < 0.0f ? node->right : (unsigned)(node - nodes_) + 1;
+            const float bound = diff * diff > reached ? diff * diff : reached;
+            if (bound < best) {
+                stackNode[top] = farChild;
+                stackBound[top++] = bound;
+            }
+            node = nodes_ + nearChild;
+        }
+        // Always scan kLeafSize slots: the overhang reads real points of the
+        // next leaf (harmless for a single nearest) or the far-away padding.
+        const unsigned first = node->first;
+        float d[kLeafSize];
+        for (size_t k = 0; k < kLeafSize; ++k) {
+            const float dx = xs_[first + k] - qx, dy = ys_[first + k] - qy, dz = zs_[first + k] - qz;
+            d[k] = dx * dx + dy * dy + dz * dz;
+        }
+        for (size_t k = 0; k < kLeafSize; ++k) {
+            if (d[k] < best) { best = d[k]; bestSlot = first + (unsigned)k; }
+        }
+    }
+    if (bestSlot == kNoNeighbor) return kNoNeighbor;
+    if (distanceSq) *distanceSq = best;
+    return index_[bestSlot];
+}
+
+size_t PointKdTree::nearestK(const Point3 &q, size_t k, double maxDistance, unsigned int *indices, double *distancesSq) const
+{
+    if (k > 64) k = 64;
+    if (size_ == 0 || k == 0) return 0;
+    const float qx = (float)q.x, qy = (float)q.y, qz = (float)q.z;
+    const float qv[3] = { qx, qy, qz };
+    const float limit = (float)(maxDistance * maxDistance);
+    float dist[64];
+    unsigned slots[64];
+    size_t found = 0;
+
+    unsigned stackNode[kStackDepth];
+    float stackBound[kStackDepth];
+    int top = 0;
+    stackNode[top] = 0;
+    stackBound[top++] = 0.0f;
+    while (top > 0) {
+        --top;
+        float worst = found == k ? dist[k - 1] : limit;
+        if (stackBound[top] >= worst) continue;
+        const Node *node = nodes_ + stackNode[top];
+        while (node->axis != kLeaf) {
+            const float diff = qv[node->axis] - node->split;
+            const unsigned nearChild = diff < 0.0f ? (unsigned)(node - nodes_) + 1 : node->right;
+            const unsigned farChild = diff < 0.0f ? node->right : (unsigned)(node - nodes_) + 1;
+            const float bound = diff * diff;
+            if (bound < worst) {
+                stackNode[top] = farChild;
+                stackBound[top++] = bound;
+            }
+            node = nodes_ + nearChild;
+        }
+        const unsigned end = node->first + node->count;
+        for (unsigned s = node->first; s < end; ++s) {
+            const float dx = xs_[s] - qx, dy = ys_[s] - qy, dz = zs_[s] - qz;
+            const float d = dx * dx + dy * dy + dz * dz;
+            if (d >= worst) continue;
+            // insertion into the sorted list (drops the last entry when full)
+            size_t at = found < k ? found++ : k - 1;
+            while (at > 0 && dist[at - 1] > d) {
+                dist[at] = dist[at - 1];
+                slots[at] = slots[at - 1];
+                --at;
+            }
+            dist[at] = d;
+            slots[at] = s;
+            worst = found == k ? dist[k - 1] : limit;
+        }
+    }
+    for (size_t i = 0; i < found; ++i) {
+        indices[i] = index_[slots[i]];
+        if (distancesSq) distancesSq[i] = dist[i];
+    }
+    return found;
+}
+
+} // namespace AdasTools
@@ -0,0 +1,227 @@
+/* *******************************************************************************
+ * File: src/multicam.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Multi-camera one-pass projector. Sector masks are built from
+ *              the azimuth span of each camera's image border rays, widened
+ *              by the worst-case parallax of the camera mounting offset.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "multicam.hpp"
+#include <math.h>
+#include "compact.hpp"
+#include "instrumentation.hpp"
+#include "trace.hpp"
+
+namespace AdasTools {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const size_t kDecodeChunk = 256; // compact points decoded per step (6 KB on the stack)
+
+double wrapAngle(double a)
+{
+    while (a > kPi) a -= 2.0 * kPi;
+    while (a < -kPi) a += 2.0 * kPi;
+    return a;
+}
+
+// True azimuth of a diamond-angle value d in [0, 4].
+double diamondToAngle(double d)
+{
+    double x, y;
+    if (d < 1.0) { x = 1.0 - d; y = d; }
+    else if (d < 2.0) { x = 1.0 - d; y = 2.0 - d; }
+    else if (d < 3.0) { x = d - 3.0; y = 2.0 - d; }
+    else { x = d - 3.0; y = d - 4.0; }
+    return atan2(y, x);
+}
+
+// Camera-frame ray through pixel (u, v) rotated into the cloud frame (R^T d).
+void pixelRay(const double r[12], double fx, double s, double cx, double fy, double cy,
+              double u, double v, double out[3])
+{
+    double dy = (v - cy) / fy;
+    double dx = (u - cx - s * dy) / fx;
+    out[0] = r[0] * dx + r[4] * dy + r[8];
+    out[1] = r[1] * dx + r[5] * dy + r[9];
+    out[2] = r[2] * dx + r[6] * dy + r[10];
+}
+
+// true if the vertical direction (0,0,sign) projects inside the image: the
+// camera then sees every azimuth.
+bool seesVertical(const double r[12], double fx, double s, double cx, double fy, double cy,
+                  double width, double height, double sign)
+{
+    double xc = r[2] * sign, yc = r[6] * sign, zc = r[10] * sign;
+    if (zc <= 0.0) return false;
+    double u = (fx * xc + s * yc) / zc + cx;
+    double v = (fy * yc) / zc + cy;
+    return u >= 0.0 && u <= width && v >= 0.0 && v <= height;
+}
+
+} // namespace
+
+MultiCameraProjector::MultiCameraProjector()
+    : count_(0), radius2_(25.0), bucketing_(true)
+{
+    for (size_t i = 0; i < kMultiCameraSectors; ++i) masks_[i] = 0;
+}
+
+bool MultiCameraProjector::setCameras(const CameraModel *cameras, size_t count, double bucketRadius)
+{
+    count_ = 0;
+    for (size_t i = 0; i < kMultiCameraSectors; ++i) masks_[i] = 0;
+    if (count > kMultiCameraMaxCameras) return false;
+    if (bucketRadius < 1e-6) bucketRadius = 1e-6;
+    radius2_ = bucketRadius * bucketRadius;
+
+    for (size_t c = 0; c < count; ++c) {
+        const CameraModel &m = cameras[c];
+        PackedCamera &p = cams_[c];
+        for (int i = 0; i < 12; ++i) p.r[i] = m.extrinsic[i];
+        p.fx = m.intrinsic[0]; p.s = m.intrinsic[1]; p.cx = m.intrinsic[2];
+        p.fy = m.intrinsic[4]; p.cy = m.intrinsic[5];
+        p.width = (double)m.width; p.height = (double)m.height;
+        p.minDepth = m.minDepth;
+
+        const unsigned int bit = 1u << c;
+        // Camera centre in the cloud frame: -R^T t.
+        double ox = -(p.r[0] * p.r[3] + p.r[4] * p.r[7] + p.r[8] * p.r[11]);
+        double oy = -(p.r[1] * p.r[3] + p.r[5] * p.r[7] + p.r[9] * p.r[11]);
+        double offset = sqrt(ox * ox + oy * oy);
+
+        bool all = offset >= bucketRadius ||
+                   seesVertical(p.r, p.fx, p.s, p.cx, p.fy, p.cy, p.width, p.height, 1.0) ||
+                   seesVertical(p.r, p.fx, p.s, p.cx, p.fy, p.cy, p.width, p.height, -1.0);
+
+        double axis[3];
+        pixelRay(p.r, p.fx, p.s, p.cx, p.fy, p.cy, 0.5 * p.width, 0.5 * p.height, axis);
+        if (fabs(axis[0]) + fabs(axis[1]) < 1e-9) all = true;
+
+        double lo = 0.0, hi = 0.0;
+        double a0 = atan2(axis[1], axis[0]);
+        if (!all) {
+            // Border rays bound the frustum's azimuth span (no vertical inside).
+            const int kSteps = 16;
+            for (int e = 0; e < 4 * kSteps; ++e) {
+                double t = (double)(e % kSteps) / (double)kSteps;
+                double u, v;
+                switch (e / kSteps) {
+                case 0: u = t * p.width; v = 0.0; break;
+                case 1: u = p.width; v = t * p.height; break;
+                case 2: u = (1.0 - t) * p.width; v = p.height; break;
+                default: u = 0.0; v = (1.0 - t) * p.height; break;
+                }
+                double ray[3];
+                pixelRay(p.r, p.fx, p.s, p.cx, p.fy, p.cy, u, v, ray);
+                double d = wrapAngle(atan2(ray[1], ray[0]) - a0);
+                if (d < lo) lo = d;
+                if (d > hi) hi = d;
+            }
+            // Seen from the origin a point at range >= bucketRadius shifts by at
+            // most asin(offset / bucketRadius); add a little for sampling.
+            double margin = asin(offset / bucketRadius) + 2.0 * kPi / (double)kMultiCameraSectors;
+            lo -= margin;
+            hi += margin;
+            if (hi - lo >= 2.0 * kPi) all = true;
+        }
+
+        double mid = a0 + 0.5 * (lo + hi);
+        double half = 0.5 * (hi - lo);
+        for (size_t sct = 0; sct < kMultiCameraSectors; ++sct) {
+            if (all) { masks_[sct] |= bit; continue; }
+            double q = (double)(kMultiCameraSectors / 4);
+            double sa = diamondToAngle((double)sct / q);
+            double sb = diamondToAngle((double)(sct + 1) / q);
+            double width = wrapAngle(sb - sa);
+            if (width < 0.0) width += 2.0 * kPi;
+            double centre = sa + 0.5 * width;
+            if (fabs(wrapAngle(centre - mid)) <= half + 0.5 * width) masks_[sct] |= bit;
+        }
+    }
+    count_ = count;
+    return true;
+}
+
+size_t MultiCameraProjector::project(const Point3 *points, size_t n, CameraHitList *outs) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_PROJECT_MULTI_CAMERA, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "projectMultiCamera");
+    for (size_t c = 0; c < count_; ++c) { outs[c].count = 0; outs[c].overflow = 0; }
+    if (count_ == 0) return 0;
+    return projectRange(points, n, 0, outs);
+}
+
+size_t MultiCameraProjector::project(const PointI16 *points, size_t n, const PointQuantization &q, CameraHitList *outs) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_PROJECT_MULTI_CAMERA, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "projectMultiCamera");
+    for (size_t c = 0; c < count_; ++c) { outs[c].count = 0; outs[c].overflow = 0; }
+    if (count_ == 0) return 0;
+    Point3 chunk[kDecodeChunk];
+    size_t total = 0;
+    for (size_t base = 0; base < n; base += kDecodeChunk) {
+        const size_t k = n - base < kDecodeChunk ? n - base : kDecodeChunk;
+        decodePointsI16(points + base, k, q, chunk);
+        total += projectRange(chunk, k, base, outs);
+    }
+    return total;
+}
+
+size_t MultiCameraProjector::project(const PointF16 *points, size_t n, const PointQuantization &q, CameraHitList *outs) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_PROJECT_MULTI_CAMERA, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "projectMultiCamera");
+    for (size_t c = 0; c < count_; ++c) { outs[c].count = 0; outs[c].overflow = 0; }
+    if (count_ == 0) return 0;
+    Point3 chunk[kDecodeChunk];
+    size_t total = 0;
+    for (size_t base = 0; base < n; base += kDecodeChunk) {
+        const size_t k = n - base < kDecodeChunk ? n - base : kDecodeChunk;
+        decodePointsF16(points + base, k, q, chunk);
+        total += projectRange(chunk, k, base, outs);
+    }
+    return total;
+}
+
+// Appends the hits of points[0, n) (reported as base + i) to outs.
+size_t MultiCameraProjector::projectRange(const Point3 *points, size_t n, size_t base, CameraHitList *outs) const
+{
+    const unsigned int allCameras = count_ == 32 ? 0xffffffffu : ((1u << count_) - 1u);
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double X = points[i].x, Y = points[i].y, Z = points[i].z;
+        unsigned int mask = allCameras;
+        if (bucketing_ && X * X + Y * Y >= radius2_) mask = masks_[sectorOf(X, Y)];
+        while (mask) {
+            const unsigned int c = (unsigned int)__builtin_ctz(mask);
+            mask &= mask - 1u;
+            const PackedCamera &p = cams_[c];
+            double z = p.r[8] * X + p.r[9] * Y + p.r[10] * Z + p.r[11];
+            if (!(z > p.minDepth)) continue;
+            double x = p.r[0] * X + p.r[1] * Y + p.r[2] * Z + p.r[3];
+            double y = p.r[4] * X + p.r[5] * Y + p.r[6] * Z + p.r[7];
+            double inv = 1.0 / z;
+            double u = (p.fx * x + p.s * y) * inv + p.cx;
+            double v = (p.fy * y) * inv + p.cy;
+            if (!(u >= 0.0 && u < p.width && v >= 0.0 && v < p.height)) continue;
+            CameraHitList &out = outs[c];
+            if (out.count < out.capacity) {
+                CameraHit &h = out.hits[out.count++];
+                h.index = (unsigned int)(base + i);
+                h.u = (float)u;
+                h.v = (float)v;
+                h.depth = (float)z;
+                ++total;
+            } else {
+                ++out.overflow;
+            }
+        }
+    }
+    return total;
+}
+
+} // namespace AdasTools
@@ -0,0 +1,128 @@
+/* *******************************************************************************
+ * File: src/parallel.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: TaskPool implementation on std::thread. Tasks are handed out
+ *              through an atomic counter; a generation number wakes the
+ *              parked workers for each run. A thread-local marker lets
+ *              nested runs on the same pool fall back to inline execution.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "parallel.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace AdasTools {
+
+namespace {
+
+// Pool whose task the calling thread is executing (nullptr outside any run).
+thread_local const TaskPool *t_insidePool = nullptr;
+
+} // namespace
+
+struct TaskPool::State {
+    std::mutex runMutex; // serializes run() callers
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::thread *threads;
+    unsigned long long generation;
+    bool stop;
+    size_t busy; // workers still inside the current generation
+
+    void (*fn)(void *, size_t);
+    void *ctx;
+    size_t tasks;
+    std::atomic<size_t> next;
+    const TaskPool *owner;
+
+    void drain()
+    {
+        const TaskPool *outer = t_insidePool;
+        t_insidePool = owner;
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < tasks; i = next.fetch_add(1, std::memory_order_relaxed)) {
+            fn(ctx, i);
+        }
+        t_insidePool = outer;
+    }
+
+    void worker()
+    {
+        unsigned long long seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+            }
+            drain();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) done.notify_one();
+        }
+    }
+};
+
+TaskPool::TaskPool(size_t workers)
+    : state_(new State()), workers_(workers)
+{
+    state_->generation = 0;
+    state_->stop = false;
+    state_->busy = 0;
+    state_->fn = nullptr;
+    state_->ctx = nullptr;
+    state_->tasks = 0;
+    state_->next.store(0, std::memory_order_relaxed);
+    state_->owner = this;
+    state_->threads = workers ? new std::thread[workers] : nullptr;
+    for (size_t i = 0; i < workers; ++i) state_->threads[i] = std::thread([this] { state_->worker(); });
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stop = true;
+    }
+    state_->wake.notify_all();
+    for (size_t i = 0; i < workers_; ++i) state_->threads[i].join();
+    delete[] state_->threads;
+    delete state_;
+}
+
+void TaskPool::run(size_t tasks, void (*fn)(void *ctx, size_t task), void *ctx)
+{
+    if (tasks == 0) return;
+    // Nested run from one of this pool's own tasks: runMutex is held by the
+    // outer run, so execute inline on the calling thread instead of deadlocking.
+    if (workers_ == 0 || tasks == 1 || t_insidePool == this) {
+        for (size_t i = 0; i < tasks; ++i) fn(ctx, i);
+        return;
+    }
+    std::lock_guard<std::mutex> runLock(state_->runMutex);
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->fn = fn;
+        state_->ctx = ctx;
+        state_->tasks = tasks;
+        state_->next.store(0, std::memory_order_relaxed);
+        state_->busy = workers_;
+        ++state_->generation;
+    }
+    state_->wake.notify_all();
+    state_->drain();
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->done.wait(lock, [&] { return state_->busy == 0; });
+}
+
+TaskPool *defaultTaskPool()
+{
+    static TaskPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+    return &pool;
+}
+
+} // namespace AdasTools
@@ -0,0 +1,507 @@
+/* *******************************************************************************
+ * File: src/poselog.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Pose log I/O. CSV lines are located with memchr in a fixed
+ *              read buffer and parsed with an exact fast-path number parser
+ *              (std::from_chars for the rest);
+ *              binary records are read straight into the caller's array.
+ *
+ *              Binary layout (native little-endian):
+ *                header  32 B: "APLG", u32 version, u32 0x01020304, u32 56, 16 B reserved
+ *                records 56 B each: stamp, x, y, z, roll, pitch, yaw (doubles)
+ *                index   16 B each: stamp, record number (doubles), one per kPoseLogIndexStride
+ *                trailer 32 B: u64 index offset, u64 index count, u64 record count,
+ *                              u32 stride, "APLI"
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "poselog.hpp"
+#include "instrumentation.hpp"
+#include <charconv>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trajectory.hpp"
+
+namespace AdasTools {
+
+static_assert(sizeof(StampedPose) == 7 * sizeof(double), "StampedPose must be 7 packed doubles");
+
+namespace {
+
+const char kMagic[4] = { 'A', 'P', 'L', 'G' };
+const char kIndexMagic[4] = { 'A', 'P', 'L', 'I' };
+const uint32_t kVersion = 1;
+const uint32_t kEndianTag = 0x01020304u;
+const long kHeaderBytes = 32;
+const long kTrailerBytes = 32;
+const size_t kRecordBytes = sizeof(StampedPose);
+
+const double kPow10[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+struct BinaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t endian;
+    uint32_t recordBytes;
+    uint64_t reserved[2];
+};
+
+struct BinaryTrailer {
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint64_t recordCount;
+    uint32_t stride;
+    char magic[4];
+};
+
+static_assert(sizeof(BinaryHeader) == 32 && sizeof(BinaryTrailer) == 32, "unexpected pose log layout");
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+// Exact slow path: long mantissas, large exponents, inf/nan.
+bool parseFromChars(const char *&p, const char *end, double &out)
+{
+    const char *s = p;
+    if (s < end && *s == '+') ++s;
+    double v;
+    std::from_chars_result r = std::from_chars(s, end, v);
+    if (r.ec != std::errc() && r.ec != std::errc::result_out_of_range) return false;
+    if (r.ec == std::errc::result_out_of_range) {
+        // from_chars leaves v untouched on range errors; let strtod pick 0/inf.
+        char token[64];
+        size_t n = (size_t)(r.ptr - p) < sizeof(token) - 1 ? (size_t)(r.ptr - p) : sizeof(token) - 1;
+        memcpy(token, p, n);
+        token[n] = '\0';
+        v = strtod(token, nullptr);
+    }
+    p = r.ptr;
+    out = v;
+    return true;
+}
+
+} // namespace
+
+bool parsePoseLogNumber(const char *&p, const char *end, double &out)
+{
+    while (p < end && isBlank(*p)) ++p;
+    const char *s = p;
+    bool negative = false;
+    if (s < end && (*s == '+' || *s == '-')) { negative = *s == '-'; ++s; }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exp10 = 0;
+    bool any = false;
+    bool truncated = false;
+    for (; s < end && *s >= '0' && *s <= '9'; ++s) {
+        unsigned d = (unsigned)(*s - '0');
+        any = true;
+        if (mantissa == 0 && d == 0) continue;
+        if (digits < 19) { mantissa = mantissa * 10u + d; ++digits; }
+        else { ++exp10; truncated |= d != 0; }
+    }
+    if (s < end && *s == '.') {
+        for (++s; s < end && *s >= '0' && *s <= '9'; ++s) {
+            unsigned d = (unsigned)(*s - '0');
+            any = true;
+            if (mantissa == 0 && d == 0) { --exp10; continue; }
+            if (digits < 19) { mantissa = mantissa * 10u + d; ++digits; --exp10; }
+            else truncated |= d != 0;
+        }
+    }
+    if (!any) return parseFromChars(p, end, out); // nan, inf, ...
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char *e = s + 1;
+        bool eneg = false;
+        if (e < end && (*e == '+' || *e == '-')) { eneg = *e == '-'; ++e; }
+        if (e < end && *e >= '0' && *e <= '9') {
+            int ev = 0;
+            for (; e < end && *e >= '0' && *e <= '9'; ++e) if (ev < 10000) ev = ev * 10 + (*e - '0');
+            exp10 += eneg ? -ev : ev;
+            s = e;
+        }
+    }
+
+    // Clinger's fast path: both operands exact, so one rounding.
+    if (truncated || mantissa > (1ull << 53) || exp10 < -22 || exp10 > 22) return parseFromChars(p, end, out);
+    double v = (double)mantissa;
+    v = exp10 < 0 ? v / kPow10[-exp10] : v * kPow10[exp10];
+    out = negative ? -v : v;
+    p = s;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+PoseLogWriter::PoseLogWriter()
+    : file_(nullptr), format_(POSE_LOG_CSV), count_(0), failed_(false), used_(0),
+      index_(nullptr), indexCount_(0), indexCapacity_(0)
+{
+}
+
+PoseLogWriter::~PoseLogWriter()
+{
+    close();
+    free(index_);
+}
+
+bool PoseLogWriter::open(const char *path, PoseLogFormat format)
+{
+    close();
+    file_ = fopen(path, format == POSE_LOG_BINARY ? "wb" : "w");
+    if (!file_) return false;
+    format_ = format;
+    count_ = 0;
+    failed_ = false;
+    used_ = 0;
+    indexCount_ = 0;
+    if (format == POSE_LOG_BINARY) {
+        BinaryHeader h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, kMagic, 4);
+        h.version = kVersion;
+        h.endian = kEndianTag;
+        h.recordBytes = (uint32_t)kRecordBytes;
+        memcpy(buffer_, &h, sizeof(h));
+        used_ = sizeof(h);
+    } else {
+        const char *header = "# stamp,x,y,z,roll,pitch,yaw\n";
+        used_ = strlen(header);
+        memcpy(buffer_, header, used_);
+    }
+    return true;
+}
+
+bool PoseLogWriter::flushBuffer()
+{
+    if (used_ && fwrite(buffer_, 1, used_, file_) != used_) failed_ = true;
+    used_ = 0;
+    return !failed_;
+}
+
+bool PoseLogWriter::addIndexEntry(double stamp)
+{
+    if (indexCount_ == indexCapacity_) {
+        size_t cap = indexCapacity_ ? indexCapacity_ * 2 : 256;
+        double *grown = static_cast<double *>(realloc(index_, cap * 2 * sizeof(double)));
+        if (!grown) return false;
+        index_ = grown;
+        indexCapacity_ = cap;
+    }
+    index_[indexCount_ * 2 + 0] = stamp;
+    index_[indexCount_ * 2 + 1] = (double)count_;
+    ++indexCount_;
+    return true;
+}
+
+bool PoseLogWriter::write(const StampedPose &record)
+{
+    if (!file_ || failed_) return false;
+    if (format_ == POSE_LOG_BINARY) {
+        if (count_ % kPoseLogIndexStride == 0 && !addIndexEntry(record.stamp)) { failed_ = true; return false; }
+        if (used_ + kRecordBytes > sizeof(buffer_) && !flushBuffer()) return false;
+        memcpy(buffer_ + used_, &record, kRecordBytes);
+        used_ += kRecordBytes;
+    } else {
+        if (used_ + 7 * 26 > sizeof(buffer_) && !flushBuffer()) return false;
+        const double v[7] = { record.stamp, record.pose.x, record.pose.y, record.pose.z,
+                              record.pose.roll, record.pose.pitch, record.pose.yaw };
+        for (int i = 0; i < 7; ++i) {
+            // Shortest of %.15g / %.17g that reads back exactly.
+            char *dst = buffer_ + used_;
+            int n = snprintf(dst, 26, "%.15g", v[i]);
+            const char *q = dst;
+            double back;
+            if (!parsePoseLogNumber(q, dst + n, back) || back != v[i]) n = snprintf(dst, 26, "%.17g", v[i]);
+            used_ += (size_t)n;
+            buffer_[used_++] = i < 6 ? ',' : '\n';
+        }
+    }
+    ++count_;
+    return true;
+}
+
+bool PoseLogWriter::write(const StampedPose *records, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_POSE_LOG_WRITE, n);
+    for (size_t i = 0; i < n; ++i) {
+        if (!write(records[i])) return false;
+    }
+    return true;
+}
+
+bool PoseLogWriter::close()
+{
+    if (!file_) return true;
+    if (format_ == POSE_LOG_BINARY && !failed_) {
+        flushBuffer();
+        BinaryTrailer t;
+        memset(&t, 0, sizeof(t));
+        t.indexOffset = (uint64_t)kHeaderBytes + count_ * kRecordBytes;
+        t.indexCount = indexCount_;
+        t.recordCount = count_;
+        t.stride = (uint32_t)kPoseLogIndexStride;
+        memcpy(t.magic, kIndexMagic, 4);
+        if (indexCount_ && fwrite(index_, 2 * sizeof(double), indexCount_, file_) != indexCount_) failed_ = true;
+        if (fwrite(&t, sizeof(t), 1, file_) != 1) failed_ = true;
+    } else {
+        flushBuffer();
+    }
+    if (fclose(file_) != 0) failed_ = true;
+    file_ = nullptr;
+    return !failed_;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+PoseLogReader::PoseLogReader()
+    : file_(nullptr), format_(POSE_LOG_CSV), recordCount_(0), recordsRead_(0), malformed_(0),
+      index_(nullptr), indexCount_(0), pos_(0), end_(0), eof_(false), sawContent_(false), skipLine_(false),
+      hasPending_(false)
+{
+}
+
+PoseLogReader::~PoseLogReader()
+{
+    close();
+}
+
+void PoseLogReader::close()
+{
+    if (file_) fclose(file_);
+    file_ = nullptr;
+    free(index_);
+    index_ = nullptr;
+    indexCount_ = 0;
+    recordCount_ = 0;
+    hasPending_ = false;
+}
+
+bool PoseLogReader::open(const char *path)
+{
+    close();
+    file_ = fopen(path, "rb");
+    if (!file_) return false;
+    malformed_ = 0;
+
+    BinaryHeader h;
+    size_t got = fread(&h, 1, sizeof(h), file_);
+    if (got >= 4 && memcmp(h.magic, kMagic, 4) == 0) {
+        if (got != sizeof(h) || h.version != kVersion || h.endian != kEndianTag || h.recordBytes != kRecordBytes) {
+            close();
+            return false;
+        }
+        format_ = POSE_LOG_BINARY;
+        fseek(file_, 0, SEEK_END);
+        long size = ftell(file_);
+        uint64_t dataEnd = (uint64_t)size;
+        BinaryTrailer t;
+        if (size >= kHeaderBytes + kTrailerBytes && fseek(file_, size - kTrailerBytes, SEEK_SET) == 0 &&
+            fread(&t, sizeof(t), 1, file_) == 1 && memcmp(t.magic, kIndexMagic, 4) == 0 &&
+            t.indexOffset == (uint64_t)kHeaderBytes + t.recordCount * kRecordBytes &&
+            t.indexOffset + t.indexCount * 16u + (uint64_t)kTrailerBytes == (uint64_t)size) {
+            recordCount_ = t.recordCount;
+            if (t.indexCount && t.stride == kPoseLogIndexStride) {
+                index_ = static_cast<double *>(malloc(t.indexCount * 2 * sizeof(double)));
+                if (index_ && fseek(file_, (long)t.indexOffset, SEEK_SET) == 0 &&
+                    fread(index_, 2 * sizeof(double), t.indexCount, file_) == t.indexCount) {
+                    indexCount_ = t.indexCount;
+                } else {
+                    free(index_);
+                    index_ = nullptr;
+                }
+            }
+        } else {
+            // No valid footer (writer not closed): use every complete record.
+            recordCount_ = (dataEnd - (uint64_t)kHeaderBytes) / kRecordBytes;
+        }
+    } else {
+        format_ = POSE_LOG_CSV;
+    }
+    return rewindData();
+}
+
+bool PoseLogReader::rewindData()
+{
+    hasPending_ = false;
+    recordsRead_ = 0;
+    malformed_ = 0; // the CSV rescan counts every line again
+    sawContent_ = false;
+    pos_ = end_ = 0;
+    eof_ = false;
+    skipLine_ = false;
+    return fseek(file_, format_ == POSE_LOG_BINARY ? kHeaderBytes : 0, SEEK_SET) == 0;
+}
+
+bool PoseLogReader::refill()
+{
+    if (eof_) return false;
+    if (pos_ > 0) {
+        memmove(buffer_, buffer_ + pos_, end_ - pos_);
+        end_ -= pos_;
+        pos_ = 0;
+    }
+    size_t got = fread(buffer_ + end_, 1, sizeof(buffer_) - end_, file_);
+    end_ += got;
+    if (got == 0) eof_ = true;
+    return got > 0;
+}
+
+bool PoseLogReader::nextCsv(StampedPose &out)
+{
+    for (;;) {
+        const char *base = buffer_ + pos_;
+        const char *nl = static_cast<const char *>(memchr(base, '\n', end_ - pos_));
+        size_t lineEnd, next;
+        if (nl) {
+            lineEnd = (size_t)(nl - buffer_);
+            next = lineEnd + 1;
+        } else if (!eof_ && end_ - pos_ < sizeof(buffer_)) {
+            refill();
+            continue;
+        } else if (pos_ < end_ && !eof_) {
+            // A line longer than the buffer: reject it as a whole (counted
+            // once) and drop everything up to its newline.
+            if (!skipLine_) ++malformed_;
+            skipLine_ = true;
+            pos_ = end_;
+            continue;
+        } else if (pos_ < end_) {
+            // Last line without a newline.
+            lineEnd = end_;
+            next = end_;
+        } else {
+            return false;
+        }
+        if (skipLine_) {
+            // Tail of an over-long line.
+            skipLine_ = false;
+            pos_ = next;
+            continue;
+        }
+
+        const char *p = buffer_ + pos_;
+        const char *e = buffer_ + lineEnd;
+        pos_ = next;
+        if (e > p && e[-1] == '\r') --e;
+        while (p < e && isBlank(*p)) ++p;
+        if (p == e || *p == '#') continue;
+
+        double v[7];
+        bool ok = true;
+        for (int i = 0; i < 7 && ok; ++i) {
+            ok = parsePoseLogNumber(p, e, v[i]);
+            while (ok && p < e && isBlank(*p)) ++p;
+            if (ok && i < 6) ok = p < e && *p++ == ',';
+        }
+        if (ok && p != e) ok = false;
+        bool first = !sawContent_;
+        sawContent_ = true;
+        if (!ok) {
+            // An unparsable first content line is a column header.
+            if (!first) ++malformed_;
+            continue;
+        }
+        out.stamp = v[0];
+        out.pose = Pose{ v[1], v[2], v[3], v[4], v[5], v[6] };
+        return true;
+    }
+}
+
+bool PoseLogReader::nextRecord(StampedPose &out)
+{
+    if (format_ == POSE_LOG_CSV) return nextCsv(out);
+    if (recordsRead_ >= recordCount_) return false;
+    if (fread(&out, kRecordBytes, 1, file_) != 1) { recordsRead_ = recordCount_; return false; }
+    ++recordsRead_;
+    return true;
+}
+
+size_t PoseLogReader::read(StampedPose *out, size_t maxCount)
+{
+    // counts the records returned, not the requested capacity
+    ADAS_PROFILE_SCOPE_NAMED(profile, PROBE_POSE_LOG_READ);
+    const size_t n = readRecords(out, maxCount);
+    ADAS_PROFILE_SET_POINTS(profile, n);
+    return n;
+}
+
+size_t PoseLogReader::readRecords(StampedPose *out, size_t maxCount)
+{
+    if (!file_ || maxCount == 0) return 0;
+    size_t n = 0;
+    if (hasPending_) {
+        out[n++] = pending_;
+        hasPending_ = false;
+    }
+    if (format_ == POSE_LOG_BINARY) {
+        unsigned long long left = recordCount_ - recordsRead_;
+        size_t want = maxCount - n;
+        if ((unsigned long long)want > left) want = (size_t)left;
+        size_t got = fread(out + n, kRecordBytes, want, file_);
+        recordsRead_ += got;
+        if (got < want) recordsRead_ = recordCount_;
+        return n + got;
+    }
+    while (n < maxCount && nextCsv(out[n])) ++n;
+    return n;
+}
+
+bool PoseLogReader::seek(double stamp)
+{
+    if (!file_) return false;
+    if (format_ == POSE_LOG_BINARY && indexCount_) {
+        // Last index entry at or before `stamp`, then a short forward scan.
+        size_t lo = 0, hi = indexCount_;
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (index_[mid * 2] <= stamp) lo = mid;
+            else hi = mid;
+        }
+        unsigned long long record = (unsigned long long)index_[lo * 2 + 1];
+        hasPending_ = false;
+        if (fseek(file_, (long)(kHeaderBytes + record * kRecordBytes), SEEK_SET) != 0) return false;
+        recordsRead_ = record;
+    } else if (!rewindData()) {
+        return false;
+    }
+    StampedPose r;
+    while (nextRecord(r)) {
+        if (r.stamp >= stamp) {
+            pending_ = r;
+            hasPending_ = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+long long loadPoseLog(const char *path, Trajectory &out)
+{
+    PoseLogReader reader;
+    if (!reader.open(path)) return -1;
+    if (reader.recordCount() && !out.reserve(out.size() + (size_t)reader.recordCount())) return -1;
+    StampedPose chunk[256];
+    Pose poses[256];
+    RigidTransform transforms[256];
+    long long total = 0;
+    size_t n;
+    while ((n = reader.read(chunk, 256)) > 0) {
+        for (size_t i = 0; i < n; ++i) poses[i] = chunk[i].pose;
+        posesToTransforms(poses, transforms, n);
+        for (size_t i = 0; i < n; ++i) {
+            if (!out.append(chunk[i].stamp, transforms[i])) return -1;
+        }
+        total += (long long)n;
+    }
+    return total;
+}
+
+} // namespace AdasTools
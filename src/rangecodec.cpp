@@ -0,0 +1,440 @@
+/* *******************************************************************************
+ * File: src/rangecodec.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Range-image codec. Each row is predicted from its previous
+ *              cell, residuals are zigzag mapped and written as Rice codes
+ *              whose parameter is chosen per group of 32 values (escape to a
+ *              raw 32-bit value for outliers such as dropouts). Blocks are
+ *              encoded in parallel into fixed worst-case slots of the output
+ *              and then packed.
+ *
+ *              Stream layout (native little-endian):
+ *                header 32 B: "ARIC", u32 version, u32 rows, u32 cols,
+ *                             f64 precision, u32 rows per block, u32 flags
+ *                table  u32 payload bytes per block
+ *                blocks bit streams, ranges then intensities (byte aligned)
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "rangecodec.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace AdasTools {
+
+namespace {
+
+const char kMagic[4] = { 'A', 'R', 'I', 'C' };
+const uint32_t kVersion = 1;
+const uint32_t kFlagIntensity = 1u;
+const uint32_t kFlagLossless = 2u;
+const unsigned kGroup = 32;      // values sharing one Rice parameter
+const unsigned kEscape = 16;     // quotients >= kEscape are stored raw
+const unsigned kKBits = 5;       // bits of the per-group Rice parameter
+const size_t kMaxValueBits = kEscape + 1 + 32;
+const uint32_t kMaxSteps = 0x7FFFFFFFu;
+
+struct StreamHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t rows;
+    uint32_t cols;
+    double precision;
+    uint32_t rowsPerBlock;
+    uint32_t flags;
+};
+
+static_assert(sizeof(StreamHeader) == 32, "unexpected range codec header layout");
+
+class BitWriter {
+public:
+    explicit BitWriter(unsigned char *out) : out_(out), acc_(0), bits_(0) {}
+
+    // n <= 32
+    inline void put(uint32_t value, unsigned n)
+    {
+        acc_ |= (uint64_t)value << bits_;
+        bits_ += n;
+        if (bits_ >= 32) {
+            const uint32_t word = (uint32_t)acc_;
+            memcpy(out_, &word, 4);
+            out_ += 4;
+            acc_ >>= 32;
+            bits_ -= 32;
+        }
+    }
+
+    inline void putRice(uint32_t u, unsigned k)
+    {
+        const uint32_t q = u >> k;
+        if (q < kEscape) {
+            put(1u << q, q + 1); // q zeros, then a one (LSB first)
+            if (k) put(u & ((1u << k) - 1u), k);
+        } else {
+            put(1u << kEscape, kEscape + 1);
+            put(u, 32);
+        }
+    }
+
+    // Flush the partial word; returns the end of the written bytes.
+    unsigned char *finish()
+    {
+        while (bits_ > 0) {
+            *out_++ = (unsigned char)acc_;
+            acc_ >>= 8;
+            bits_ = bits_ > 8 ? bits_ - 8 : 0;
+        }
+        return out_;
+    }
+
+private:
+    unsigned char *out_;
+    uint64_t acc_;
+    unsigned bits_;
+};
+
+class BitReader {
+public:
+    BitReader(const unsigned char *p, const unsigned char *end) : p_(p), end_(end), acc_(0), bits_(0), bad_(false) {}
+
+    bool bad() const { return bad_; }
+
+    inline void refill()
+    {
+        if (end_ - p_ >= 8) {
+            uint64_t v;
+            memcpy(&v, p_, 8);
+            acc_ |= v << bits_;
+            const unsigned bytes = (63 - bits_) >> 3;
+            p_ += bytes;
+            bits_ += bytes * 8;
+        } else {
+            while (bits_ <= 56 && p_ < end_) {
+                acc_ |= (uint64_t)*p_++ << bits_;
+                bits_ += 8;
+            }
+        }
+    }
+
+    // n <= 32
+    inline uint32_t get(unsigned n)
+    {
+        if (bits_ < n) {
+            refill();
+            if (bits_ < n) { bad_ = true; return 0; }
+        }
+        const uint32_t v = (uint32_t)(acc_ & ((1ull << n) - 1ull));
+        acc_ >>= n;
+        bits_ -= n;
+        return v;
+    }
+
+    inline uint32_t getRice(unsigned k)
+    {
+        if (bits_ < kEscape + 1) refill();
+        const uint64_t window = bits_ < 64 ? acc_ & ((1ull << bits_) - 1ull) : acc_;
+        if (window == 0) { bad_ = true; return 0; }
+        const unsigned q = (unsigned)__builtin_ctzll(window);
+        if (q > kEscape) { bad_ = true; return 0; }
+        acc_ >>= q + 1;
+        bits_ -= q + 1;
+        if (q == kEscape) return get(32);
+        return k ? (q << k) | get(k) : q;
+    }
+
+private:
+    const unsigned char *p_;
+    const unsigned char *end_;
+    uint64_t acc_;
+    unsigned bits_;
+    bool bad_;
+};
+
+inline uint32_t zigzag(int32_t d) { return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31); }
+inline int32_t unzigzag(uint32_t u) { return (int32_t)(u >> 1) ^ -(int32_t)(u & 1u); }
+
+inline unsigned riceCost(const uint32_t *u, unsigned n, unsigned k)
+{
+    unsigned bits = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        const uint32_t q = u[i] >> k;
+        bits += q < kEscape ? q + 1 + k : kEscape + 1 + 32;
+    }
+    return bits;
+}
+
+// Cheapest Rice parameter for a group: log2 of the mean, then the neighbours.
+unsigned chooseRiceParameter(const uint32_t *u, unsigned n)
+{
+    uint64_t sum = 0;
+    for (unsigned i = 0; i < n; ++i) sum += u[i];
+    const uint64_t mean = sum / n;
+    unsigned k0 = mean ? 63u - (unsigned)__builtin_clzll(mean) : 0u;
+    if (k0 > 31) k0 = 31;
+    unsigned best = k0, bestCost = riceCost(u, n, k0);
+    if (k0 > 0) {
+        const unsigned c = riceCost(u, n, k0 - 1);
+        if (c < bestCost) { best = k0 - 1; bestCost = c; }
+    }
+    if (k0 < 31) {
+        const unsigned c = riceCost(u, n, k0 + 1);
+        if (c < bestCost) best = k0 + 1;
+    }
+    return best;
+}
+
+// Code `count` residuals in groups of kGroup.
+void writeGroups(BitWriter &w, const uint32_t *u, size_t count)
+{
+    for (size_t g = 0; g < count; g += kGroup) {
+        const unsigned n = (unsigned)(count - g < kGroup ? count - g : kGroup);
+        const unsigned k = chooseRiceParameter(u + g, n);
+        w.put(k, kKBits);
+        for (unsigned i = 0; i < n; ++i) w.putRice(u[g + i], k);
+    }
+}
+
+bool readGroups(BitReader &r, uint32_t *u, size_t count)
+{
+    for (size_t g = 0; g < count; g += kGroup) {
+        const unsigned n = (unsigned)(count - g < kGroup ? count - g : kGroup);
+        const unsigned k = r.get(kKBits);
+        for (unsigned i = 0; i < n; ++i) u[g + i] = r.getRice(k);
+        if (r.bad()) return false;
+    }
+    return true;
+}
+
+// Worst case of one block: every value escaped, groups restart on every row.
+inline size_t blockBound(size_t rows, size_t cols, bool intensity)
+{
+    const size_t streams = intensity ? 2 : 1;
+    const size_t values = streams * rows * cols;
+    const size_t groups = streams * rows * ((cols + kGroup - 1) / kGroup);
+    return (values * kMaxValueBits + groups * kKBits + 7) / 8 + 8;
+}
+
+struct EncodeJob {
+    const RangeImage *image;
+    const StreamHeader *header;
+    unsigned char *slots; // block b starts at slots + b * slotBytes
+    size_t slotBytes;
+    unsigned char *table; // u32 payload size per block
+
+    void operator()(size_t block)
+    {
+        const unsigned cols = header->cols;
+        const unsigned first = (unsigned)block * header->rowsPerBlock;
+        const unsigned last = first + header->rowsPerBlock < header->rows ? first + header->rowsPerBlock : header->rows;
+        const bool lossless = (header->flags & kFlagLossless) != 0;
+        const double inv = lossless ? 0.0 : 1.0 / header->precision;
+        uint32_t u[kGroup * 8];
+        const size_t chunk = sizeof(u) / sizeof(u[0]);
+        unsigned char *begin = slots + block * slotBytes;
+        BitWriter w(begin);
+
+        // Residuals are produced in chunks of whole groups; prediction restarts every row.
+        for (unsigned row = first; row < last; ++row) {
+            const float *r = image->range + (size_t)row * cols;
+            uint32_t prev = 0;
+            for (size_t c0 = 0; c0 < cols; c0 += chunk) {
+                const size_t n = cols - c0 < chunk ? cols - c0 : chunk;
+                for (size_t i = 0; i < n; ++i) {
+                    const float f = r[c0 + i];
+                    uint32_t v;
+                    if (lossless) {
+                        memcpy(&v, &f, 4);
+                    } else {
+                        const double s = (double)f * inv;
+                        if (!(s > 0.0) || isinf(s)) v = 0u; // no return (also NaN)
+                        else v = s < (double)kMaxSteps ? (uint32_t)nearbyint(s) : kMaxSteps;
+                    }
+                    u[i] = zigzag((int32_t)(v - prev));
+                    prev = v;
+                }
+                writeGroups(w, u, n);
+            }
+        }
+        if (header->flags & kFlagIntensity) {
+            for (unsigned row = first; row < last; ++row) {
+                const unsigned char *s = image->intensity + (size_t)row * cols;
+                unsigned char prev = 0;
+                for (size_t c0 = 0; c0 < cols; c0 += chunk) {
+                    const size_t n = cols - c0 < chunk ? cols - c0 : chunk;
+                    for (size_t i = 0; i < n; ++i) {
+                        const int d = (int)(signed char)(unsigned char)(s[c0 + i] - prev);
+                        u[i] = zigzag(d);
+                        prev = s[c0 + i];
+                    }
+                    writeGroups(w, u, n);
+                }
+            }
+        }
+        const uint32_t bytes = (uint32_t)(w.finish() - begin);
+        memcpy(table + block * sizeof(uint32_t), &bytes, sizeof(bytes));
+    }
+};
+
+struct DecodeJob {
+    const RangeImage *image;
+    const StreamHeader *header;
+    const unsigned char *const *blocks; // blocks[b] .. blocks[b + 1]
+    std::atomic<bool> *failed;
+
+    void operator()(size_t block)
+    {
+        const unsigned cols = header->cols;
+        const unsigned first = (unsigned)block * header->rowsPerBlock;
+        const unsigned last = first + header->rowsPerBlock < header->rows ? first + header->rowsPerBlock : header->rows;
+        const bool lossless = (header->flags & kFlagLossless) != 0;
+        const double step = header->precision;
+        uint32_t u[kGroup * 8];
+        const size_t chunk = sizeof(u) / sizeof(u[0]);
+        BitReader r(blocks[block], blocks[block + 1]);
+
+        for (unsigned row = first; row < last; ++row) {
+            float *out = image->range + (size_t)row * cols;
+            uint32_t prev = 0;
+            for (size_t c0 = 0; c0 < cols; c0 += chunk) {
+                const size_t n = cols - c0 < chunk ? cols - c0 : chunk;
+                if (!readGroups(r, u, n)) { failed->store(true, std::memory_order_relaxed); return; }
+                for (size_t i = 0; i < n; ++i) {
+                    prev += (uint32_t)unzigzag(u[i]);
+                    if (lossless) memcpy(&out[c0 + i], &prev, 4);
+                    else out[c0 + i] = (float)((double)prev * step);
+                }
+            }
+        }
+        if (!(header->flags & kFlagIntensity)) return;
+        for (unsigned row = first; row < last; ++row) {
+            unsigned char *out = image->intensity ? image->intensity + (size_t)row * cols : nullptr;
+            unsigned char prev = 0;
+            for (size_t c0 = 0; c0 < cols; c0 += chunk) {
+                const size_t n = cols - c0 < chunk ? cols - c0 : chunk;
+                if (!readGroups(r, u, n)) { failed->store(true, std::memory_order_relaxed); return; }
+                if (!out) continue; // stream has intensities, caller does not want them
+                for (size_t i = 0; i < n; ++i) {
+                    prev = (unsigned char)(prev + unzigzag(u[i]));
+                    out[c0 + i] = prev;
+                }
+            }
+        }
+    }
+};
+
+inline size_t blockCount(unsigned rows, unsigned rowsPerBlock) { return (rows + rowsPerBlock - 1) / rowsPerBlock; }
+
+bool validHeader(const StreamHeader &h)
+{
+    return memcmp(h.magic, kMagic, 4) == 0 && h.version == kVersion && h.rows > 0 && h.cols > 0 &&
+           h.rowsPerBlock > 0 && (h.flags & ~(kFlagIntensity | kFlagLossless)) == 0 &&
+           ((h.flags & kFlagLossless) ? h.precision == 0.0 : h.precision > 0.0);
+}
+
+} // namespace
+
+size_t rangeImageEncodedBound(unsigned rows, unsigned cols, const RangeCodecConfig &config)
+{
+    if (rows == 0 || cols == 0 || config.rowsPerBlock == 0) return sizeof(StreamHeader);
+    const size_t blocks = blockCount(rows, config.rowsPerBlock);
+    const size_t blockRows = config.rowsPerBlock < rows ? config.rowsPerBlock : rows;
+    return sizeof(StreamHeader) + blocks * (sizeof(uint32_t) + blockBound(blockRows, cols, config.intensity));
+}
+
+size_t encodeRangeImage(const RangeImage &image, const RangeCodecConfig &config, unsigned char *out, size_t capacity,
+                        TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RANGE_ENCODE, (size_t)image.rows * image.cols);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_USER, "encodeRangeImage");
+    if (image.rows == 0 || image.cols == 0 || !image.range || config.rowsPerBlock == 0) return 0;
+    if (!(config.precision >= 0.0) || (config.intensity && !image.intensity)) return 0;
+    if (capacity < rangeImageEncodedBound(image.rows, image.cols, config)) return 0;
+
+    StreamHeader header;
+    memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.rows = image.rows;
+    header.cols = image.cols;
+    header.precision = config.precision;
+    header.rowsPerBlock = config.rowsPerBlock;
+    header.flags = (config.intensity ? kFlagIntensity : 0u) | (config.precision == 0.0 ? kFlagLossless : 0u);
+    memcpy(out, &header, sizeof(header));
+
+    // Blocks are coded into worst-case slots after the table, then packed in order.
+    const size_t blocks = blockCount(image.rows, config.rowsPerBlock);
+    const size_t blockRows = config.rowsPerBlock < image.rows ? config.rowsPerBlock : image.rows;
+    unsigned char *table = out + sizeof(header);
+    unsigned char *payload = table + blocks * sizeof(uint32_t);
+    EncodeJob job{ &image, &header, payload, blockBound(blockRows, image.cols, config.intensity), table };
+    (pool ? pool : defaultTaskPool())->parallelFor(blocks, job);
+
+    unsigned char *end = payload;
+    for (size_t b = 0; b < blocks; ++b) {
+        uint32_t bytes;
+        memcpy(&bytes, table + b * sizeof(uint32_t), sizeof(bytes));
+        memmove(end, payload + b * job.slotBytes, bytes);
+        end += bytes;
+    }
+    return (size_t)(end - out);
+}
+
+bool rangeImageInfo(const unsigned char *data, size_t bytes, RangeImageInfo &info)
+{
+    StreamHeader h;
+    if (!data || bytes < sizeof(h)) return false;
+    memcpy(&h, data, sizeof(h));
+    if (!validHeader(h)) return false;
+    info.rows = h.rows;
+    info.cols = h.cols;
+    info.precision = h.precision;
+    info.intensity = (h.flags & kFlagIntensity) != 0;
+    return true;
+}
+
+bool decodeRangeImage(const unsigned char *data, size_t bytes, const RangeImage &image, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RANGE_DECODE, (size_t)image.rows * image.cols);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_USER, "decodeRangeImage");
+    StreamHeader h;
+    if (!data || bytes < sizeof(h) || !image.range) return false;
+    memcpy(&h, data, sizeof(h));
+    if (!validHeader(h) || h.rows != image.rows || h.cols != image.cols) return false;
+
+    const size_t blocks = blockCount(h.rows, h.rowsPerBlock);
+    if ((bytes - sizeof(h)) / sizeof(uint32_t) < blocks) return false;
+    const unsigned char *table = data + sizeof(h);
+    const unsigned char *payload = table + blocks * sizeof(uint32_t);
+    const unsigned char *starts[257];
+    const unsigned char **bounds = starts;
+    if (blocks + 1 > sizeof(starts) / sizeof(starts[0])) {
+        bounds = (const unsigned char **)malloc((blocks + 1) * sizeof(const unsigned char *));
+        if (!bounds) return false;
+    }
+    size_t offset = 0;
+    bool ok = true;
+    for (size_t b = 0; b < blocks && ok; ++b) {
+        uint32_t size;
+        memcpy(&size, table + b * sizeof(uint32_t), sizeof(size));
+        bounds[b] = payload + offset;
+        offset += size;
+        ok = offset <= bytes - (size_t)(payload - data);
+    }
+    if (ok) {
+        bounds[blocks] = payload + offset;
+        std::atomic<bool> failed{ false };
+        DecodeJob job{ &image, &h, bounds, &failed };
+        (pool ? pool : defaultTaskPool())->parallelFor(blocks, job);
+        ok = !failed.load();
+    }
+    if (bounds != starts) free(bounds);
+    return ok;
+}
+
+} // namespace AdasTools
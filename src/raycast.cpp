@@ -0,0 +1,294 @@
+/* *******************************************************************************
+ * File: src/raycast.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: 3D DDA ray casting. The ray is parametrised by distance t (m)
+ *              along its unit direction; each axis keeps the t of its next
+ *              voxel boundary, and the walk steps the axis whose boundary
+ *              comes first. Carving writes the grid from several threads
+ *              with relaxed atomic ORs, which commute, so the grid is the
+ *              same for any thread count.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "raycast.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kRayBlock = 64; // rays per task
+
+/** Voxel walk state of one ray. */
+struct Dda {
+    int cell[3];
+    int step[3];
+    double tNext[3];  // t of the next boundary per axis
+    double tDelta[3]; // t between boundaries per axis
+    double t;         // t where the current voxel was entered
+    double tEnd;
+    int n[3];
+
+    unsigned int index() const { return (unsigned int)(((size_t)cell[2] * n[1] + cell[1]) * n[0] + cell[0]); }
+
+    // Clip [0, tEnd] to the grid box and find the first voxel; false if the ray misses the grid.
+    bool start(const VoxelGridSpec &s, double inv, const Point3 &o, const double u[3], double maxT)
+    {
+        const double g0[3] = { (o.x - s.origin.x) * inv, (o.y - s.origin.y) * inv, (o.z - s.origin.z) * inv };
+        n[0] = s.nx;
+        n[1] = s.ny;
+        n[2] = s.nz;
+        double t0 = 0.0, t1 = maxT;
+        for (int a = 0; a < 3; ++a) {
+            const double rate = u[a] * inv; // voxels per metre
+            if (rate == 0.0) {
+                if (!(g0[a] >= 0.0 && g0[a] < n[a])) return false;
+                continue;
+            }
+            double ta = -g0[a] / rate, tb = (n[a] - g0[a]) / rate;
+            if (ta > tb) { const double x = ta; ta = tb; tb = x; }
+            if (ta > t0) t0 = ta;
+            if (tb < t1) t1 = tb;
+        }
+        if (!(t0 <= t1)) return false;
+        for (int a = 0; a < 3; ++a) {
+            const double rate = u[a] * inv;
+            int c = (int)floor(g0[a] + t0 * rate);
+            c = c < 0 ? 0 : (c >= n[a] ? n[a] - 1 : c);
+            cell[a] = c;
+            if (rate > 0.0) {
+                step[a] = 1;
+                tDelta[a] = 1.0 / rate;
+                tNext[a] = (c + 1 - g0[a]) / rate;
+            } else if (rate < 0.0) {
+                step[a] = -1;
+                tDelta[a] = -1.0 / rate;
+                tNext[a] = (c - g0[a]) / rate;
+            } else {
+                step[a] = 0;
+                tDelta[a] = tNext[a] = HUGE_VAL;
+            }
+        }
+        t = t0;
+        tEnd = t1;
+        return true;
+    }
+
+    // Step into the next voxel; false once the ray leaves the grid or passes tEnd.
+    bool advance()
+    {
+        const int a = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+        if (tNext[a] > tEnd) return false;
+        t = tNext[a];
+        cell[a] += step[a];
+        if (cell[a] < 0 || cell[a] >= n[a]) return false;
+        tNext[a] += tDelta[a];
+        return true;
+    }
+};
+
+// Unit direction and length of v; false for a zero or non-finite vector
+inline bool unitVector(double dx, double dy, double dz, double u[3], double &length)
+{
+    length = sqrt(dx * dx + dy * dy + dz * dz);
+    if (!(length > 0.0) || !(length < HUGE_VAL)) return false;
+    u[0] = dx / length;
+    u[1] = dy / length;
+    u[2] = dz / length;
+    return true;
+}
+
+struct CastJob {
+    const VoxelGrid *grid;
+    Point3 origin;
+    unsigned int originVoxel;
+    const Point3 *directions;
+    size_t n;
+    double maxRange;
+    double *hitRange;
+    unsigned int *hitVoxel;
+    std::atomic<size_t> hits;
+
+    void operator()(size_t block)
+    {
+        const size_t last = (block + 1) * kRayBlock < n ? (block + 1) * kRayBlock : n;
+        const unsigned char *cells = grid->data();
+        size_t count = 0;
+        for (size_t i = block * kRayBlock; i < last; ++i) {
+            double u[3], length, range = maxRange;
+            unsigned int voxel = kNoVoxel;
+            Dda d;
+            if (unitVector(directions[i].x, directions[i].y, directions[i].z, u, length) &&
+                d.start(grid->spec(), 1.0 / grid->spec().resolution, origin, u, maxRange)) {
+                do {
+                    const unsigned int idx = d.index();
+                    if ((cells[idx] & VOXEL_OCCUPIED) && idx != originVoxel) {
+                        range = d.t;
+                        voxel = idx;
+                        ++count;
+                        break;
+                    }
+                } while (d.advance());
+            }
+            hitRange[i] = range;
+            if (hitVoxel) hitVoxel[i] = voxel;
+        }
+        hits.fetch_add(count, std::memory_order_relaxed);
+    }
+};
+
+struct SegmentJob {
+    const VoxelGrid *grid;
+    unsigned char *cells; // non-null: carve
+    Point3 origin;
+    unsigned int originVoxel;
+    const Point3 *points;
+    size_t n;
+    unsigned char *visible;
+    std::atomic<size_t> total; // visible points, or carved voxel visits
+
+    void operator()(size_t block)
+    {
+        const size_t last = (block + 1) * kRayBlock < n ? (block + 1) * kRayBlock : n;
+        const unsigned char *read = grid->data();
+        const double inv = 1.0 / grid->spec().resolution;
+        size_t count = 0;
+        for (size_t i = block * kRayBlock; i < last; ++i) {
+            const Point3 &p = points[i];
+            const unsigned int target = grid->voxelIndex(p);
+            double u[3], length;
+            Dda d;
+            bool clear = true;
+            if (unitVector(p.x - origin.x, p.y - origin.y, p.z - origin.z, u, length) &&
+                d.start(grid->spec(), inv, origin, u, length)) {
+                do {
+                    const unsigned int idx = d.index();
+                    if (idx == target) break;
+                    if (cells) {
+                        std::atomic_ref<unsigned char> cell(cells[idx]);
+                        if (!(cell.load(std::memory_order_relaxed) & VOXEL_FREE)) {
+                            cell.fetch_or((unsigned char)VOXEL_FREE, std::memory_order_relaxed);
+                        }
+                        ++count;
+                    } else if ((read[idx] & VOXEL_OCCUPIED) && idx != originVoxel) {
+                        clear = false;
+                        break;
+                    }
+                } while (d.advance());
+            }
+            if (!cells) {
+                visible[i] = clear ? 1 : 0;
+                count += clear;
+            }
+        }
+        total.fetch_add(count, std::memory_order_relaxed);
+    }
+};
+
+} // namespace
+
+VoxelGridSpec centeredVoxelGrid(double cx, double cy, double z0, double resolution, int nx, int ny, int nz)
+{
+    VoxelGridSpec s;
+    s.origin = Point3{ cx - 0.5 * nx * resolution, cy - 0.5 * ny * resolution, z0 };
+    s.resolution = resolution;
+    s.nx = nx;
+    s.ny = ny;
+    s.nz = nz;
+    return s;
+}
+
+VoxelGrid::VoxelGrid() : spec_(), invResolution_(0.0), cells_(nullptr) {}
+
+VoxelGrid::~VoxelGrid() { free(cells_); }
+
+bool VoxelGrid::init(const VoxelGridSpec &spec)
+{
+    free(cells_);
+    cells_ = nullptr;
+    spec_ = VoxelGridSpec();
+    if (!(spec.resolution > 0.0) || spec.nx <= 0 || spec.ny <= 0 || spec.nz <= 0 ||
+        (double)spec.nx * spec.ny * spec.nz >= 4294967295.0) {
+        return false;
+    }
+    cells_ = (unsigned char *)calloc((size_t)spec.nx * spec.ny * spec.nz, 1);
+    if (!cells_) return false;
+    spec_ = spec;
+    invResolution_ = 1.0 / spec.resolution;
+    return true;
+}
+
+void VoxelGrid::clear()
+{
+    if (cells_) memset(cells_, 0, voxelCount());
+}
+
+unsigned int VoxelGrid::voxelIndex(const Point3 &p) const
+{
+    const double gx = (p.x - spec_.origin.x) * invResolution_;
+    const double gy = (p.y - spec_.origin.y) * invResolution_;
+    const double gz = (p.z - spec_.origin.z) * invResolution_;
+    if (!(gx >= 0.0 && gx < spec_.nx && gy >= 0.0 && gy < spec_.ny && gz >= 0.0 && gz < spec_.nz)) return kNoVoxel;
+    return (unsigned int)(((size_t)gz * spec_.ny + (size_t)gy) * spec_.nx + (size_t)gx);
+}
+
+Point3 VoxelGrid::voxelCenter(unsigned int index) const
+{
+    const unsigned ix = index % spec_.nx, iy = (index / spec_.nx) % spec_.ny, iz = index / spec_.nx / spec_.ny;
+    return Point3{ spec_.origin.x + (ix + 0.5) * spec_.resolution, spec_.origin.y + (iy + 0.5) * spec_.resolution,
+                   spec_.origin.z + (iz + 0.5) * spec_.resolution };
+}
+
+size_t VoxelGrid::insertPoints(const Point3 *points, size_t n)
+{
+    if (!cells_) return 0;
+    size_t inside = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const unsigned int idx = voxelIndex(points[i]);
+        if (idx == kNoVoxel) continue;
+        cells_[idx] |= VOXEL_OCCUPIED;
+        ++inside;
+    }
+    return inside;
+}
+
+size_t castRays(const VoxelGrid &grid, const Point3 &origin, const Point3 *directions, size_t n, double maxRange,
+                double *hitRange, unsigned int *hitVoxel, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RAY_CAST, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "castRays");
+    if (!grid.data() || !directions || !hitRange || n == 0) return 0;
+    CastJob job{ &grid, origin, grid.voxelIndex(origin), directions, n, maxRange, hitRange, hitVoxel, { 0 } };
+    (pool ? pool : defaultTaskPool())->parallelFor((n + kRayBlock - 1) / kRayBlock, job);
+    return job.hits.load();
+}
+
+size_t checkVisibility(const VoxelGrid &grid, const Point3 &origin, const Point3 *points, size_t n,
+                       unsigned char *visible, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_VISIBILITY, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "checkVisibility");
+    if (!grid.data() || !points || !visible || n == 0) return 0;
+    SegmentJob job{ &grid, nullptr, origin, grid.voxelIndex(origin), points, n, visible, { 0 } };
+    (pool ? pool : defaultTaskPool())->parallelFor((n + kRayBlock - 1) / kRayBlock, job);
+    return job.total.load();
+}
+
+size_t carveFreeSpace(VoxelGrid &grid, const Point3 &origin, const Point3 *points, size_t n, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_CARVE_FREE_SPACE, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "carveFreeSpace");
+    if (!grid.data() || !points || n == 0) return 0;
+    SegmentJob job{ &grid, grid.data(), origin, grid.voxelIndex(origin), points, n, nullptr, { 0 } };
+    (pool ? pool : defaultTaskPool())->parallelFor((n + kRayBlock - 1) / kRayBlock, job);
+    return job.total.load();
+}
+
+} // namespace AdasTools
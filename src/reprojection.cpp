@@ -0,0 +1,191 @@
+/* *******************************************************************************
+ * File: src/reprojection.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Batch reprojection residuals and Jacobians. The Euler chain
+ *              R = Rz*Ry*Rx is split as A = Rz*Ry and Rx once per call, so
+ *              each rotation column of the pose Jacobian is a cross product
+ *              and at most two 3x3 products.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "reprojection.hpp"
+#include "arena.hpp"
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include <math.h>
+#include <stdlib.h>
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kBlock = 1024; // correspondences per task (fixed: keeps the sums deterministic)
+const size_t kAlign = 32;
+
+struct BlockStats {
+    double sumSq;
+    double sumDist;
+    double max;
+    size_t maxIndex;
+    size_t valid;
+};
+
+struct Camera {
+    double A[9];  // Rz(yaw) * Ry(pitch)
+    double Rx[9]; // Rx(roll)
+    double t[3];
+    double fx, fy, cx, cy, s;
+    double minDepth;
+};
+
+inline void mul3(const double m[9], double x, double y, double z, double out[3])
+{
+    out[0] = m[0] * x + m[1] * y + m[2] * z;
+    out[1] = m[3] * x + m[4] * y + m[5] * z;
+    out[2] = m[6] * x + m[7] * y + m[8] * z;
+}
+
+struct ReprojectionJob {
+    const ImageCorrespondence *c;
+    size_t n;
+    const Camera *cam;
+    ReprojectionOutputs out;
+    BlockStats *blocks;
+
+    void operator()(size_t task)
+    {
+        const Camera &k = *cam;
+        const size_t first = task * kBlock;
+        const size_t last = first + kBlock < n ? first + kBlock : n;
+        BlockStats b{ 0.0, 0.0, -1.0, n, 0 };
+        for (size_t i = first; i < last; ++i) {
+            const Point3 &p = c[i].point;
+            double pr[3], q[3];
+            mul3(k.Rx, p.x, p.y, p.z, pr);
+            mul3(k.A, pr[0], pr[1], pr[2], q);
+            const double xc = q[0] + k.t[0], yc = q[1] + k.t[1], zc = q[2] + k.t[2];
+            if (!(zc > k.minDepth)) {
+                if (out.residuals) { out.residuals[2 * i] = 0.0; out.residuals[2 * i + 1] = 0.0; }
+                if (out.poseJacobian) { for (int j = 0; j < 12; ++j) out.poseJacobian[12 * i + j] = 0.0; }
+                if (out.intrinsicJacobian) { for (int j = 0; j < 10; ++j) out.intrinsicJacobian[10 * i + j] = 0.0; }
+                if (out.valid) out.valid[i] = 0;
+                continue;
+            }
+            const double iz = 1.0 / zc;
+            const double xn = xc * iz, yn = yc * iz;
+            const double du = k.fx * xn + k.s * yn + k.cx - c[i].u;
+            const double dv = k.fy * yn + k.cy - c[i].v;
+            const double d2 = du * du + dv * dv, dist = sqrt(d2);
+            b.sumSq += d2;
+            b.sumDist += dist;
+            if (dist > b.max) { b.max = dist; b.maxIndex = i; }
+            ++b.valid;
+            if (out.valid) out.valid[i] = 1;
+            if (out.residuals) { out.residuals[2 * i] = du; out.residuals[2 * i + 1] = dv; }
+
+            if (out.poseJacobian) {
+                // d(u,v)/d(camera point)
+                const double ux = k.fx * iz, uy = k.s * iz, uz = -(k.fx * xn + k.s * yn) * iz;
+                const double vy = k.fy * iz, vz = -k.fy * yn * iz;
+                // d(camera point)/d(roll, pitch, yaw)
+                double e[3], dr[3], dp[3];
+                mul3(k.Rx, 0.0, -p.z, p.y, e);
+                mul3(k.A, e[0], e[1], e[2], dr);   // roll: A * Rx * (ex x p)
+                mul3(k.A, pr[2], 0.0, -pr[0], dp); // pitch: A * (ey x Rx p)
+                const double dy[3] = { -q[1], q[0], 0.0 }; // yaw: ez x (R p)
+                double *J = out.poseJacobian + 12 * i;
+                J[0] = ux; J[1] = uy; J[2] = uz;
+                J[3] = ux * dr[0] + uy * dr[1] + uz * dr[2];
+                J[4] = ux * dp[0] + uy * dp[1] + uz * dp[2];
+                J[5] = ux * dy[0] + uy * dy[1] + uz * dy[2];
+                J[6] = 0.0; J[7] = vy; J[8] = vz;
+                J[9] = vy * dr[1] + vz * dr[2];
+                J[10] = vy * dp[1] + vz * dp[2];
+                J[11] = vy * dy[1] + vz * dy[2];
+            }
+            if (out.intrinsicJacobian) {
+                double *J = out.intrinsicJacobian + 10 * i;
+                J[0] = xn; J[1] = 0.0; J[2] = 1.0; J[3] = 0.0; J[4] = yn;
+                J[5] = 0.0; J[6] = yn; J[7] = 0.0; J[8] = 1.0; J[9] = 0.0;
+            }
+        }
+        blocks[task] = b;
+    }
+};
+
+void cameraFromPose(const Pose &pose, const double K[9], double minDepth, Camera &cam)
+{
+    const double cr = cos(pose.roll), sr = sin(pose.roll);
+    const double cp = cos(pose.pitch), sp = sin(pose.pitch);
+    const double cy = cos(pose.yaw), sy = sin(pose.yaw);
+    // Rz * Ry
+    cam.A[0] = cy * cp; cam.A[1] = -sy; cam.A[2] = cy * sp;
+    cam.A[3] = sy * cp; cam.A[4] = cy;  cam.A[5] = sy * sp;
+    cam.A[6] = -sp;     cam.A[7] = 0.0; cam.A[8] = cp;
+    cam.Rx[0] = 1.0; cam.Rx[1] = 0.0; cam.Rx[2] = 0.0;
+    cam.Rx[3] = 0.0; cam.Rx[4] = cr;  cam.Rx[5] = -sr;
+    cam.Rx[6] = 0.0; cam.Rx[7] = sr;  cam.Rx[8] = cr;
+    cam.t[0] = pose.x; cam.t[1] = pose.y; cam.t[2] = pose.z;
+    cam.fx = K[0]; cam.s = K[1]; cam.cx = K[2]; cam.fy = K[4]; cam.cy = K[5];
+    cam.minDepth = minDepth;
+}
+
+} // namespace
+
+size_t reprojectionScratchBytes(size_t n)
+{
+    return ((n + kBlock - 1) / kBlock) * sizeof(BlockStats) + kAlign;
+}
+
+bool evaluateReprojection(const ImageCorrespondence *correspondences, size_t n, const Pose &extrinsic,
+                          const double intrinsic[9], const ReprojectionOutputs &outputs, ReprojectionStats &stats,
+                          double minDepth, FrameArena *scratch, TaskPool *pool)
+{
+    ADAS_PROFILE_SCOPE(PROBE_REPROJECTION_ERROR, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_PROJECT, "evaluateReprojection");
+    stats = ReprojectionStats{ 0, 0.0, 0.0, 0.0, n };
+    if (n == 0) return true;
+
+    if (!scratch) scratch = threadScratchArena();
+    const size_t bytes = reprojectionScratchBytes(n);
+    const size_t marker = scratch ? scratch->mark() : 0;
+    BlockStats *blocks = scratch ? (BlockStats *)scratch->allocate(bytes, kAlign) : (BlockStats *)malloc(bytes);
+    if (!blocks) return false;
+
+    Camera cam;
+    cameraFromPose(extrinsic, intrinsic, minDepth, cam);
+    const size_t tasks = (n + kBlock - 1) / kBlock;
+    ReprojectionJob job{ correspondences, n, &cam, outputs, blocks };
+    (pool ? pool : defaultTaskPool())->parallelFor(tasks, job);
+
+    double sumSq = 0.0, sumDist = 0.0, max = -1.0;
+    for (size_t t = 0; t < tasks; ++t) {
+        const BlockStats &b = blocks[t];
+        sumSq += b.sumSq;
+        sumDist += b.sumDist;
+        stats.valid += b.valid;
+        if (b.max > max) { max = b.max; stats.maxIndex = b.maxIndex; }
+    }
+    if (stats.valid) {
+        stats.rms = sqrt(sumSq / (double)stats.valid);
+        stats.mean = sumDist / (double)stats.valid;
+        stats.max = max;
+    }
+
+    if (scratch) scratch->rewind(marker);
+    else free(blocks);
+    return true;
+}
+
+bool evaluateReprojection(const ImageCorrespondence *correspondences, size_t n, const double extrinsic[16],
+                          const double intrinsic[9], const ReprojectionOutputs &outputs, ReprojectionStats &stats,
+                          double minDepth, FrameArena *scratch, TaskPool *pool)
+{
+    return evaluateReprojection(correspondences, n, matrixToPose(extrinsic), intrinsic, outputs, stats, minDepth,
+                                scratch, pool);
+}
+
+} // namespace AdasTools
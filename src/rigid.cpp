@@ -0,0 +1,179 @@
+/* *******************************************************************************
+ * File: src/rigid.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Batch rigid-transform kernels. On x86 with GCC/Clang an
+ *              AVX2/FMA version (one 4-wide row = 3 rotation columns +
+ *              translation per register) is compiled with a target attribute
+ *              and chosen at run time; other targets use the portable inline
+ *              operations from rigid.hpp.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "rigid.hpp"
+#include "instrumentation.hpp"
+#include "trace.hpp"
+#include "trig.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ADAS_RIGID_HAVE_AVX2 1
+#endif
+
+namespace AdasTools {
+
+namespace {
+
+#if defined(ADAS_RIGID_HAVE_AVX2)
+
+bool cpuHasAvx2Fma()
+{
+    static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return ok;
+}
+
+// Row r of A*B = a_r0*B0 + a_r1*B1 + a_r2*B2 + a_r3*[0 0 0 1].
+__attribute__((target("avx2,fma")))
+inline __m256d composeRow(const double *ar, __m256d b0, __m256d b1, __m256d b2, __m256d e3)
+{
+    __m256d acc = _mm256_mul_pd(_mm256_broadcast_sd(ar + 3), e3);
+    acc = _mm256_fmadd_pd(_mm256_broadcast_sd(ar + 0), b0, acc);
+    acc = _mm256_fmadd_pd(_mm256_broadcast_sd(ar + 1), b1, acc);
+    acc = _mm256_fmadd_pd(_mm256_broadcast_sd(ar + 2), b2, acc);
+    return acc;
+}
+
+__attribute__((target("avx2,fma")))
+inline void storeRigid(double *out, __m256d r0, __m256d r1, __m256d r2, __m256d e3)
+{
+    _mm256_storeu_pd(out + 0, r0);
+    _mm256_storeu_pd(out + 4, r1);
+    _mm256_storeu_pd(out + 8, r2);
+    _mm256_storeu_pd(out + 12, e3);
+}
+
+__attribute__((target("avx2,fma")))
+void composePairsAvx2(const double *as, size_t aStride, const double *bs, size_t bStride, double *outs, size_t n)
+{
+    const __m256d e3 = _mm256_set_pd(1.0, 0.0, 0.0, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        const double *a = as + i * aStride;
+        const double *b = bs + i * bStride;
+        const __m256d b0 = _mm256_loadu_pd(b + 0);
+        const __m256d b1 = _mm256_loadu_pd(b + 4);
+        const __m256d b2 = _mm256_loadu_pd(b + 8);
+        __m256d r0 = composeRow(a + 0, b0, b1, b2, e3);
+        __m256d r1 = composeRow(a + 4, b0, b1, b2, e3);
+        __m256d r2 = composeRow(a + 8, b0, b1, b2, e3);
+        storeRigid(outs + i * 16, r0, r1, r2, e3);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void composeRightAvx2(const double *as, const double *b, double *outs, size_t n)
+{
+    // The right operand is shared: keep its rows in registers.
+    const __m256d e3 = _mm256_set_pd(1.0, 0.0, 0.0, 0.0);
+    const __m256d b0 = _mm256_loadu_pd(b + 0);
+    const __m256d b1 = _mm256_loadu_pd(b + 4);
+    const __m256d b2 = _mm256_loadu_pd(b + 8);
+    for (size_t i = 0; i < n; ++i) {
+        const double *a = as + i * 16;
+        __m256d r0 = composeRow(a + 0, b0, b1, b2, e3);
+        __m256d r1 = composeRow(a + 4, b0, b1, b2, e3);
+        __m256d r2 = composeRow(a + 8, b0, b1, b2, e3);
+        storeRigid(outs + i * 16, r0, r1, r2, e3);
+    }
+}
+
+#endif // ADAS_RIGID_HAVE_AVX2
+
+void composePairsScalar(const double *as, size_t aStride, const double *bs, size_t bStride, double *outs, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) rigidCompose(as + i * aStride, bs + i * bStride, outs + i * 16);
+}
+
+} // namespace
+
+void rigidComposeBatch(const double a[16], const double *bs, double *outs, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RIGID_COMPOSE, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "rigidComposeBatch");
+#if defined(ADAS_RIGID_HAVE_AVX2)
+    if (cpuHasAvx2Fma()) { composePairsAvx2(a, 0, bs, 16, outs, n); return; }
+#endif
+    composePairsScalar(a, 0, bs, 16, outs, n);
+}
+
+void rigidComposeBatchRight(const double *as, const double b[16], double *outs, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RIGID_COMPOSE, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "rigidComposeBatchRight");
+#if defined(ADAS_RIGID_HAVE_AVX2)
+    if (cpuHasAvx2Fma()) { composeRightAvx2(as, b, outs, n); return; }
+#endif
+    composePairsScalar(as, 16, b, 0, outs, n);
+}
+
+void rigidComposePairs(const double *as, const double *bs, double *outs, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RIGID_COMPOSE, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "rigidComposePairs");
+#if defined(ADAS_RIGID_HAVE_AVX2)
+    if (cpuHasAvx2Fma()) { composePairsAvx2(as, 16, bs, 16, outs, n); return; }
+#endif
+    composePairsScalar(as, 16, bs, 16, outs, n);
+}
+
+void rigidInverseBatch(const double *ms, double *outs, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RIGID_INVERSE, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "rigidInverseBatch");
+    for (size_t i = 0; i < n; ++i) rigidInverse(ms + i * 16, outs + i * 16);
+}
+
+void posesToMatrices(const Pose *poses, double *outs, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_POSES_TO_MATRICES, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "posesToMatrices");
+    const size_t kBlock = 64;
+    const TrigTier tier = trigTier();
+    double angles[3 * kBlock], s[3 * kBlock], c[3 * kBlock];
+    for (size_t base = 0; base < n; base += kBlock) {
+        // Block layout: k rolls, k pitches, k yaws
+        const size_t k = n - base < kBlock ? n - base : kBlock;
+        for (size_t i = 0; i < k; ++i) {
+            angles[i] = poses[base + i].roll;
+            angles[k + i] = poses[base + i].pitch;
+            angles[2 * k + i] = poses[base + i].yaw;
+        }
+        sinCosBatch(angles, s, c, 3 * k, tier);
+        for (size_t i = 0; i < k; ++i) {
+            const double sr = s[i], cr = c[i], sp = s[k + i], cp = c[k + i], sy = s[2 * k + i], cy = c[2 * k + i];
+            const Pose &p = poses[base + i];
+            double *m = outs + (base + i) * 16;
+            // R = Rz * Ry * Rx, as pose6ToMatrix()
+            m[0] = cy*cp; m[1] = cy*sp*sr - sy*cr; m[2] = cy*sp*cr + sy*sr; m[3] = p.x;
+            m[4] = sy*cp; m[5] = sy*sp*sr + cy*cr; m[6] = sy*sp*cr - cy*sr; m[7] = p.y;
+            m[8] = -sp;   m[9] = cp*sr;            m[10] = cp*cr;           m[11] = p.z;
+            m[12] = 0.0; m[13] = 0.0; m[14] = 0.0; m[15] = 1.0;
+        }
+    }
+}
+
+void rigidTransformPoints(const double m[16], const Point3 *in, Point3 *out, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_RIGID_TRANSFORM_POINTS, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "rigidTransformPoints");
+    const double r00 = m[0], r01 = m[1], r02 = m[2], tx = m[3];
+    const double r10 = m[4], r11 = m[5], r12 = m[6], ty = m[7];
+    const double r20 = m[8], r21 = m[9], r22 = m[10], tz = m[11];
+    for (size_t i = 0; i < n; ++i) {
+        const double x = in[i].x, y = in[i].y, z = in[i].z;
+        out[i].x = r00*x + r01*y + r02*z + tx;
+        out[i].y = r10*x + r11*y + r12*z + ty;
+        out[i].z = r20*x + r21*y + r22*z + tz;
+    }
+}
+
+} // namespace AdasTools
@@ -0,0 +1,184 @@
+/* *******************************************************************************
+ * File: src/roi.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: ROI point filters. Points are processed in blocks: one pass
+ *              per region computes a 0/1 keep byte per point with comparisons
+ *              only (vectorizable), then a branchless store-and-advance loop
+ *              compacts the block.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "roi.hpp"
+#include "instrumentation.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include "transformers.hpp"
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kBlock = 256;
+
+} // namespace
+
+bool PointFilter::add(const Region &r)
+{
+    if (count_ >= kRoiMaxRegions) return false;
+    regions_[count_++] = r;
+    return true;
+}
+
+bool PointFilter::addBox(const AxisAlignedBox &box, RoiMode mode)
+{
+    Region r;
+    const double m[12] = { 1, 0, 0, -0.5 * (box.min.x + box.max.x),
+                           0, 1, 0, -0.5 * (box.min.y + box.max.y),
+                           0, 0, 1, -0.5 * (box.min.z + box.max.z) };
+    for (int i = 0; i < 12; ++i) r.m[i] = m[i];
+    r.hx = 0.5 * (box.max.x - box.min.x);
+    r.hy = 0.5 * (box.max.y - box.min.y);
+    r.hz = 0.5 * (box.max.z - box.min.z);
+    r.r2 = 0.0;
+    r.shape = SHAPE_BOX;
+    r.removeInside = mode == ROI_REMOVE_INSIDE;
+    return add(r);
+}
+
+bool PointFilter::addOrientedBox(const OrientedBox &box, RoiMode mode)
+{
+    Region r;
+    double pose[16], inv[16];
+    poseToMatrix(box.center, pose);
+    rigidInverse(pose, inv);
+    for (int i = 0; i < 12; ++i) r.m[i] = inv[i];
+    r.hx = 0.5 * box.size.x;
+    r.hy = 0.5 * box.size.y;
+    r.hz = 0.5 * box.size.z;
+    r.r2 = 0.0;
+    r.shape = SHAPE_BOX;
+    r.removeInside = mode == ROI_REMOVE_INSIDE;
+    return add(r);
+}
+
+bool PointFilter::addCylinder(const RoiCylinder &cylinder, RoiMode mode)
+{
+    Region r;
+    const double m[12] = { 1, 0, 0, -cylinder.cx,
+                           0, 1, 0, -cylinder.cy,
+                           0, 0, 1, -0.5 * (cylinder.zMin + cylinder.zMax) };
+    for (int i = 0; i < 12; ++i) r.m[i] = m[i];
+    r.hx = r.hy = cylinder.radius;
+    r.hz = 0.5 * (cylinder.zMax - cylinder.zMin);
+    r.r2 = cylinder.radius * cylinder.radius;
+    r.shape = SHAPE_CYLINDER;
+    r.removeInside = mode == ROI_REMOVE_INSIDE;
+    return add(r);
+}
+
+bool PointFilter::passes(const Point3 &p) const
+{
+    unsigned char keep;
+    keepMask(&p, 1, &keep);
+    return keep != 0;
+}
+
+void PointFilter::keepMask(const Point3 *in, size_t n, unsigned char *keep) const
+{
+    for (size_t i = 0; i < n; ++i) keep[i] = 1;
+    for (size_t k = 0; k < count_; ++k) {
+        const Region &r = regions_[k];
+        const double m0 = r.m[0], m1 = r.m[1], m2 = r.m[2], m3 = r.m[3];
+        const double m4 = r.m[4], m5 = r.m[5], m6 = r.m[6], m7 = r.m[7];
+        const double m8 = r.m[8], m9 = r.m[9], m10 = r.m[10], m11 = r.m[11];
+        const double hx = r.hx, hy = r.hy, hz = r.hz, r2 = r.r2;
+        const unsigned char flip = r.removeInside;
+        if (r.shape == SHAPE_CYLINDER) {
+            for (size_t i = 0; i < n; ++i) {
+                const double x = in[i].x + m3, y = in[i].y + m7, z = in[i].z + m11;
+                const unsigned char inside = (unsigned char)((x * x + y * y <= r2) & (z >= -hz) & (z <= hz));
+                keep[i] &= (unsigned char)(inside ^ flip);
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                const double px = in[i].x, py = in[i].y, pz = in[i].z;
+                const double x = m0 * px + m1 * py + m2 * pz + m3;
+                const double y = m4 * px + m5 * py + m6 * pz + m7;
+                const double z = m8 * px + m9 * py + m10 * pz + m11;
+                const unsigned char inside = (unsigned char)((x >= -hx) & (x <= hx) & (y >= -hy) & (y <= hy) &
+                                                             (z >= -hz) & (z <= hz));
+                keep[i] &= (unsigned char)(inside ^ flip);
+            }
+        }
+    }
+}
+
+size_t PointFilter::filterPoints(const Point3 *in, size_t n, Point3 *out) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_FILTER_POINTS, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "filterPoints");
+    unsigned char keep[kBlock];
+    size_t count = 0;
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = n - base < kBlock ? n - base : kBlock;
+        keepMask(in + base, m, keep);
+        // Always store, advance by the keep bit: count <= base + i, so this
+        // also works in place.
+        for (size_t i = 0; i < m; ++i) {
+            out[count] = in[base + i];
+            count += keep[i];
+        }
+    }
+    return count;
+}
+
+size_t PointFilter::filterIndices(const Point3 *in, size_t n, unsigned int *indices) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_FILTER_POINTS, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "filterIndices");
+    unsigned char keep[kBlock];
+    size_t count = 0;
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = n - base < kBlock ? n - base : kBlock;
+        keepMask(in + base, m, keep);
+        for (size_t i = 0; i < m; ++i) {
+            indices[count] = (unsigned int)(base + i);
+            count += keep[i];
+        }
+    }
+    return count;
+}
+
+size_t PointFilter::filterTransform(const Point3 *in, size_t n, const double transform[16], Point3 *out) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_FILTER_POINTS, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "filterTransform");
+    unsigned char keep[kBlock];
+    unsigned short survivors[kBlock];
+    const double r00 = transform[0], r01 = transform[1], r02 = transform[2], tx = transform[3];
+    const double r10 = transform[4], r11 = transform[5], r12 = transform[6], ty = transform[7];
+    const double r20 = transform[8], r21 = transform[9], r22 = transform[10], tz = transform[11];
+    size_t count = 0;
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = n - base < kBlock ? n - base : kBlock;
+        keepMask(in + base, m, keep);
+        size_t s = 0;
+        for (size_t i = 0; i < m; ++i) {
+            survivors[s] = (unsigned short)i;
+            s += keep[i];
+        }
+        // Only survivors are transformed; out[count + j] never passes in[base + i].
+        for (size_t j = 0; j < s; ++j) {
+            const Point3 p = in[base + survivors[j]];
+            Point3 &o = out[count + j];
+            o.x = r00 * p.x + r01 * p.y + r02 * p.z + tx;
+            o.y = r10 * p.x + r11 * p.y + r12 * p.z + ty;
+            o.z = r20 * p.x + r21 * p.y + r22 * p.z + tz;
+        }
+        count += s;
+    }
+    return count;
+}
+
+} // namespace AdasTools
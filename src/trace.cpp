@@ -0,0 +1,198 @@
+/* *******************************************************************************
+ * File: src/trace.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Per-thread trace event buffers and the Chrome trace JSON
+ *              writer. A thread appends to its own buffer and publishes the
+ *              new count with a release store; the exporter reads each buffer
+ *              up to its published count, so recording never takes a lock.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "trace.hpp"
+#include "histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+namespace AdasTools {
+
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    unsigned long long beginNs;
+    unsigned long long endNs;
+    int stage;
+};
+
+struct ThreadTrace {
+    TraceEvent events[kTraceEventsPerThread];
+    std::atomic<size_t> count;
+    std::atomic<size_t> dropped;
+    unsigned tid;
+    char name[32];
+    ThreadTrace *next;
+};
+
+std::atomic<bool> g_enabled{ false };
+std::atomic<ThreadTrace *> g_traces{ nullptr };
+std::atomic<unsigned> g_nextTid{ 1 };
+thread_local ThreadTrace *t_trace = nullptr;
+
+ThreadTrace *threadTrace()
+{
+    if (t_trace) return t_trace;
+    // Buffers are never freed so events of exited threads can still be exported.
+    ThreadTrace *t = new ThreadTrace();
+    t->count.store(0, std::memory_order_relaxed);
+    t->dropped.store(0, std::memory_order_relaxed);
+    t->tid = g_nextTid.fetch_add(1, std::memory_order_relaxed);
+    t->name[0] = '\0';
+    t->next = g_traces.load(std::memory_order_relaxed);
+    while (!g_traces.compare_exchange_weak(t->next, t, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    t_trace = t;
+    return t;
+}
+
+// Event names are expected to be identifiers; escape the JSON specials anyway.
+void writeJsonString(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s < 0x20) continue;
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+} // namespace
+
+void traceSetEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool traceEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+bool stageTimingEnabled()
+{
+    return traceEnabled() || latencyEnabled();
+}
+
+unsigned long long traceNowNs()
+{
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void traceRecord(TraceStage stage, const char *name, unsigned long long beginNs, unsigned long long endNs)
+{
+    if (latencyEnabled()) latencyRecord(stage, endNs - beginNs);
+    if (!traceEnabled()) return;
+    ThreadTrace *t = threadTrace();
+    size_t n = t->count.load(std::memory_order_relaxed);
+    if (n >= kTraceEventsPerThread) {
+        t->dropped.store(t->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent &e = t->events[n];
+    e.name = name;
+    e.beginNs = beginNs;
+    e.endNs = endNs;
+    e.stage = (int)stage;
+    t->count.store(n + 1, std::memory_order_release);
+}
+
+void traceSetThreadName(const char *name)
+{
+    ThreadTrace *t = threadTrace();
+    strncpy(t->name, name, sizeof(t->name) - 1);
+    t->name[sizeof(t->name) - 1] = '\0';
+}
+
+bool traceWriteChromeJson(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+
+    // Timestamps are emitted relative to the earliest event to keep them short.
+    unsigned long long origin = ~0ull;
+    for (ThreadTrace *t = g_traces.load(std::memory_order_acquire); t; t = t->next) {
+        size_t n = t->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) if (t->events[i].beginNs < origin) origin = t->events[i].beginNs;
+    }
+    if (origin == ~0ull) origin = 0;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (ThreadTrace *t = g_traces.load(std::memory_order_acquire); t; t = t->next) {
+        if (t->name[0] != '\0') {
+            fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                    first ? "" : ",\n", t->tid);
+            writeJsonString(f, t->name);
+            fprintf(f, "}}");
+            first = false;
+        }
+        size_t n = t->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            const TraceEvent &e = t->events[i];
+            fprintf(f, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"cat\":\"%s\",\"name\":",
+                    first ? "" : ",\n", t->tid, traceStageName((TraceStage)e.stage));
+            writeJsonString(f, e.name);
+            fprintf(f, ",\"ts\":%.3f,\"dur\":%.3f}",
+                    (double)(e.beginNs - origin) / 1000.0, (double)(e.endNs - e.beginNs) / 1000.0);
+            first = false;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    bool ok = ferror(f) == 0;
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+void traceClear()
+{
+    for (ThreadTrace *t = g_traces.load(std::memory_order_acquire); t; t = t->next) {
+        t->count.store(0, std::memory_order_relaxed);
+        t->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t traceEventCount()
+{
+    size_t total = 0;
+    for (ThreadTrace *t = g_traces.load(std::memory_order_acquire); t; t = t->next) {
+        total += t->count.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+size_t traceDroppedCount()
+{
+    size_t total = 0;
+    for (ThreadTrace *t = g_traces.load(std::memory_order_acquire); t; t = t->next) {
+        total += t->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char *traceStageName(TraceStage stage)
+{
+    switch (stage) {
+    case TRACE_STAGE_TRANSFORM: return "transform";
+    case TRACE_STAGE_PROJECT: return "project";
+    case TRACE_STAGE_RASTERIZE: return "rasterize";
+    case TRACE_STAGE_INTERPOLATE: return "interpolate";
+    case TRACE_STAGE_USER: return "user";
+    default: return "unknown";
+    }
+}
+
+} // namespace AdasTools
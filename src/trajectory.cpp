@@ -0,0 +1,224 @@
+/* *******************************************************************************
+ * File: src/trajectory.cpp
+ * Project: ADAS Tools Library (adas_tools)
+ * Description: Trajectory storage and relative-pose queries. The relative
+ *              kernel is written on scalars so the consecutive-delta loop over
+ *              the SoA columns can be vectorized by the compiler.
+ * Author: VineetKP
+ * Created: 2026-10-18
+ * *******************************************************************************/
+
+#include "trajectory.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "instrumentation.hpp"
+#include "rigid.hpp"
+#include "trace.hpp"
+#include "trig.hpp"
+
+namespace AdasTools {
+
+namespace {
+
+const size_t kColumns = 8;
+
+// T_i^-1 * T_j on raw components: q = conj(qi) * qj, t = R(qi)^T (tj - ti).
+inline void relativeKernel(double aw, double ax, double ay, double az, double atx, double aty, double atz,
+                           double bw, double bx, double by, double bz, double btx, double bty, double btz,
+                           RigidTransform &out)
+{
+    out.q.w = aw * bw + ax * bx + ay * by + az * bz;
+    out.q.x = aw * bx - ax * bw - ay * bz + az * by;
+    out.q.y = aw * by + ax * bz - ay * bw - az * bx;
+    out.q.z = aw * bz - ax * by + ay * bx - az * bw;
+
+    // Rotate d by conj(qa): d + 2w(u x d) + 2u x (u x d) with u = -(ax, ay, az).
+    double dx = btx - atx, dy = bty - aty, dz = btz - atz;
+    double ux = -ax, uy = -ay, uz = -az;
+    double cx = 2.0 * (uy * dz - uz * dy);
+    double cy = 2.0 * (uz * dx - ux * dz);
+    double cz = 2.0 * (ux * dy - uy * dx);
+    out.t.x = dx + aw * cx + (uy * cz - uz * cy);
+    out.t.y = dy + aw * cy + (uz * cx - ux * cz);
+    out.t.z = dz + aw * cz + (ux * cy - uy * cx);
+}
+
+} // namespace
+
+RigidTransform poseToTransform(const Pose &pose)
+{
+    RigidTransform r;
+    r.q = quaternionFromRPY(pose.roll, pose.pitch, pose.yaw);
+    r.t = Point3{ pose.x, pose.y, pose.z };
+    return r;
+}
+
+void posesToTransforms(const Pose *poses, RigidTransform *out, size_t n)
+{
+    ADAS_PROFILE_SCOPE(PROBE_POSES_TO_TRANSFORMS, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "posesToTransforms");
+    const size_t kBlock = 64;
+    const TrigTier tier = trigTier();
+    double angles[3 * kBlock], s[3 * kBlock], c[3 * kBlock];
+    for (size_t base = 0; base < n; base += kBlock) {
+        // Block layout: k half rolls, k half pitches, k half yaws
+        const size_t k = n - base < kBlock ? n - base : kBlock;
+        for (size_t i = 0; i < k; ++i) {
+            angles[i] = poses[base + i].roll * 0.5;
+            angles[k + i] = poses[base + i].pitch * 0.5;
+            angles[2 * k + i] = poses[base + i].yaw * 0.5;
+        }
+        sinCosBatch(angles, s, c, 3 * k, tier);
+        for (size_t i = 0; i < k; ++i) {
+            const double sr = s[i], cr = c[i], sp = s[k + i], cp = c[k + i], sy = s[2 * k + i], cy = c[2 * k + i];
+            const Pose &p = poses[base + i];
+            RigidTransform &r = out[base + i];
+            // as quaternionFromRPY()
+            r.q.w = cr*cp*cy + sr*sp*sy;
+            r.q.x = sr*cp*cy - cr*sp*sy;
+            r.q.y = cr*sp*cy + sr*cp*sy;
+            r.q.z = cr*cp*sy - sr*sp*cy;
+            r.t = Point3{ p.x, p.y, p.z };
+        }
+    }
+}
+
+void transformToMatrix(const RigidTransform &tf, double outMat16[16])
+{
+    const double w = tf.q.w, x = tf.q.x, y = tf.q.y, z = tf.q.z;
+    outMat16[0] = 1.0 - 2.0 * (y*y + z*z); outMat16[1] = 2.0 * (x*y - w*z);       outMat16[2] = 2.0 * (x*z + w*y);        outMat16[3] = tf.t.x;
+    outMat16[4] = 2.0 * (x*y + w*z);       outMat16[5] = 1.0 - 2.0 * (x*x + z*z); outMat16[6] = 2.0 * (y*z - w*x);        outMat16[7] = tf.t.y;
+    outMat16[8] = 2.0 * (x*z - w*y);       outMat16[9] = 2.0 * (y*z + w*x);       outMat16[10] = 1.0 - 2.0 * (x*x + y*y); outMat16[11] = tf.t.z;
+    outMat16[12] = 0.0; outMat16[13] = 0.0; outMat16[14] = 0.0; outMat16[15] = 1.0;
+}
+
+Pose transformToPose(const RigidTransform &tf)
+{
+    double m[16];
+    transformToMatrix(tf, m);
+    return matrixToPose(m);
+}
+
+Trajectory::Trajectory()
+    : block_(nullptr), stamp_(nullptr), qw_(nullptr), qx_(nullptr), qy_(nullptr), qz_(nullptr),
+      tx_(nullptr), ty_(nullptr), tz_(nullptr), size_(0), capacity_(0)
+{
+}
+
+Trajectory::~Trajectory()
+{
+    free(block_);
+}
+
+bool Trajectory::reserve(size_t capacity)
+{
+    if (capacity <= capacity_) return true;
+    if (capacity > (size_t)-1 / (kColumns * sizeof(double))) return false; // byte count must not wrap
+    double *block = static_cast<double *>(malloc(capacity * kColumns * sizeof(double)));
+    if (!block) return false;
+    double *cols[kColumns];
+    for (size_t c = 0; c < kColumns; ++c) cols[c] = block + c * capacity;
+    const double *old[kColumns] = { stamp_, qw_, qx_, qy_, qz_, tx_, ty_, tz_ };
+    if (size_) {
+        for (size_t c = 0; c < kColumns; ++c) memcpy(cols[c], old[c], size_ * sizeof(double));
+    }
+    free(block_);
+    block_ = block;
+    stamp_ = cols[0]; qw_ = cols[1]; qx_ = cols[2]; qy_ = cols[3];
+    qz_ = cols[4]; tx_ = cols[5]; ty_ = cols[6]; tz_ = cols[7];
+    capacity_ = capacity;
+    return true;
+}
+
+bool Trajectory::grow()
+{
+    return reserve(capacity_ ? capacity_ * 2 : 1024);
+}
+
+bool Trajectory::append(double stamp, const Pose &pose)
+{
+    return append(stamp, poseToTransform(pose));
+}
+
+bool Trajectory::append(double stamp, const RigidTransform &absolute)
+{
+    if (size_ == capacity_ && !grow()) return false;
+    Quaternion q = normalizeQuaternion(absolute.q);
+    // Keep consecutive quaternions in the same hemisphere for interpolation.
+    if (size_ && q.w * qw_[size_ - 1] + q.x * qx_[size_ - 1] + q.y * qy_[size_ - 1] + q.z * qz_[size_ - 1] < 0.0) {
+        q.w = -q.w; q.x = -q.x; q.y = -q.y; q.z = -q.z;
+    }
+    const size_t i = size_++;
+    stamp_[i] = stamp;
+    qw_[i] = q.w; qx_[i] = q.x; qy_[i] = q.y; qz_[i] = q.z;
+    tx_[i] = absolute.t.x; ty_[i] = absolute.t.y; tz_[i] = absolute.t.z;
+    return true;
+}
+
+bool Trajectory::appendDelta(double stamp, const RigidTransform &delta)
+{
+    if (size_ == 0) return append(stamp, delta);
+    return append(stamp, composeTransform(transform(size_ - 1), delta));
+}
+
+RigidTransform Trajectory::relative(size_t i, size_t j) const
+{
+    RigidTransform r;
+    relativeKernel(qw_[i], qx_[i], qy_[i], qz_[i], tx_[i], ty_[i], tz_[i],
+                   qw_[j], qx_[j], qy_[j], qz_[j], tx_[j], ty_[j], tz_[j], r);
+    return r;
+}
+
+void Trajectory::relativeBatch(const size_t *from, const size_t *to, RigidTransform *out, size_t n) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_TRAJECTORY_RELATIVE, n);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "Trajectory::relativeBatch");
+    for (size_t k = 0; k < n; ++k) out[k] = relative(from[k], to[k]);
+}
+
+void Trajectory::deltas(size_t first, size_t count, size_t stride, RigidTransform *out) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_TRAJECTORY_RELATIVE, count);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_TRANSFORM, "Trajectory::deltas");
+    const double *__restrict w = qw_ + first;
+    const double *__restrict x = qx_ + first;
+    const double *__restrict y = qy_ + first;
+    const double *__restrict z = qz_ + first;
+    const double *__restrict px = tx_ + first;
+    const double *__restrict py = ty_ + first;
+    const double *__restrict pz = tz_ + first;
+    for (size_t k = 0; k < count; ++k) {
+        const size_t a = k * stride, b = a + stride;
+        relativeKernel(w[a], x[a], y[a], z[a], px[a], py[a], pz[a],
+                       w[b], x[b], y[b], z[b], px[b], py[b], pz[b], out[k]);
+    }
+}
+
+size_t Trajectory::indexAtOrBefore(double t) const
+{
+    if (size_ == 0 || t < stamp_[0]) return size_;
+    size_t lo = 0, hi = size_;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (stamp_[mid] <= t) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+bool Trajectory::interpolate(double t, RigidTransform &out) const
+{
+    ADAS_PROFILE_SCOPE(PROBE_TRAJECTORY_INTERPOLATE, 1);
+    ADAS_TRACE_SCOPE(TRACE_STAGE_INTERPOLATE, "Trajectory::interpolate");
+    size_t i = indexAtOrBefore(t);
+    if (i == size_ || t > stamp_[size_ - 1]) return false;
+    if (i + 1 == size_ || stamp_[i + 1] == stamp_[i]) { out = transform(i); return true; }
+    double a = (t - stamp_[i]) / (stamp_[i + 1] - stamp_[i]);
+    RigidTransform p = transform(i), q = transform(i + 1);
+    out.q = slerp(p.q, q.q, a);
+    out.t = Point3{ p.t.x + a * (q.t.x - p.t.x), p.t.y + a * (q.t.y - p.t.y), p.t.z + a * (q.t.z - p.t.z) };
+    return true;
+}
+
+} // namespace AdasTools
@@ -0,0 +1,83 @@
+/* *******************************************************************************
+ * File: tests/bench_core.cpp
+ * Description: Micro-benchmark of per-element calls into the transform and
+ *              quaternion core from a user loop. Built twice: `bench_core`
+ *              links the out-of-line library, `bench_core_inline` compiles the
+ *              core inline (ADAS_TOOLS_HEADER_ONLY). Compare their ns/elem
+ *              (and an ADAS_TOOLS_LTO=ON build) to see the call overhead.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "transformers.hpp"
+#include "quaternion.hpp"
+
+using namespace AdasTools;
+
+static const int N = 100000;
+static const int REPEAT = 20;
+static Point3 g_in[N];
+static Point3 g_out[N];
+static Quaternion g_q[N];
+
+static bool approx(double a, double b, double eps=1e-9) { double d=a-b; if (d<0)d=-d; return d<=eps; }
+
+template <typename F>
+static double timeLoop(const char *label, F body)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < REPEAT; ++r) body();
+    auto end = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(end - start).count();
+    double perElem = ns / ((double)N * REPEAT);
+    std::cout << "  " << label << ": " << perElem << " ns/elem\n";
+    return perElem;
+}
+
+int main()
+{
+    for (int i = 0; i < N; ++i) {
+        g_in[i] = Point3{ 0.01 * i, 1.0 - 0.002 * i, 0.5 + 0.001 * (i % 100) };
+        g_q[i] = quaternionFromRPY(0.001 * (i % 628), 0.1, -0.2);
+    }
+    const Quaternion rot = quaternionFromRPY(0.1, -0.05, 0.3);
+    const Frame3D frame = {1.5, -0.2, 0.8, 0.02, -0.01, 0.4};
+
+#if defined(ADAS_TOOLS_HEADER_ONLY)
+    std::cout << "bench_core (header-only inline core)\n";
+#else
+    std::cout << "bench_core (out-of-line core)\n";
+#endif
+
+    timeLoop("scalePosition+translatePosition", []() {
+        for (int i = 0; i < N; ++i) g_out[i] = translatePosition(scalePosition(g_in[i], 1.01), 0.5, -0.25, 0.1);
+    });
+    if (!approx(g_out[7].x, g_in[7].x * 1.01 + 0.5)) { std::cerr << "scale/translate mismatch\n"; return 1; }
+
+    timeLoop("rotateByQuaternion", [&rot]() {
+        for (int i = 0; i < N; ++i) g_out[i] = rotateByQuaternion(rot, g_in[i]);
+    });
+    Point3 ref = rotatePosition(g_in[11], 0.1, -0.05, 0.3);
+    if (!approx(g_out[11].x, ref.x) || !approx(g_out[11].y, ref.y) || !approx(g_out[11].z, ref.z)) {
+        std::cerr << "rotateByQuaternion mismatch\n"; return 2;
+    }
+
+    Quaternion acc = { 1.0, 0.0, 0.0, 0.0 };
+    timeLoop("multiplyQuaternion", [&acc, &rot]() {
+        for (int i = 0; i < N; ++i) g_q[i] = multiplyQuaternion(rot, g_q[i]);
+        acc = multiplyQuaternion(acc, g_q[N - 1]);
+    });
+
+    timeLoop("localToGlobal(Point3)", [&frame]() {
+        for (int i = 0; i < N; ++i) g_out[i] = localToGlobal(g_in[i], frame);
+    });
+    Point3 back = globalToLocal(g_out[3], frame);
+    if (!approx(back.x, g_in[3].x) || !approx(back.y, g_in[3].y) || !approx(back.z, g_in[3].z)) {
+        std::cerr << "localToGlobal mismatch\n"; return 3;
+    }
+
+    double norm = sqrt(acc.w*acc.w + acc.x*acc.x + acc.y*acc.y + acc.z*acc.z);
+    std::cout << "checksum " << g_out[N / 2].x + norm << "\n";
+    return 0;
+}
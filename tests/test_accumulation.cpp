@@ -0,0 +1,208 @@
+/* *******************************************************************************
+ * File: tests/test_accumulation.cpp
+ * Description: Test the rolling voxel accumulation map: a static scene seen
+ *              from a moving vehicle comes back in the current vehicle frame,
+ *              age eviction and the per-voxel ring, distance eviction while
+ *              rolling along a corridor (hash deletion), the voxel cap,
+ *              identical extraction for any thread count. Also prints the
+ *              per-frame cost against re-transforming the sweep history.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include "accumulation.hpp"
+#include "arena.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const size_t kMaxPoints = 1 << 20;
+static Point3 g_scene[kMaxPoints], g_sweep[kMaxPoints], g_out[kMaxPoints], g_out2[kMaxPoints];
+static double g_stamps[kMaxPoints], g_stamps2[kMaxPoints];
+static Point3 g_history[10][100000]; // timing: raw sweeps for the naive path
+static double g_historyPose[10][16];
+static size_t g_historySize[10];
+
+static TestRng g_rng{ 11u };
+
+// Scene points seen from `pose`, keeping those within `range` of the vehicle
+static size_t observe(const Pose &pose, size_t n, double range)
+{
+    double m[16];
+    transformToMatrix(inverseTransform(poseToTransform(pose)), m);
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Point3 p = rigidTransformPoint(m, g_scene[i]);
+        if (p.x * p.x + p.y * p.y + p.z * p.z <= range * range) g_sweep[k++] = p;
+    }
+    return k;
+}
+
+// Lattice 0.25 + 0.5 k: every point sits mid-voxel at 0.1 m, one point per voxel
+static size_t lattice(double x0, double x1, double y0, double y1, double z0, double z1)
+{
+    size_t n = 0;
+    for (double x = x0 + 0.25; x < x1; x += 0.5)
+        for (double y = y0 + 0.25; y < y1; y += 0.5)
+            for (double z = z0 + 0.25; z < z1; z += 0.5) g_scene[n++] = Point3{ x, y, z };
+    return n;
+}
+
+// Extracted points back in the world frame must be lattice points
+static bool onLattice(const Pose &pose, size_t n)
+{
+    double m[16];
+    transformToMatrix(poseToTransform(pose), m);
+    for (size_t i = 0; i < n; ++i) {
+        const Point3 p = rigidTransformPoint(m, g_out[i]);
+        const double ex = p.x - 0.25 - 0.5 * floor((p.x - 0.25) * 2.0 + 0.5);
+        const double ey = p.y - 0.25 - 0.5 * floor((p.y - 0.25) * 2.0 + 0.5);
+        const double ez = p.z - 0.25 - 0.5 * floor((p.z - 0.25) * 2.0 + 0.5);
+        if (fabs(ex) + fabs(ey) + fabs(ez) > 1e-9) return false;
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+    FrameArena arena;
+    arena.reserve(1 << 16);
+
+    // Static scene, vehicle driving and turning: 10 sweeps, 0.25 s window
+    const size_t ns = lattice(-10.0, 10.0, -10.0, 10.0, 0.0, 2.0);
+    AccumulationConfig cfg = defaultAccumulationConfig();
+    cfg.maxAge = 0.25;
+    cfg.maxDistance = 1000.0;
+    AccumulationMap map;
+    if (!map.init(cfg)) return fail("init", 0), 1;
+    Pose pose{};
+    for (int s = 0; s < 10; ++s) {
+        pose = Pose{ 0.5 * s, 0.1 * s, 0.0, 0.01 * s, -0.005 * s, 0.05 * s };
+        const size_t n = observe(pose, ns, 1e9);
+        if (map.insert(g_sweep, n, pose, 0.1 * s) != n) ok = fail("insert count", (double)s);
+    }
+    if (map.voxelCount() != ns || map.size() != 3 * ns) ok = fail("window size", (double)map.size());
+    size_t n = map.extract(pose, g_out, kMaxPoints, g_stamps, &arena, &pool);
+    if (n != 3 * ns) ok = fail("extract count", (double)n);
+    if (!onLattice(pose, n)) ok = fail("extracted points off the scene", 0);
+    for (size_t i = 0; i < n && ok; ++i) {
+        if (g_stamps[i] < 0.65 || g_stamps[i] > 0.95) ok = fail("stamp window", g_stamps[i]);
+    }
+    if (arena.used() != 0) ok = fail("scratch not rewound", (double)arena.used());
+
+    // Same output from a serial pool and heap scratch
+    const size_t n2 = map.extract(pose, g_out2, kMaxPoints, g_stamps2, nullptr, &serial);
+    if (n2 != n || memcmp(g_out, g_out2, n * sizeof(Point3)) != 0 || memcmp(g_stamps, g_stamps2, n * sizeof(double)) != 0) {
+        ok = fail("thread-count determinism", (double)n2);
+    }
+
+    // Truncated output
+    if (map.extract(pose, g_out2, 1000, nullptr, &arena, &pool) != 1000 || memcmp(g_out, g_out2, 1000 * sizeof(Point3)) != 0) {
+        ok = fail("capacity", 0);
+    }
+
+    // Long window: the ring keeps the newest pointsPerVoxel points of each voxel
+    cfg.maxAge = 100.0;
+    map.init(cfg);
+    for (int s = 0; s < 10; ++s) map.insert(g_scene, ns, identityTransform(), 0.1 * s);
+    n = map.extract(identityTransform(), g_out, kMaxPoints, g_stamps, &arena, &pool);
+    if (n != 4 * ns || map.size() != 4 * ns) ok = fail("ring size", (double)n);
+    for (size_t i = 0; i < n && ok; ++i) {
+        if (g_stamps[i] < 0.55) ok = fail("ring kept an old point", g_stamps[i]);
+    }
+    map.evict(0.95 + 100.0 - 0.2, Point3{ 0.0, 0.0, 0.0 }); // keeps stamps >= 0.75: 0.8, 0.9
+    if (map.size() != 2 * ns || map.voxelCount() != ns) ok = fail("partial age eviction", (double)map.size());
+    map.evict(200.0, Point3{ 0.0, 0.0, 0.0 });
+    if (map.size() != 0 || map.voxelCount() != 0) ok = fail("full age eviction", (double)map.size());
+
+    // Rolling along a corridor: voxels leave the radius and are removed from the hash
+    const size_t nc = lattice(-30.0, 80.0, -6.0, 6.0, 0.0, 2.0);
+    cfg.maxDistance = 20.0;
+    map.init(cfg);
+    for (int s = 0; s < 100; ++s) {
+        pose = Pose{ 0.5 * s, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        map.insert(g_sweep, observe(pose, nc, 25.0), pose, 0.01 * s);
+    }
+    size_t inside = 0;
+    for (size_t i = 0; i < nc; ++i) {
+        const double dx = g_scene[i].x - pose.x, dy = g_scene[i].y, dz = g_scene[i].z;
+        inside += dx * dx + dy * dy + dz * dz <= 400.0;
+    }
+    n = map.extract(pose, g_out, kMaxPoints, nullptr, &arena, &pool);
+    if (map.voxelCount() != inside || n != map.size()) ok = fail("rolling voxel count", (double)map.voxelCount());
+    if (!onLattice(pose, n)) ok = fail("rolling points off the scene", 0);
+    for (size_t i = 0; i < n && ok; ++i) {
+        if (g_out[i].x * g_out[i].x + g_out[i].y * g_out[i].y + g_out[i].z * g_out[i].z > 400.0) ok = fail("beyond radius", (double)i);
+    }
+
+    // Voxel cap: new voxels beyond maxVoxels are dropped, existing ones still fill
+    cfg.maxVoxels = 100;
+    cfg.maxDistance = 1000.0;
+    map.init(cfg);
+    if (map.insert(g_scene, 500, identityTransform(), 0.0) != 100 || map.dropped() != 400) ok = fail("voxel cap", (double)map.dropped());
+    if (map.insert(g_scene, 500, identityTransform(), 0.1) != 100 || map.voxelCount() != 100 || map.size() != 200) {
+        ok = fail("voxel cap refill", (double)map.size());
+    }
+
+    // Argument checks
+    AccumulationConfig bad = defaultAccumulationConfig();
+    bad.pointsPerVoxel = kAccumulationMaxPointsPerVoxel + 1;
+    AccumulationMap empty;
+    if (empty.init(bad) || empty.insert(g_scene, 10, identityTransform(), 0.0) != 0 ||
+        empty.extract(identityTransform(), g_out, kMaxPoints) != 0) {
+        ok = fail("argument checks", 0);
+    }
+
+    // Timing: 100k-point sweeps at 10 Hz of a static scene, 1 s window.
+    // Accumulated: insert + extract per frame; naive: keep the last 10 sweeps and
+    // re-transform each into the current vehicle frame.
+    const size_t sweep = 100000, history = 10;
+    for (size_t i = 0; i < sweep; ++i) {
+        const double a = 6.283185307179586 * g_rng.uniform(), r = 5.0 + 55.0 * g_rng.uniform();
+        g_scene[i] = Point3{ r * cos(a), r * sin(a), 3.0 * g_rng.uniform() - 1.0 };
+    }
+    map.init(defaultAccumulationConfig());
+    const int frames = 30;
+    double insertMs = 0.0, extractMs = 0.0, naiveMs = 0.0;
+    size_t extracted = 0, naive = 0;
+    for (int f = 0; f < frames; ++f) {
+        pose = Pose{ 1.0 * f, 0.02 * f, 0.0, 0.0, 0.0, 0.01 * f };
+        const size_t k = observe(pose, sweep, 80.0);
+        for (size_t i = 0; i < k; ++i) g_sweep[i].z += 0.02 * (g_rng.uniform() - 0.5);
+        const size_t slot = (size_t)f % history;
+        memcpy(g_history[slot], g_sweep, k * sizeof(Point3));
+        poseToMatrix(pose, g_historyPose[slot]);
+        g_historySize[slot] = k;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        map.insert(g_sweep, k, pose, 0.1 * f);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        extracted = map.extract(pose, g_out, kMaxPoints, nullptr, &arena, &pool);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        double worldToVehicle[16], m[16];
+        transformToMatrix(inverseTransform(poseToTransform(pose)), worldToVehicle);
+        naive = 0;
+        for (size_t h = 0; h < history && h <= (size_t)f; ++h) {
+            rigidCompose(worldToVehicle, g_historyPose[h], m);
+            rigidTransformPoints(m, g_history[h], g_out2 + naive, g_historySize[h]);
+            naive += g_historySize[h];
+        }
+        auto t3 = std::chrono::high_resolution_clock::now();
+        insertMs += std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count();
+        extractMs += std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t2 - t1).count();
+        naiveMs += std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t3 - t2).count();
+    }
+    std::cout << "accumulate " << sweep << "-point sweeps, " << history << " in window: insert " << insertMs / frames
+              << " ms, extract " << extractMs / frames << " ms (" << extracted << " points), re-transform history "
+              << naiveMs / frames << " ms (" << naive << " points, " << pool.concurrency() << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "accumulation tests passed\n";
+    return 0;
+}
@@ -0,0 +1,58 @@
+/* *******************************************************************************
+ * File: tests/test_arena.cpp
+ * Description: Test the per-frame arena: alignment, exhaustion, O(1) reset,
+ *              nested scopes, size overflow and the thread-default scratch
+ *              arena.
+ * *******************************************************************************/
+
+#include <iostream>
+#include "arena.hpp"
+#include "helpers.hpp"
+
+using namespace AdasTools;
+
+int main()
+{
+    static unsigned char storage[4096];
+    FrameArena a(storage, sizeof(storage));
+
+    char *c = a.allocArray<char>(3);
+    double *d = a.allocArray<double>(10, 64);
+    if (!c || !d || ((size_t)d % 64) != 0) { std::cerr << "aligned allocation failed\n"; return 1; }
+    size_t used = a.used();
+
+    {
+        ArenaScope scope(a);
+        if (!a.allocArray<Point3>(50)) { std::cerr << "scoped allocation failed\n"; return 2; }
+    }
+    if (a.used() != used) { std::cerr << "scope did not rewind\n"; return 3; }
+
+    if (a.allocate(8192) != nullptr || a.failedAllocations() != 1) { std::cerr << "exhaustion not reported\n"; return 4; }
+
+    // Sizes that wrap size_t fail cleanly instead of returning a bogus pointer
+    size_t before = a.used();
+    if (a.allocArray<Point3>((size_t)-1 / sizeof(Point3) + 2) != nullptr || a.allocate((size_t)-1 - 8, 64) != nullptr ||
+        a.allocate((size_t)-1) != nullptr || a.used() != before || a.failedAllocations() != 4) {
+        std::cerr << "overflow not rejected\n"; return 10;
+    }
+
+    a.reset();
+    if (a.used() != 0 || a.highWater() < used) { std::cerr << "reset/highWater wrong\n"; return 5; }
+
+    // Owned block, optionally huge-page backed (falls back silently)
+    FrameArena owned;
+    if (!owned.reserve(1 << 20, ARENA_BACKING_HUGE_PAGES) || owned.capacity() < (1u << 20)) {
+        std::cerr << "reserve failed\n"; return 6;
+    }
+    Point3 *pts = owned.allocArray<Point3>(10000);
+    if (!pts) { std::cerr << "owned allocation failed\n"; return 7; }
+    pts[9999] = Point3{ 1.0, 2.0, 3.0 };
+
+    if (threadScratchArena() != nullptr) { std::cerr << "default scratch arena not null\n"; return 8; }
+    setThreadScratchArena(&owned);
+    if (threadScratchArena() != &owned) { std::cerr << "scratch arena not installed\n"; return 9; }
+    setThreadScratchArena(nullptr);
+
+    std::cout << "arena test OK (huge pages: " << (owned.hugePages() ? "yes" : "no") << ")\n";
+    return 0;
+}
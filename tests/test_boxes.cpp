@@ -0,0 +1,169 @@
+/* *******************************************************************************
+ * File: tests/test_boxes.cpp
+ * Description: Test oriented box operations: corners and frame changes against
+ *              per-corner localToGlobal, image rectangles against per-corner
+ *              projectPointCamera, near-plane clipping against densely sampled
+ *              edges, and the behind/outside classifications. Also prints a
+ *              small throughput comparison.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "boxes.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 2000;
+static OrientedBox g_boxes[N], g_moved[N];
+static ImageRect g_rects[N];
+
+static const double K[9] = { 800.0, 0.0, 640.0, 0.0, 800.0, 360.0, 0.0, 0.0, 1.0 };
+static const int W = 1280, H = 720;
+static const double kNear = 0.5;
+
+static double dist(const Point3 &a, const Point3 &b)
+{
+    return fabs(a.x - b.x) + fabs(a.y - b.y) + fabs(a.z - b.z);
+}
+
+// Camera looking along vehicle +x (x right = -y, y down = -z, z forward = x), 1.5 m up.
+static void cameraExtrinsic(double E[16])
+{
+    const double e[16] = { 0, -1, 0, 0,
+                           0, 0, -1, 1.5,
+                           1, 0, 0, 0,
+                           0, 0, 0, 1 };
+    for (int i = 0; i < 16; ++i) E[i] = e[i];
+}
+
+int main()
+{
+    bool ok = true;
+    for (int i = 0; i < N; ++i) {
+        g_boxes[i].center = Pose{ 5.0 + 0.03 * i, 8.0 * sin(0.37 * i), 0.2 * cos(0.11 * i), 0.05 * sin(i), 0.04 * cos(i), 0.7 * i };
+        g_boxes[i].size = Point3{ 4.0 + (i % 3), 1.8, 1.5 };
+    }
+
+    // Corners vs. localToGlobal of the signed half sizes
+    Point3 corners[8];
+    double worst = 0.0;
+    for (int i = 0; i < N; i += 37) {
+        const OrientedBox &b = g_boxes[i];
+        boxCorners(b, corners);
+        Frame3D f{ b.center.x, b.center.y, b.center.z, b.center.roll, b.center.pitch, b.center.yaw };
+        for (int c = 0; c < 8; ++c) {
+            Point3 local{ (c & 1 ? 0.5 : -0.5) * b.size.x, (c & 2 ? 0.5 : -0.5) * b.size.y, (c & 4 ? 0.5 : -0.5) * b.size.z };
+            double d = dist(corners[c], localToGlobal(local, f));
+            if (d > worst) worst = d;
+        }
+    }
+    if (worst > 1e-12) ok = fail("boxCorners", worst);
+
+    // Box frame change == corner-wise frame change
+    Frame3D vehicle{ 100.0, -20.0, 1.0, 0.01, -0.02, 2.0 };
+    boxesLocalToGlobal(g_boxes, g_moved, N, vehicle);
+    worst = 0.0;
+    for (int i = 0; i < N; i += 13) {
+        boxCorners(g_boxes[i], corners);
+        Point3 moved[8];
+        boxCorners(g_moved[i], moved);
+        for (int c = 0; c < 8; ++c) {
+            double d = dist(moved[c], localToGlobal(corners[c], vehicle));
+            if (d > worst) worst = d;
+        }
+    }
+    if (worst > 1e-9) ok = fail("boxesLocalToGlobal", worst);
+
+    // Rectangles of boxes fully in front == bbox of the 8 projected corners
+    double E[16];
+    cameraExtrinsic(E);
+    size_t visible = projectBoxesToImage(g_boxes, N, E, K, W, H, kNear, g_rects);
+    worst = 0.0;
+    size_t inFront = 0;
+    for (int i = 0; i < N; ++i) {
+        if (g_rects[i].visibility != BOX_IN_FRONT) continue;
+        ++inFront;
+        boxCorners(g_boxes[i], corners);
+        double uMin = 1e300, uMax = -1e300, vMin = 1e300, vMax = -1e300;
+        for (int c = 0; c < 8; ++c) {
+            Point3 uvz = projectPointCamera(corners[c], E, K);
+            if (uvz.x < uMin) uMin = uvz.x;
+            if (uvz.x > uMax) uMax = uvz.x;
+            if (uvz.y < vMin) vMin = uvz.y;
+            if (uvz.y > vMax) vMax = uvz.y;
+        }
+        uMin = uMin < 0 ? 0 : uMin; vMin = vMin < 0 ? 0 : vMin;
+        uMax = uMax > W ? W : uMax; vMax = vMax > H ? H : vMax;
+        double d = fabs(uMin - g_rects[i].uMin) + fabs(uMax - g_rects[i].uMax) + fabs(vMin - g_rects[i].vMin) + fabs(vMax - g_rects[i].vMax);
+        if (d > worst) worst = d;
+    }
+    if (inFront < 100 || visible < inFront) ok = fail("too few visible boxes", (double)inFront);
+    if (worst > 1e-6) ok = fail("rect vs projected corners", worst);
+
+    // A box straddling the near plane: rect == bbox of densely sampled edge points in front
+    OrientedBox straddle{ Pose{ 1.0, 0.5, 0.0, 0.0, 0.0, 0.3 }, Point3{ 4.0, 2.0, 1.6 } };
+    ImageRect rect;
+    projectBoxesToImage(&straddle, 1, E, K, W, H, kNear, &rect);
+    if (rect.visibility != BOX_CLIPPED || rect.minDepth != kNear) ok = fail("straddling box not clipped", (double)rect.visibility);
+    boxCorners(straddle, corners);
+    const unsigned char edges[12][2] = { { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, { 0, 2 }, { 1, 3 },
+                                         { 4, 6 }, { 5, 7 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+    double uMin = 1e300, uMax = -1e300, vMin = 1e300, vMax = -1e300;
+    for (int e = 0; e < 12; ++e) {
+        for (int k = 0; k <= 20000; ++k) {
+            double t = k / 20000.0;
+            const Point3 &a = corners[edges[e][0]], &b = corners[edges[e][1]];
+            Point3 p{ a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), a.z + t * (b.z - a.z) };
+            Point3 uvz = projectPointCamera(p, E, K);
+            if (uvz.z < kNear) continue;
+            if (uvz.x < uMin) uMin = uvz.x;
+            if (uvz.x > uMax) uMax = uvz.x;
+            if (uvz.y < vMin) vMin = uvz.y;
+            if (uvz.y > vMax) vMax = uvz.y;
+        }
+    }
+    uMin = uMin < 0 ? 0 : uMin; vMin = vMin < 0 ? 0 : vMin;
+    uMax = uMax > W ? W : uMax; vMax = vMax > H ? H : vMax;
+    double d = fabs(uMin - rect.uMin) + fabs(uMax - rect.uMax) + fabs(vMin - rect.vMin) + fabs(vMax - rect.vMax);
+    if (d > 1.0) ok = fail("clipped rect vs sampled edges", d);
+
+    // Behind the camera and outside the image
+    OrientedBox behind{ Pose{ -10.0, 0.0, 0.0, 0.0, 0.0, 0.0 }, Point3{ 4.0, 2.0, 1.5 } };
+    OrientedBox offImage{ Pose{ 5.0, 40.0, 0.0, 0.0, 0.0, 0.0 }, Point3{ 4.0, 2.0, 1.5 } };
+    projectBoxesToImage(&behind, 1, E, K, W, H, kNear, &rect);
+    if (rect.visibility != BOX_BEHIND) ok = fail("behind", (double)rect.visibility);
+    projectBoxesToImage(&offImage, 1, E, K, W, H, kNear, &rect);
+    if (rect.visibility != BOX_OUTSIDE_IMAGE) ok = fail("outside image", (double)rect.visibility);
+
+    // Throughput: 8 x (localToGlobal + projectPointCamera) vs. batch
+    const int rounds = 20;
+    double sink = 0.0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int i = 0; i < N; ++i) {
+            const OrientedBox &b = g_boxes[i];
+            Frame3D f{ b.center.x, b.center.y, b.center.z, b.center.roll, b.center.pitch, b.center.yaw };
+            for (int c = 0; c < 8; ++c) {
+                Point3 local{ (c & 1 ? 0.5 : -0.5) * b.size.x, (c & 2 ? 0.5 : -0.5) * b.size.y, (c & 4 ? 0.5 : -0.5) * b.size.z };
+                sink += projectPointCamera(localToGlobal(local, f), E, K).x;
+            }
+        }
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        g_boxes[r].center.x += 1e-6;
+        sink += (double)projectBoxesToImage(g_boxes, N, E, K, W, H, kNear, g_rects) + g_rects[r].uMin;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double cornerNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count() / (rounds * N);
+    double batchNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t2 - t1).count() / (rounds * N);
+    std::cout << "ns/box: per-corner transform+project " << cornerNs << ", projectBoxesToImage " << batchNs << "\n";
+    if (sink == 12345.0) std::cout << "";
+
+    if (!ok) return 1;
+    std::cout << "box tests passed\n";
+    return 0;
+}
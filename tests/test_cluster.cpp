@@ -0,0 +1,195 @@
+/* *******************************************************************************
+ * File: tests/test_cluster.cpp
+ * Description: Test Euclidean clustering against a brute-force O(n^2)
+ *              union-find (same partition), clusters that cross tile seams,
+ *              min/max size filtering, yaw-fitted boxes, the subset entry
+ *              point, failure status and identical output for any thread
+ *              count. Also prints the time for a ~100k-point obstacle cloud.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "cluster.hpp"
+#include "arena.hpp"
+#include "parallel.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 100000;
+static Point3 g_pts[N];
+static unsigned int g_labels[N], g_labels2[N], g_members[N], g_idx[N];
+static PointCluster g_clusters[4096], g_clusters2[4096];
+
+static TestRng g_rng{ 5u };
+
+static unsigned refFind(unsigned *parent, unsigned c)
+{
+    while (parent[c] != c) c = parent[c] = parent[parent[c]];
+    return c;
+}
+
+// Brute-force partition check: same-cluster <=> same reference component.
+static bool testAgainstBruteForce(TaskPool &pool)
+{
+    const int M = 3000;
+    static Point3 pts[M];
+    static unsigned parent[M], labels[M], firstOfRoot[M], firstOfLabel[M];
+    for (int i = 0; i < M; ++i) pts[i] = Point3{ 30.0 * g_rng.uniform(), 12.0 * g_rng.uniform(), 2.0 * g_rng.uniform() };
+    const double tol = 0.45;
+    for (int i = 0; i < M; ++i) parent[i] = (unsigned)i;
+    for (int i = 0; i < M; ++i) {
+        for (int j = i + 1; j < M; ++j) {
+            const double dx = pts[i].x - pts[j].x, dy = pts[i].y - pts[j].y, dz = pts[i].z - pts[j].z;
+            if (dx * dx + dy * dy + dz * dz <= tol * tol) {
+                unsigned a = refFind(parent, (unsigned)i), b = refFind(parent, (unsigned)j);
+                if (a != b) parent[a > b ? a : b] = a < b ? a : b;
+            }
+        }
+    }
+    ClusterConfig cfg = defaultClusterConfig();
+    cfg.tolerance = tol;
+    cfg.minPoints = 1;
+    cfg.tileSize = 2.0; // many seams
+    size_t count = clusterPoints(pts, M, cfg, labels, g_clusters, 4096, g_members, nullptr, &pool);
+    size_t refCount = 0;
+    for (int i = 0; i < M; ++i) refCount += refFind(parent, (unsigned)i) == (unsigned)i;
+    if (count != refCount) return fail("brute-force cluster count", (double)count - (double)refCount);
+    for (int i = 0; i < M; ++i) firstOfRoot[i] = firstOfLabel[i] = 0xFFFFFFFFu;
+    for (int i = 0; i < M; ++i) {
+        const unsigned r = refFind(parent, (unsigned)i), l = labels[i];
+        if (l >= count) return fail("noise with minPoints 1", i);
+        if (firstOfRoot[r] == 0xFFFFFFFFu) firstOfRoot[r] = (unsigned)i;
+        if (firstOfLabel[l] == 0xFFFFFFFFu) firstOfLabel[l] = (unsigned)i;
+        if (firstOfRoot[r] != firstOfLabel[l]) return fail("brute-force partition", i);
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+    FrameArena arena;
+    arena.reserve(32 << 20);
+    ok = testAgainstBruteForce(pool) && ok;
+
+    // Scene: 200 yawed 4.5 x 1.8 x 1.5 "cars" on a 15 m grid, a 60 m wall of
+    // points 0.3 m apart (crosses many tiles), plus isolated single points.
+    int n = 0;
+    const int cars = 200;
+    for (int c = 0; c < cars; ++c) {
+        const double cx = -100.0 + 15.0 * (c % 14), cy = -100.0 + 15.0 * (c / 14), yaw = 0.1 * (c % 13) - 0.6;
+        const double co = cos(yaw), si = sin(yaw);
+        for (int k = 0; k < 450; ++k) {
+            const double u = 4.5 * (g_rng.uniform() - 0.5), v = 1.8 * (g_rng.uniform() - 0.5), z = 1.5 * g_rng.uniform();
+            g_pts[n++] = Point3{ cx + co * u - si * v, cy + si * u + co * v, z };
+        }
+    }
+    const int wallStart = n;
+    for (int k = 0; k < 200; ++k) g_pts[n++] = Point3{ -110.0 + 0.3 * k, 120.0, 1.0 };
+    const int noiseStart = n;
+    for (int k = 0; k < 50; ++k) g_pts[n++] = Point3{ -100.0 + 15.0 * (k % 14) + 7.5, -100.0 + 15.0 * (k / 14) + 7.5, 5.0 };
+
+    ClusterConfig cfg = defaultClusterConfig();
+    cfg.tolerance = 0.5;
+    cfg.minPoints = 5;
+    size_t count = clusterPoints(g_pts, (size_t)n, cfg, g_labels, g_clusters, 4096, g_members, &arena, &pool);
+    if (arena.used() != 0) ok = fail("scratch not rewound", (double)arena.used());
+    if (count != (size_t)cars + 1) ok = fail("scene cluster count", (double)count);
+    for (int k = noiseStart; k < n; ++k) {
+        if (g_labels[k] != kClusterNoise) { ok = fail("isolated point not noise", k); break; }
+    }
+    if (g_labels[wallStart] == kClusterNoise || g_labels[wallStart] != g_labels[noiseStart - 1]) ok = fail("wall split at a seam", 0);
+    else if (g_clusters[g_labels[wallStart]].memberCount != 200) ok = fail("wall size", g_clusters[g_labels[wallStart]].memberCount);
+
+    // Car boxes: yaw recovered modulo pi, size close to the generated extents
+    for (int c = 0; c < cars && ok; ++c) {
+        const unsigned id = g_labels[c * 450];
+        const PointCluster &cl = g_clusters[id];
+        const double yaw = 0.1 * (c % 13) - 0.6;
+        double dyaw = fmod(fabs(cl.box.center.yaw - yaw), 3.14159265358979323846);
+        if (dyaw > 1.5) dyaw = 3.14159265358979323846 - dyaw;
+        // (PCA yaw of 450 samples is good to a few hundredths of a radian; a
+        // stray corner sample can be farther than the tolerance from the rest)
+        if (cl.memberCount < 445 || dyaw > 0.08 || cl.box.size.x < 4.3 || cl.box.size.x > 4.8 || cl.box.size.y < 1.6 ||
+            cl.box.size.y > 2.3 || cl.box.size.z > 1.5 || cl.box.center.roll != 0.0 || cl.box.center.pitch != 0.0) {
+            ok = fail("car box", (double)c);
+        }
+        // every member inside the box
+        const double co = cos(cl.box.center.yaw), si = sin(cl.box.center.yaw);
+        for (unsigned i = 0; i < cl.memberCount; ++i) {
+            const Point3 &p = g_pts[g_members[cl.firstMember + i]];
+            const double x = p.x - cl.box.center.x, y = p.y - cl.box.center.y;
+            const double u = co * x + si * y, v = -si * x + co * y;
+            if (fabs(u) > 0.5 * cl.box.size.x + 1e-9 || fabs(v) > 0.5 * cl.box.size.y + 1e-9) { ok = fail("member outside box", i); break; }
+            if (g_labels[g_members[cl.firstMember + i]] != id) { ok = fail("member label", i); break; }
+        }
+    }
+
+    // Thread count does not change anything
+    size_t count2 = clusterPoints(g_pts, (size_t)n, cfg, g_labels2, g_clusters2, 4096, nullptr, nullptr, &serial);
+    if (count2 != count) ok = fail("serial count", (double)count2);
+    for (int i = 0; i < n; ++i) {
+        if (g_labels[i] != g_labels2[i]) { ok = fail("serial labels", i); break; }
+    }
+    for (size_t c = 0; c < count && c < count2; ++c) {
+        if (g_clusters[c].box.center.x != g_clusters2[c].box.center.x || g_clusters[c].firstMember != g_clusters2[c].firstMember) {
+            ok = fail("serial boxes", (double)c);
+            break;
+        }
+    }
+
+    // maxPoints and maxClusters
+    cfg.maxPoints = 300;
+    if (clusterPoints(g_pts, (size_t)n, cfg, g_labels2, g_clusters2, 4096, nullptr, &arena, &pool) != 1 || g_labels2[wallStart] != 0) {
+        ok = fail("maxPoints", 0);
+    }
+    cfg.maxPoints = 0xFFFFFFFFu;
+    if (clusterPoints(g_pts, (size_t)n, cfg, g_labels2, g_clusters2, 10, nullptr, &arena, &pool) != 10 || g_labels2[199 * 450] != kClusterNoise) {
+        ok = fail("maxClusters", 0);
+    }
+
+    // Subset: every other car only
+    size_t m = 0;
+    for (int c = 0; c < cars; c += 2) {
+        for (int k = 0; k < 450; ++k) g_idx[m++] = (unsigned)(c * 450 + k);
+    }
+    bool status = false;
+    size_t subset = clusterPointSubset(g_pts, g_idx, m, cfg, g_labels2, g_clusters2, 4096, g_members, &arena, &pool, &status);
+    if (subset != (size_t)cars / 2 || !status) ok = fail("subset count", (double)subset);
+    const unsigned sub = g_labels2[450]; // first point of car 2
+    if (sub >= subset || g_members[g_clusters2[sub].firstMember] / 450 != 2 ||
+        g_clusters2[sub].box.center.x != g_clusters[g_labels[900]].box.center.x) {
+        ok = fail("subset mapping", sub);
+    }
+
+    // An exhausted arena is reported, not mistaken for "no clusters"
+    static unsigned char tiny[4096];
+    FrameArena small(tiny, sizeof(tiny));
+    if (clusterPointSubset(g_pts, g_idx, m, cfg, g_labels2, g_clusters2, 4096, nullptr, &small, &pool, &status) != 0 || status) {
+        ok = fail("exhausted arena status", 0);
+    }
+    if (clusterPointSubset(g_pts, g_idx, 0, cfg, g_labels2, g_clusters2, 4096, nullptr, &small, &pool, &status) != 0 || !status) {
+        ok = fail("empty subset status", 0);
+    }
+
+    // Timing: ~100k points as 220 denser objects
+    n = 0;
+    for (int c = 0; c < 220 && n + 450 <= N; ++c) {
+        const double cx = -100.0 + 12.0 * (c % 16), cy = -80.0 + 12.0 * (c / 16);
+        for (int k = 0; k < 450; ++k) g_pts[n++] = Point3{ cx + 4.0 * g_rng.uniform(), cy + 2.0 * g_rng.uniform(), 1.8 * g_rng.uniform() };
+    }
+    const int rounds = 10;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) count = clusterPoints(g_pts, (size_t)n, cfg, g_labels, g_clusters, 4096, g_members, &arena, &pool);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count() / rounds;
+    std::cout << "clusterPoints " << n << " points -> " << count << " clusters: " << ms << " ms (" << pool.concurrency()
+              << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "cluster tests passed\n";
+    return 0;
+}
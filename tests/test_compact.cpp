@@ -0,0 +1,165 @@
+/* *******************************************************************************
+ * File: tests/test_compact.cpp
+ * Description: Test compact point storage: half-float conversions (exact
+ *              values, rounding, subnormals, inf), int16 and fp16 round-trip
+ *              error, clamping, odd lengths (SIMD tails), the fused transform
+ *              and multi-camera projection against the decoded cloud. Also
+ *              prints transform timings for 24-byte vs 6-byte points.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "compact.hpp"
+#include "multicam.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 1 << 20;
+static Point3 g_pts[N], g_dec[N], g_out[N], g_ref[N];
+static PointI16 g_i16[N];
+static PointF16 g_f16[N];
+
+static TestRng g_rng{ 9u };
+
+static bool testHalf()
+{
+    bool ok = true;
+    const struct { unsigned short h; float f; } exact[] = {
+        { 0x0000, 0.0f }, { 0x3C00, 1.0f }, { 0xC000, -2.0f }, { 0x7BFF, 65504.0f },
+        { 0x0001, 5.9604644775390625e-8f }, { 0x0400, 6.103515625e-5f }, { 0x3555, 0.333251953125f },
+    };
+    for (const auto &e : exact) {
+        if (halfToFloat(e.h) != e.f) ok = fail("halfToFloat", e.h);
+        if (floatToHalf(e.f) != e.h) ok = fail("floatToHalf", e.h);
+    }
+    if (floatToHalf(-0.0f) != 0x8000 || floatToHalf(1e6f) != 0x7C00 || floatToHalf(-1e6f) != 0xFC00) ok = fail("signs / overflow", 0);
+    if (floatToHalf(65519.0f) != 0x7BFF || floatToHalf(65520.0f) != 0x7C00) ok = fail("overflow rounding", 0);
+    if (floatToHalf(1.0f + 1.0f / 2048.0f) != 0x3C00 || floatToHalf(1.0f + 3.0f / 2048.0f) != 0x3C02) ok = fail("ties to even", 0);
+    if (floatToHalf(2.9802322387695312e-8f) != 0x0000 || floatToHalf(4.5e-8f) != 0x0001) ok = fail("subnormal rounding", 0);
+    if (!isinf(halfToFloat(0x7C00)) || !isnan(halfToFloat(0x7E00))) ok = fail("inf / nan", 0);
+    // every finite half survives the round trip
+    for (unsigned h = 0; h < 0x10000u && ok; ++h) {
+        if ((h & 0x7C00u) == 0x7C00u) continue;
+        if (floatToHalf(halfToFloat((unsigned short)h)) != h) ok = fail("half round trip", h);
+    }
+    return ok;
+}
+
+int main()
+{
+    bool ok = testHalf();
+    for (int i = 0; i < N; ++i) {
+        const double r = 2.0 + 78.0 * g_rng.uniform(), a = 6.283185307179586 * g_rng.uniform();
+        g_pts[i] = Point3{ r * cos(a), r * sin(a), -1.8 + 4.0 * g_rng.uniform() };
+    }
+
+    // int16 at 1 cm: error <= half a step; odd count exercises the scalar tail
+    const int M = 100003;
+    const PointQuantization q16 = quantizationForResolution(Point3{ 0.0, 0.0, 0.0 }, 0.01);
+    if (encodePointsI16(g_pts, M, q16, g_i16) != 0) ok = fail("unexpected clamp", 0);
+    decodePointsI16(g_i16, M, q16, g_dec);
+    for (int i = 0; i < M; ++i) {
+        const double e = fabs(g_dec[i].x - g_pts[i].x) + fabs(g_dec[i].y - g_pts[i].y) + fabs(g_dec[i].z - g_pts[i].z);
+        if (e > 0.015 + 1e-9 || fabs(g_dec[i].x - g_pts[i].x) > 0.005 + 1e-9) { ok = fail("int16 error", e); break; }
+    }
+    Point3 far[2] = { { 400.0, 0.0, 0.0 }, { 1.0, 2.0, 3.0 } };
+    PointI16 farQ[2];
+    if (encodePointsI16(far, 2, q16, farQ) != 1 || farQ[0].x != 32767 || farQ[1].z != 300) ok = fail("int16 clamp", farQ[0].x);
+
+    // Bounds quantization: finer steps for a small box
+    const PointQuantization qb = quantizationForBounds(Point3{ -80.0, -80.0, -2.0 }, Point3{ 80.0, 80.0, 2.5 });
+    encodePointsI16(g_pts, M, qb, g_i16);
+    decodePointsI16(g_i16, M, qb, g_dec);
+    for (int i = 0; i < M; ++i) {
+        if (fabs(g_dec[i].z - g_pts[i].z) > 0.5 * qb.scale.z + 1e-12 || fabs(g_dec[i].x - g_pts[i].x) > 0.5 * qb.scale.x + 1e-12) {
+            ok = fail("bounds quantization", i);
+            break;
+        }
+    }
+
+    // fp16 relative to the sensor: relative error <= 2^-11
+    const PointQuantization qh = quantizationForResolution(Point3{ 0.0, 0.0, 0.0 }, 1.0);
+    encodePointsF16(g_pts, M, qh, g_f16);
+    decodePointsF16(g_f16, M, qh, g_dec);
+    for (int i = 0; i < M; ++i) {
+        const double e = fabs(g_dec[i].x - g_pts[i].x);
+        if (e > fabs(g_pts[i].x) * (1.0 / 2048.0) + 1e-7) { ok = fail("fp16 error", e); break; }
+        if (g_f16[i].y != floatToHalf((float)g_pts[i].y)) { ok = fail("fp16 SIMD vs scalar encode", i); break; }
+    }
+
+    // Fused transform == transform of the decoded cloud
+    double T[16];
+    poseToMatrix(Pose{ 12.0, -3.0, 0.5, 0.01, -0.02, 0.7 }, T);
+    encodePointsI16(g_pts, M, q16, g_i16);
+    decodePointsI16(g_i16, M, q16, g_dec);
+    rigidTransformPoints(T, g_dec, g_ref, M);
+    rigidTransformPointsI16(T, g_i16, M, q16, g_out);
+    for (int i = 0; i < M; ++i) {
+        if (fabs(g_out[i].x - g_ref[i].x) + fabs(g_out[i].y - g_ref[i].y) + fabs(g_out[i].z - g_ref[i].z) > 1e-9) {
+            ok = fail("fused int16 transform", i);
+            break;
+        }
+    }
+    decodePointsF16(g_f16, M, qh, g_dec);
+    rigidTransformPoints(T, g_dec, g_ref, M);
+    rigidTransformPointsF16(T, g_f16, M, qh, g_out);
+    for (int i = 0; i < M; ++i) {
+        if (fabs(g_out[i].x - g_ref[i].x) + fabs(g_out[i].y - g_ref[i].y) + fabs(g_out[i].z - g_ref[i].z) > 1e-9) {
+            ok = fail("fused fp16 transform", i);
+            break;
+        }
+    }
+
+    // Projection from compact clouds == projection of the decoded cloud
+    CameraModel cam;
+    double E[16];
+    poseToMatrix(Pose{ 0.0, 0.0, 0.0, -1.5707963267948966, 0.0, -1.5707963267948966 }, E);
+    for (int i = 0; i < 16; ++i) cam.extrinsic[i] = E[i];
+    const double K[9] = { 1000.0, 0.0, 960.0, 0.0, 1000.0, 540.0, 0.0, 0.0, 1.0 };
+    for (int i = 0; i < 9; ++i) cam.intrinsic[i] = K[i];
+    cam.width = 1920; cam.height = 1080; cam.minDepth = 0.5;
+    MultiCameraProjector projector;
+    projector.setCameras(&cam, 1);
+    static CameraHit hitsA[N], hitsB[N];
+    CameraHitList a{ hitsA, (size_t)N, 0, 0 }, b{ hitsB, (size_t)N, 0, 0 };
+    decodePointsI16(g_i16, M, q16, g_dec);
+    const size_t ha = projector.project(g_dec, M, &a), hb = projector.project(g_i16, M, q16, &b);
+    if (ha != hb || ha < (size_t)M / 8) ok = fail("int16 projection count", (double)hb - (double)ha);
+    for (size_t i = 0; i < ha && i < hb; ++i) {
+        if (hitsA[i].index != hitsB[i].index || hitsA[i].u != hitsB[i].u || hitsA[i].depth != hitsB[i].depth) {
+            ok = fail("int16 projection hit", (double)i);
+            break;
+        }
+    }
+    decodePointsF16(g_f16, M, qh, g_dec);
+    if (projector.project(g_dec, M, &a) != projector.project(g_f16, M, qh, &b) || hitsA[a.count - 1].index != hitsB[b.count - 1].index) {
+        ok = fail("fp16 projection", 0);
+    }
+
+    // Timing: 1M points, 24-byte vs 6-byte storage
+    encodePointsI16(g_pts, N, q16, g_i16);
+    encodePointsF16(g_pts, N, qh, g_f16);
+    const int rounds = 10;
+    auto ms = [](std::chrono::high_resolution_clock::time_point t0, std::chrono::high_resolution_clock::time_point t1) {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count() / rounds;
+    };
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) rigidTransformPoints(T, g_pts, g_out, N);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) rigidTransformPointsI16(T, g_i16, N, q16, g_out);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) rigidTransformPointsF16(T, g_f16, N, qh, g_out);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) decodePointsI16(g_i16, N, q16, g_out);
+    auto t4 = std::chrono::high_resolution_clock::now();
+    std::cout << "transform " << N << " points: Point3 (24 B) " << ms(t0, t1) << " ms, int16 (6 B) " << ms(t1, t2)
+              << " ms, fp16 (6 B) " << ms(t2, t3) << " ms; int16 decode " << ms(t3, t4) << " ms\n";
+
+    if (!ok) return 1;
+    std::cout << "compact tests passed\n";
+    return 0;
+}
@@ -0,0 +1,134 @@
+/* *******************************************************************************
+ * File: tests/test_depth.cpp
+ * Description: Test depth-image unprojection: every point projects back to
+ *              its pixel and depth through projectPointCamera(), invalid
+ *              depths are dropped, strides and odd sizes, 16-bit depth with a
+ *              scale, ray-distance encoding, identical output for any thread
+ *              count. Also prints the time for a 2 MP depth map.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include "depth.hpp"
+#include "arena.hpp"
+#include "multicam.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int W = 1920, H = 1080;
+static float g_depth[W * H];
+static unsigned short g_mm[W * H];
+static Point3 g_pts[W * H], g_pts2[W * H];
+static unsigned int g_pix[W * H], g_pix2[W * H];
+
+static TestRng g_rng{ 5u };
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+    FrameArena arena;
+    arena.reserve(1 << 16);
+
+    // Front camera 1.6 m up, slightly rotated, skewed K; target = vehicle frame
+    CameraModel cam;
+    poseToMatrix(Pose{ 0.1, 1.6, -1.5, -1.5707963267948966 + 0.02, 0.01, -1.5707963267948966 - 0.03 }, cam.extrinsic);
+    const double K[9] = { 1000.0, 0.8, 955.0, 0.0, 1010.0, 545.0, 0.0, 0.0, 1.0 };
+    memcpy(cam.intrinsic, K, sizeof(K));
+    cam.width = W;
+    cam.height = H;
+    cam.minDepth = 0.3;
+    size_t invalid = 0;
+    for (int i = 0; i < W * H; ++i) {
+        g_depth[i] = (float)(2.0 + 60.0 * g_rng.uniform());
+        if (i % 97 == 0) { g_depth[i] = (i % 2) ? nanf("") : 0.0f; ++invalid; }
+        else if (i % 101 == 0) { g_depth[i] = 500.0f; ++invalid; } // beyond maxDepth
+        g_mm[i] = (unsigned short)lrint(g_depth[i] == g_depth[i] && g_depth[i] < 65.0f ? g_depth[i] * 1000.0f : 0.0f);
+    }
+
+    // Round trip through projectPointCamera
+    DepthUnprojector un;
+    if (!un.build(cam, 1) || un.maxPoints() != (size_t)W * H) return fail("build", 0), 1;
+    const size_t n = un.unproject(g_depth, W, g_pts, g_pix, 100.0, &arena, &pool);
+    if (n != (size_t)W * H - invalid) ok = fail("valid count", (double)n);
+    for (size_t k = 0; k < n && ok; k += 7) {
+        const Point3 uvd = projectPointCamera(g_pts[k], cam.extrinsic, cam.intrinsic);
+        const unsigned u = g_pix[k] % W, v = g_pix[k] / W;
+        if (fabs(uvd.x - u) > 1e-3 || fabs(uvd.y - v) > 1e-3 || fabs(uvd.z - g_depth[g_pix[k]]) > 1e-6 * g_depth[g_pix[k]] + 1e-9) {
+            ok = fail("round trip", uvd.x - u);
+        }
+        if (k && g_pix[k] <= g_pix[k - 7]) ok = fail("pixel order", (double)k);
+    }
+    if (arena.used() != 0) ok = fail("scratch not rewound", (double)arena.used());
+
+    // Same output from a serial pool and heap scratch
+    const size_t n2 = un.unproject(g_depth, W, g_pts2, g_pix2, 100.0, nullptr, &serial);
+    if (n2 != n || memcmp(g_pts, g_pts2, n * sizeof(Point3)) != 0 || memcmp(g_pix, g_pix2, n * sizeof(unsigned)) != 0) {
+        ok = fail("thread-count determinism", (double)n2);
+    }
+
+    // 16-bit millimetres: same points to within the 0.5 mm quantization
+    const size_t nmm = un.unproject(g_mm, W, 0.001, g_pts2, g_pix2, 100.0, &arena, &pool);
+    if (nmm != n) ok = fail("uint16 count", (double)nmm);
+    for (size_t k = 0; k < n && k < nmm && ok; ++k) {
+        if (g_pix2[k] != g_pix[k] || fabs(g_pts2[k].x - g_pts[k].x) + fabs(g_pts2[k].y - g_pts[k].y) + fabs(g_pts2[k].z - g_pts[k].z) > 3e-3) {
+            ok = fail("uint16 point", (double)k);
+        }
+    }
+
+    // Stride 3 on an odd-sized crop: ceil(w/3) * ceil(h/3) samples, pixel indices on the grid
+    CameraModel crop = cam;
+    crop.width = 1001;
+    crop.height = 500;
+    DepthUnprojector sub;
+    sub.build(crop, 3);
+    for (int i = 0; i < 1001 * 500; ++i) g_depth[i] = 10.0f;
+    const size_t ns = sub.unproject(g_depth, 1001, g_pts, g_pix, 1e30, &arena, &pool);
+    if (ns != sub.maxPoints() || ns != (size_t)334 * 167 || g_pix[ns - 1] != 498u * 1001u + 999u) ok = fail("stride", (double)ns);
+    for (size_t k = 0; k < ns && ok; k += 13) {
+        const Point3 uvd = projectPointCamera(g_pts[k], crop.extrinsic, crop.intrinsic);
+        if (fabs(uvd.x - g_pix[k] % 1001) > 1e-3 || fabs(uvd.y - g_pix[k] / 1001) > 1e-3) ok = fail("stride round trip", (double)k);
+    }
+
+    // Ray-distance encoding: points at the given distance from the camera center
+    DepthUnprojector ranged;
+    ranged.build(crop, 2, DEPTH_RANGE);
+    const size_t nr = ranged.unproject(g_depth, 1001, g_pts, nullptr, 1e30, &arena, &pool);
+    double inv[16];
+    rigidInverse(crop.extrinsic, inv); // camera center = (inv[3], inv[7], inv[11])
+    for (size_t k = 0; k < nr && ok; ++k) {
+        const double dx = g_pts[k].x - inv[3], dy = g_pts[k].y - inv[7], dz = g_pts[k].z - inv[11];
+        if (fabs(sqrt(dx * dx + dy * dy + dz * dz) - 10.0) > 1e-5) ok = fail("range encoding", (double)k);
+    }
+
+    // Argument checks
+    CameraModel bad = cam;
+    bad.width = 0;
+    DepthUnprojector empty;
+    if (empty.build(bad) || empty.unproject(g_depth, W, g_pts) != 0 || un.unproject(g_depth, W - 1, g_pts) != 0) ok = fail("argument checks", 0);
+
+    // Timing: 2 MP depth map, all pixels and every second pixel
+    for (int i = 0; i < W * H; ++i) g_depth[i] = (float)(2.0 + 60.0 * g_rng.uniform());
+    DepthUnprojector half;
+    half.build(cam, 2);
+    const int rounds = 10;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) un.unproject(g_depth, W, g_pts, nullptr, 100.0, &arena, &pool);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) half.unproject(g_depth, W, g_pts, nullptr, 100.0, &arena, &pool);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "unproject " << W << "x" << H << " depth: stride 1 "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count() / rounds
+              << " ms, stride 2 " << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t2 - t1).count() / rounds
+              << " ms (" << pool.concurrency() << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "depth tests passed\n";
+    return 0;
+}
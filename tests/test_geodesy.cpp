@@ -0,0 +1,152 @@
+/* *******************************************************************************
+ * File: tests/test_geodesy.cpp
+ * Description: Test WGS84 conversions: reference ECEF coordinates, geodetic
+ *              round trips over the globe (poles and altitude extremes
+ *              included), ENU axes and round trips, batch vs single-point
+ *              results and thread-count determinism, GNSS poses and the ENU
+ *              Frame3D through localToGlobal(), independence from the global
+ *              trig tier. Also prints batch timings.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include "geodesy.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "trig.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const size_t N = 1000000;
+static GeodeticPoint g_lla[N], g_lla2[N];
+static Point3 g_xyz[N], g_xyz2[N];
+
+static TestRng g_rng{ 29u };
+
+static double distance(const Point3 &a, const Point3 &b)
+{
+    return sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+}
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+    const double b = kWgs84A * (1.0 - kWgs84F);
+
+    // Reference points: equator/prime meridian, north pole, 90E at 1 km
+    if (distance(geodeticToEcef(GeodeticPoint{ 0.0, 0.0, 0.0 }), Point3{ kWgs84A, 0.0, 0.0 }) > 1e-9 ||
+        distance(geodeticToEcef(geodeticFromDegrees(90.0, 0.0, 0.0)), Point3{ 0.0, 0.0, b }) > 1e-9 ||
+        distance(geodeticToEcef(geodeticFromDegrees(0.0, 90.0, 1000.0)), Point3{ 0.0, kWgs84A + 1000.0, 0.0 }) > 1e-9) {
+        ok = fail("reference ECEF", 0);
+    }
+    const GeodeticPoint pole = ecefToGeodetic(Point3{ 0.0, 0.0, -b - 50.0 });
+    if (fabs(pole.latitude + 1.5707963267948966) > 1e-15 || fabs(pole.altitude - 50.0) > 1e-8) ok = fail("south pole", pole.altitude);
+
+    // Round trips over the globe, -500 m .. 100 km
+    double maxAngle = 0.0, maxHeight = 0.0;
+    for (size_t i = 0; i < 100000; ++i) {
+        GeodeticPoint g{ (g_rng.uniform() - 0.5) * 3.141592653589793, (g_rng.uniform() - 0.5) * 6.283185307179586, -500.0 + 100500.0 * g_rng.uniform() };
+        if (i < 100) g.latitude = (i % 2 ? 1.0 : -1.0) * (1.5707963267948966 - 1e-9 * (double)i); // near the poles
+        const GeodeticPoint back = ecefToGeodetic(geodeticToEcef(g));
+        const double dAngle = fabs(back.latitude - g.latitude) + fabs(back.longitude - g.longitude) * cos(g.latitude);
+        maxAngle = dAngle > maxAngle ? dAngle : maxAngle;
+        maxHeight = fabs(back.altitude - g.altitude) > maxHeight ? fabs(back.altitude - g.altitude) : maxHeight;
+    }
+    if (maxAngle > 1e-14 || maxHeight > 1e-7) ok = fail("geodetic round trip", maxAngle * kWgs84A + maxHeight);
+
+    // ENU at a reference point: axes point east / north / up, origin at zero
+    const GeodeticPoint ref = geodeticFromDegrees(48.137, 11.575, 520.0);
+    const EnuFrame frame = makeEnuFrame(ref);
+    const Point3 o = geodeticToEnu(frame, ref);
+    const Point3 east = geodeticToEnu(frame, GeodeticPoint{ ref.latitude, ref.longitude + 1e-6, ref.altitude });
+    const Point3 north = geodeticToEnu(frame, GeodeticPoint{ ref.latitude + 1e-6, ref.longitude, ref.altitude });
+    const Point3 up = geodeticToEnu(frame, GeodeticPoint{ ref.latitude, ref.longitude, ref.altitude + 10.0 });
+    if (distance(o, Point3{ 0.0, 0.0, 0.0 }) > 1e-8 || !(east.x > 4.0 && fabs(east.y) < 1e-3) ||
+        !(north.y > 6.0 && fabs(north.x) < 1e-8) || distance(up, Point3{ 0.0, 0.0, 10.0 }) > 1e-8) {
+        ok = fail("ENU axes", east.x);
+    }
+
+    // Batch = single point, ENU round trip, identical for any thread count (odd count: partial block)
+    const size_t n = 200001;
+    for (size_t i = 0; i < n; ++i) {
+        g_lla[i] = GeodeticPoint{ ref.latitude + 0.02 * (g_rng.uniform() - 0.5), ref.longitude + 0.03 * (g_rng.uniform() - 0.5), 400.0 + 300.0 * g_rng.uniform() };
+    }
+    geodeticToEnuBatch(frame, g_lla, g_xyz, n, &pool);
+    geodeticToEnuBatch(frame, g_lla, g_xyz2, n, &serial);
+    if (memcmp(g_xyz, g_xyz2, n * sizeof(Point3)) != 0) ok = fail("ENU batch determinism", 0);
+    double worst = 0.0;
+    for (size_t i = 0; i < n; i += 37) {
+        const double e = distance(g_xyz[i], geodeticToEnu(frame, g_lla[i]));
+        worst = e > worst ? e : worst;
+    }
+    if (worst > 1e-8) ok = fail("ENU batch vs single", worst);
+    enuToGeodeticBatch(frame, g_xyz, g_lla2, n, &pool);
+    worst = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double e = (fabs(g_lla2[i].latitude - g_lla[i].latitude) + fabs(g_lla2[i].longitude - g_lla[i].longitude)) * kWgs84A +
+                         fabs(g_lla2[i].altitude - g_lla[i].altitude);
+        worst = e > worst ? e : worst;
+    }
+    if (worst > 1e-7) ok = fail("ENU round trip (m)", worst);
+    geodeticToEcefBatch(g_lla, g_xyz2, n, &pool);
+    ecefToGeodeticBatch(g_xyz2, g_lla2, n, &pool);
+    if (distance(g_xyz2[n - 1], geodeticToEcef(g_lla[n - 1])) != 0.0 || fabs(g_lla2[n - 1].altitude - g_lla[n - 1].altitude) > 1e-7) {
+        ok = fail("ECEF batch", 0);
+    }
+
+    // The process-wide fast trig tier does not leak into the ellipsoid math
+    setTrigTier(TRIG_POLY_1E7);
+    const EnuFrame fastFrame = makeEnuFrame(ref);
+    const Point3 fastEcef = geodeticToEcef(g_lla[n - 1]);
+    setTrigTier(TRIG_LIBM);
+    if (memcmp(fastFrame.ecefToEnu, frame.ecefToEnu, sizeof(frame.ecefToEnu)) != 0 ||
+        distance(fastEcef, geodeticToEcef(g_lla[n - 1])) != 0.0) {
+        ok = fail("trig tier independence", distance(fastEcef, geodeticToEcef(g_lla[n - 1])));
+    }
+
+    // ENU frame as Frame3D: localToGlobal(enu, f) is the ECEF point
+    const Frame3D f = enuFrameInEcef(frame);
+    worst = 0.0;
+    for (size_t i = 0; i < 1000; ++i) {
+        const double e = distance(localToGlobal(g_xyz[i], f), geodeticToEcef(g_lla[i]));
+        worst = e > worst ? e : worst;
+    }
+    if (worst > 1e-6) ok = fail("enuFrameInEcef", worst);
+
+    // GNSS pose 2 km north-east, heading due north: 10 m ahead of the vehicle is 10 m north
+    // in the vehicle's own tangent frame, whatever the reference frame's tilt
+    const GeodeticPoint car{ ref.latitude + 2e-4, ref.longitude + 3e-4, 530.0 };
+    const Pose pose = geodeticPoseToEnu(frame, car, 0.0, 0.0, headingToEnuYaw(0.0));
+    const Point3 ahead = localToGlobal(Point3{ 10.0, 0.0, 0.0 }, Frame3D{ pose.x, pose.y, pose.z, pose.roll, pose.pitch, pose.yaw });
+    const EnuFrame carFrame = makeEnuFrame(car);
+    const Point3 aheadLocal = geodeticToEnu(carFrame, enuToGeodetic(frame, ahead));
+    if (distance(Point3{ pose.x, pose.y, pose.z }, geodeticToEnu(frame, car)) > 1e-9 ||
+        distance(aheadLocal, Point3{ 0.0, 10.0, 0.0 }) > 1e-8) {
+        ok = fail("GNSS pose", distance(aheadLocal, Point3{ 0.0, 10.0, 0.0 }));
+    }
+
+    // Timing: 1M points around the reference
+    for (size_t i = 0; i < N; ++i) {
+        g_lla[i] = GeodeticPoint{ ref.latitude + 0.05 * (g_rng.uniform() - 0.5), ref.longitude + 0.05 * (g_rng.uniform() - 0.5), 500.0 + 50.0 * g_rng.uniform() };
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    geodeticToEnuBatch(frame, g_lla, g_xyz, N, &pool);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    enuToGeodeticBatch(frame, g_xyz, g_lla2, N, &pool);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    rigidTransformPoints(frame.enuToEcef, g_xyz, g_xyz2, N);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    std::cout << "geodesy " << N << " points: LLA->ENU " << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count()
+              << " ms, ENU->LLA " << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t2 - t1).count()
+              << " ms, ENU->ECEF " << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t3 - t2).count()
+              << " ms (" << pool.concurrency() << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "geodesy tests passed\n";
+    return 0;
+}
@@ -0,0 +1,157 @@
+/* *******************************************************************************
+ * File: tests/test_ground.cpp
+ * Description: Test the TaskPool (including nested runs) and RANSAC ground
+ *              segmentation on a synthetic tilted road with noise and
+ *              obstacles: plane and frame accuracy, ground/obstacle
+ *              classification, identical results for any thread count, arena
+ *              and heap scratch. Also prints the time for a 100k-point cloud.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <math.h>
+#include "ground.hpp"
+#include "arena.hpp"
+#include "parallel.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 100000;
+static Point3 g_pts[N];
+static bool g_isObstacle[N];
+static unsigned int g_ground[N], g_obstacle[N], g_ground2[N], g_obstacle2[N];
+
+// Road z = 0.03 x - 0.02 y - 1.8 (vehicle frame), 30% obstacle points 0.4-2.5 m above it.
+static const double kA = 0.03, kB = -0.02, kC = -1.8;
+
+static void makeCloud()
+{
+    TestRng rng{ 11u };
+    for (int i = 0; i < N; ++i) {
+        double v[4];
+        for (int k = 0; k < 4; ++k) v[k] = rng.uniform();
+        const double r = 3.0 + 57.0 * v[0] * v[0];
+        const double a = 6.283185307179586 * v[1];
+        const double x = r * cos(a), y = r * sin(a);
+        const double road = kA * x + kB * y + kC;
+        g_isObstacle[i] = (i % 10) < 3;
+        const double h = g_isObstacle[i] ? 0.4 + 2.1 * v[2] : 0.06 * (v[3] - 0.5);
+        g_pts[i] = Point3{ x, y, road + h };
+    }
+}
+
+static bool testTaskPool()
+{
+    bool ok = true;
+    TaskPool pool(3);
+    if (pool.concurrency() != 4) ok = fail("concurrency", (double)pool.concurrency());
+    static int slots[1000];
+    std::atomic<int> calls(0);
+    auto body = [&](size_t i) { slots[i] = (int)i * 2; calls.fetch_add(1); };
+    for (int round = 0; round < 50; ++round) {
+        calls.store(0);
+        for (int i = 0; i < 1000; ++i) slots[i] = -1;
+        pool.parallelFor(1000, body);
+        if (calls.load() != 1000) { ok = fail("task count", calls.load()); break; }
+        for (int i = 0; i < 1000; ++i) {
+            if (slots[i] != 2 * i) { ok = fail("task slot", i); break; }
+        }
+    }
+    TaskPool serial(0);
+    calls.store(0);
+    serial.parallelFor(17, body);
+    if (calls.load() != 17) ok = fail("serial pool", calls.load());
+
+    // Nested parallelFor on the same pool runs inline (no deadlock); on another pool it runs normally
+    TaskPool other(2);
+    std::atomic<int> inner(0);
+    auto innerBody = [&](size_t) { inner.fetch_add(1); };
+    auto outerBody = [&](size_t i) {
+        pool.parallelFor(10, innerBody);
+        other.parallelFor(5, innerBody);
+        slots[i] = 1;
+    };
+    pool.parallelFor(40, outerBody);
+    if (inner.load() != 40 * 15) ok = fail("nested runs", inner.load());
+    return ok;
+}
+
+int main()
+{
+    bool ok = testTaskPool();
+    makeCloud();
+
+    FrameArena arena;
+    arena.reserve(1 << 20);
+    GroundSegmentationConfig cfg = defaultGroundSegmentationConfig();
+    cfg.distanceThreshold = 0.2;
+    GroundSegmentationResult res;
+    TaskPool pool(3);
+    if (!segmentGround(g_pts, N, cfg, g_ground, g_obstacle, res, &arena, &pool)) {
+        fail("segmentGround", 0);
+        return 1;
+    }
+    if (arena.used() != 0) ok = fail("scratch not rewound", (double)arena.used());
+
+    // Plane vs truth: n ~ (-a, -b, 1) / |.|, d ~ -c / |.|
+    const double len = sqrt(kA * kA + kB * kB + 1.0);
+    const double dot = (-kA * res.plane.nx - kB * res.plane.ny + res.plane.nz) / len;
+    if (dot < cos(0.2 * 3.14159265358979323846 / 180.0)) ok = fail("plane normal", acos(dot));
+    if (fabs(res.plane.d + kC / len) > 0.02) ok = fail("plane offset", res.plane.d);
+    if (res.groundCount + res.obstacleCount != (size_t)N) ok = fail("counts", (double)res.groundCount);
+    if (res.sampleInliers < cfg.sampleSize / 2) ok = fail("sample inliers", (double)res.sampleInliers);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < res.groundCount; ++i) wrong += g_isObstacle[g_ground[i]];
+    for (size_t i = 0; i < res.obstacleCount; ++i) wrong += !g_isObstacle[g_obstacle[i]];
+    if (wrong > (size_t)N / 1000) ok = fail("misclassified", (double)wrong);
+    for (size_t i = 1; i < res.groundCount; ++i) {
+        if (g_ground[i] <= g_ground[i - 1]) { ok = fail("ground order", (double)i); break; }
+    }
+
+    // Frame: z axis = normal, origin on the plane
+    double F[16];
+    poseToMatrix(res.frame, F);
+    if (fabs(F[2] - res.plane.nx) > 1e-9 || fabs(F[6] - res.plane.ny) > 1e-9 || fabs(F[10] - res.plane.nz) > 1e-9) {
+        ok = fail("frame z axis", F[10] - res.plane.nz);
+    }
+    const double onPlane = res.plane.nx * F[3] + res.plane.ny * F[7] + res.plane.nz * F[11] + res.plane.d;
+    if (fabs(onPlane) > 1e-9) ok = fail("frame origin", onPlane);
+
+    // Same answer on the caller alone and through the heap fallback
+    TaskPool serial(0);
+    GroundSegmentationResult res2;
+    if (!segmentGround(g_pts, N, cfg, g_ground2, g_obstacle2, res2, nullptr, &serial)) ok = fail("serial run", 0);
+    if (res2.plane.nx != res.plane.nx || res2.plane.ny != res.plane.ny || res2.plane.nz != res.plane.nz ||
+        res2.plane.d != res.plane.d || res2.groundCount != res.groundCount || res2.sampleInliers != res.sampleInliers) {
+        ok = fail("thread-count determinism", res2.plane.d - res.plane.d);
+    }
+    for (size_t i = 0; i < res.groundCount && i < res2.groundCount; ++i) {
+        if (g_ground[i] != g_ground2[i]) { ok = fail("ground indices differ", (double)i); break; }
+    }
+
+    // Ground-only output
+    GroundSegmentationResult res3;
+    segmentGround(g_pts, N, cfg, g_ground2, nullptr, res3, &arena, &pool);
+    if (res3.groundCount != res.groundCount || res3.obstacleCount != res.obstacleCount) ok = fail("ground-only output", (double)res3.groundCount);
+
+    // Nothing plausible: a wall (all normals horizontal) is rejected by maxSlope
+    static Point3 wall[1000];
+    for (int i = 0; i < 1000; ++i) wall[i] = Point3{ 5.0 + 0.001 * (i % 7), (double)(i % 40) * 0.1, (double)(i / 40) * 0.1 - 1.0 };
+    if (segmentGround(wall, 1000, cfg, g_ground2, g_obstacle2, res3, &arena, &pool)) ok = fail("wall accepted", res3.plane.nz);
+
+    const int rounds = 20;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) segmentGround(g_pts, N, cfg, g_ground, g_obstacle, res, &arena, &pool);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count() / rounds;
+    std::cout << "segmentGround " << N << " points, " << cfg.iterations << " hypotheses: " << ms << " ms ("
+              << pool.concurrency() << " threads, ground " << res.groundCount << ")\n";
+
+    if (!ok) return 1;
+    std::cout << "ground tests passed\n";
+    return 0;
+}
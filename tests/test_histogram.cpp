@@ -0,0 +1,108 @@
+/* *******************************************************************************
+ * File: tests/test_histogram.cpp
+ * Description: Test latency histogram precision, merging, and the per-stage
+ *              metrics (multi-thread recording, TraceScope feed, text/JSON
+ *              report, library entry points feeding their stages).
+ * *******************************************************************************/
+
+#include <iostream>
+#include <thread>
+#include <string.h>
+#include "histogram.hpp"
+#include "instrumentation.hpp"
+#include "quaternion.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+
+using namespace AdasTools;
+
+static bool withinRelative(double v, double ref, double rel) { double d = v - ref; if (d < 0) d = -d; return d <= ref * rel; }
+
+int main()
+{
+    // Uniform 1..100000 ns: percentiles within the 7-bit bucket precision
+    static LatencyHistogram h;
+    for (unsigned long long v = 1; v <= 100000; ++v) h.record(v);
+    if (h.count() != 100000 || h.min() != 1 || h.max() != 100000) { std::cerr << "count/min/max wrong\n"; return 1; }
+    if (!withinRelative((double)h.percentile(50.0), 50000.0, 0.016) ||
+        !withinRelative((double)h.percentile(99.0), 99000.0, 0.016) ||
+        !withinRelative((double)h.percentile(99.9), 99900.0, 0.016) ||
+        h.percentile(100.0) != 100000) {
+        std::cerr << "percentile outside precision: p50=" << h.percentile(50.0) << " p99=" << h.percentile(99.0) << "\n";
+        return 2;
+    }
+
+    // Bucket bounds are consistent with the index mapping
+    for (size_t i = 1; i < h.bucketCount(); ++i) {
+        if (h.bucketIndex(h.bucketUpperBound(i)) != i || h.bucketIndex(h.bucketUpperBound(i - 1) + 1) != i) {
+            std::cerr << "bucket bounds inconsistent at " << i << "\n";
+            return 3;
+        }
+    }
+
+    static LatencyHistogram tail;
+    tail.record(5000000);
+    if (!h.merge(tail) || h.max() != 5000000 || h.count() != 100001) { std::cerr << "merge failed\n"; return 4; }
+
+    // Per-stage metrics recorded from two threads and merged on read
+    latencyConfigure(defaultHistogramConfig());
+    latencySetEnabled(true);
+    auto work = []() {
+        for (int i = 0; i < 1000; ++i) latencyRecord(TRACE_STAGE_TRANSFORM, 1000 + (unsigned long long)i);
+        latencyRecord(TRACE_STAGE_TRANSFORM, 40000000); // a 40 ms spike
+    };
+    std::thread t(work);
+    work();
+    t.join();
+    { TraceScope scope(TRACE_STAGE_PROJECT, "project"); }
+    latencySetEnabled(false);
+
+    static LatencyHistogram merged;
+    latencySnapshot(TRACE_STAGE_TRANSFORM, merged);
+    if (merged.count() != 2002 || merged.max() != 40000000 || merged.min() != 1000) {
+        std::cerr << "stage snapshot wrong: count=" << merged.count() << "\n";
+        return 5;
+    }
+    if (merged.percentile(99.0) > 2100 || merged.percentile(100.0) != 40000000) { std::cerr << "tail percentiles wrong\n"; return 6; }
+    latencySnapshot(TRACE_STAGE_PROJECT, merged);
+    if (merged.count() != 1) { std::cerr << "TraceScope did not feed histogram\n"; return 7; }
+
+    char report[4096];
+    size_t n = latencyFormatReport(report, sizeof(report), LATENCY_REPORT_JSON);
+    if (n >= sizeof(report) || !strstr(report, "\"transform\":{\"count\":2002") || !strstr(report, "\"p999\":")) {
+        std::cerr << "JSON report wrong: " << report << "\n";
+        return 8;
+    }
+    n = latencyFormatReport(report, sizeof(report), LATENCY_REPORT_TEXT);
+    if (!strstr(report, "adas_latency_ns_max{stage=\"transform\"} 40000000")) {
+        std::cerr << "text report wrong: " << report << "\n";
+        return 9;
+    }
+    std::cout << report;
+
+    latencyReset();
+    latencySnapshot(TRACE_STAGE_TRANSFORM, merged);
+    if (merged.count() != 0) { std::cerr << "reset failed\n"; return 10; }
+
+    // Plain library calls feed their stage histograms (instrumented builds only)
+    latencySetEnabled(true);
+    const Frame3D frame{ 1.0, 2.0, 0.5, 0.1, -0.2, 0.3 };
+    for (int i = 0; i < 10; ++i) (void)localToGlobal(Point3{ (double)i, 0.0, 1.0 }, frame);
+    static Point3 pts[100];
+    double m[16];
+    poseToMatrix(Pose{ 1.0, 0.0, 0.0, 0.0, 0.0, 0.5 }, m);
+    rigidTransformPoints(m, pts, pts, 100);
+    (void)slerp(quaternionFromRPY(0.0, 0.0, 0.0), quaternionFromRPY(0.0, 0.0, 1.0), 0.5);
+    latencySetEnabled(false);
+    const unsigned long long expect = profileEnabled() ? 1 : 0;
+    latencySnapshot(TRACE_STAGE_TRANSFORM, merged);
+    const unsigned long long transforms = merged.count();
+    latencySnapshot(TRACE_STAGE_INTERPOLATE, merged);
+    if (transforms != 11 * expect || merged.count() != expect) {
+        std::cerr << "library calls did not feed histograms: transform=" << transforms << "\n";
+        return 11;
+    }
+
+    std::cout << "histogram test OK\n";
+    return 0;
+}
@@ -0,0 +1,183 @@
+/* *******************************************************************************
+ * File: tests/test_icp.cpp
+ * Description: Test the KD-tree against brute force (nearest, k-nearest,
+ *              radius, hints), PCA normals on a plane, and point-to-plane ICP
+ *              on a synthetic street (ground, walls, poles, cars) sampled
+ *              twice: recovered extrinsic vs truth, identical results for any
+ *              thread count, failure without overlap. Also prints the tree,
+ *              normal and registration times for 30k-point clouds.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "icp.hpp"
+#include "arena.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 30000;
+static Point3 g_target[N], g_source[N], g_normals[N];
+
+static TestRng g_rng{ 7u };
+
+// One random point on the street scene (world frame, ground at z = -1.8).
+static Point3 scenePoint()
+{
+    const double pick = g_rng.uniform();
+    const double a = g_rng.uniform(), b = g_rng.uniform();
+    if (pick < 0.4) return Point3{ -40.0 + 80.0 * a, -40.0 + 80.0 * b, -1.8 + 0.01 * sin(0.7 * a * 80.0) };
+    if (pick < 0.55) return Point3{ 25.0, -30.0 + 60.0 * a, -1.8 + 5.0 * b };           // wall facing -x
+    if (pick < 0.7) return Point3{ -30.0 + 60.0 * a, -20.0, -1.8 + 4.0 * b };           // wall facing +y
+    if (pick < 0.8) return Point3{ -30.0 + 20.0 * a, 10.0 + 20.0 * a, -1.8 + 3.0 * b }; // diagonal wall
+    if (pick < 0.9) {                                                                   // 20 poles
+        const int k = (int)(20.0 * g_rng.uniform());
+        const double ang = 6.283185307179586 * a;
+        return Point3{ -18.0 + 2.0 * k + 0.15 * cos(ang), 4.0 + 0.3 * k + 0.15 * sin(ang), -1.8 + 4.0 * b };
+    }
+    // 8 parked cars: 4 x 2 x 1.5 boxes, one of the 4 side faces or the roof
+    const int car = (int)(8.0 * g_rng.uniform()), face = (int)(5.0 * g_rng.uniform());
+    const double cx = -20.0 + 6.0 * car, cy = -8.0 - 0.5 * car;
+    switch (face) {
+    case 0: return Point3{ cx - 2.0, cy - 1.0 + 2.0 * a, -1.8 + 1.5 * b };
+    case 1: return Point3{ cx + 2.0, cy - 1.0 + 2.0 * a, -1.8 + 1.5 * b };
+    case 2: return Point3{ cx - 2.0 + 4.0 * a, cy - 1.0, -1.8 + 1.5 * b };
+    case 3: return Point3{ cx - 2.0 + 4.0 * a, cy + 1.0, -1.8 + 1.5 * b };
+    default: return Point3{ cx - 2.0 + 4.0 * a, cy - 1.0 + 2.0 * b, -0.3 };
+    }
+}
+
+static bool testTree()
+{
+    bool ok = true;
+    const int M = 4000;
+    static Point3 pts[M];
+    for (int i = 0; i < M; ++i) pts[i] = Point3{ 20.0 * g_rng.uniform(), 10.0 * g_rng.uniform(), 2.0 * g_rng.uniform() };
+    for (int i = 0; i < 40; ++i) pts[M - 1 - i] = pts[i]; // duplicates
+    PointKdTree tree;
+    if (!tree.build(pts, M) || tree.size() != (size_t)M) return fail("build", 0);
+
+    for (int q = 0; q < 500 && ok; ++q) {
+        const Point3 p{ -1.0 + 22.0 * g_rng.uniform(), -1.0 + 12.0 * g_rng.uniform(), -0.5 + 3.0 * g_rng.uniform() };
+        double best = 1e30;
+        double dist[M];
+        for (int i = 0; i < M; ++i) {
+            const double dx = pts[i].x - p.x, dy = pts[i].y - p.y, dz = pts[i].z - p.z;
+            dist[i] = dx * dx + dy * dy + dz * dz;
+            best = dist[i] < best ? dist[i] : best;
+        }
+        double d2 = 0.0;
+        const unsigned j = tree.nearest(p, 100.0, &d2);
+        if (j == kNoNeighbor || fabs(dist[j] - best) > 1e-5 * (1.0 + best) || fabs(d2 - best) > 1e-5 * (1.0 + best)) {
+            ok = fail("nearest", q);
+        }
+        // a far hint must not change the answer
+        const unsigned h = tree.nearest(p, 100.0, nullptr, (unsigned)(q * 7 % M));
+        if (h == kNoNeighbor || fabs(dist[h] - best) > 1e-5 * (1.0 + best)) ok = fail("nearest with hint", q);
+        // radius: nothing when the radius is below the nearest distance
+        if (tree.nearest(p, sqrt(best) * 0.99, nullptr) != kNoNeighbor) ok = fail("radius", q);
+
+        unsigned idx[8];
+        double kd[8];
+        const size_t found = tree.nearestK(p, 8, 100.0, idx, kd);
+        if (found != 8) { ok = fail("nearestK count", (double)found); break; }
+        for (int k = 0; k < 8; ++k) {
+            // kth smallest by counting
+            int smaller = 0;
+            for (int i = 0; i < M; ++i) smaller += dist[i] < dist[idx[k]] - 1e-5 * (1.0 + dist[idx[k]]);
+            if (smaller > k || (k > 0 && kd[k] < kd[k - 1])) { ok = fail("nearestK order", k); break; }
+        }
+    }
+    PointKdTree empty;
+    if (!empty.build(pts, 0) || empty.nearest(pts[0], 1.0) != kNoNeighbor) ok = fail("empty tree", 0);
+    return ok;
+}
+
+int main()
+{
+    bool ok = testTree();
+
+    for (int i = 0; i < N; ++i) g_target[i] = scenePoint();
+    // Truth: source (second lidar) to target (first lidar) frame
+    const Pose truth{ 0.35, -0.25, 0.12, 0.008, -0.012, 0.035 };
+    const RigidTransform T = poseToTransform(truth);
+    const RigidTransform Tinv = inverseTransform(T);
+    for (int i = 0; i < N; ++i) {
+        const Point3 w = scenePoint();
+        const Point3 p = rotateByQuaternion(Tinv.q, w);
+        g_source[i] = Point3{ p.x + Tinv.t.x + 0.01 * (g_rng.uniform() - 0.5), p.y + Tinv.t.y + 0.01 * (g_rng.uniform() - 0.5),
+                              p.z + Tinv.t.z + 0.01 * (g_rng.uniform() - 0.5) };
+    }
+
+    TaskPool pool(3), serial(0);
+    FrameArena arena;
+    arena.reserve(4 << 20);
+    PointKdTree tree;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    tree.build(g_target, N);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    estimatePointNormals(tree, g_target, N, 10, 1.5, g_normals, &pool);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    // Ground normals are vertical
+    size_t ground = 0, vertical = 0;
+    for (int i = 0; i < N; ++i) {
+        if (g_target[i].z < -1.75 && fabs(g_target[i].x) < 15.0 && fabs(g_target[i].y + 30.0) < 8.0) {
+            ++ground;
+            vertical += fabs(g_normals[i].z) > 0.99;
+        }
+    }
+    if (ground < 100 || vertical < ground * 95 / 100) ok = fail("ground normals", (double)vertical / (double)ground);
+
+    IcpConfig cfg = defaultIcpConfig();
+    IcpResult res;
+    const Pose zero{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    auto t3 = std::chrono::high_resolution_clock::now();
+    if (!registerPointToPlane(tree, g_target, g_normals, g_source, N, zero, cfg, res, &arena, &pool)) ok = fail("register", 0);
+    auto t4 = std::chrono::high_resolution_clock::now();
+    if (arena.used() != 0) ok = fail("scratch not rewound", (double)arena.used());
+    const double dt = sqrt((res.pose.x - truth.x) * (res.pose.x - truth.x) + (res.pose.y - truth.y) * (res.pose.y - truth.y) +
+                           (res.pose.z - truth.z) * (res.pose.z - truth.z));
+    const double dr = fabs(res.pose.roll - truth.roll) + fabs(res.pose.pitch - truth.pitch) + fabs(res.pose.yaw - truth.yaw);
+    if (!res.converged) ok = fail("not converged", res.iterations);
+    if (dt > 0.01) ok = fail("translation error", dt);
+    if (dr > 0.001) ok = fail("rotation error", dr);
+    if (res.rms > 0.05) ok = fail("rms", res.rms); // poles are curved at the 0.15 m scale
+    if (res.correspondences < (size_t)N * 8 / 10) ok = fail("correspondences", (double)res.correspondences);
+
+    // Thread count and the heap fallback do not change the result
+    IcpResult res2;
+    registerPointToPlane(tree, g_target, g_normals, g_source, N, poseToTransform(zero), cfg, res2, nullptr, &serial);
+    if (res2.transform.t.x != res.transform.t.x || res2.transform.q.w != res.transform.q.w ||
+        res2.transform.q.z != res.transform.q.z || res2.iterations != res.iterations) {
+        ok = fail("thread-count determinism", res2.transform.t.x - res.transform.t.x);
+    }
+
+    // No overlap: fails cleanly and leaves the initial guess
+    const Pose far{ 500.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if (registerPointToPlane(tree, g_target, g_normals, g_source, N, far, cfg, res2, &arena, &pool) || res2.pose.x != 500.0) {
+        ok = fail("no overlap", res2.pose.x);
+    }
+
+    // Warm start from the previous answer (continuous refinement)
+    const int rounds = 10;
+    auto t5 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) registerPointToPlane(tree, g_target, g_normals, g_source, N, res.transform, cfg, res2, &arena, &pool);
+    auto t6 = std::chrono::high_resolution_clock::now();
+
+    auto ms = [](std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b) {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(b - a).count();
+    };
+    std::cout << "PointKdTree build " << N << " points: " << ms(t0, t1) << " ms, normals: " << ms(t1, t2) << " ms\n";
+    std::cout << "registerPointToPlane " << N << " -> " << N << " points: " << ms(t3, t4) << " ms (" << res.iterations
+              << " iterations, rms " << res.rms << " m), warm start " << ms(t5, t6) / rounds << " ms ("
+              << res2.iterations << " iterations, " << pool.concurrency() << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "icp tests passed\n";
+    return 0;
+}
@@ -0,0 +1,192 @@
+/* *******************************************************************************
+ * File: tests/test_imu.cpp
+ * Description: Test IMU strapdown integration: quaternion exp/log, circular
+ *              motion against the analytic solution at 1 kHz and 10 Hz,
+ *              rate independence for constant rate and specific force,
+ *              preintegration against propagation, bias removal, stale
+ *              samples, Trajectory output (one probe call per batch) and
+ *              independence from the global trig tier. Also prints the cost
+ *              per sample.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "imu.hpp"
+#include "instrumentation.hpp"
+#include "quaternion.hpp"
+#include "trajectory.hpp"
+#include "trig.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const size_t kSamples = 1000000;
+static ImuSample g_samples[kSamples];
+static NavState g_states[20000];
+
+static TestRng g_rng{ 23u };
+
+static double distance(const Point3 &a, const Point3 &b)
+{
+    return sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+}
+
+// Rotation angle between two unit quaternions
+static double angle(const Quaternion &a, const Quaternion &b)
+{
+    const Quaternion d = multiplyQuaternion(Quaternion{ a.w, -a.x, -a.y, -a.z }, b);
+    const Point3 v = quaternionLog(d);
+    return sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+static double stateError(const NavState &a, const NavState &b)
+{
+    return distance(a.pose.t, b.pose.t) + distance(a.velocity, b.velocity) + angle(a.pose.q, b.pose.q);
+}
+
+// n samples at `rate` Hz starting after t0, constant measurements
+static void constantSamples(size_t n, double t0, double rate, const Point3 &gyro, const Point3 &accel)
+{
+    for (size_t i = 0; i < n; ++i) g_samples[i] = ImuSample{ t0 + (double)(i + 1) / rate, gyro, accel };
+}
+
+int main()
+{
+    bool ok = true;
+
+    // Exp/log round trips, tiny and large angles; exp of a z rotation is the yaw quaternion
+    const Point3 vs[4] = { { 0.3, -0.2, 0.9 }, { 1e-9, 2e-9, -1e-9 }, { 0.0, 0.0, 0.0 }, { 0.0, 3.1, 0.2 } };
+    for (int i = 0; i < 4; ++i) {
+        const Point3 back = quaternionLog(quaternionExp(vs[i]));
+        if (distance(back, vs[i]) > 1e-14) ok = fail("exp/log round trip", distance(back, vs[i]));
+    }
+    const Quaternion yaw = quaternionFromRPY(0.0, 0.0, 0.7), e = quaternionExp(Point3{ 0.0, 0.0, 0.7 });
+    if (fabs(yaw.w - e.w) + fabs(yaw.z - e.z) > 1e-15) ok = fail("exp vs quaternionFromRPY", yaw.w - e.w);
+
+    // Circular drive: radius 20 m at 0.5 rad/s (10 m/s), heading along the circle.
+    // Body rate (0, 0, w) and specific force (0, r w^2, g) are constant; 10 s at 1 kHz and 10 Hz.
+    const double r = 20.0, w = 0.5, T = 10.0;
+    NavState start;
+    start.stamp = 0.0;
+    start.pose = poseToTransform(Pose{ r, 0.0, 0.0, 0.0, 0.0, 1.5707963267948966 });
+    start.velocity = Point3{ 0.0, r * w, 0.0 };
+    NavState truth;
+    truth.stamp = T;
+    truth.pose = poseToTransform(Pose{ r * cos(w * T), r * sin(w * T), 0.0, 0.0, 0.0, w * T + 1.5707963267948966 });
+    truth.velocity = Point3{ -r * w * sin(w * T), r * w * cos(w * T), 0.0 };
+    const double rates[2] = { 1000.0, 10.0 };
+    for (int k = 0; k < 2; ++k) {
+        const size_t n = (size_t)(T * rates[k]);
+        constantSamples(n, 0.0, rates[k], Point3{ 0.0, 0.0, w }, Point3{ 0.0, r * w * w, kStandardGravity });
+        ImuPropagator imu;
+        imu.reset(start);
+        if (imu.propagate(g_samples, n, g_states) != n) ok = fail("propagate count", (double)k);
+        if (stateError(imu.state(), truth) > 1e-8) ok = fail(k ? "circle at 10 Hz" : "circle at 1 kHz", stateError(imu.state(), truth));
+        if (stateError(g_states[n - 1], imu.state()) != 0.0) ok = fail("outputs", (double)k);
+    }
+
+    // The process-wide fast trig tier does not degrade integration
+    constantSamples(10000, 0.0, 1000.0, Point3{ 0.0, 0.0, w }, Point3{ 0.0, r * w * w, kStandardGravity });
+    ImuPropagator exact, fastTier;
+    exact.reset(start);
+    fastTier.reset(start);
+    exact.propagate(g_samples, 10000);
+    setTrigTier(TRIG_POLY_1E7);
+    fastTier.propagate(g_samples, 10000);
+    setTrigTier(TRIG_LIBM);
+    if (stateError(exact.state(), fastTier.state()) != 0.0) ok = fail("trig tier independence", stateError(exact.state(), fastTier.state()));
+
+    // Constant tumbling rate and specific force: 2 s at 1 kHz equals 2 s at 5 Hz
+    const Point3 gyro{ 0.4, -0.9, 1.3 }, accel{ 1.5, -0.7, 9.0 };
+    ImuPropagator fast, slow;
+    fast.reset(start);
+    slow.reset(start);
+    constantSamples(2000, 0.0, 1000.0, gyro, accel);
+    fast.propagate(g_samples, 2000);
+    constantSamples(10, 0.0, 5.0, gyro, accel);
+    slow.propagate(g_samples, 10);
+    if (stateError(fast.state(), slow.state()) > 1e-9) ok = fail("rate independence", stateError(fast.state(), slow.state()));
+
+    // Preintegration between keyframes reproduces propagation for any start state,
+    // in one call or split, with uneven sample spacing and varying measurements
+    const size_t np = 1500;
+    double t = 0.0;
+    for (size_t i = 0; i < np; ++i) {
+        t += 0.0005 + 0.001 * g_rng.uniform();
+        g_samples[i] = ImuSample{ t, Point3{ g_rng.uniform() - 0.5, g_rng.uniform() - 0.5, 2.0 * (g_rng.uniform() - 0.5) },
+                                  Point3{ 4.0 * (g_rng.uniform() - 0.5), g_rng.uniform() - 0.5, kStandardGravity + g_rng.uniform() - 0.5 } };
+    }
+    ImuBias bias{ Point3{ 0.01, -0.02, 0.005 }, Point3{ 0.1, 0.05, -0.2 } };
+    ImuPreintegration pre = startPreintegration(0.0), split = startPreintegration(0.0);
+    if (preintegrateImu(pre, g_samples, np, bias) != np) ok = fail("preintegrate count", 0);
+    preintegrateImu(split, g_samples, 700, bias);
+    preintegrateImu(split, g_samples, np, bias); // first 700 are stale and skipped
+    const Point3 gravity{ 0.0, 0.0, -kStandardGravity };
+    for (int s = 0; s < 3; ++s) {
+        NavState from;
+        from.stamp = 0.0;
+        from.pose = poseToTransform(Pose{ 5.0 * s, -3.0, 1.0, 0.1 * s, -0.2, 2.0 * s });
+        from.velocity = Point3{ 3.0 * s, 1.0, -0.5 };
+        ImuPropagator imu;
+        imu.reset(from);
+        imu.setBias(bias);
+        imu.propagate(g_samples, np);
+        const NavState predicted = predictNavState(from, pre, gravity);
+        if (stateError(predicted, imu.state()) > 1e-9 || predicted.stamp != imu.state().stamp) {
+            ok = fail("preintegration vs propagation", stateError(predicted, imu.state()));
+        }
+        if (stateError(predictNavState(from, split, gravity), predicted) > 1e-12) ok = fail("split preintegration", (double)s);
+    }
+
+    // Bias: biased samples with setBias() match clean samples without
+    constantSamples(500, 0.0, 1000.0, gyro, accel);
+    ImuPropagator clean, biased;
+    clean.reset(start);
+    biased.reset(start);
+    clean.propagate(g_samples, 500);
+    for (size_t i = 0; i < 500; ++i) {
+        g_samples[i].gyro = Point3{ gyro.x + bias.gyro.x, gyro.y + bias.gyro.y, gyro.z + bias.gyro.z };
+        g_samples[i].accel = Point3{ accel.x + bias.accel.x, accel.y + bias.accel.y, accel.z + bias.accel.z };
+    }
+    biased.setBias(bias);
+    biased.propagate(g_samples, 500);
+    if (stateError(clean.state(), biased.state()) > 1e-12) ok = fail("bias", stateError(clean.state(), biased.state()));
+
+    // Trajectory output: one pose per sample, stale samples skipped
+    ImuPropagator traj;
+    traj.reset(start);
+    Trajectory path;
+    constantSamples(200, 0.0, 1000.0, gyro, accel);
+    g_samples[100].stamp = g_samples[99].stamp; // duplicate stamp
+    profileReset();
+    if (traj.propagate(g_samples, 200, path) != 199 || path.size() != 199) ok = fail("trajectory size", (double)path.size());
+    ProfileSnapshot snap;
+    profileSnapshot(snap);
+    if (snap.probes[PROBE_IMU_PROPAGATE].calls != (profileEnabled() ? 1u : 0u) ||
+        snap.probes[PROBE_IMU_PROPAGATE].points != (profileEnabled() ? 200u : 0u)) {
+        ok = fail("trajectory propagate probe", (double)snap.probes[PROBE_IMU_PROPAGATE].calls);
+    }
+    RigidTransform mid;
+    if (!path.interpolate(0.1505, mid) || distance(path.transform(198).t, traj.state().pose.t) != 0.0) ok = fail("trajectory poses", 0);
+
+    // Timing: 1M samples (several 1 kHz IMUs for minutes)
+    constantSamples(kSamples, 0.0, 1000.0, gyro, accel);
+    for (size_t i = 0; i < kSamples; ++i) g_samples[i].gyro.x += 0.1 * g_rng.uniform();
+    ImuPropagator timed;
+    timed.reset(start);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    timed.propagate(g_samples, kSamples);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    ImuPreintegration timedPre = startPreintegration(0.0);
+    preintegrateImu(timedPre, g_samples, kSamples, bias);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    const double propNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count() / kSamples;
+    std::cout << "IMU propagation " << propNs << " ns/sample, preintegration "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t2 - t1).count() / kSamples
+              << " ns/sample (4 IMUs at 1 kHz: " << propNs * 4000.0 * 1e-7 << " % of one core)\n";
+
+    if (!ok) return 1;
+    std::cout << "imu tests passed\n";
+    return 0;
+}
@@ -0,0 +1,83 @@
+/* *******************************************************************************
+ * File: tests/test_instrumentation.cpp
+ * Description: Test the hot-path instrumentation counters. With the library
+ *              built with ADAS_TOOLS_INSTRUMENTATION=ON the counters must match
+ *              the calls made (across threads) and batch probes the elements
+ *              processed; otherwise they must stay zero.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include "boxes.hpp"
+#include "instrumentation.hpp"
+#include "transformers.hpp"
+#include "quaternion.hpp"
+#include "rigid.hpp"
+#include "trajectory.hpp"
+
+using namespace AdasTools;
+
+int main()
+{
+    profileReset();
+    Frame3D f = {1.0, 2.0, 0.5, 0.1, -0.2, 0.3};
+    double E[16], K[9] = {800, 0, 320, 0, 800, 240, 0, 0, 1};
+    poseToMatrix(Pose{0, 0, 0, 0, 0, 0}, E);
+
+    auto work = [&]() {
+        for (int i = 0; i < 1000; ++i) {
+            Point3 g = localToGlobal(Point3{ (double)i, 0.5, 1.0 }, f);
+            (void)globalToLocal(g, f);
+            (void)projectPointCamera(Point3{ 0.1, 0.2, 5.0 }, E, K);
+        }
+        Quaternion a = quaternionFromRPY(0.1, 0.2, 0.3);
+        Quaternion b = quaternionFromRPY(0.3, 0.2, 0.1);
+        for (int i = 0; i < 500; ++i) (void)slerp(a, b, i / 500.0);
+    };
+    std::thread t(work);
+    work();
+    t.join();
+
+    // Batch entry points count elements, not calls
+    static Point3 pts[64];
+    static double poses[4 * 16], composed[4 * 16];
+    rigidTransformPoints(E, pts, pts, 64);
+    for (int i = 0; i < 4; ++i) poseToMatrix(Pose{ 0.1 * i, 0, 0, 0, 0, 0.2 * i }, poses + 16 * i);
+    rigidComposeBatch(E, poses, composed, 4);
+    Trajectory traj;
+    RigidTransform mid;
+    traj.append(0.0, Pose{ 0, 0, 0, 0, 0, 0 });
+    traj.append(1.0, Pose{ 1, 0, 0, 0, 0, 0.5 });
+    traj.interpolate(0.5, mid);
+    static OrientedBox boxes[10];
+    boxesTransform(boxes, boxes, 10, E);
+    boxesLocalToGlobal(boxes, boxes, 3, f);
+
+    ProfileSnapshot snap;
+    profileSnapshot(snap);
+    unsigned long long expect = profileEnabled() ? 2000ull : 0ull;
+    if (snap.probes[PROBE_LOCAL_TO_GLOBAL].calls != expect ||
+        snap.probes[PROBE_GLOBAL_TO_LOCAL].calls != expect ||
+        snap.probes[PROBE_PROJECT_POINT_CAMERA].points != expect ||
+        snap.probes[PROBE_SLERP].calls != expect / 2 + (profileEnabled() ? 1 : 0) ||
+        snap.probes[PROBE_RIGID_TRANSFORM_POINTS].points != (profileEnabled() ? 64u : 0u) ||
+        snap.probes[PROBE_RIGID_COMPOSE].points != (profileEnabled() ? 4u : 0u) ||
+        snap.probes[PROBE_TRAJECTORY_INTERPOLATE].calls != (profileEnabled() ? 1u : 0u) ||
+        snap.probes[PROBE_BOXES_TRANSFORM].points != (profileEnabled() ? 10u : 0u) ||
+        snap.probes[PROBE_BOXES_LOCAL_TO_GLOBAL].points != (profileEnabled() ? 3u : 0u)) {
+        std::cerr << "instrumentation counters mismatch\n";
+        return 1;
+    }
+    if (snap.ticksPerSecond <= 0.0) { std::cerr << "invalid tick rate\n"; return 2; }
+
+    for (int i = 0; i < PROBE_COUNT; ++i) {
+        if (std::string(profileProbeName((ProfileProbe)i)) == "unknown") { std::cerr << "probe " << i << " has no name\n"; return 3; }
+        const ProbeStats &s = snap.probes[i];
+        if (s.calls == 0) continue;
+        std::cout << profileProbeName((ProfileProbe)i) << ": calls=" << s.calls
+                  << " ns/call=" << (double)s.ticks / snap.ticksPerSecond * 1e9 / (double)s.calls << "\n";
+    }
+    std::cout << "instrumentation test OK (enabled: " << (profileEnabled() ? "yes" : "no") << ")\n";
+    return 0;
+}
@@ -0,0 +1,193 @@
+/* *******************************************************************************
+ * File: tests/test_ipm.cpp
+ * Description: Test inverse perspective mapping with a synthetic four-camera
+ *              surround rig looking at a textured ground plane: warped BEV
+ *              cells against the texture, coverage and camera choice, seam
+ *              blending, identical results for 1/3/4 channels (scalar vs
+ *              SSE2 paths) and any thread count, and argument checks. Also
+ *              prints table build time against per-frame warp time.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include "ipm.hpp"
+#include "multicam.hpp"
+#include "parallel.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int W = 1280, H = 720, kCams = 4;
+static const unsigned kRows = 800, kCols = 800;
+static unsigned char g_gray[kCams][W * H], g_rgb[kCams][W * H * 3], g_rgba[kCams][W * H * 4];
+static unsigned char g_bev1[kRows * kCols], g_bev3[kRows * kCols * 3], g_bev4[kRows * kCols * 4], g_bevB[kRows * kCols * 3];
+
+static double texture(double x, double y)
+{
+    return 128.0 + 60.0 * sin(1.3 * x) + 50.0 * cos(0.9 * y);
+}
+
+struct Mount {
+    double c[3];             // camera center, vehicle frame
+    double r[3], d[3], f[3]; // right, down, forward axes in the vehicle frame
+};
+
+// Camera at height 1.5 m facing `yaw`, pitched down by `pitch`.
+static Mount mount(double x, double y, double yaw, double pitch)
+{
+    Mount m;
+    m.c[0] = x; m.c[1] = y; m.c[2] = 1.5;
+    m.f[0] = cos(yaw) * cos(pitch); m.f[1] = sin(yaw) * cos(pitch); m.f[2] = -sin(pitch);
+    m.r[0] = sin(yaw); m.r[1] = -cos(yaw); m.r[2] = 0.0;
+    m.d[0] = m.f[1] * m.r[2] - m.f[2] * m.r[1];
+    m.d[1] = m.f[2] * m.r[0] - m.f[0] * m.r[2];
+    m.d[2] = m.f[0] * m.r[1] - m.f[1] * m.r[0];
+    return m;
+}
+
+static CameraModel cameraFor(const Mount &m)
+{
+    CameraModel cam;
+    const double *axes[3] = { m.r, m.d, m.f };
+    for (int i = 0; i < 3; ++i) {
+        cam.extrinsic[4 * i + 0] = axes[i][0];
+        cam.extrinsic[4 * i + 1] = axes[i][1];
+        cam.extrinsic[4 * i + 2] = axes[i][2];
+        cam.extrinsic[4 * i + 3] = -(axes[i][0] * m.c[0] + axes[i][1] * m.c[1] + axes[i][2] * m.c[2]);
+    }
+    cam.extrinsic[12] = cam.extrinsic[13] = cam.extrinsic[14] = 0.0;
+    cam.extrinsic[15] = 1.0;
+    const double K[9] = { 500.0, 0.0, 640.0, 0.0, 500.0, 360.0, 0.0, 0.0, 1.0 };
+    for (int i = 0; i < 9; ++i) cam.intrinsic[i] = K[i];
+    cam.width = W;
+    cam.height = H;
+    cam.minDepth = 0.1;
+    return cam;
+}
+
+// Ray-cast every pixel onto the ground (z = 0); the sky stays black.
+static void render(const Mount &m, int k)
+{
+    for (int v = 0; v < H; ++v) {
+        for (int u = 0; u < W; ++u) {
+            const double a = (u - 640.0) / 500.0, b = (v - 360.0) / 500.0;
+            double dir[3];
+            for (int i = 0; i < 3; ++i) dir[i] = a * m.r[i] + b * m.d[i] + m.f[i];
+            unsigned char value = 0;
+            if (dir[2] < -1e-9) {
+                const double t = -m.c[2] / dir[2];
+                value = (unsigned char)lrint(texture(m.c[0] + t * dir[0], m.c[1] + t * dir[1]));
+            }
+            const size_t i = (size_t)v * W + u;
+            g_gray[k][i] = value;
+            for (int c = 0; c < 3; ++c) g_rgb[k][3 * i + c] = value;
+            for (int c = 0; c < 4; ++c) g_rgba[k][4 * i + c] = value;
+        }
+    }
+}
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+    const double kPi = 3.141592653589793;
+    const Mount mounts[kCams] = { mount(2.0, 0.0, 0.0, 0.5), mount(0.0, 1.0, 0.5 * kPi, 0.6),
+                                  mount(-2.5, 0.0, kPi, 0.5), mount(0.0, -1.0, -0.5 * kPi, 0.6) };
+    CameraModel cams[kCams];
+    ImageU8 gray[kCams], rgb[kCams], rgba[kCams];
+    for (int k = 0; k < kCams; ++k) {
+        cams[k] = cameraFor(mounts[k]);
+        render(mounts[k], k);
+        gray[k] = ImageU8{ g_gray[k], W, H, 1, (size_t)W };
+        rgb[k] = ImageU8{ g_rgb[k], W, H, 3, (size_t)W * 3 };
+        rgba[k] = ImageU8{ g_rgba[k], W, H, 4, (size_t)W * 4 };
+    }
+
+    // 16 m x 16 m at 2 cm, ground at z = 0
+    const BevGridSpec grid = centeredBevGrid(kRows, kCols, 0.02, 0.0);
+    BevRemap remap;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (!remap.build(cams, kCams, grid, 32.0, &pool)) return fail("build", 0), 1;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const double buildMs = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count();
+
+    ImageU8 bev1{ g_bev1, (int)kCols, (int)kRows, 1, kCols }, bev3{ g_bev3, (int)kCols, (int)kRows, 3, kCols * 3 };
+    ImageU8 bev4{ g_bev4, (int)kCols, (int)kRows, 4, kCols * 4 };
+    if (!remap.warp(gray, bev1, &pool) || !remap.warp(rgb, bev3, &pool) || !remap.warp(rgba, bev4, &pool)) ok = fail("warp", 0);
+
+    // Covered cells match the ground texture
+    double sumErr = 0.0, maxErr = 0.0;
+    size_t covered = 0;
+    for (unsigned r = 0; r < kRows; ++r) {
+        for (unsigned c = 0; c < kCols; ++c) {
+            if (remap.cellCamera(r, c) < 0) {
+                if (g_bev1[r * kCols + c] != 0) ok = fail("uncovered cell not cleared", r * kCols + c);
+                continue;
+            }
+            const Point3 p = remap.cellCenter(r, c);
+            const double e = fabs(g_bev1[r * kCols + c] - texture(p.x, p.y));
+            sumErr += e;
+            maxErr = e > maxErr ? e : maxErr;
+            ++covered;
+        }
+    }
+    if (covered != remap.coveredCells() || covered < (size_t)kRows * kCols * 8 / 10) ok = fail("coverage", (double)covered);
+    if (sumErr / (double)covered > 1.0 || maxErr > 6.0) ok = fail("texture error", maxErr);
+
+    // Camera choice: front / left / rear / right of the vehicle
+    if (remap.cellCamera(20, kCols / 2) != 0 || remap.cellCamera(kRows / 2, 20) != 1 || remap.cellCamera(kRows - 20, kCols / 2) != 2 ||
+        remap.cellCamera(kRows / 2, kCols - 20) != 3) {
+        ok = fail("camera choice", remap.cellCamera(20, kCols / 2));
+    }
+    const Point3 corner = remap.cellCenter(0, 0);
+    if (fabs(corner.x - 7.99) > 1e-12 || fabs(corner.y - 7.99) > 1e-12 || corner.z != 0.0) ok = fail("cell center", corner.x);
+
+    // Channels agree exactly (scalar 1-channel vs SSE2 3/4-channel paths)
+    for (size_t i = 0; i < (size_t)kRows * kCols; ++i) {
+        if (g_bev3[3 * i] != g_bev1[i] || g_bev3[3 * i + 2] != g_bev1[i] || g_bev4[4 * i + 3] != g_bev1[i]) {
+            ok = fail("channel mismatch", (double)i);
+            break;
+        }
+    }
+
+    // Serial pool gives the same image
+    ImageU8 bevB{ g_bevB, (int)kCols, (int)kRows, 3, kCols * 3 };
+    remap.warp(rgb, bevB, &serial);
+    if (memcmp(g_bevB, g_bev3, sizeof(g_bev3)) != 0) ok = fail("thread-count determinism", 0);
+
+    // Seams: with flat per-camera images, blended cells fall between the camera values
+    for (int k = 0; k < kCams; ++k) memset(g_gray[k], 40 * (k + 1), sizeof(g_gray[k]));
+    BevRemap hard;
+    hard.build(cams, kCams, grid, 0.0, &pool);
+    size_t blendedSoft = 0, blendedHard = 0;
+    remap.warp(gray, bev1, &pool);
+    for (size_t i = 0; i < (size_t)kRows * kCols; ++i) blendedSoft += g_bev1[i] % 40 != 0;
+    hard.warp(gray, bev1, &pool);
+    for (size_t i = 0; i < (size_t)kRows * kCols; ++i) blendedHard += g_bev1[i] % 40 != 0;
+    if (blendedSoft == 0 || blendedHard != 0 || hard.coveredCells() != remap.coveredCells()) ok = fail("feathering", (double)blendedSoft);
+
+    // Argument checks
+    ImageU8 wrong[kCams];
+    for (int k = 0; k < kCams; ++k) wrong[k] = rgb[k];
+    wrong[2].width = W - 1;
+    ImageU8 small{ g_bevB, (int)kCols - 1, (int)kRows, 3, kCols * 3 };
+    if (remap.warp(wrong, bev3, &pool) || remap.warp(rgb, small, &pool) || remap.warp(gray, bev3, &pool)) ok = fail("argument checks", 0);
+    BevRemap empty;
+    if (empty.warp(rgb, bev3) || empty.build(cams, kBevMaxCameras + 1, grid)) ok = fail("empty remap", 0);
+
+    // Timing: warp of a 4-camera RGB frame set vs rebuilding the geometry
+    const int rounds = 10;
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) remap.warp(rgb, bev3, &pool);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    const double warpMs = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t3 - t2).count() / rounds;
+    std::cout << "BEV " << kRows << "x" << kCols << " from " << kCams << " RGB cameras " << W << "x" << H << ": table build "
+              << buildMs << " ms (" << remap.tableBytes() / 1024 << " KiB), warp " << warpMs << " ms, mean error "
+              << sumErr / (double)covered << " levels (" << pool.concurrency() << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "ipm tests passed\n";
+    return 0;
+}
@@ -0,0 +1,159 @@
+/* *******************************************************************************
+ * File: tests/test_multicam.cpp
+ * Description: Test the one-pass multi-camera projector against per-camera
+ *              projectPointCamera() passes on a six-camera surround rig, with
+ *              and without sector bucketing, plus overflow handling. Also
+ *              prints a small throughput comparison.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "multicam.hpp"
+#include "transformers.hpp"
+
+using namespace AdasTools;
+
+static const int N = 100000;
+static const int kCams = 6;
+static Point3 g_pts[N];
+static CameraHit g_hits[kCams][N];
+static CameraHit g_ref[kCams][N];
+
+// Camera at `pos` looking along yaw (pitched down by `pitch`), x right, y down, z forward.
+static void makeCamera(double yaw, double pitch, double px, double py, double pz, CameraModel &cam)
+{
+    double cyw = cos(yaw), syw = sin(yaw), cp = cos(pitch), sp = sin(pitch);
+    double f[3] = { cyw * cp, syw * cp, -sp };
+    double r[3] = { syw, -cyw, 0.0 };
+    double d[3] = { f[1] * r[2] - f[2] * r[1], f[2] * r[0] - f[0] * r[2], f[0] * r[1] - f[1] * r[0] };
+    const double *rows[3] = { r, d, f };
+    double p[3] = { px, py, pz };
+    for (int i = 0; i < 3; ++i) {
+        cam.extrinsic[i*4 + 0] = rows[i][0];
+        cam.extrinsic[i*4 + 1] = rows[i][1];
+        cam.extrinsic[i*4 + 2] = rows[i][2];
+        cam.extrinsic[i*4 + 3] = -(rows[i][0] * p[0] + rows[i][1] * p[1] + rows[i][2] * p[2]);
+    }
+    cam.extrinsic[12] = 0.0; cam.extrinsic[13] = 0.0; cam.extrinsic[14] = 0.0; cam.extrinsic[15] = 1.0;
+    double K[9] = { 400.0, 0.0, 320.0, 0.0, 400.0, 240.0, 0.0, 0.0, 1.0 };
+    for (int i = 0; i < 9; ++i) cam.intrinsic[i] = K[i];
+    cam.width = 640;
+    cam.height = 480;
+    cam.minDepth = 0.1;
+}
+
+static size_t referencePass(const CameraModel &cam, CameraHit *out)
+{
+    size_t count = 0;
+    for (int i = 0; i < N; ++i) {
+        Point3 uvz = projectPointCamera(g_pts[i], cam.extrinsic, cam.intrinsic);
+        if (!(uvz.z > cam.minDepth)) continue;
+        if (uvz.x < 0.0 || uvz.x >= cam.width || uvz.y < 0.0 || uvz.y >= cam.height) continue;
+        out[count].index = (unsigned int)i;
+        out[count].u = (float)uvz.x;
+        out[count].v = (float)uvz.y;
+        out[count].depth = (float)uvz.z;
+        ++count;
+    }
+    return count;
+}
+
+static bool sameHits(const CameraHitList &a, const CameraHit *ref, size_t refCount)
+{
+    if (a.count != refCount) return false;
+    for (size_t i = 0; i < refCount; ++i) {
+        if (a.hits[i].index != ref[i].index) return false;
+        if (fabs(a.hits[i].u - ref[i].u) > 1e-3f || fabs(a.hits[i].v - ref[i].v) > 1e-3f ||
+            fabs(a.hits[i].depth - ref[i].depth) > 1e-4f) return false;
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    unsigned int seed = 12345u;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        double a = (seed >> 8) * (2.0 * 3.14159265358979323846 / 16777216.0);
+        seed = seed * 1664525u + 1013904223u;
+        double r = 0.5 + 60.0 * (double)(seed >> 8) / 16777216.0;
+        seed = seed * 1664525u + 1013904223u;
+        double z = -2.0 + 6.0 * (double)(seed >> 8) / 16777216.0;
+        g_pts[i] = Point3{ r * cos(a), r * sin(a), z };
+    }
+
+    CameraModel cams[kCams];
+    const double mount[kCams][3] = { { 2.0, 0.0, 1.5 }, { 1.2, 0.9, 1.4 }, { -0.5, 0.9, 1.4 },
+                                     { -1.0, 0.0, 1.6 }, { -0.5, -0.9, 1.4 }, { 1.2, -0.9, 1.4 } };
+    for (int c = 0; c < kCams; ++c) {
+        makeCamera(c * 3.14159265358979323846 / 3.0, c == 0 ? 0.1 : 0.0, mount[c][0], mount[c][1], mount[c][2], cams[c]);
+    }
+
+    MultiCameraProjector proj;
+    if (!proj.setCameras(cams, kCams, 5.0)) { std::cerr << "FAIL setCameras\n"; return 1; }
+    CameraModel tooMany[kMultiCameraMaxCameras + 1];
+    for (size_t c = 0; c <= kMultiCameraMaxCameras; ++c) tooMany[c] = cams[0];
+    MultiCameraProjector rejected;
+    if (rejected.setCameras(tooMany, kMultiCameraMaxCameras + 1) || rejected.cameraCount() != 0) {
+        std::cerr << "FAIL too many cameras accepted\n";
+        ok = false;
+    }
+
+    // Sector masks: every sector is seen by at least one camera, none by all six.
+    for (size_t s = 0; s < kMultiCameraSectors; ++s) {
+        unsigned int m = proj.sectorMask(s);
+        if (m == 0 || m == (1u << kCams) - 1u) {
+            std::cerr << "FAIL sector " << s << " mask " << m << "\n";
+            ok = false;
+        }
+    }
+
+    size_t refCount[kCams];
+    for (int c = 0; c < kCams; ++c) refCount[c] = referencePass(cams[c], g_ref[c]);
+
+    CameraHitList lists[kCams];
+    for (int bucketing = 0; bucketing < 2; ++bucketing) {
+        proj.setBucketing(bucketing != 0);
+        for (int c = 0; c < kCams; ++c) lists[c] = CameraHitList{ g_hits[c], (size_t)N, 0, 0 };
+        size_t total = proj.project(g_pts, N, lists);
+        size_t expect = 0;
+        for (int c = 0; c < kCams; ++c) {
+            expect += refCount[c];
+            if (!sameHits(lists[c], g_ref[c], refCount[c])) {
+                std::cerr << "FAIL camera " << c << " bucketing " << bucketing << ": " << lists[c].count << " vs " << refCount[c] << "\n";
+                ok = false;
+            }
+        }
+        if (total != expect) { std::cerr << "FAIL total " << total << " vs " << expect << "\n"; ok = false; }
+    }
+
+    // Overflow: hits beyond capacity are counted, not written.
+    for (int c = 0; c < kCams; ++c) lists[c] = CameraHitList{ g_hits[c], 10, 0, 0 };
+    proj.project(g_pts, N, lists);
+    for (int c = 0; c < kCams; ++c) {
+        if (lists[c].count != (refCount[c] < 10 ? refCount[c] : 10) || lists[c].count + lists[c].overflow != refCount[c]) {
+            std::cerr << "FAIL overflow camera " << c << "\n";
+            ok = false;
+        }
+    }
+
+    // Throughput: six projectPointCamera passes vs. one bucketed sweep.
+    for (int c = 0; c < kCams; ++c) lists[c] = CameraHitList{ g_hits[c], (size_t)N, 0, 0 };
+    const int rounds = 10;
+    size_t sink = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) for (int c = 0; c < kCams; ++c) sink += referencePass(cams[c], g_ref[c]);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) sink += proj.project(g_pts, N, lists);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double passNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count() / (rounds * (double)N);
+    double sweepNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t2 - t1).count() / (rounds * (double)N);
+    std::cout << "ns/point for " << kCams << " cameras: per-camera passes " << passNs << ", one-pass projector " << sweepNs << "\n";
+    if (sink == 1) std::cout << "";
+
+    if (!ok) return 1;
+    std::cout << "multicam tests passed\n";
+    return 0;
+}
@@ -0,0 +1,168 @@
+/* *******************************************************************************
+ * File: tests/test_poselog.cpp
+ * Description: Test pose log I/O: exact CSV and binary round trips, the
+ *              number parser against strtod, header/malformed/over-long line
+ *              handling, index seeks, footer-less binary logs, the read
+ *              probe's record count and loading into a Trajectory. Also
+ *              prints CSV parse throughput vs. sscanf.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "instrumentation.hpp"
+#include "poselog.hpp"
+#include "trajectory.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 50000;
+static StampedPose g_in[N], g_out[N];
+
+static bool samePose(const StampedPose &a, const StampedPose &b)
+{
+    return a.stamp == b.stamp && a.pose.x == b.pose.x && a.pose.y == b.pose.y && a.pose.z == b.pose.z &&
+           a.pose.roll == b.pose.roll && a.pose.pitch == b.pose.pitch && a.pose.yaw == b.pose.yaw;
+}
+
+static bool roundTrip(const char *path, PoseLogFormat format)
+{
+    PoseLogWriter w;
+    if (!w.open(path, format) || !w.write(g_in, N) || !w.close()) return fail("write log");
+    PoseLogReader r;
+    if (!r.open(path) || r.format() != format) return fail("open log");
+    size_t total = 0, n;
+    profileReset();
+    while ((n = r.read(g_out + total, 777)) > 0) total += n;
+    if (total != (size_t)N) return fail("record count");
+    ProfileSnapshot snap;
+    profileSnapshot(snap);
+    if (snap.probes[PROBE_POSE_LOG_READ].points != (profileEnabled() ? (unsigned long long)N : 0ull)) {
+        return fail("read probe counts records, not capacity");
+    }
+    for (int i = 0; i < N; ++i) if (!samePose(g_in[i], g_out[i])) return fail("record mismatch");
+
+    // Seek to an exact stamp, between stamps and past the end
+    StampedPose s;
+    if (!r.seek(g_in[31337].stamp) || r.read(&s, 1) != 1 || !samePose(s, g_in[31337])) return fail("seek exact");
+    if (!r.seek(g_in[5000].stamp + 1e-4) || r.read(&s, 1) != 1 || !samePose(s, g_in[5001])) return fail("seek between");
+    if (r.read(&s, 1) != 1 || !samePose(s, g_in[5002])) return fail("read after seek");
+    if (r.seek(g_in[N - 1].stamp + 1.0)) return fail("seek past end");
+    if (!r.seek(-1.0) || r.read(&s, 1) != 1 || !samePose(s, g_in[0])) return fail("seek before start");
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    for (int i = 0; i < N; ++i) {
+        double t = 1.7e9 + 0.01 * i;
+        g_in[i].stamp = t;
+        g_in[i].pose = Pose{ 100.0 * sin(1e-3 * i), -3.25 + 1e-4 * i, 1.0 / 3.0, 1e-5 * i, -0.5 * cos(1e-2 * i), (i % 7) * 0.125 };
+    }
+
+    // Number parser agrees with strtod
+    const char *samples[] = { "0", "-0.0", "3.14159", "1e-3", "-2.5E+10", "0.000123456789012345678",
+                              "123456789012345678901234", "1.7976931348623157e308", "4.9e-324", "  42,", "inf", "-nan" };
+    for (const char *text : samples) {
+        const char *p = text;
+        double v = 0.0;
+        double ref = strtod(text, nullptr);
+        if (!parsePoseLogNumber(p, text + strlen(text), v) || (v != ref && !(isnan(v) && isnan(ref)))) {
+            std::cerr << "FAIL parse " << text << "\n";
+            ok = false;
+        }
+    }
+    const char *bad = "abc";
+    double dummy;
+    if (parsePoseLogNumber(bad, bad + 3, dummy)) ok = fail("parse rejects text");
+
+    ok = roundTrip("test_poselog.csv", POSE_LOG_CSV) && ok;
+    ok = roundTrip("test_poselog.bin", POSE_LOG_BINARY) && ok;
+
+    // Hand-written CSV: column header, comments, blank/CRLF lines, one bad line
+    FILE *f = fopen("test_poselog_hand.csv", "w");
+    fputs("stamp,x,y,z,roll,pitch,yaw\n# comment\n\n1.0,1,2,3,0.1,0.2,0.3\r\n"
+          "2.0, 4 ,5,6,0,0,0\nbroken line\n3.0,7,8,9,0,0,1e-1", f);
+    fclose(f);
+    PoseLogReader hand;
+    StampedPose rec[4];
+    if (!hand.open("test_poselog_hand.csv") || hand.read(rec, 4) != 3 || hand.malformedLines() != 1 ||
+        rec[1].pose.x != 4.0 || rec[2].pose.yaw != 0.1 || rec[0].pose.roll != 0.1) {
+        ok = fail("hand-written CSV");
+    }
+    // CSV seeks rescan from the start without counting malformed lines twice
+    if (!hand.seek(3.0) || !hand.seek(3.0) || hand.malformedLines() != 1) ok = fail("malformed count after seek");
+
+    // Lines longer than the read buffer are rejected whole, not split into records
+    // (the tail of each over-long line below would parse as a pose on its own)
+    f = fopen("test_poselog_long.csv", "w");
+    fputs("1.0,1,2,3,0,0,0\n", f);
+    for (int k = 0; k < 2; ++k) {
+        for (size_t i = 0; i < kPoseLogBufferSize + 1000; ++i) fputc(' ', f);
+        fputs(k ? "9.0,1,2,3,0,0,0" : "5.0,1,2,3,0,0,0\n2.0,4,5,6,0,0,0\n", f);
+    }
+    fclose(f);
+    PoseLogReader longLines;
+    if (!longLines.open("test_poselog_long.csv") || longLines.read(rec, 4) != 2 || longLines.malformedLines() != 2 ||
+        rec[0].stamp != 1.0 || rec[1].stamp != 2.0) {
+        ok = fail("over-long CSV lines");
+    }
+
+    // Binary log without footer (writer killed): drop the index and trailer
+    f = fopen("test_poselog.bin", "rb");
+    FILE *g = fopen("test_poselog_nofooter.bin", "wb");
+    static char copy[32 + 1000 * sizeof(StampedPose) + 20];
+    size_t got = fread(copy, 1, sizeof(copy), f);
+    fwrite(copy, 1, got, g);
+    fclose(f);
+    fclose(g);
+    PoseLogReader partial;
+    if (!partial.open("test_poselog_nofooter.bin") || partial.recordCount() != 1000 ||
+        !partial.seek(g_in[500].stamp) || partial.read(rec, 1) != 1 || !samePose(rec[0], g_in[500])) {
+        ok = fail("footer-less binary");
+    }
+
+    // Load into a trajectory
+    Trajectory traj;
+    if (loadPoseLog("test_poselog.bin", traj) != N || traj.size() != (size_t)N || traj.stamp(N - 1) != g_in[N - 1].stamp) {
+        ok = fail("loadPoseLog");
+    }
+    if (loadPoseLog("does_not_exist.csv", traj) != -1) ok = fail("loadPoseLog missing file");
+
+    // Throughput: reader vs. fgets + sscanf on the same CSV
+    PoseLogReader r;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    r.open("test_poselog.csv");
+    size_t total = 0, n;
+    while ((n = r.read(g_out, 1024)) > 0) total += n;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    f = fopen("test_poselog.csv", "r");
+    char line[512];
+    size_t scanned = 0;
+    while (fgets(line, sizeof(line), f)) {
+        StampedPose s;
+        if (sscanf(line, "%lf,%lf,%lf,%lf,%lf,%lf,%lf", &s.stamp, &s.pose.x, &s.pose.y, &s.pose.z,
+                   &s.pose.roll, &s.pose.pitch, &s.pose.yaw) == 7) ++scanned;
+    }
+    fclose(f);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double readerNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count() / N;
+    double scanfNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t2 - t1).count() / N;
+    std::cout << "CSV ns/pose: PoseLogReader " << readerNs << ", fgets+sscanf " << scanfNs << "\n";
+    if (total != scanned) ok = fail("reader/sscanf count");
+
+    remove("test_poselog.csv");
+    remove("test_poselog.bin");
+    remove("test_poselog_hand.csv");
+    remove("test_poselog_long.csv");
+    remove("test_poselog_nofooter.bin");
+
+    if (!ok) return 1;
+    std::cout << "poselog tests passed\n";
+    return 0;
+}
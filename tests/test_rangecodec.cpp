@@ -0,0 +1,130 @@
+/* *******************************************************************************
+ * File: tests/test_rangecodec.cpp
+ * Description: Test the range-image codec on a synthetic 128 x 2048 sweep:
+ *              quantized round trip within half a step, bit-exact lossless
+ *              mode (NaN and negative values included), intensities, odd
+ *              sizes and many blocks, identical streams for any thread count,
+ *              and rejection of truncated or foreign data. Also prints the
+ *              compression ratio and encode/decode times.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include "rangecodec.hpp"
+#include "parallel.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const unsigned kRows = 128, kCols = 2048;
+static float g_range[kRows * kCols], g_back[kRows * kCols];
+static unsigned char g_int[kRows * kCols], g_intBack[kRows * kCols];
+static unsigned char g_a[8 << 20], g_b[8 << 20];
+
+static TestRng g_rng{ 17u };
+
+// Ground at z = -1.8 m and a wavy wall around the sensor; mm noise and 3 % dropouts.
+static void makeSweep(unsigned rows, unsigned cols)
+{
+    for (unsigned r = 0; r < rows; ++r) {
+        const double el = (-25.0 + 40.0 * r / (rows - 1)) * 3.141592653589793 / 180.0;
+        for (unsigned c = 0; c < cols; ++c) {
+            const double az = 6.283185307179586 * c / cols;
+            const double wall = (30.0 + 10.0 * sin(3.0 * az)) / cos(el);
+            const double ground = el < 0.0 ? 1.8 / sin(-el) : 1e9;
+            const bool onGround = ground < wall;
+            double range = (onGround ? ground : wall) + 0.003 * (g_rng.uniform() - 0.5);
+            if (g_rng.uniform() < 0.03) range = 0.0;
+            g_range[r * cols + c] = (float)range;
+            g_int[r * cols + c] = (unsigned char)(onGround ? 20 + (int)(8.0 * g_rng.uniform()) : 120 + (int)(30.0 * g_rng.uniform()));
+        }
+    }
+}
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+    makeSweep(kRows, kCols);
+    RangeImage image{ kRows, kCols, g_range, g_int };
+    RangeImage back{ kRows, kCols, g_back, g_intBack };
+
+    // Quantized (1 mm) with intensities
+    RangeCodecConfig config = defaultRangeCodecConfig();
+    config.intensity = true;
+    const size_t bound = rangeImageEncodedBound(kRows, kCols, config);
+    if (bound > sizeof(g_a)) return fail("bound", (double)bound), 1;
+    const size_t bytes = encodeRangeImage(image, config, g_a, bound, &pool);
+    if (bytes == 0 || !decodeRangeImage(g_a, bytes, back, &pool)) ok = fail("quantized round trip", (double)bytes);
+    for (unsigned i = 0; i < kRows * kCols && ok; ++i) {
+        if (fabs((double)g_back[i] - (double)g_range[i]) > 0.0005 + 1e-5 * g_range[i] || (g_range[i] == 0.0f) != (g_back[i] == 0.0f)) {
+            ok = fail("quantized range", i);
+        }
+        if (g_intBack[i] != g_int[i]) ok = fail("intensity", i);
+    }
+    RangeImageInfo info;
+    if (!rangeImageInfo(g_a, bytes, info) || info.rows != kRows || info.cols != kCols || info.precision != 0.001 || !info.intensity) {
+        ok = fail("info", 0);
+    }
+    const double ratio = (double)(kRows * kCols * 5) / (double)bytes;
+
+    // Same stream from a serial pool; ranges-only decode of a stream with intensities
+    const size_t bytes2 = encodeRangeImage(image, config, g_b, bound, &serial);
+    if (bytes2 != bytes || memcmp(g_a, g_b, bytes) != 0) ok = fail("thread-count determinism", (double)bytes2);
+    RangeImage rangesOnly{ kRows, kCols, g_back, nullptr };
+    if (!decodeRangeImage(g_a, bytes, rangesOnly, &serial)) ok = fail("ranges-only decode", 0);
+
+    // Lossless: bit-exact, including values the quantizer would drop
+    g_range[5] = -3.5f;
+    g_range[77] = nanf("");
+    g_range[1000] = 1e30f;
+    RangeCodecConfig exact = defaultRangeCodecConfig();
+    exact.precision = 0.0;
+    const size_t exactBytes = encodeRangeImage(image, exact, g_b, sizeof(g_b), &pool);
+    if (exactBytes == 0 || !decodeRangeImage(g_b, exactBytes, back, &pool) || memcmp(g_back, g_range, sizeof(g_range)) != 0) {
+        ok = fail("lossless round trip", (double)exactBytes);
+    }
+    const size_t qBytes = encodeRangeImage(image, config, g_a, bound, &pool);
+    decodeRangeImage(g_a, qBytes, back, &pool);
+    if (g_back[5] != 0.0f || g_back[77] != 0.0f || g_back[1000] != (float)(2147483647.0 * 0.001)) ok = fail("invalid ranges", g_back[5]);
+
+    // Odd sizes, one row per block (> 256 blocks), coarse steps
+    const unsigned rows = 260, cols = 1001;
+    makeSweep(rows, cols);
+    RangeImage odd{ rows, cols, g_range, g_int }, oddBack{ rows, cols, g_back, g_intBack };
+    RangeCodecConfig coarse{ 0.02, 1, true };
+    const size_t oddBytes = encodeRangeImage(odd, coarse, g_a, sizeof(g_a), &pool);
+    if (oddBytes == 0 || !decodeRangeImage(g_a, oddBytes, oddBack, &pool)) ok = fail("odd sizes", (double)oddBytes);
+    for (unsigned i = 0; i < rows * cols && ok; ++i) {
+        if (fabs((double)g_back[i] - (double)g_range[i]) > 0.01 + 1e-5 * g_range[i] || g_intBack[i] != g_int[i]) ok = fail("odd sizes value", i);
+    }
+
+    // Bad input
+    if (decodeRangeImage(g_a, oddBytes - 1, oddBack, &pool) || decodeRangeImage(g_a, 40, oddBack, &pool)) ok = fail("truncated stream", 0);
+    if (decodeRangeImage(g_a, oddBytes, back, &pool)) ok = fail("size mismatch", 0);
+    g_a[0] = 'X';
+    if (rangeImageInfo(g_a, oddBytes, info) || decodeRangeImage(g_a, oddBytes, oddBack, &pool)) ok = fail("bad magic", 0);
+    if (encodeRangeImage(odd, coarse, g_a, rangeImageEncodedBound(rows, cols, coarse) - 1, &pool) != 0) ok = fail("capacity", 0);
+
+    // Timing: one 128 x 2048 sweep (a 10 Hz sensor delivers one every 100 ms)
+    makeSweep(kRows, kCols);
+    const int rounds = 10;
+    size_t enc = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) enc = encodeRangeImage(image, config, g_a, bound, &pool);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) decodeRangeImage(g_a, enc, back, &pool);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    const double encMs = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count() / rounds;
+    const double decMs = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t2 - t1).count() / rounds;
+    std::cout << "range image " << kRows << "x" << kCols << " (1 mm + intensity): " << bytes << " bytes, ratio " << ratio
+              << " vs float+u8, lossless " << exactBytes << " bytes; encode " << encMs << " ms, decode " << decMs
+              << " ms (" << pool.concurrency() << " threads)\n";
+    if (ratio < 2.0) ok = fail("compression ratio", ratio);
+
+    if (!ok) return 1;
+    std::cout << "rangecodec tests passed\n";
+    return 0;
+}
@@ -0,0 +1,215 @@
+/* *******************************************************************************
+ * File: tests/test_raycast.cpp
+ * Description: Test DDA ray casting against brute-force ray/box intersection
+ *              with every occupied voxel: first hits from inside and outside
+ *              the grid, visibility of points, free-space carving, identical
+ *              results for any thread count. Also prints the time for 100k
+ *              rays against fixed-step ray marching.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include "raycast.hpp"
+#include "parallel.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const size_t kRays = 100000;
+static Point3 g_dirs[kRays];
+static double g_range[kRays], g_range2[kRays];
+static unsigned int g_voxel[kRays], g_voxel2[kRays];
+static unsigned char g_visible[kRays];
+static unsigned int g_occupied[1 << 16];
+
+static TestRng g_rng{ 17u };
+
+// Entry distance of the ray o + t d (|d| = 1) into the voxel's box, or -1 if it misses within [0, tMax]
+static double boxEntry(const VoxelGrid &grid, unsigned int voxel, const Point3 &o, const double d[3], double tMax)
+{
+    const Point3 c = grid.voxelCenter(voxel);
+    const double h = 0.5 * grid.spec().resolution;
+    const double lo[3] = { c.x - h, c.y - h, c.z - h }, hi[3] = { c.x + h, c.y + h, c.z + h }, p[3] = { o.x, o.y, o.z };
+    double t0 = 0.0, t1 = tMax;
+    for (int a = 0; a < 3; ++a) {
+        if (d[a] == 0.0) {
+            if (p[a] < lo[a] || p[a] >= hi[a]) return -1.0;
+            continue;
+        }
+        double ta = (lo[a] - p[a]) / d[a], tb = (hi[a] - p[a]) / d[a];
+        if (ta > tb) { const double x = ta; ta = tb; tb = x; }
+        if (ta > t0) t0 = ta;
+        if (tb < t1) t1 = tb;
+    }
+    return t0 <= t1 ? t0 : -1.0;
+}
+
+// Brute force first hit: nearest entry over all occupied voxels except `skip`
+static double bruteHit(const VoxelGrid &grid, size_t occupied, unsigned int skip, const Point3 &o, const Point3 &dir,
+                       double tMax, unsigned int &voxel)
+{
+    const double len = sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+    const double d[3] = { dir.x / len, dir.y / len, dir.z / len };
+    double best = tMax;
+    voxel = kNoVoxel;
+    for (size_t k = 0; k < occupied; ++k) {
+        if (g_occupied[k] == skip) continue;
+        const double t = boxEntry(grid, g_occupied[k], o, d, tMax);
+        if (t >= 0.0 && (t < best || (t == best && voxel == kNoVoxel))) {
+            best = t;
+            voxel = g_occupied[k];
+        }
+    }
+    return best;
+}
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+
+    // 48 x 40 x 12 voxels of 0.25 m, ~3 % occupied
+    VoxelGrid grid;
+    if (!grid.init(centeredVoxelGrid(0.0, 0.0, -1.0, 0.25, 48, 40, 12))) return fail("init", 0), 1;
+    size_t occupied = 0;
+    for (unsigned int i = 0; i < grid.voxelCount(); ++i) {
+        if (g_rng.uniform() >= 0.03) continue;
+        const Point3 c = grid.voxelCenter(i);
+        if (grid.insertPoints(&c, 1) != 1 || grid.voxelIndex(c) != i) ok = fail("voxel index", (double)i);
+        g_occupied[occupied++] = i;
+    }
+
+    // First hits from inside (origin voxel skipped) and from outside the grid. Origins off the
+    // 0.05 m lattice of the voxel centers, so no test ray passes exactly through a voxel edge.
+    const Point3 origins[2] = { { 0.1037, -0.2113, 0.4171 }, { -9.0, 1.3, 0.2 } };
+    const size_t nr = 3000;
+    for (int o = 0; o < 2; ++o) {
+        for (size_t i = 0; i < nr; ++i) g_dirs[i] = Point3{ g_rng.uniform() - 0.5 + (o ? 0.6 : 0.0), g_rng.uniform() - 0.5, 0.3 * (g_rng.uniform() - 0.5) };
+        g_dirs[0] = Point3{ 1.0, 0.0, 0.0 }; // axis-aligned
+        g_dirs[1] = Point3{ 0.0, 0.0, -1.0 };
+        const size_t hits = castRays(grid, origins[o], g_dirs, nr, 30.0, g_range, g_voxel, &pool);
+        const unsigned int skip = grid.voxelIndex(origins[o]);
+        size_t bruteHits = 0, mismatches = 0;
+        for (size_t i = 0; i < nr; ++i) {
+            unsigned int v;
+            const double t = bruteHit(grid, occupied, skip, origins[o], g_dirs[i], 30.0, v);
+            bruteHits += v != kNoVoxel;
+            if (v != g_voxel[i] || fabs(t - g_range[i]) > 1e-9) ++mismatches;
+        }
+        if (hits != bruteHits || mismatches != 0) ok = fail(o ? "hits from outside" : "hits from inside", (double)mismatches);
+
+        castRays(grid, origins[o], g_dirs, nr, 30.0, g_range2, g_voxel2, &serial);
+        if (memcmp(g_range, g_range2, nr * sizeof(double)) != 0 || memcmp(g_voxel, g_voxel2, nr * sizeof(unsigned)) != 0) {
+            ok = fail("thread-count determinism", (double)o);
+        }
+    }
+    // Short range: nothing beyond maxRange
+    castRays(grid, origins[0], g_dirs, nr, 0.6, g_range, g_voxel, &pool);
+    for (size_t i = 0; i < nr && ok; ++i) {
+        if (g_range[i] > 0.6 || (g_voxel[i] == kNoVoxel && g_range[i] != 0.6)) ok = fail("max range", g_range[i]);
+    }
+
+    // Visibility of voxel centers: occluded iff an occupied voxel other than the target's is entered first
+    Point3 targets[2000];
+    const Point3 eye = origins[0];
+    for (int i = 0; i < 2000; ++i) {
+        targets[i] = grid.voxelCenter((i % 2) ? g_occupied[i % occupied] : (unsigned int)(g_rng.uniform() * grid.voxelCount()));
+    }
+    const size_t nvis = checkVisibility(grid, eye, targets, 2000, g_visible, &pool);
+    size_t bruteVisible = 0;
+    for (int i = 0; i < 2000; ++i) {
+        const Point3 dir{ targets[i].x - eye.x, targets[i].y - eye.y, targets[i].z - eye.z };
+        const double len = sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+        const unsigned int target = grid.voxelIndex(targets[i]), skip = grid.voxelIndex(eye);
+        bool clear = true;
+        if (len > 0.0) {
+            const double d[3] = { dir.x / len, dir.y / len, dir.z / len };
+            for (size_t k = 0; k < occupied && clear; ++k) {
+                if (g_occupied[k] == target || g_occupied[k] == skip) continue;
+                // stop at the target's own voxel
+                const double tTarget = boxEntry(grid, target, eye, d, len);
+                const double t = boxEntry(grid, g_occupied[k], eye, d, len);
+                if (t >= 0.0 && t < tTarget) clear = false;
+            }
+        }
+        bruteVisible += clear;
+        if ((g_visible[i] != 0) != clear) ok = fail("visibility", (double)i);
+    }
+    if (nvis != bruteVisible || nvis == 0 || nvis == 2000) ok = fail("visible count", (double)nvis);
+
+    // Carving: every voxel crossed before a target's own voxel is marked free, nothing else;
+    // occupancy bits untouched, same grid for any thread count
+    VoxelGrid carved, carved2, reference;
+    carved.init(grid.spec());
+    carved2.init(grid.spec());
+    reference.init(grid.spec());
+    carved.insertPoints(targets, 2000);
+    carved2.insertPoints(targets, 2000);
+    reference.insertPoints(targets, 2000);
+    const size_t visits = carveFreeSpace(carved, eye, targets, 500, &pool);
+    if (carveFreeSpace(carved2, eye, targets, 500, &serial) != visits || memcmp(carved.data(), carved2.data(), carved.voxelCount()) != 0) {
+        ok = fail("carve determinism", (double)visits);
+    }
+    size_t wrong = 0, freeVoxels = 0;
+    for (unsigned int v = 0; v < carved.voxelCount(); ++v) {
+        bool crossed = false;
+        for (int i = 0; i < 500 && !crossed; ++i) {
+            const Point3 dir{ targets[i].x - eye.x, targets[i].y - eye.y, targets[i].z - eye.z };
+            const double len = sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+            const unsigned int target = carved.voxelIndex(targets[i]);
+            if (!(len > 0.0) || v == target) continue;
+            const double d[3] = { dir.x / len, dir.y / len, dir.z / len };
+            const double t = boxEntry(carved, v, eye, d, len);
+            crossed = t >= 0.0 && t < boxEntry(carved, target, eye, d, len);
+        }
+        const bool isFree = (carved.data()[v] & VOXEL_FREE) != 0;
+        freeVoxels += isFree;
+        wrong += isFree != crossed;
+        wrong += carved.occupied(v) != reference.occupied(v);
+    }
+    if (wrong != 0 || freeVoxels == 0 || visits < freeVoxels) ok = fail("carving", (double)wrong);
+
+    // Argument checks
+    VoxelGrid empty;
+    VoxelGridSpec bad = grid.spec();
+    bad.resolution = 0.0;
+    if (empty.init(bad) || castRays(empty, eye, g_dirs, 10, 1.0, g_range) != 0 || grid.voxelIndex(Point3{ 100.0, 0.0, 0.0 }) != kNoVoxel) {
+        ok = fail("argument checks", 0);
+    }
+
+    // Timing: 100k rays over 40 m in a 200 x 200 x 20 grid of 0.2 m, 1 % occupied
+    VoxelGrid big;
+    big.init(centeredVoxelGrid(0.0, 0.0, -1.0, 0.2, 200, 200, 20));
+    for (size_t i = 0; i < big.voxelCount(); ++i) big.data()[i] = g_rng.uniform() < 0.01 ? VOXEL_OCCUPIED : 0;
+    for (size_t i = 0; i < kRays; ++i) {
+        const double a = 6.283185307179586 * g_rng.uniform();
+        g_dirs[i] = Point3{ cos(a), sin(a), 0.1 * (g_rng.uniform() - 0.5) };
+    }
+    const Point3 sensor{ 0.3, 0.1, 0.9 };
+    auto t0 = std::chrono::high_resolution_clock::now();
+    const size_t hits = castRays(big, sensor, g_dirs, kRays, 40.0, g_range, nullptr, &pool);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    // Fixed-step marching at a quarter voxel, one ray at a time
+    const unsigned int sensorVoxel = big.voxelIndex(sensor);
+    size_t marched = 0;
+    for (size_t i = 0; i < kRays; ++i) {
+        const double len = sqrt(g_dirs[i].x * g_dirs[i].x + g_dirs[i].y * g_dirs[i].y + g_dirs[i].z * g_dirs[i].z);
+        for (double t = 0.0; t < 40.0; t += 0.05) {
+            const unsigned int v = big.voxelIndex(Point3{ sensor.x + t * g_dirs[i].x / len, sensor.y + t * g_dirs[i].y / len,
+                                                          sensor.z + t * g_dirs[i].z / len });
+            if (v == kNoVoxel) break;
+            if (v != sensorVoxel && big.occupied(v)) { ++marched; break; }
+        }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "castRays " << kRays << " rays (" << hits << " hits): "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count()
+              << " ms, fixed-step marching " << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t2 - t1).count()
+              << " ms (" << marched << " hits, " << pool.concurrency() << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "raycast tests passed\n";
+    return 0;
+}
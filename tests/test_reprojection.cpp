@@ -0,0 +1,198 @@
+/* *******************************************************************************
+ * File: tests/test_reprojection.cpp
+ * Description: Test batch reprojection evaluation: residuals against
+ *              projectPointCamera(), pose and intrinsic Jacobians against
+ *              central differences, statistics, points behind the camera,
+ *              identical results for any thread count, and a Gauss-Newton
+ *              calibration recovery driven by the Jacobians. Also prints the
+ *              time for 200k correspondences.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "reprojection.hpp"
+#include "arena.hpp"
+#include "parallel.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 200000;
+static ImageCorrespondence g_c[N];
+static double g_res[2 * N], g_res2[2 * N], g_jp[12 * N], g_jk[10 * N];
+static unsigned char g_valid[N];
+
+static TestRng g_rng{ 3u };
+
+// Lidar (x forward, z up) to camera (z forward, y down), mounted 1.5 m forward and slightly rotated.
+static const Pose kExtrinsic{ 0.05, 0.3, -1.5, -1.5707963267948966 + 0.01, 0.02, -1.5707963267948966 - 0.015 };
+static const double kK[9] = { 1000.0, 0.5, 960.0, 0.0, 990.0, 540.0, 0.0, 0.0, 1.0 };
+
+static Point3 project(const Point3 &p, const Pose &e, const double K[9])
+{
+    double E[16];
+    poseToMatrix(e, E);
+    return projectPointCamera(p, E, K);
+}
+
+static void makeCorrespondences(int n, double noise)
+{
+    double E[16], Einv[16];
+    poseToMatrix(kExtrinsic, E);
+    rigidInverse(E, Einv);
+    for (int i = 0; i < n; ++i) {
+        // camera-frame point inside the image, then back to the lidar frame
+        const double z = (i % 100) == 0 ? -5.0 : 3.0 + 37.0 * g_rng.uniform();
+        const double x = (1920.0 * g_rng.uniform() - 960.0) / 1000.0 * fabs(z), y = (1080.0 * g_rng.uniform() - 540.0) / 990.0 * fabs(z);
+        const Point3 p = rigidTransformPoint(Einv, Point3{ x, y, z });
+        const Point3 uv = projectPointCamera(p, E, kK);
+        g_c[i].point = p;
+        g_c[i].u = uv.x + noise * (g_rng.uniform() - 0.5);
+        g_c[i].v = uv.y + noise * (g_rng.uniform() - 0.5);
+    }
+}
+
+// Solve A x = b (11x11) by Gaussian elimination with partial pivoting.
+static bool solve11(double A[121], double b[11])
+{
+    for (int c = 0; c < 11; ++c) {
+        int piv = c;
+        for (int r = c + 1; r < 11; ++r) if (fabs(A[r * 11 + c]) > fabs(A[piv * 11 + c])) piv = r;
+        if (fabs(A[piv * 11 + c]) < 1e-300) return false;
+        for (int k = 0; k < 11; ++k) { const double t = A[c * 11 + k]; A[c * 11 + k] = A[piv * 11 + k]; A[piv * 11 + k] = t; }
+        const double t = b[c]; b[c] = b[piv]; b[piv] = t;
+        for (int r = c + 1; r < 11; ++r) {
+            const double f = A[r * 11 + c] / A[c * 11 + c];
+            for (int k = c; k < 11; ++k) A[r * 11 + k] -= f * A[c * 11 + k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = 10; r >= 0; --r) {
+        double s = b[r];
+        for (int k = r + 1; k < 11; ++k) s -= A[r * 11 + k] * b[k];
+        b[r] = s / A[r * 11 + r];
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    TaskPool pool(3), serial(0);
+    FrameArena arena;
+    arena.reserve(1 << 20);
+    makeCorrespondences(N, 1.0);
+
+    ReprojectionOutputs out{ g_res, g_jp, g_jk, g_valid };
+    ReprojectionStats stats;
+    if (!evaluateReprojection(g_c, N, kExtrinsic, kK, out, stats, 1e-6, &arena, &pool)) ok = fail("evaluate", 0);
+    if (arena.used() != 0) ok = fail("scratch not rewound", (double)arena.used());
+
+    // Residuals, validity and statistics
+    double sumSq = 0.0, maxErr = 0.0;
+    size_t valid = 0;
+    for (int i = 0; i < N && ok; ++i) {
+        const Point3 uv = project(g_c[i].point, kExtrinsic, kK);
+        if (uv.z <= 1e-6) {
+            if (g_valid[i] || g_res[2 * i] != 0.0 || g_jp[12 * i + 3] != 0.0) ok = fail("invalid point", i);
+            continue;
+        }
+        ++valid;
+        const double du = uv.x - g_c[i].u, dv = uv.y - g_c[i].v;
+        if (!g_valid[i] || fabs(g_res[2 * i] - du) > 1e-8 || fabs(g_res[2 * i + 1] - dv) > 1e-8) ok = fail("residual", i);
+        sumSq += du * du + dv * dv;
+        maxErr = sqrt(du * du + dv * dv) > maxErr ? sqrt(du * du + dv * dv) : maxErr;
+    }
+    if (stats.valid != valid || valid != (size_t)N - N / 100) ok = fail("valid count", (double)stats.valid);
+    if (fabs(stats.rms - sqrt(sumSq / (double)valid)) > 1e-9 || fabs(stats.max - maxErr) > 1e-9) ok = fail("stats", stats.rms);
+    if (stats.maxIndex >= (size_t)N || fabs(sqrt(g_res[2 * stats.maxIndex] * g_res[2 * stats.maxIndex] +
+                                                 g_res[2 * stats.maxIndex + 1] * g_res[2 * stats.maxIndex + 1]) - stats.max) > 1e-12) {
+        ok = fail("maxIndex", (double)stats.maxIndex);
+    }
+
+    // Jacobians vs central differences
+    for (int i = 1; i < 200 && ok; i += 7) {
+        const double h = 1e-6;
+        for (int k = 0; k < 6; ++k) {
+            Pose a = kExtrinsic, b = kExtrinsic;
+            double *pa = &a.x, *pb = &b.x;
+            pa[k] += h;
+            pb[k] -= h;
+            const Point3 ua = project(g_c[i].point, a, kK), ub = project(g_c[i].point, b, kK);
+            const double du = (ua.x - ub.x) / (2.0 * h), dv = (ua.y - ub.y) / (2.0 * h);
+            if (fabs(du - g_jp[12 * i + k]) > 1e-4 * (1.0 + fabs(du)) || fabs(dv - g_jp[12 * i + 6 + k]) > 1e-4 * (1.0 + fabs(dv))) {
+                ok = fail("pose jacobian", k);
+            }
+        }
+        const int slot[5] = { 0, 4, 2, 5, 1 }; // fx, fy, cx, cy, s in K
+        for (int k = 0; k < 5; ++k) {
+            double Ka[9], Kb[9];
+            for (int j = 0; j < 9; ++j) Ka[j] = Kb[j] = kK[j];
+            Ka[slot[k]] += 1e-3;
+            Kb[slot[k]] -= 1e-3;
+            const Point3 ua = project(g_c[i].point, kExtrinsic, Ka), ub = project(g_c[i].point, kExtrinsic, Kb);
+            const double du = (ua.x - ub.x) / 2e-3, dv = (ua.y - ub.y) / 2e-3;
+            if (fabs(du - g_jk[10 * i + k]) > 1e-6 || fabs(dv - g_jk[10 * i + 5 + k]) > 1e-6) ok = fail("intrinsic jacobian", k);
+        }
+    }
+
+    // Matrix overload, other thread count, heap scratch, residuals only
+    double E[16];
+    poseToMatrix(kExtrinsic, E);
+    ReprojectionStats stats2;
+    ReprojectionOutputs resOnly{ g_res2, nullptr, nullptr, nullptr };
+    evaluateReprojection(g_c, N, E, kK, resOnly, stats2, 1e-6, nullptr, &serial);
+    if (stats2.valid != stats.valid || fabs(stats2.rms - stats.rms) > 1e-9 || stats2.maxIndex != stats.maxIndex) {
+        ok = fail("matrix overload", stats2.rms - stats.rms);
+    }
+    evaluateReprojection(g_c, N, kExtrinsic, kK, resOnly, stats2, 1e-6, &arena, &serial);
+    if (stats2.rms != stats.rms || stats2.mean != stats.mean || stats2.max != stats.max) ok = fail("thread-count determinism", 0);
+    for (int i = 0; i < 2 * N; ++i) {
+        if (g_res2[i] != g_res[i]) { ok = fail("serial residuals", i); break; }
+    }
+
+    // Gauss-Newton on pose + intrinsics from a perturbed start (noise-free data)
+    const int M = 2000;
+    makeCorrespondences(M, 0.0);
+    Pose pose = kExtrinsic;
+    pose.x += 0.05; pose.y -= 0.04; pose.z += 0.03; pose.roll += 0.01; pose.pitch -= 0.015; pose.yaw += 0.02;
+    double K[9] = { 1030.0, 0.0, 950.0, 0.0, 970.0, 548.0, 0.0, 0.0, 1.0 };
+    for (int it = 0; it < 8; ++it) {
+        evaluateReprojection(g_c, M, pose, K, out, stats, 1e-6, &arena, &pool);
+        double A[121] = { 0 }, b[11] = { 0 };
+        for (int i = 0; i < M; ++i) {
+            for (int r = 0; r < 2; ++r) {
+                double J[11];
+                for (int k = 0; k < 6; ++k) J[k] = g_jp[12 * i + 6 * r + k];
+                for (int k = 0; k < 5; ++k) J[6 + k] = g_jk[10 * i + 5 * r + k];
+                for (int a = 0; a < 11; ++a) {
+                    for (int c = 0; c < 11; ++c) A[a * 11 + c] += J[a] * J[c];
+                    b[a] -= J[a] * g_res[2 * i + r];
+                }
+            }
+        }
+        if (!solve11(A, b)) { ok = fail("gauss-newton solve", it); break; }
+        pose.x += b[0]; pose.y += b[1]; pose.z += b[2]; pose.roll += b[3]; pose.pitch += b[4]; pose.yaw += b[5];
+        K[0] += b[6]; K[4] += b[7]; K[2] += b[8]; K[5] += b[9]; K[1] += b[10];
+    }
+    if (stats.rms > 1e-6 || fabs(pose.yaw - kExtrinsic.yaw) > 1e-8 || fabs(K[0] - kK[0]) > 1e-5 || fabs(K[1] - kK[1]) > 1e-5) {
+        ok = fail("gauss-newton recovery", stats.rms);
+    }
+
+    // Timing: 200k correspondences with both Jacobians
+    makeCorrespondences(N, 1.0);
+    const int rounds = 10;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) evaluateReprojection(g_c, N, kExtrinsic, kK, out, stats, 1e-6, &arena, &pool);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count() / rounds;
+    std::cout << "evaluateReprojection " << N << " correspondences (residuals + jacobians): " << ms << " ms, rms "
+              << stats.rms << " px (" << pool.concurrency() << " threads)\n";
+
+    if (!ok) return 1;
+    std::cout << "reprojection tests passed\n";
+    return 0;
+}
@@ -0,0 +1,158 @@
+/* *******************************************************************************
+ * File: tests/test_rigid.cpp
+ * Description: Test the rigid matrix module: compose/inverse/transpose against
+ *              a naive 4x4 reference, batch (SIMD) vs. scalar agreement, point
+ *              transforms, batch pose -> matrix and the *FromMatrix round
+ *              trip. Also prints a small batch-compose throughput
+ *              comparison.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "trig.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 4096;
+static double g_as[N * 16], g_bs[N * 16], g_out[N * 16], g_ref[N * 16];
+
+static void naiveMul(const double a[16], const double b[16], double out[16])
+{
+    for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) {
+        double s = 0.0;
+        for (int k = 0; k < 4; ++k) s += a[r*4 + k] * b[k*4 + c];
+        out[r*4 + c] = s;
+    }
+}
+
+static double maxDiff(const double *a, const double *b, int n)
+{
+    double worst = 0.0;
+    for (int i = 0; i < n; ++i) if (fabs(a[i] - b[i]) > worst) worst = fabs(a[i] - b[i]);
+    return worst;
+}
+
+static void randomPose(int i, double m[16])
+{
+    double p[6] = { 0.37 * i - 20.0, 1.3 * sin(0.1 * i), 0.2 * cos(0.05 * i),
+                    0.3 * sin(0.7 * i), 0.2 * cos(0.3 * i), 3.0 * sin(0.011 * i) };
+    pose6ToMatrix(p, m);
+}
+
+int main()
+{
+    bool ok = true;
+    for (int i = 0; i < N; ++i) {
+        randomPose(i, g_as + i * 16);
+        randomPose(N - i, g_bs + i * 16);
+    }
+
+    // Single compose / inverse / transpose
+    double m[16], ref[16], inv[16], id[16];
+    rigidCompose(g_as, g_bs, m);
+    naiveMul(g_as, g_bs, ref);
+    if (maxDiff(m, ref, 16) > 1e-12) ok = fail("rigidCompose", maxDiff(m, ref, 16));
+
+    rigidInverse(m, inv);
+    naiveMul(m, inv, id);
+    const double eye[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+    if (maxDiff(id, eye, 16) > 1e-12) ok = fail("rigidInverse", maxDiff(id, eye, 16));
+
+    double aliased[16];
+    for (int i = 0; i < 16; ++i) aliased[i] = m[i];
+    rigidInverse(aliased, aliased);
+    if (maxDiff(aliased, inv, 16) != 0.0) ok = fail("rigidInverse aliasing", maxDiff(aliased, inv, 16));
+    for (int i = 0; i < 16; ++i) aliased[i] = g_as[i];
+    rigidCompose(aliased, g_bs, aliased);
+    if (maxDiff(aliased, m, 16) != 0.0) ok = fail("rigidCompose aliasing", maxDiff(aliased, m, 16));
+
+    double t[16], tt[16];
+    matrixTranspose4(m, t);
+    if (t[1] != m[4] || t[12] != m[3]) ok = fail("matrixTranspose4", 1.0);
+    matrixTranspose4(t, tt);
+    if (maxDiff(tt, m, 16) != 0.0) ok = fail("matrixTranspose4 twice", maxDiff(tt, m, 16));
+
+    // Batch variants vs. the naive reference
+    for (int i = 0; i < N; ++i) naiveMul(g_as, g_bs + i * 16, g_ref + i * 16);
+    rigidComposeBatch(g_as, g_bs, g_out, N);
+    if (maxDiff(g_out, g_ref, N * 16) > 1e-12) ok = fail("rigidComposeBatch", maxDiff(g_out, g_ref, N * 16));
+
+    for (int i = 0; i < N; ++i) naiveMul(g_as + i * 16, g_bs, g_ref + i * 16);
+    rigidComposeBatchRight(g_as, g_bs, g_out, N);
+    if (maxDiff(g_out, g_ref, N * 16) > 1e-12) ok = fail("rigidComposeBatchRight", maxDiff(g_out, g_ref, N * 16));
+
+    for (int i = 0; i < N; ++i) naiveMul(g_as + i * 16, g_bs + i * 16, g_ref + i * 16);
+    rigidComposePairs(g_as, g_bs, g_out, N);
+    if (maxDiff(g_out, g_ref, N * 16) > 1e-12) ok = fail("rigidComposePairs", maxDiff(g_out, g_ref, N * 16));
+
+    rigidInverseBatch(g_as, g_out, N);
+    for (int i = 0; i < N; ++i) rigidInverse(g_as + i * 16, g_ref + i * 16);
+    if (maxDiff(g_out, g_ref, N * 16) != 0.0) ok = fail("rigidInverseBatch", maxDiff(g_out, g_ref, N * 16));
+
+    // Point transforms (in place)
+    Point3 pts[8], moved[8];
+    for (int i = 0; i < 8; ++i) pts[i] = Point3{ 1.0 * i, -2.0 + i, 0.5 * i };
+    for (int i = 0; i < 8; ++i) moved[i] = rigidTransformPoint(m, pts[i]);
+    rigidTransformPoints(m, pts, pts, 8);
+    for (int i = 0; i < 8; ++i) {
+        if (pts[i].x != moved[i].x || pts[i].y != moved[i].y || pts[i].z != moved[i].z) ok = fail("rigidTransformPoints", 1.0);
+    }
+
+    // posesToMatrices == poseToMatrix for every trig tier (odd count: partial block)
+    static Pose poses[1001];
+    for (int i = 0; i < 1001; ++i) {
+        poses[i] = Pose{ 0.37 * i, -1.0, 0.5, 0.3 * sin(0.7 * i), 0.2 * cos(0.3 * i), 3.0 * sin(0.011 * i) };
+    }
+    poses[7].yaw = 2.0e5; // beyond the polynomial range
+    const TrigTier tiers[4] = { TRIG_LIBM, TRIG_SINCOS, TRIG_POLY_1E12, TRIG_POLY_1E7 };
+    for (int t = 0; t < 4; ++t) {
+        setTrigTier(tiers[t]);
+        posesToMatrices(poses, g_out, 1001);
+        for (int i = 0; i < 1001; ++i) poseToMatrix(poses[i], g_ref + i * 16);
+        if (maxDiff(g_out, g_ref, 1001 * 16) != 0.0) ok = fail("posesToMatrices", maxDiff(g_out, g_ref, 1001 * 16));
+    }
+    setTrigTier(TRIG_LIBM);
+
+    // matrixToPose inverts poseToMatrix; FromMatrix functions round-trip
+    Pose vehicle{ 10.0, -4.0, 0.3, 0.02, -0.03, 1.2 };
+    Pose sensor{ 1.5, 0.2, 1.8, 0.1, 0.05, -0.4 };
+    double pm[16];
+    poseToMatrix(sensor, pm);
+    Pose back = matrixToPose(pm);
+    double e = fabs(back.x - sensor.x) + fabs(back.roll - sensor.roll) + fabs(back.pitch - sensor.pitch) + fabs(back.yaw - sensor.yaw);
+    if (e > 1e-12) ok = fail("matrixToPose", e);
+    Pose g = localToGlobalFromMatrix(vehicle, sensor);
+    Pose l = globalToLocalFromMatrix(vehicle, g);
+    e = fabs(l.x - sensor.x) + fabs(l.y - sensor.y) + fabs(l.z - sensor.z) +
+        fabs(l.roll - sensor.roll) + fabs(l.pitch - sensor.pitch) + fabs(l.yaw - sensor.yaw);
+    if (e > 1e-9) ok = fail("FromMatrix round trip", e);
+
+    // Throughput: naive 4x4 loop vs. batch compose (one vehicle against N poses)
+    const int rounds = 50;
+    double sink = 0.0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        g_as[3] += 1e-6;
+        for (int i = 0; i < N; ++i) naiveMul(g_as, g_bs + i * 16, g_ref + i * 16);
+        sink += g_ref[r * 16 + 3];
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        g_as[3] += 1e-6;
+        rigidComposeBatch(g_as, g_bs, g_out, N);
+        sink += g_out[r * 16 + 3];
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double naiveNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count() / (rounds * N);
+    double batchNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t2 - t1).count() / (rounds * N);
+    std::cout << "compose ns/matrix: naive 4x4 " << naiveNs << ", rigidComposeBatch " << batchNs << "\n";
+    if (sink == 12345.0) std::cout << "";
+
+    if (!ok) return 1;
+    std::cout << "rigid tests passed\n";
+    return 0;
+}
@@ -0,0 +1,109 @@
+/* *******************************************************************************
+ * File: tests/test_ringbuffer.cpp
+ * Description: Test SPSC/MPSC rings and the pose mailbox across threads, using
+ *              the recycled PointFrame slot pattern (free ring + full ring).
+ * *******************************************************************************/
+
+#include <iostream>
+#include <thread>
+#include "ringbuffer.hpp"
+
+using namespace AdasTools;
+
+static const int kSlots = 8;
+static const int kPointsPerSlot = 64;
+static Point3 g_storage[kSlots][kPointsPerSlot];
+static PointFrame g_frames[kSlots];
+
+int main()
+{
+    // Single-threaded sanity: capacity and FIFO order
+    SpscRing<int, 4> small;
+    for (int i = 0; i < 4; ++i) if (!small.tryPush(i)) { std::cerr << "spsc push failed\n"; return 1; }
+    if (small.tryPush(99)) { std::cerr << "spsc accepted push when full\n"; return 2; }
+    for (int i = 0; i < 4; ++i) {
+        int v = -1;
+        if (!small.tryPop(v) || v != i) { std::cerr << "spsc order failed\n"; return 3; }
+    }
+
+    // Driver -> fusion handoff with recycled frame slots
+    SpscRing<PointFrame *, kSlots> freeSlots;
+    SpscRing<PointFrame *, kSlots> fullSlots;
+    for (int i = 0; i < kSlots; ++i) {
+        g_frames[i].points = g_storage[i];
+        g_frames[i].capacity = kPointsPerSlot;
+        g_frames[i].count = 0;
+        freeSlots.tryPush(&g_frames[i]);
+    }
+
+    const unsigned long long kFrames = 20000;
+    std::thread driver([&]() {
+        for (unsigned long long n = 0; n < kFrames; ++n) {
+            PointFrame *f = nullptr;
+            while (!freeSlots.tryPop(f)) std::this_thread::yield();
+            f->count = (size_t)(n % kPointsPerSlot) + 1;
+            for (size_t i = 0; i < f->count; ++i) f->points[i] = Point3{ (double)n, (double)i, 0.0 };
+            f->sequence = n;
+            while (!fullSlots.tryPush(f)) std::this_thread::yield();
+        }
+    });
+
+    unsigned long long expected = 0;
+    bool ok = true;
+    while (expected < kFrames) {
+        PointFrame *f = nullptr;
+        if (!fullSlots.tryPop(f)) { std::this_thread::yield(); continue; }
+        if (f->sequence != expected || f->count != (size_t)(expected % kPointsPerSlot) + 1 ||
+            f->points[f->count - 1].x != (double)expected) ok = false;
+        ++expected;
+        while (!freeSlots.tryPush(f)) std::this_thread::yield();
+    }
+    driver.join();
+    if (!ok) { std::cerr << "spsc frame handoff corrupted\n"; return 4; }
+
+    // Multi-producer: every pushed value must be popped exactly once
+    MpscRing<int, 256> mp;
+    const int kProducers = 4, kPerProducer = 5000;
+    std::thread producers[kProducers];
+    for (int p = 0; p < kProducers; ++p) {
+        producers[p] = std::thread([&mp, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                while (!mp.tryPush(p * kPerProducer + i)) std::this_thread::yield();
+            }
+        });
+    }
+    static bool seen[kProducers * kPerProducer];
+    int received = 0;
+    while (received < kProducers * kPerProducer) {
+        int v;
+        if (!mp.tryPop(v)) { std::this_thread::yield(); continue; }
+        if (v < 0 || v >= kProducers * kPerProducer || seen[v]) { std::cerr << "mpsc duplicate/invalid " << v << "\n"; return 5; }
+        seen[v] = true;
+        ++received;
+    }
+    for (int p = 0; p < kProducers; ++p) producers[p].join();
+
+    // Mailbox: reader always sees a consistent, non-decreasing pose
+    Mailbox<Pose> box;
+    Pose tmp;
+    if (box.read(tmp)) { std::cerr << "mailbox read before publish\n"; return 6; }
+    const int kPoses = 100000;
+    std::thread writer([&box]() {
+        for (int i = 1; i <= kPoses; ++i) {
+            double v = (double)i;
+            box.publish(Pose{ v, v, v, v, v, v });
+        }
+    });
+    double last = 0.0;
+    while (last < (double)kPoses) {
+        Pose p;
+        if (!box.read(p)) continue;
+        if (p.x != p.y || p.x != p.yaw || p.x < last) { std::cerr << "mailbox torn/stale pose\n"; ok = false; break; }
+        last = p.x;
+    }
+    writer.join();
+    if (!ok) return 7;
+
+    std::cout << "ringbuffer test OK\n";
+    return 0;
+}
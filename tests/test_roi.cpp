@@ -0,0 +1,122 @@
+/* *******************************************************************************
+ * File: tests/test_roi.cpp
+ * Description: Test ROI point filters (axis-aligned box, oriented box,
+ *              cylinder; keep/remove) against a straightforward per-point
+ *              reference, in-place compaction, index output and the fused
+ *              filter+transform path. Also prints a throughput comparison
+ *              with transform-then-filter.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "roi.hpp"
+#include "rigid.hpp"
+#include "transformers.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 200000;
+static Point3 g_pts[N], g_out[N], g_ref[N], g_tmp[N];
+static unsigned int g_idx[N];
+
+// Ego box removed, far points (outside a 50 m cylinder) removed, plus a tilted keep box.
+static bool referencePasses(const Point3 &p, const OrientedBox &tilted)
+{
+    bool inEgo = p.x >= -1.0 && p.x <= 4.0 && p.y >= -1.0 && p.y <= 1.0 && p.z >= -2.0 && p.z <= 0.5;
+    bool inRange = p.x * p.x + p.y * p.y <= 50.0 * 50.0 && p.z >= -3.0 && p.z <= 5.0;
+    Frame3D f{ tilted.center.x, tilted.center.y, tilted.center.z, tilted.center.roll, tilted.center.pitch, tilted.center.yaw };
+    Point3 l = globalToLocal(p, f);
+    bool inTilted = fabs(l.x) <= 0.5 * tilted.size.x && fabs(l.y) <= 0.5 * tilted.size.y && fabs(l.z) <= 0.5 * tilted.size.z;
+    return !inEgo && inRange && inTilted;
+}
+
+int main()
+{
+    bool ok = true;
+    TestRng rng{ 7u };
+    for (int i = 0; i < N; ++i) {
+        double v[3];
+        for (int k = 0; k < 3; ++k) v[k] = rng.uniform();
+        double r = 70.0 * v[0] * v[0];
+        double a = 6.283185307179586 * v[1];
+        g_pts[i] = Point3{ r * cos(a), r * sin(a), -2.5 + 5.0 * v[2] };
+    }
+
+    OrientedBox tilted{ Pose{ 0.0, 0.0, 0.0, 0.05, -0.03, 0.4 }, Point3{ 120.0, 60.0, 6.0 } };
+    PointFilter filter;
+    if (!filter.addBox(AxisAlignedBox{ Point3{ -1.0, -1.0, -2.0 }, Point3{ 4.0, 1.0, 0.5 } }, ROI_REMOVE_INSIDE) ||
+        !filter.addCylinder(RoiCylinder{ 0.0, 0.0, 50.0, -3.0, 5.0 }, ROI_KEEP_INSIDE) ||
+        !filter.addOrientedBox(tilted, ROI_KEEP_INSIDE)) {
+        ok = fail("add regions", 0);
+    }
+    for (size_t k = filter.regionCount(); k < kRoiMaxRegions; ++k) filter.addCylinder(RoiCylinder{ 0, 0, 1e9, -1e9, 1e9 }, ROI_KEEP_INSIDE);
+    if (filter.addBox(AxisAlignedBox{ Point3{ 0, 0, 0 }, Point3{ 1, 1, 1 } }, ROI_KEEP_INSIDE)) ok = fail("region limit", 0);
+
+    size_t refCount = 0;
+    for (int i = 0; i < N; ++i) {
+        if (referencePasses(g_pts[i], tilted)) g_ref[refCount++] = g_pts[i];
+    }
+    if (refCount < N / 4 || refCount > (size_t)N * 9 / 10) ok = fail("reference keeps an unexpected share", (double)refCount);
+
+    size_t kept = filter.filterPoints(g_pts, N, g_out);
+    if (kept != refCount) ok = fail("filterPoints count", (double)kept);
+    for (size_t i = 0; i < kept && i < refCount; ++i) {
+        if (g_out[i].x != g_ref[i].x || g_out[i].y != g_ref[i].y || g_out[i].z != g_ref[i].z) { ok = fail("filterPoints order", (double)i); break; }
+    }
+    for (int i = 0; i < 1000; ++i) {
+        if (filter.passes(g_pts[i]) != referencePasses(g_pts[i], tilted)) { ok = fail("passes", i); break; }
+    }
+
+    size_t idxCount = filter.filterIndices(g_pts, N, g_idx);
+    if (idxCount != refCount) ok = fail("filterIndices count", (double)idxCount);
+    for (size_t i = 0; i < idxCount && i < refCount; ++i) {
+        if (g_pts[g_idx[i]].x != g_ref[i].x) { ok = fail("filterIndices", (double)i); break; }
+    }
+
+    // Fused transform == filter then transform
+    double T[16];
+    poseToMatrix(Pose{ 1.2, 0.0, 1.8, 0.0, 0.02, 0.01 }, T);
+    size_t fused = filter.filterTransform(g_pts, N, T, g_out);
+    rigidTransformPoints(T, g_ref, g_tmp, refCount);
+    if (fused != refCount) ok = fail("filterTransform count", (double)fused);
+    for (size_t i = 0; i < fused && i < refCount; ++i) {
+        if (g_out[i].x != g_tmp[i].x || g_out[i].y != g_tmp[i].y || g_out[i].z != g_tmp[i].z) { ok = fail("filterTransform", (double)i); break; }
+    }
+
+    // In place
+    for (int i = 0; i < N; ++i) g_tmp[i] = g_pts[i];
+    if (filter.filterPoints(g_tmp, N, g_tmp) != refCount || g_tmp[refCount - 1].x != g_ref[refCount - 1].x) ok = fail("in-place filterPoints", 0);
+    for (int i = 0; i < N; ++i) g_tmp[i] = g_pts[i];
+    if (filter.filterTransform(g_tmp, N, T, g_tmp) != refCount || g_tmp[0].x != g_out[0].x) ok = fail("in-place filterTransform", 0);
+
+    // Throughput: transform everything then filter in the output frame vs. fused
+    PointFilter simple;
+    simple.addBox(AxisAlignedBox{ Point3{ -1.0, -1.0, -2.0 }, Point3{ 4.0, 1.0, 0.5 } }, ROI_REMOVE_INSIDE);
+    simple.addCylinder(RoiCylinder{ 0.0, 0.0, 40.0, -3.0, 5.0 }, ROI_KEEP_INSIDE);
+    const int rounds = 10;
+    size_t sink = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        Frame3D f{ 1.2, 0.0, 1.8, 0.0, 0.02, 0.01 };
+        size_t c = 0;
+        for (int i = 0; i < N; ++i) {
+            Point3 g = localToGlobal(g_pts[i], f);
+            if (simple.passes(g_pts[i])) g_out[c++] = g;
+        }
+        sink += c;
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) sink += simple.filterTransform(g_pts, N, T, g_out);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double naiveNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count() / (rounds * (double)N);
+    double fusedNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t2 - t1).count() / (rounds * (double)N);
+    std::cout << "ns/point: localToGlobal + per-point test " << naiveNs << ", fused filterTransform " << fusedNs
+              << " (kept " << (double)simple.filterIndices(g_pts, N, g_idx) / N * 100.0 << "%)\n";
+    if (sink == 1) std::cout << "";
+
+    if (!ok) return 1;
+    std::cout << "roi tests passed\n";
+    return 0;
+}
@@ -0,0 +1,71 @@
+/* *******************************************************************************
+ * File: tests/test_trace.cpp
+ * Description: Test trace event recording from several threads and the Chrome
+ *              trace JSON export (thread names, categories, event counts).
+ * *******************************************************************************/
+
+#include <iostream>
+#include <thread>
+#include <stdio.h>
+#include <string.h>
+#include "trace.hpp"
+
+using namespace AdasTools;
+
+static int countOccurrences(const char *hay, const char *needle)
+{
+    int n = 0;
+    for (const char *p = strstr(hay, needle); p; p = strstr(p + 1, needle)) ++n;
+    return n;
+}
+
+int main()
+{
+    traceSetEnabled(true);
+    traceSetThreadName("fusion");
+
+    std::thread driver([]() {
+        traceSetThreadName("lidar_driver");
+        for (int i = 0; i < 10; ++i) {
+            TraceScope scope(TRACE_STAGE_TRANSFORM, "localToGlobal");
+        }
+    });
+    for (int i = 0; i < 5; ++i) {
+        TraceScope scope(TRACE_STAGE_PROJECT, "projectPointCamera");
+    }
+    driver.join();
+
+    traceSetEnabled(false);
+    { TraceScope ignored(TRACE_STAGE_RASTERIZE, "ignored"); }
+
+    if (traceEventCount() != 15 || traceDroppedCount() != 0) {
+        std::cerr << "unexpected event count " << traceEventCount() << "\n";
+        return 1;
+    }
+
+    const char *path = "test_trace_output.json";
+    if (!traceWriteChromeJson(path)) { std::cerr << "trace write failed\n"; return 2; }
+
+    static char buf[1 << 16];
+    FILE *f = fopen(path, "r");
+    if (!f) { std::cerr << "trace file missing\n"; return 3; }
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    remove(path);
+
+    if (countOccurrences(buf, "\"cat\":\"transform\"") != 10 ||
+        countOccurrences(buf, "\"cat\":\"project\"") != 5 ||
+        countOccurrences(buf, "\"lidar_driver\"") != 1 ||
+        countOccurrences(buf, "ignored") != 0 ||
+        strncmp(buf, "{\"displayTimeUnit\"", 18) != 0) {
+        std::cerr << "trace JSON content mismatch\n" << buf << "\n";
+        return 4;
+    }
+
+    traceClear();
+    if (traceEventCount() != 0) { std::cerr << "traceClear failed\n"; return 5; }
+
+    std::cout << "trace test OK\n";
+    return 0;
+}
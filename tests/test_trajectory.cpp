@@ -0,0 +1,146 @@
+/* *******************************************************************************
+ * File: tests/test_trajectory.cpp
+ * Description: Test the SoA trajectory: relative poses against
+ *              globalToLocalFromMatrix, prefix composition of deltas, batch
+ *              deltas, batch pose conversion, time lookup/interpolation and
+ *              growth. Also prints a small relative-pose throughput
+ *              comparison.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "trajectory.hpp"
+#include "transformers.hpp"
+#include "trig.hpp"
+#include "test_util.hpp"
+
+using namespace AdasTools;
+
+static const int N = 20000;
+static Pose g_poses[N];
+static RigidTransform g_out[N];
+
+static double poseError(const Pose &a, const Pose &b)
+{
+    return fabs(a.x - b.x) + fabs(a.y - b.y) + fabs(a.z - b.z) +
+           fabs(a.roll - b.roll) + fabs(a.pitch - b.pitch) + fabs(a.yaw - b.yaw);
+}
+
+static double transformError(const RigidTransform &a, const RigidTransform &b)
+{
+    double d = fabs(a.t.x - b.t.x) + fabs(a.t.y - b.t.y) + fabs(a.t.z - b.t.z);
+    double dot = a.q.w * b.q.w + a.q.x * b.q.x + a.q.y * b.q.y + a.q.z * b.q.z;
+    return d + (1.0 - fabs(dot));
+}
+
+int main()
+{
+    bool ok = true;
+    for (int i = 0; i < N; ++i) {
+        double s = 0.01 * i;
+        g_poses[i] = Pose{ 30.0 * sin(0.2 * s), 2.0 * s, 0.1 * sin(s), 0.02 * sin(3.0 * s), 0.03 * cos(2.0 * s), fmod(0.3 * s, 6.0) - 3.0 };
+    }
+
+    Trajectory traj;
+    for (int i = 0; i < N; ++i) {
+        if (!traj.append(0.1 * i, g_poses[i])) { fail("append", 1.0); return 1; }
+    }
+    if (traj.size() != (size_t)N || traj.capacity() < (size_t)N) ok = fail("size/capacity", 0.0);
+
+    // Absolute poses survive the quaternion round trip
+    double worst = 0.0;
+    for (int i = 0; i < N; i += 97) {
+        double e = poseError(traj.pose(i), g_poses[i]);
+        if (e > worst) worst = e;
+    }
+    if (worst > 1e-9) ok = fail("pose round trip", worst);
+
+    // posesToTransforms == poseToTransform for every trig tier
+    const TrigTier tiers[4] = { TRIG_LIBM, TRIG_SINCOS, TRIG_POLY_1E12, TRIG_POLY_1E7 };
+    for (int t = 0; t < 4; ++t) {
+        setTrigTier(tiers[t]);
+        posesToTransforms(g_poses, g_out, 1001);
+        for (int i = 0; i < 1001; ++i) {
+            const RigidTransform r = poseToTransform(g_poses[i]);
+            if (r.q.w != g_out[i].q.w || r.q.x != g_out[i].q.x || r.q.y != g_out[i].q.y || r.q.z != g_out[i].q.z ||
+                r.t.x != g_out[i].t.x) {
+                ok = fail("posesToTransforms", (double)i);
+                break;
+            }
+        }
+    }
+    setTrigTier(TRIG_LIBM);
+
+    // relative(i, j) == globalToLocalFromMatrix(pose i, pose j)
+    worst = 0.0;
+    for (int k = 0; k < 500; ++k) {
+        int i = (k * 7919) % N, j = (k * 104729 + 13) % N;
+        Pose ref = globalToLocalFromMatrix(g_poses[i], g_poses[j]);
+        double e = poseError(transformToPose(traj.relative(i, j)), ref);
+        if (e > worst) worst = e;
+    }
+    if (worst > 1e-8) ok = fail("relative vs globalToLocalFromMatrix", worst);
+
+    // Prefix composition: re-appending the deltas reproduces the trajectory
+    traj.deltas(0, N - 1, 1, g_out);
+    Trajectory odom;
+    odom.reserve(N);
+    if (odom.reserve((size_t)-1 / 16) || odom.reserve((size_t)-1) || odom.capacity() != (size_t)N) {
+        ok = fail("overflowing reserve", (double)odom.capacity());
+    }
+    odom.appendDelta(0.0, traj.transform(0));
+    for (int i = 1; i < N; ++i) odom.appendDelta(0.1 * i, g_out[i - 1]);
+    double e = transformError(odom.transform(N - 1), traj.transform(N - 1));
+    if (e > 1e-7) ok = fail("appendDelta drift", e);
+
+    // Strided deltas and relativeBatch agree with relative()
+    traj.deltas(5, 100, 10, g_out);
+    worst = 0.0;
+    for (int k = 0; k < 100; ++k) {
+        double d = transformError(g_out[k], traj.relative(5 + k * 10, 5 + (k + 1) * 10));
+        if (d > worst) worst = d;
+    }
+    size_t from[3] = { 0, 10, (size_t)N - 1 }, to[3] = { (size_t)N - 1, 10, 0 };
+    RigidTransform batch[3];
+    traj.relativeBatch(from, to, batch, 3);
+    for (int k = 0; k < 3; ++k) {
+        double d = transformError(batch[k], traj.relative(from[k], to[k]));
+        if (d > worst) worst = d;
+    }
+    if (transformError(batch[1], identityTransform()) > 1e-15) ok = fail("relative(i, i)", 1.0);
+    if (worst > 1e-12) ok = fail("deltas/relativeBatch", worst);
+
+    // Time lookup and interpolation
+    if (traj.indexAtOrBefore(-1.0) != traj.size() || traj.indexAtOrBefore(0.0) != 0 ||
+        traj.indexAtOrBefore(0.15) != 1 || traj.indexAtOrBefore(1e9) != (size_t)N - 1) {
+        ok = fail("indexAtOrBefore", 1.0);
+    }
+    RigidTransform mid;
+    if (!traj.interpolate(0.1 * 123, mid) || transformError(mid, traj.transform(123)) > 1e-12) ok = fail("interpolate at sample", 1.0);
+    if (!traj.interpolate(0.1 * 123 + 0.05, mid)) ok = fail("interpolate between samples", 1.0);
+    else {
+        RigidTransform a = traj.transform(123), b = traj.transform(124);
+        if (fabs(mid.t.x - 0.5 * (a.t.x + b.t.x)) > 1e-9) ok = fail("interpolate translation", fabs(mid.t.x - 0.5 * (a.t.x + b.t.x)));
+    }
+    if (traj.interpolate(-0.5, mid) || traj.interpolate(0.1 * N, mid)) ok = fail("interpolate out of range", 1.0);
+
+    // Throughput: globalToLocalFromMatrix vs. cached relative()
+    double sink = 0.0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i + 1 < N; ++i) sink += globalToLocalFromMatrix(g_poses[i], g_poses[i + 1]).x;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < 10; ++r) {
+        traj.deltas(0, N - 1, 1, g_out);
+        sink += g_out[r].t.x;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double matNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count() / (N - 1);
+    double deltaNs = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t2 - t1).count() / (10.0 * (N - 1));
+    std::cout << "relative pose ns: globalToLocalFromMatrix " << matNs << ", Trajectory::deltas " << deltaNs << "\n";
+    if (sink == 12345.0) std::cout << "";
+
+    if (!ok) return 1;
+    std::cout << "trajectory tests passed\n";
+    return 0;
+}
@@ -0,0 +1,98 @@
+/* *******************************************************************************
+ * File: tests/test_trig.cpp
+ * Description: Test the sinCos accuracy tiers against libm (documented error
+ *              bounds), batch/scalar agreement, the libm fallback for large
+ *              angles, and the Euler core with a non-default global tier.
+ *              Also prints a small throughput comparison.
+ * *******************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <math.h>
+#include "trig.hpp"
+#include "transformers.hpp"
+#include "quaternion.hpp"
+
+using namespace AdasTools;
+
+static const int N = 200000;
+static double g_x[N], g_s[N], g_c[N];
+
+static double maxError(TrigTier tier, double range)
+{
+    double worst = 0.0;
+    for (int i = 0; i < N; ++i) {
+        double x = -range + 2.0 * range * (double)i / (double)(N - 1);
+        double s, c;
+        sinCos(x, s, c, tier);
+        double es = fabs(s - sin(x)), ec = fabs(c - cos(x));
+        if (es > worst) worst = es;
+        if (ec > worst) worst = ec;
+    }
+    return worst;
+}
+
+static double batchNs(TrigTier tier)
+{
+    // Inputs change every round so repeated libm calls cannot be folded away.
+    double sink = 0.0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < 20; ++r) {
+        g_x[r] += 1e-3;
+        sinCosBatch(g_x, g_s, g_c, N, tier);
+        sink += g_s[r] + g_c[N - 1 - r];
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    if (sink == 12345.0) std::cout << "";
+    return std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(end - start).count() / (20.0 * N);
+}
+
+int main()
+{
+    struct { TrigTier tier; double bound; const char *name; } tiers[] = {
+        { TRIG_SINCOS, 1e-15, "sincos" },
+        { TRIG_POLY_1E12, 1e-15, "poly 1e-12" },
+        { TRIG_POLY_1E7, 3e-8, "poly 1e-7" },
+    };
+    for (const auto &t : tiers) {
+        double e1 = maxError(t.tier, 4.0);
+        double e2 = maxError(t.tier, kTrigPolyRangeLimit);
+        if (e1 > t.bound || e2 > t.bound) {
+            std::cerr << t.name << " error too large: " << e1 << " / " << e2 << "\n";
+            return 1;
+        }
+        std::cout << t.name << ": max error " << (e1 > e2 ? e1 : e2) << "\n";
+    }
+
+    // Batch matches scalar; out-of-range angles fall back to libm
+    for (int i = 0; i < N; ++i) g_x[i] = (i % 97 == 0) ? 3.0e7 + i : 0.001 * i - 100.0;
+    sinCosBatch(g_x, g_s, g_c, N, TRIG_POLY_1E7);
+    for (int i = 0; i < N; ++i) {
+        double s, c;
+        sinCos(g_x[i], s, c, TRIG_POLY_1E7);
+        if (s != g_s[i] || c != g_c[i]) { std::cerr << "batch/scalar mismatch at " << i << "\n"; return 2; }
+    }
+    if (g_s[0] != sin(g_x[0])) { std::cerr << "large-angle fallback not exact\n"; return 3; }
+
+    // Euler core under the fast tier stays within the tier's error
+    setTrigTier(TRIG_POLY_1E7);
+    Frame3D f = {2.0, 0.1, -0.3, 0.1, -0.2, 0.3};
+    Point3 p = {1.234, -0.5, 0.75};
+    Point3 g = localToGlobal(p, f);
+    Point3 back = globalToLocal(g, f);
+    Quaternion q = quaternionFromRPY(0.1, -0.2, 0.3);
+    setTrigTier(TRIG_LIBM);
+    Point3 gRef = localToGlobal(p, f);
+    if (fabs(back.x - p.x) > 1e-6 || fabs(g.x - gRef.x) > 1e-6 || fabs(g.y - gRef.y) > 1e-6) {
+        std::cerr << "core under TRIG_POLY_1E7 drifted\n";
+        return 4;
+    }
+    double qn = sqrt(q.w*q.w + q.x*q.x + q.y*q.y + q.z*q.z);
+    if (fabs(qn - 1.0) > 1e-7) { std::cerr << "quaternion norm drifted\n"; return 5; }
+
+    for (int i = 0; i < N; ++i) g_x[i] = 0.0001 * i - 10.0;
+    std::cout << "batch ns/angle: libm " << batchNs(TRIG_LIBM) << ", sincos " << batchNs(TRIG_SINCOS)
+              << ", poly 1e-12 " << batchNs(TRIG_POLY_1E12) << ", poly 1e-7 " << batchNs(TRIG_POLY_1E7) << "\n";
+    std::cout << "trig test OK\n";
+    return 0;
+}
@@ -0,0 +1,34 @@
+/* *******************************************************************************
+ * File: tests/test_util.hpp
+ * Description: Helpers shared by the test programs: failure reporting and a
+ *              seeded LCG for reproducible test data.
+ * *******************************************************************************/
+
+#pragma once
+#include <iostream>
+
+/** @brief Print a failed check with its error; returns false for `ok = fail(...)`. */
+inline bool fail(const char *what, double err)
+{
+    std::cerr << "FAIL " << what << " (" << err << ")\n";
+    return false;
+}
+
+/** @brief Print a failed check; returns false for `ok = fail(...)`. */
+inline bool fail(const char *what)
+{
+    std::cerr << "FAIL " << what << "\n";
+    return false;
+}
+
+/** @brief Linear congruential generator: the same sequence for a seed on every platform. */
+struct TestRng {
+    unsigned int seed;
+
+    /** @brief Next value, uniform in [0, 1) with 24 bits. */
+    double uniform()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (double)(seed >> 8) / 16777216.0;
+    }
+};